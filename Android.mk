@@ -103,6 +103,8 @@ LOCAL_SRC_FILES := \
     device/src/HeadsetVaMic.cpp \
     device/src/RTProxy.cpp \
     device/src/SpeakerProtection.cpp \
+    device/src/SpkrTelemetry.cpp \
+    device/src/SpkrTempSampler.cpp \
     device/src/FMDevice.cpp \
     device/src/ExtEC.cpp \
     device/src/HapticsDev.cpp \
@@ -110,7 +112,9 @@ LOCAL_SRC_FILES := \
     device/src/ECRefDevice.cpp \
     session/src/Session.cpp \
     session/src/PayloadBuilder.cpp \
+    session/src/ParamBatch.cpp \
     session/src/SessionAlsaPcm.cpp \
+    session/src/PcmNonBlockingIo.cpp \
     session/src/SessionAgm.cpp \
     session/src/SessionAlsaUtils.cpp \
     session/src/SessionAlsaCompress.cpp \
@@ -123,17 +127,30 @@ LOCAL_SRC_FILES := \
     session/src/ACDEngine.cpp \
     resource_manager/src/ResourceManager.cpp \
     resource_manager/src/SndCardMonitor.cpp \
+    resource_manager/src/MixerEventDispatcher.cpp \
+    resource_manager/src/MixerPathPlanner.cpp \
+    resource_manager/src/StreamGraphPool.cpp \
+    resource_manager/src/SsrOrchestrator.cpp \
+    resource_manager/src/PalExecutor.cpp \
+    resource_manager/src/PalVoteAggregator.cpp \
+    resource_manager/src/StreamConcurrencyState.cpp \
     utils/src/SoundTriggerPlatformInfo.cpp \
     utils/src/ACDPlatformInfo.cpp \
     utils/src/VoiceUIPlatformInfo.cpp \
     utils/src/PalRingBuffer.cpp \
+    utils/src/PalTraceLog.cpp \
+    utils/src/PalSpanTracer.cpp \
+    utils/src/PalOfflineClock.cpp \
+    utils/src/PalInitGraph.cpp \
     utils/src/SoundTriggerUtils.cpp \
+    utils/src/SoundModelStore.cpp \
     utils/src/VoiceUIInterface.cpp \
     utils/src/SVAInterface.cpp \
     utils/src/HotwordInterface.cpp \
     utils/src/CustomVAInterface.cpp \
     utils/src/SignalHandler.cpp \
-    utils/src/MetadataParser.cpp
+    utils/src/MetadataParser.cpp \
+    utils/src/VUILatencyTracer.cpp
 
 LOCAL_HEADER_LIBRARIES := \
     libarpal_headers \
@@ -215,6 +232,373 @@ LOCAL_VENDOR_MODULE := true
 
 include $(BUILD_EXECUTABLE)
 
+include $(CLEAR_VARS)
+LOCAL_USE_VNDK := true
+
+LOCAL_SRC_FILES  := test/MixerEventDispatcherTest.cpp
+
+LOCAL_MODULE               := PalMixerEventTest
+LOCAL_MODULE_OWNER         := qti
+LOCAL_MODULE_TAGS          := optional
+
+LOCAL_C_INCLUDES := $(LOCAL_PATH)/resource_manager/inc
+
+LOCAL_HEADER_LIBRARIES := \
+    libarpal_headers \
+    libagm_headers
+
+LOCAL_SHARED_LIBRARIES := \
+                          libar-pal
+LOCAL_VENDOR_MODULE := true
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+LOCAL_USE_VNDK := true
+
+LOCAL_SRC_FILES  := test/MixerPathPlannerBench.cpp
+
+LOCAL_MODULE               := PalMixerPathBench
+LOCAL_MODULE_OWNER         := qti
+LOCAL_MODULE_TAGS          := optional
+
+LOCAL_C_INCLUDES := \
+    $(LOCAL_PATH)/resource_manager/inc \
+    $(TOP)/system/media/audio_route/include
+
+LOCAL_HEADER_LIBRARIES := \
+    libarpal_headers
+
+LOCAL_SHARED_LIBRARIES := \
+                          libar-pal \
+                          libaudioroute \
+                          libexpat
+
+ifeq ($(TARGET_USES_QTI_TINYCOMPRESS),true)
+LOCAL_SHARED_LIBRARIES += libqti-tinyalsa
+else
+LOCAL_SHARED_LIBRARIES += libtinyalsa
+endif
+LOCAL_VENDOR_MODULE := true
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+LOCAL_USE_VNDK := true
+
+# built with the sampler source, the test provides the mixer controls
+LOCAL_SRC_FILES  := \
+    test/SpkrTempSamplerTest.cpp \
+    device/src/SpkrTempSampler.cpp
+
+LOCAL_MODULE               := PalSpkrTempSamplerTest
+LOCAL_MODULE_OWNER         := qti
+LOCAL_MODULE_TAGS          := optional
+
+LOCAL_C_INCLUDES := \
+    $(LOCAL_PATH) \
+    $(LOCAL_PATH)/device/inc
+
+LOCAL_HEADER_LIBRARIES := \
+    libarpal_headers \
+    libarosal_headers
+
+LOCAL_SHARED_LIBRARIES := \
+                          libar-pal \
+                          liblog
+LOCAL_VENDOR_MODULE := true
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+LOCAL_USE_VNDK := true
+
+LOCAL_SRC_FILES  := \
+    test/ParamBatchTest.cpp \
+    session/src/ParamBatch.cpp
+
+LOCAL_MODULE               := PalParamBatchTest
+LOCAL_MODULE_OWNER         := qti
+LOCAL_MODULE_TAGS          := optional
+
+LOCAL_C_INCLUDES := \
+    $(LOCAL_PATH) \
+    $(LOCAL_PATH)/session/inc
+
+LOCAL_HEADER_LIBRARIES := \
+    libarpal_headers \
+    libspf-headers \
+    libarosal_headers
+
+LOCAL_SHARED_LIBRARIES := \
+                          libar-pal \
+                          liblog
+LOCAL_VENDOR_MODULE := true
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+LOCAL_USE_VNDK := true
+
+LOCAL_CFLAGS     := -D_ANDROID_
+LOCAL_CFLAGS     += -Wno-macro-redefined
+
+LOCAL_SRC_FILES  := test/DisplayPortEdidTest.cpp
+
+LOCAL_MODULE               := PalDisplayPortEdidTest
+LOCAL_MODULE_OWNER         := qti
+LOCAL_MODULE_TAGS          := optional
+
+LOCAL_C_INCLUDES := \
+    $(LOCAL_PATH)/stream/inc \
+    $(LOCAL_PATH)/device/inc \
+    $(LOCAL_PATH)/session/inc \
+    $(LOCAL_PATH)/resource_manager/inc \
+    $(LOCAL_PATH)/context_manager/inc \
+    $(LOCAL_PATH)/utils/inc \
+    $(LOCAL_PATH)/plugins/codecs \
+    $(TOP)/system/media/audio_route/include \
+    $(TOP)/system/media/audio/include
+
+LOCAL_HEADER_LIBRARIES := \
+    libarpal_headers \
+    libspf-headers \
+    libcapiv2_headers \
+    libagm_headers \
+    libacdb_headers \
+    liblisten_headers \
+    libarosal_headers \
+    libvui_dmgr_headers
+
+LOCAL_SHARED_LIBRARIES := \
+                          libar-pal \
+                          liblog
+
+ifeq ($(TARGET_USES_QTI_TINYCOMPRESS),true)
+LOCAL_SHARED_LIBRARIES += libqti-tinyalsa libqti-tinycompress
+else
+LOCAL_C_INCLUDES       += $(TOP)/external/tinycompress/include
+LOCAL_SHARED_LIBRARIES += libtinyalsa libtinycompress
+endif
+LOCAL_VENDOR_MODULE := true
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+LOCAL_USE_VNDK := true
+
+LOCAL_CFLAGS     := -D_ANDROID_
+LOCAL_CFLAGS     += -Wno-macro-redefined
+
+LOCAL_SRC_FILES  := test/ResourceManagerXmlBench.cpp
+
+LOCAL_MODULE               := PalRmXmlBench
+LOCAL_MODULE_OWNER         := qti
+LOCAL_MODULE_TAGS          := optional
+
+LOCAL_C_INCLUDES := \
+    $(LOCAL_PATH)/stream/inc \
+    $(LOCAL_PATH)/device/inc \
+    $(LOCAL_PATH)/session/inc \
+    $(LOCAL_PATH)/resource_manager/inc \
+    $(LOCAL_PATH)/context_manager/inc \
+    $(LOCAL_PATH)/utils/inc \
+    $(LOCAL_PATH)/plugins/codecs \
+    $(TOP)/system/media/audio_route/include \
+    $(TOP)/system/media/audio/include
+
+LOCAL_HEADER_LIBRARIES := \
+    libarpal_headers \
+    libspf-headers \
+    libcapiv2_headers \
+    libagm_headers \
+    libacdb_headers \
+    liblisten_headers \
+    libarosal_headers \
+    libvui_dmgr_headers
+
+LOCAL_SHARED_LIBRARIES := \
+                          libar-pal \
+                          libexpat \
+                          liblog
+
+ifeq ($(TARGET_USES_QTI_TINYCOMPRESS),true)
+LOCAL_SHARED_LIBRARIES += libqti-tinyalsa libqti-tinycompress
+else
+LOCAL_C_INCLUDES       += $(TOP)/external/tinycompress/include
+LOCAL_SHARED_LIBRARIES += libtinyalsa libtinycompress
+endif
+LOCAL_VENDOR_MODULE := true
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+LOCAL_USE_VNDK := true
+
+LOCAL_SRC_FILES  := \
+    test/StreamConcurrencyStateTest.cpp \
+    resource_manager/src/StreamConcurrencyState.cpp
+
+LOCAL_MODULE               := PalStreamConcurrencyStateTest
+LOCAL_MODULE_OWNER         := qti
+LOCAL_MODULE_TAGS          := optional
+
+LOCAL_C_INCLUDES := \
+    $(LOCAL_PATH) \
+    $(LOCAL_PATH)/resource_manager/inc
+
+LOCAL_HEADER_LIBRARIES := \
+    libarpal_headers
+
+LOCAL_SHARED_LIBRARIES := \
+                          liblog
+LOCAL_VENDOR_MODULE := true
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+LOCAL_USE_VNDK := true
+
+LOCAL_SRC_FILES  := test/SsrRestoreTest.cpp
+
+LOCAL_MODULE               := PalSsrRestoreTest
+LOCAL_MODULE_OWNER         := qti
+LOCAL_MODULE_TAGS          := optional
+
+LOCAL_C_INCLUDES := \
+    $(LOCAL_PATH) \
+    $(LOCAL_PATH)/resource_manager/inc
+
+LOCAL_HEADER_LIBRARIES := \
+    libarpal_headers
+
+LOCAL_SHARED_LIBRARIES := \
+                          libar-pal \
+                          liblog
+LOCAL_VENDOR_MODULE := true
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+LOCAL_USE_VNDK := true
+
+LOCAL_SRC_FILES  := test/BoundedQueueTest.cpp
+
+LOCAL_MODULE               := PalBoundedQueueTest
+LOCAL_MODULE_OWNER         := qti
+LOCAL_MODULE_TAGS          := optional
+
+LOCAL_C_INCLUDES := \
+    $(LOCAL_PATH)/context_manager/inc
+
+LOCAL_SHARED_LIBRARIES := \
+                          liblog
+LOCAL_VENDOR_MODULE := true
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+LOCAL_USE_VNDK := true
+
+LOCAL_SRC_FILES  := test/PalExecutorTest.cpp
+
+LOCAL_MODULE               := PalExecutorTest
+LOCAL_MODULE_OWNER         := qti
+LOCAL_MODULE_TAGS          := optional
+
+LOCAL_C_INCLUDES := \
+    $(LOCAL_PATH)/resource_manager/inc
+
+LOCAL_SHARED_LIBRARIES := \
+                          libar-pal \
+                          liblog
+LOCAL_VENDOR_MODULE := true
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+LOCAL_USE_VNDK := true
+
+LOCAL_SRC_FILES  := test/PalTraceLogBench.cpp
+
+LOCAL_MODULE               := PalTraceLogBench
+LOCAL_MODULE_OWNER         := qti
+LOCAL_MODULE_TAGS          := optional
+
+LOCAL_C_INCLUDES := \
+    $(LOCAL_PATH)
+
+LOCAL_HEADER_LIBRARIES := \
+    libarpal_headers \
+    libarosal_headers
+
+LOCAL_SHARED_LIBRARIES := \
+                          libar-pal \
+                          liblog
+LOCAL_VENDOR_MODULE := true
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+LOCAL_USE_VNDK := true
+
+LOCAL_SRC_FILES  := test/PcmNonBlockingIoTest.cpp
+
+LOCAL_MODULE               := PalPcmNonBlockingIoTest
+LOCAL_MODULE_OWNER         := qti
+LOCAL_MODULE_TAGS          := optional
+
+LOCAL_C_INCLUDES := \
+    $(LOCAL_PATH)/session/inc
+
+LOCAL_SHARED_LIBRARIES := \
+                          libar-pal \
+                          liblog
+LOCAL_VENDOR_MODULE := true
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+LOCAL_USE_VNDK := true
+
+LOCAL_SRC_FILES  := test/PalVoteAggregatorTest.cpp
+
+LOCAL_MODULE               := PalVoteAggregatorTest
+LOCAL_MODULE_OWNER         := qti
+LOCAL_MODULE_TAGS          := optional
+
+LOCAL_C_INCLUDES := \
+    $(LOCAL_PATH)/resource_manager/inc
+
+LOCAL_HEADER_LIBRARIES := \
+    libarpal_headers
+
+LOCAL_SHARED_LIBRARIES := \
+                          libar-pal \
+                          liblog
+LOCAL_VENDOR_MODULE := true
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+LOCAL_USE_VNDK := true
+
+LOCAL_SRC_FILES  := test/PalInitGraphTest.cpp
+
+LOCAL_MODULE               := PalInitGraphTest
+LOCAL_MODULE_OWNER         := qti
+LOCAL_MODULE_TAGS          := optional
+
+LOCAL_C_INCLUDES := \
+    $(LOCAL_PATH)/utils/inc
+
+LOCAL_SHARED_LIBRARIES := \
+                          libar-pal \
+                          liblog
+LOCAL_VENDOR_MODULE := true
+
+include $(BUILD_EXECUTABLE)
+
 include $(CLEAR_VARS)
 
 include $(PAL_BASE_PATH)/plugins/Android.mk
@@ -72,6 +72,7 @@
 #include "Device.h"
 #include "ResourceManager.h"
 #include "PalCommon.h"
+#include "PalSpanTracer.h"
 class Stream;
 
 /**
@@ -114,6 +115,9 @@ static void notify_concurrent_stream(pal_stream_type_t type,
  */
 int32_t pal_init(void)
 {
+    /* started before the first span to trace the init itself */
+    PalSpanTracer::startFromEnv();
+    PAL_TRACE_SPAN("pal_init");
     PAL_DBG(LOG_TAG, "Enter.");
     int32_t ret = 0;
     std::shared_ptr<ResourceManager> ri = NULL;
@@ -137,7 +141,11 @@ int32_t pal_init(void)
         goto exit;
     }
 
-    ri->init();
+    ret = ri->init();
+    if (ret != 0) {
+        PAL_ERR(LOG_TAG, "resource manager init failed, error:%d", ret);
+        goto exit;
+    }
 
     ret = ri->initContextManager();
     if (ret != 0) {
@@ -162,6 +170,7 @@ void pal_deinit(void)
     PAL_DBG(LOG_TAG, "Enter.");
 
     std::shared_ptr<ResourceManager> ri = NULL;
+    bool deinit = false;
 
     pal_mutex.lock();
     if (pal_init_ref_cnt > 0) {
@@ -183,9 +192,15 @@ void pal_deinit(void)
 
     ResourceManager::deinit();
 
+    if (PalSpanTracer::isEnabled())
+        PalSpanTracer::stop();
+    deinit = true;
+
 exit:
     pal_mutex.unlock();
     PAL_DBG(LOG_TAG, "Exit.");
+    if (deinit)
+        pal_trace_deinit();
     return;
 }
 
@@ -196,6 +211,7 @@ int32_t pal_stream_open(struct pal_stream_attributes *attributes,
                         pal_stream_callback cb, uint64_t cookie,
                         pal_stream_handle_t **stream_handle)
 {
+    PAL_TRACE_SPAN("pal_stream_open");
     uint64_t *stream = NULL;
     Stream *s = NULL;
     int status;
@@ -264,6 +280,7 @@ exit:
 
 int32_t pal_stream_close(pal_stream_handle_t *stream_handle)
 {
+    PAL_TRACE_SPAN("pal_stream_close");
     Stream *s = NULL;
     int status;
     struct pal_stream_attributes sAttr;
@@ -314,6 +331,7 @@ exit:
 
 int32_t pal_stream_start(pal_stream_handle_t *stream_handle)
 {
+    PAL_TRACE_SPAN("pal_stream_start");
     Stream *s = NULL;
     struct pal_stream_attributes sAttr;
     std::shared_ptr<ResourceManager> rm = NULL;
@@ -377,6 +395,7 @@ exit:
 
 int32_t pal_stream_stop(pal_stream_handle_t *stream_handle)
 {
+    PAL_TRACE_SPAN("pal_stream_stop");
     Stream *s = NULL;
     std::shared_ptr<ResourceManager> rm = NULL;
     int status;
@@ -511,6 +530,67 @@ ssize_t pal_stream_read(pal_stream_handle_t *stream_handle, struct pal_buffer *b
     return status;
 }
 
+static ssize_t pal_stream_rwv(pal_stream_handle_t *stream_handle, struct pal_buffer *bufs,
+                              uint32_t count, ssize_t *sizes, bool isWrite)
+{
+    Stream *s = NULL;
+    int status;
+    std::shared_ptr<ResourceManager> rm = NULL;
+
+    rm = ResourceManager::getInstance();
+    if (!rm) {
+        PAL_ERR(LOG_TAG, "Invalid resource manager");
+        status = -EINVAL;
+        return status;
+    }
+    rm->lockValidStreamMutex();
+    if (!stream_handle || !rm->isActiveStream(stream_handle) || !bufs ||
+        !count || !sizes) {
+        rm->unlockValidStreamMutex();
+        status = -EINVAL;
+        PAL_ERR(LOG_TAG, "Invalid input parameters status %d", status);
+        return status;
+    }
+
+    PAL_VERBOSE(LOG_TAG, "Enter. Stream handle :%pK, %u buffers", stream_handle, count);
+    s =  reinterpret_cast<Stream *>(stream_handle);
+    status = rm->increaseStreamUserCounter(s);
+    if (0 != status) {
+        rm->unlockValidStreamMutex();
+        PAL_ERR(LOG_TAG, "failed to increase stream user count");
+        return status;
+    }
+    rm->unlockValidStreamMutex();
+
+    if (isWrite)
+        status = s->writev(bufs, count, sizes);
+    else
+        status = s->readv(bufs, count, sizes);
+    if (status < 0) {
+        PAL_ERR(LOG_TAG, "stream %s failed status %d", isWrite ? "writev" : "readv",
+                status);
+    }
+
+    rm->lockValidStreamMutex();
+    rm->decreaseStreamUserCounter(s);
+    rm->unlockValidStreamMutex();
+
+    PAL_VERBOSE(LOG_TAG, "Exit. status %d", status);
+    return status;
+}
+
+ssize_t pal_stream_writev(pal_stream_handle_t *stream_handle, struct pal_buffer *bufs,
+                          uint32_t count, ssize_t *sizes)
+{
+    return pal_stream_rwv(stream_handle, bufs, count, sizes, true);
+}
+
+ssize_t pal_stream_readv(pal_stream_handle_t *stream_handle, struct pal_buffer *bufs,
+                         uint32_t count, ssize_t *sizes)
+{
+    return pal_stream_rwv(stream_handle, bufs, count, sizes, false);
+}
+
 int32_t pal_stream_get_param(pal_stream_handle_t *stream_handle,
                              uint32_t param_id, pal_param_payload **param_payload)
 {
@@ -1077,6 +1157,7 @@ int32_t pal_add_remove_effect(pal_stream_handle_t *stream_handle,
 int32_t pal_stream_set_device(pal_stream_handle_t *stream_handle,
                            uint32_t no_of_devices, struct pal_device *devices)
 {
+    PAL_TRACE_SPAN("pal_stream_set_device");
     int status = -EINVAL;
     Stream *s = NULL;
     std::shared_ptr<ResourceManager> rm = NULL;
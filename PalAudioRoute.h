@@ -62,21 +62,33 @@
 #ifndef AUDIO_HW
 #define AUDIO_HW
 
+#include <errno.h>
 #include "audio_route/audio_route.h"
+#include "MixerPathPlanner.h"
+#include "PalSpanTracer.h"
 
 static std::mutex audio_route_mutex;
 
-inline void enableDevice(struct audio_route *ar, char * device_name)
+/*
+ * Named mixer paths are applied through the precompiled plans, which only
+ * write the controls that change; audio_route is the fallback when the
+ * plans could not be compiled.
+ */
+inline void enableDevice(struct audio_route *ar, const char *device_name)
 {
+    PAL_TRACE_SPAN("enableDevice");
     audio_route_mutex.lock();
-    audio_route_apply_and_update_path(ar, device_name);
+    if (MixerPathPlanner::getInstance()->applyPath(device_name) == -ENODEV)
+        audio_route_apply_and_update_path(ar, device_name);
     audio_route_mutex.unlock();
 }
 
-inline void disableDevice(struct audio_route *ar, char * device_name)
+inline void disableDevice(struct audio_route *ar, const char *device_name)
 {
+    PAL_TRACE_SPAN("disableDevice");
     audio_route_mutex.lock();
-    audio_route_reset_and_update_path(ar, device_name);
+    if (MixerPathPlanner::getInstance()->resetPath(device_name) == -ENODEV)
+        audio_route_reset_and_update_path(ar, device_name);
     audio_route_mutex.unlock();
 }
 #endif
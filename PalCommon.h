@@ -42,6 +42,7 @@
 #else
 #include <log/log.h>
 #endif
+#include "PalTraceLog.h"
 
 #define PAL_LOG_ERR             (0x1) /**< error message, represents code bugs that should be debugged and fixed.*/
 #define PAL_LOG_INFO            (0x2) /**< info message, additional info to support debug */
@@ -50,25 +51,48 @@
 
 extern uint32_t pal_log_lvl;
 
+/* levels compiled in, the others are dropped regardless of pal_log_lvl */
+#ifndef PAL_LOG_BUILD_LVL
+#define PAL_LOG_BUILD_LVL (PAL_LOG_ERR|PAL_LOG_INFO|PAL_LOG_DBG|PAL_LOG_VERBOSE)
+#endif
+
+/*
+ * Debug, info and verbose messages are recorded with their raw arguments
+ * and formatted on the PalTraceLog thread, see PalTraceLog.h. Errors are
+ * always logged synchronously, after the pending records of the thread.
+ * The arguments are evaluated exactly once, whichever path the site takes.
+ */
+#define PAL_ASYNC_LOG(alog, level, arg, ...)                              \
+    do {                                                                  \
+        static struct pal_trace_site pal_site =                           \
+            {level, LOG_TAG, __func__, __LINE__, arg, {PAL_TRACE_SITE_NEW}}; \
+        pal_trace_log(&pal_site, [](auto... pal_args) {                   \
+            alog("%s: %d: "  arg, pal_site.func, pal_site.line, pal_args...); \
+        }, ##__VA_ARGS__);                                                \
+    } while (0)
+
+/* pending asynchronous records are written out before aborting */
 #define PAL_FATAL(log_tag, arg,...)                                       \
     if (pal_log_lvl & PAL_LOG_ERR) {                              \
+        pal_trace_flush();                                        \
         ALOGE("%s: %d: "  arg, __func__, __LINE__, ##__VA_ARGS__);\
         abort();                                                  \
     }
 
 #define PAL_ERR(log_tag, arg,...)                                          \
     if (pal_log_lvl & PAL_LOG_ERR) {                              \
+        pal_trace_flush_pending();                                \
         ALOGE("%s: %d: "  arg, __func__, __LINE__, ##__VA_ARGS__);\
     }
 #define PAL_DBG(log_tag,arg,...)                                           \
-    if (pal_log_lvl & PAL_LOG_DBG) {                               \
-        ALOGD("%s: %d: "  arg, __func__, __LINE__, ##__VA_ARGS__); \
+    if ((PAL_LOG_BUILD_LVL & PAL_LOG_DBG) && (pal_log_lvl & PAL_LOG_DBG)) {  \
+        PAL_ASYNC_LOG(ALOGD, PAL_LOG_DBG, arg, ##__VA_ARGS__);      \
     }
 #define PAL_INFO(log_tag,arg,...)                                         \
-    if (pal_log_lvl & PAL_LOG_INFO) {                             \
-        ALOGI("%s: %d: "  arg, __func__, __LINE__, ##__VA_ARGS__);\
+    if ((PAL_LOG_BUILD_LVL & PAL_LOG_INFO) && (pal_log_lvl & PAL_LOG_INFO)) { \
+        PAL_ASYNC_LOG(ALOGI, PAL_LOG_INFO, arg, ##__VA_ARGS__);       \
     }
 #define PAL_VERBOSE(log_tag,arg,...)                                      \
-    if (pal_log_lvl & PAL_LOG_VERBOSE) {                          \
-        ALOGV("%s: %d: "  arg, __func__, __LINE__, ##__VA_ARGS__);\
+    if ((PAL_LOG_BUILD_LVL & PAL_LOG_VERBOSE) && (pal_log_lvl & PAL_LOG_VERBOSE)) { \
+        PAL_ASYNC_LOG(ALOGV, PAL_LOG_VERBOSE, arg, ##__VA_ARGS__);    \
     }
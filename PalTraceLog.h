@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef PAL_TRACE_LOG_H
+#define PAL_TRACE_LOG_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+#define PAL_TRACE_MAX_ARGS 8
+
+enum {
+    PAL_TRACE_SITE_NEW = 0,
+    PAL_TRACE_SITE_ASYNC,
+    PAL_TRACE_SITE_SYNC,
+};
+
+/*
+ * Static data of a PAL_DBG/PAL_INFO/PAL_VERBOSE call site, its address is
+ * the format id stored in the trace records. A site is classified on its
+ * first use; sites printing strings (%s), which may be gone by the time the
+ * record is formatted, stay on the synchronous log path.
+ */
+struct pal_trace_site {
+    uint32_t level;
+    const char *tag;
+    const char *func;
+    int line;
+    const char *fmt;
+    std::atomic<int> mode;
+};
+
+/* classifies the site on first use, false if it logs synchronously */
+bool pal_trace_async(struct pal_trace_site *site, uint32_t nargs);
+/* false if the caller has to log synchronously */
+bool pal_trace_record(struct pal_trace_site *site, uint32_t nargs,
+                      const uint64_t *args);
+/* formats and writes out all pending records */
+void pal_trace_flush();
+/*
+ * Same, if the calling thread has records pending. Called before logging
+ * synchronously so that the messages of a thread keep their order.
+ */
+void pal_trace_flush_pending();
+/* writes out pending records and joins the formatter thread */
+void pal_trace_deinit();
+
+inline uint64_t pal_trace_arg(double v)
+{
+    uint64_t raw;
+
+    memcpy(&raw, &v, sizeof(raw));
+    return raw;
+}
+
+inline uint64_t pal_trace_arg(float v)
+{
+    return pal_trace_arg((double)v);
+}
+
+inline uint64_t pal_trace_arg(std::nullptr_t)
+{
+    return 0;
+}
+
+template <typename T>
+inline uint64_t pal_trace_arg(T *v)
+{
+    return (uint64_t)(uintptr_t)v;
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value ||
+                               std::is_enum<T>::value, uint64_t>::type
+pal_trace_arg(T v)
+{
+    return (uint64_t)(int64_t)v;
+}
+
+/*
+ * The arguments are evaluated once by the caller; syncLog is called with
+ * them if the site cannot be recorded.
+ */
+template <typename SyncLog, typename... Args>
+inline void pal_trace_log(struct pal_trace_site *site, SyncLog syncLog,
+                          Args... args)
+{
+    if (sizeof...(Args) > PAL_TRACE_MAX_ARGS ||
+        !pal_trace_async(site, sizeof...(Args))) {
+        pal_trace_flush_pending();
+        syncLog(args...);
+        return;
+    }
+
+    const uint64_t raw[sizeof...(Args) + 1] = {pal_trace_arg(args)..., 0};
+
+    if (!pal_trace_record(site, sizeof...(Args), raw)) {
+        pal_trace_flush_pending();
+        syncLog(args...);
+    }
+}
+
+#endif //PAL_TRACE_LOG_H
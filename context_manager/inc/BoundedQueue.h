@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Bounded lock-free queue, safe for any number of producers and consumers.
+ * Push and pop fail instead of blocking when the queue is full or empty.
+ */
+template <typename T, size_t N>
+class BoundedQueue
+{
+public:
+    BoundedQueue() : enqueue_pos(0), dequeue_pos(0)
+    {
+        static_assert(N >= 2 && (N & (N - 1)) == 0, "size must be a power of two");
+        for (size_t i = 0; i < N; i++)
+            cells[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    bool push(const T &data)
+    {
+        struct cell *c;
+        size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+
+        for (;;) {
+            c = &cells[pos & (N - 1)];
+            size_t seq = c->seq.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+            if (diff == 0) {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1,
+                        std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+        c->data = data;
+        c->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T &data)
+    {
+        struct cell *c;
+        size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+
+        for (;;) {
+            c = &cells[pos & (N - 1)];
+            size_t seq = c->seq.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos.compare_exchange_weak(pos, pos + 1,
+                        std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+        data = c->data;
+        c->seq.store(pos + N, std::memory_order_release);
+        return true;
+    }
+
+private:
+    struct cell {
+        std::atomic<size_t> seq;
+        T data;
+    };
+    struct cell cells[N];
+    std::atomic<size_t> enqueue_pos;
+    std::atomic<size_t> dequeue_pos;
+};
+
+/*
+ * BoundedQueue whose producers sleep while it is full, until a pop frees
+ * a slot or the queue is closed. Push and pop stay lock-free while no
+ * producer waits; pop only takes the lock to wake a waiting producer.
+ */
+template <typename T, size_t N>
+class WaitableBoundedQueue
+{
+public:
+    WaitableBoundedQueue() : waiters(0), closed(false) {}
+
+    /* blocks while the queue is full, fails once it is closed */
+    bool push(const T &data)
+    {
+        bool pushed = false;
+
+        if (closed)
+            return false;
+        if (queue.push(data))
+            return true;
+
+        std::unique_lock<std::mutex> lck(mtx);
+        waiters++;
+        /* pairs with the fence in pop, so a freed slot or a wakeup is seen */
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        space_cv.wait(lck, [&] { return closed || (pushed = queue.push(data)); });
+        waiters--;
+        return pushed;
+    }
+
+    bool pop(T &data)
+    {
+        if (!queue.pop(data))
+            return false;
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lck(mtx);
+            space_cv.notify_one();
+        }
+        return true;
+    }
+
+    /* fails the waiting and later pushes until reopened */
+    void close()
+    {
+        std::lock_guard<std::mutex> lck(mtx);
+        closed = true;
+        space_cv.notify_all();
+    }
+
+    void reopen()
+    {
+        std::lock_guard<std::mutex> lck(mtx);
+        closed = false;
+    }
+
+    /* producers currently sleeping on a full queue */
+    uint32_t getWaiters() { return waiters.load(); }
+
+private:
+    BoundedQueue<T, N> queue;
+    std::mutex mtx;
+    std::condition_variable space_cv;
+    std::atomic<uint32_t> waiters;
+    std::atomic<bool> closed;
+};
+
+#endif //BOUNDED_QUEUE_H
@@ -32,12 +32,22 @@
 #include <vector>
 #include <thread>
 #include <queue>
+#include <deque>
+#include <atomic>
 #include <condition_variable>
+#include <semaphore.h>
 #include <PalApi.h>
 #include <PalCommon.h>
 #include "kvh2xml.h"
 #include "ACDPlatformInfo.h"
 #include "SoundTriggerUtils.h"
+#include "BoundedQueue.h"
+
+/* queue and pool sizes have to be powers of two */
+#define CM_CMD_QUEUE_SIZE 64
+#define CM_CMD_POOL_SIZE 64
+#define CM_CMD_SLOT_SIZE 64
+#define CM_CMD_WORKER_COUNT 4
 
 enum PCM_DATA_EFFECT {
     PCM_DATA_EFFECT_RAW = 1,
@@ -45,6 +55,7 @@ enum PCM_DATA_EFFECT {
 };
 
 class ContextManager; /* forward declaration for RequestCommand */
+
 class ACDPlatformInfo;
 using ACDUUID = SoundTriggerUUID;
 
@@ -142,7 +153,7 @@ private:
     std::map<uint32_t, Usecase*> usecases;
 
 protected:
-    static std::mutex see_client_mutex;
+    std::mutex see_client_mutex;
 
 public:
     see_client(uint32_t id);
@@ -162,6 +173,15 @@ public:
     virtual ~RequestCommand();
 
     virtual int32_t Process(ContextManager& cm) = 0;
+    // commands of the same see client are processed in order, commands
+    // without see client wait for all others to complete.
+    virtual bool GetSeeId(uint32_t *see_id) { return false; }
+
+    // commands are allocated from a fixed pool, falling back to the heap
+    static void *operator new(size_t size);
+    static void operator delete(void *ptr);
+
+    uint32_t generation;
 };
 
 class CommandRegister : public RequestCommand {
@@ -170,6 +190,7 @@ public:
     ~CommandRegister();
 
     int32_t Process(ContextManager& cm);
+    bool GetSeeId(uint32_t *see_id) { *see_id = see_sensor_iid; return true; }
 private:
     uint32_t see_sensor_iid;
     uint32_t usecase_id;
@@ -181,6 +202,7 @@ class CommandDeregister : public RequestCommand {
 public:
     CommandDeregister(uint32_t event_id, uint32_t* event_data);
     int32_t Process(ContextManager& cm);
+    bool GetSeeId(uint32_t *see_id) { *see_id = see_sensor_iid; return true; }
 private:
     uint32_t see_sensor_iid;
     uint32_t usecase_id;
@@ -190,6 +212,7 @@ class CommandGetContextIDs : public RequestCommand {
 public:
     CommandGetContextIDs(uint32_t event_id, uint32_t* event_data);
     int32_t Process(ContextManager& cm);
+    bool GetSeeId(uint32_t *see_id) { *see_id = see_sensor_iid; return true; }
 private:
     uint32_t see_sensor_iid;
 };
@@ -210,13 +233,29 @@ public:
 class ContextManager
 {
 private:
+    struct cmd_worker {
+        std::thread thread;
+        std::mutex mtx;
+        std::condition_variable cv;
+        std::deque<RequestCommand *> cmds;
+    };
+
     std::map<uint32_t, see_client *> see_clients;
+    std::mutex see_clients_mtx;
     pal_stream_handle_t *proxy_stream;
-    bool exit_cmd_thread_;
-    std::condition_variable request_queue_cv;
-    std::mutex request_queue_mtx;
+    std::atomic<bool> exit_cmd_thread_;
+    // filled by the proxy stream callback, drained by cmd_thread_ which
+    // hands the commands over to the worker serving their see client
+    WaitableBoundedQueue<RequestCommand *, CM_CMD_QUEUE_SIZE> request_cmd_queue;
+    sem_t request_cmd_sem;
     std::thread cmd_thread_;
-    std::queue<RequestCommand *> request_cmd_queue;
+    struct cmd_worker cmd_workers_[CM_CMD_WORKER_COUNT];
+    // commands dispatched to workers and not completed yet
+    uint32_t pending_cmds_;
+    std::mutex pending_cmds_mtx;
+    std::condition_variable pending_cmds_cv;
+    // bumped on ssr down, queued commands of older generations are dropped
+    std::atomic<uint32_t> cmd_generation_;
 
     see_client* SEE_Client_CreateIf_And_Get(uint32_t see_id);
     see_client * SEE_Client_Get_Existing(uint32_t see_id);
@@ -226,6 +265,10 @@ private:
     void DestroyCommandProcessingThread();
     void CloseAll();
     static void CommandThreadRunner(ContextManager& cm);
+    static void CommandWorkerRunner(ContextManager& cm, uint32_t idx);
+    void RunCommand(RequestCommand *request_command);
+    void CompleteCommand();
+    void WaitForPendingCommands();
     int32_t build_and_send_register_ack(Usecase *uc, uint32_t see_id, uint32_t uc_id);
 
 public:
@@ -62,6 +62,7 @@
 
 #include <iostream>
 #include <chrono>
+#include <cstddef>
 #include "ContextManager.h"
 #include <asps/asps_acm_api.h>
 #include "apm_api.h"
@@ -71,7 +72,17 @@
 #define ACKDATA_DEFAULT_SIZE 1024
 #define PAL_ALIGN_8BYTE(x) (((x) + 7) & (~7))
 
-std::mutex see_client::see_client_mutex;
+/* storage for pooled RequestCommand objects */
+static struct request_cmd_pool_t {
+    request_cmd_pool_t()
+    {
+        for (uint32_t i = 0; i < CM_CMD_POOL_SIZE; i++)
+            free_slots.push(i);
+    }
+
+    alignas(std::max_align_t) unsigned char slots[CM_CMD_POOL_SIZE][CM_CMD_SLOT_SIZE];
+    BoundedQueue<uint32_t, CM_CMD_POOL_SIZE> free_slots;
+} request_cmd_pool;
 
 int32_t ContextManager::process_register_request(uint32_t see_id, uint32_t usecase_id, uint32_t size,
     void *payload)
@@ -158,7 +169,8 @@ exit:
     if (rc) {
         send_asps_basic_response(rc, EVENT_ID_ASPS_SENSOR_REGISTER_REQUEST, see_id);
     }
-    seeclient->unlock_see_client();
+    if (seeclient)
+        seeclient->unlock_see_client();
     PAL_VERBOSE(LOG_TAG, "Exit rc:%d", rc);
     return rc;
 }
@@ -273,7 +285,8 @@ int32_t ContextManager::process_deregister_request(uint32_t see_id, uint32_t use
     }
 
 exit:
-    seeclient->unlock_see_client();
+    if (seeclient)
+        seeclient->unlock_see_client();
     PAL_VERBOSE(LOG_TAG, "Exit rc:%d", rc);
     return rc;
 }
@@ -348,12 +361,18 @@ exit:
 ContextManager::ContextManager()
 {
     PAL_VERBOSE(LOG_TAG, "Enter");
+    proxy_stream = NULL;
+    exit_cmd_thread_ = false;
+    pending_cmds_ = 0;
+    cmd_generation_ = 0;
+    sem_init(&request_cmd_sem, 0, 0);
     PAL_VERBOSE(LOG_TAG, "Exit");
 }
 
 ContextManager::~ContextManager()
 {
     PAL_VERBOSE(LOG_TAG, "Enter");
+    sem_destroy(&request_cmd_sem);
     PAL_VERBOSE(LOG_TAG, "Exit");
 }
 
@@ -388,9 +407,9 @@ void ContextManager::DeInit()
 {
     PAL_VERBOSE(LOG_TAG, "Enter");
 
-    CloseAll();
     StopAndCloseProxyStream();
     DestroyCommandProcessingThread();
+    CloseAll();
 
     PAL_VERBOSE(LOG_TAG, "Exit");
 }
@@ -398,17 +417,13 @@ void ContextManager::DeInit()
 int32_t ContextManager::ssrDownHandler()
 {
     int32_t rc = 0;
-    std::unique_lock<std::mutex> lck(request_queue_mtx, std::defer_lock);
     PAL_VERBOSE(LOG_TAG, "Enter");
 
-    this->CloseAll();
+    // drop queued commands and let the running ones complete
+    cmd_generation_++;
+    WaitForPendingCommands();
 
-    lck.lock();
-    while (!request_cmd_queue.empty()) {
-        free(request_cmd_queue.front());
-        request_cmd_queue.pop();
-    }
-    lck.unlock();
+    this->CloseAll();
 
     PAL_VERBOSE(LOG_TAG, "Exit rc %d", rc);
     return rc;
@@ -430,10 +445,20 @@ int32_t ContextManager::StreamProxyCallback (pal_stream_handle_t *stream_handle,
     ContextManager* cm = ((ContextManager*)cookie);
 
     PAL_VERBOSE(LOG_TAG, "Enter");
-    std::unique_lock<std::mutex> lck(cm->request_queue_mtx);
     request_command = RequestCommandFactory::RequestCommandCreate(event_id, event_data);
-    cm->request_cmd_queue.push(request_command);
-    cm->request_queue_cv.notify_one();
+    if (!request_command)
+        goto exit;
+
+    request_command->generation = cm->cmd_generation_;
+    // sleeps while a burst outruns the dispatcher, fails once it exits
+    if (!cm->request_cmd_queue.push(request_command)) {
+        PAL_ERR(LOG_TAG, "command thread exited, dropping request");
+        delete request_command;
+        goto exit;
+    }
+    sem_post(&cm->request_cmd_sem);
+
+exit:
 
     PAL_VERBOSE(LOG_TAG, "Exit");
     return 0;
@@ -446,6 +471,7 @@ void ContextManager::CloseAll()
     see_client *see = NULL;
 
     PAL_VERBOSE(LOG_TAG, "Enter");
+    std::lock_guard<std::mutex> lck(see_clients_mtx);
     for (auto it_see_client = this->see_clients.begin(); it_see_client != this->see_clients.cend();) {
         see = it_see_client->second;
         PAL_VERBOSE(LOG_TAG, "Calling CloseAllUsecases for see_client:%d", see->Get_SEE_ID());
@@ -515,36 +541,105 @@ int32_t ContextManager::StopAndCloseProxyStream()
     return rc;
 }
 
+void ContextManager::RunCommand(RequestCommand *request_command)
+{
+    int32_t rc = 0;
+
+    if (request_command->generation != cmd_generation_) {
+        PAL_DBG(LOG_TAG, "dropping request queued before ssr");
+    } else {
+        rc = request_command->Process(*this);
+        if (rc) {
+            PAL_ERR(LOG_TAG, "Error:%d failed to process request", rc);
+        }
+    }
+
+    delete request_command;
+}
+
+void ContextManager::CompleteCommand()
+{
+    std::lock_guard<std::mutex> lck(pending_cmds_mtx);
+
+    if (--pending_cmds_ == 0)
+        pending_cmds_cv.notify_all();
+}
+
+void ContextManager::WaitForPendingCommands()
+{
+    std::unique_lock<std::mutex> lck(pending_cmds_mtx);
+
+    pending_cmds_cv.wait(lck, [this] { return pending_cmds_ == 0; });
+}
+
+void ContextManager::CommandWorkerRunner(ContextManager& cm, uint32_t idx)
+{
+    struct cmd_worker &worker = cm.cmd_workers_[idx];
+    RequestCommand *request_command;
+
+    PAL_VERBOSE(LOG_TAG, "Entering CommandWorkerRunner %d", idx);
+
+    std::unique_lock<std::mutex> lck(worker.mtx);
+    while (!cm.exit_cmd_thread_) {
+        if (worker.cmds.empty()) {
+            worker.cv.wait(lck);
+            continue;
+        }
+
+        request_command = worker.cmds.front();
+        worker.cmds.pop_front();
+        lck.unlock();
+
+        cm.RunCommand(request_command);
+        cm.CompleteCommand();
+        lck.lock();
+    }
+
+    while (!worker.cmds.empty()) {
+        delete worker.cmds.front();
+        worker.cmds.pop_front();
+        cm.CompleteCommand();
+    }
+    PAL_VERBOSE(LOG_TAG, "Exiting CommandWorkerRunner %d", idx);
+}
+
 void ContextManager::CommandThreadRunner(ContextManager& cm)
 {
     RequestCommand *request_command;
-    int32_t rc = 0;
+    uint32_t see_id = 0;
 
     PAL_VERBOSE(LOG_TAG, "Entering CommandThreadRunner");
 
-    std::unique_lock<std::mutex> lck(cm.request_queue_mtx);
     while (!cm.exit_cmd_thread_) {
         // wait until we have a command to process.
-        if (cm.request_cmd_queue.empty()) {
-            cm.request_queue_cv.wait(lck);
-            if (cm.exit_cmd_thread_) {
-                PAL_DBG(LOG_TAG, "Received exit request");
-                continue;
-            }
+        sem_wait(&cm.request_cmd_sem);
+        if (cm.exit_cmd_thread_) {
+            PAL_DBG(LOG_TAG, "Received exit request");
+            break;
         }
 
-        if (!cm.request_cmd_queue.empty()) {
-            request_command = cm.request_cmd_queue.front();
-            cm.request_cmd_queue.pop();
-
-            rc = request_command->Process(cm);
-            if (rc) {
-                PAL_ERR(LOG_TAG, "Error:%d failed to process request", rc);
-            }
+        if (!cm.request_cmd_queue.pop(request_command))
+            continue;
 
-            free(request_command);
+        if (!request_command->GetSeeId(&see_id)) {
+            // commands on all see clients run once all others completed
+            cm.WaitForPendingCommands();
+            cm.RunCommand(request_command);
+            continue;
         }
+
+        struct cmd_worker &worker = cm.cmd_workers_[see_id % CM_CMD_WORKER_COUNT];
+        cm.pending_cmds_mtx.lock();
+        cm.pending_cmds_++;
+        cm.pending_cmds_mtx.unlock();
+        worker.mtx.lock();
+        worker.cmds.push_back(request_command);
+        worker.mtx.unlock();
+        worker.cv.notify_one();
     }
+
+    while (cm.request_cmd_queue.pop(request_command))
+        delete request_command;
     PAL_VERBOSE(LOG_TAG, "Exiting CommandThreadRunner");
 }
 
@@ -555,6 +650,9 @@ int32_t ContextManager::CreateCommandProcessingThread()
     PAL_VERBOSE(LOG_TAG, "Enter");
 
     exit_cmd_thread_ = false;
+    request_cmd_queue.reopen();
+    for (uint32_t i = 0; i < CM_CMD_WORKER_COUNT; i++)
+        cmd_workers_[i].thread = std::thread(CommandWorkerRunner, std::ref(*this), i);
     cmd_thread_ = std::thread(CommandThreadRunner, std::ref(*this));
 
     PAL_VERBOSE(LOG_TAG, "Exit rc: %d", rc);
@@ -568,13 +666,22 @@ void ContextManager::DestroyCommandProcessingThread()
     PAL_VERBOSE(LOG_TAG, "Enter");
 
     exit_cmd_thread_ = true;
-    request_queue_cv.notify_all();
+    request_cmd_queue.close();
+    sem_post(&request_cmd_sem);
 
     if (cmd_thread_.joinable()) {
         PAL_DBG(LOG_TAG, "Join cmd_thread_ thread");
         cmd_thread_.join();
     }
 
+    for (uint32_t i = 0; i < CM_CMD_WORKER_COUNT; i++) {
+        cmd_workers_[i].mtx.lock();
+        cmd_workers_[i].mtx.unlock();
+        cmd_workers_[i].cv.notify_all();
+        if (cmd_workers_[i].thread.joinable())
+            cmd_workers_[i].thread.join();
+    }
+
     PAL_VERBOSE(LOG_TAG, "Exit rc:%d", rc);
 }
 
@@ -628,6 +735,30 @@ RequestCommand::~RequestCommand()
     PAL_VERBOSE(LOG_TAG, "Exit");
 }
 
+void *RequestCommand::operator new(size_t size)
+{
+    uint32_t slot;
+
+    if (size <= CM_CMD_SLOT_SIZE && request_cmd_pool.free_slots.pop(slot))
+        return request_cmd_pool.slots[slot];
+
+    PAL_DBG(LOG_TAG, "command pool exhausted, allocating %zu bytes", size);
+    return ::operator new(size);
+}
+
+void RequestCommand::operator delete(void *ptr)
+{
+    unsigned char *p = (unsigned char *)ptr;
+    unsigned char *base = &request_cmd_pool.slots[0][0];
+
+    if (p >= base && p < base + sizeof(request_cmd_pool.slots)) {
+        request_cmd_pool.free_slots.push((p - base) / CM_CMD_SLOT_SIZE);
+        return;
+    }
+
+    ::operator delete(ptr);
+}
+
 CommandRegister::CommandRegister(uint32_t event_id, uint32_t* event_data) :
     RequestCommand(event_id, event_data)
 {
@@ -818,6 +949,7 @@ see_client* ContextManager::SEE_Client_CreateIf_And_Get(uint32_t see_id)
 
     PAL_VERBOSE(LOG_TAG, "Enter seeid:%d", see_id);
 
+    std::lock_guard<std::mutex> lck(see_clients_mtx);
     it = see_clients.find(see_id);
     if (it != see_clients.end()) {
         client = it->second;
@@ -838,6 +970,7 @@ see_client* ContextManager::SEE_Client_Get_Existing(uint32_t see_id)
 
     PAL_VERBOSE(LOG_TAG, "Enter seeid:%d", see_id);
 
+    std::lock_guard<std::mutex> lck(see_clients_mtx);
     it = see_clients.find(see_id);
     if (it != see_clients.end()) {
         client = it->second;
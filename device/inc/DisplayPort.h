@@ -122,6 +122,12 @@ typedef struct edidAudioInfo {
     char channelMap[MAX_CHANNELS_SUPPORTED];
     int  channelAllocation;
     unsigned int  channelMask;
+    /* summary over all audio blocks, filled in once by getSinkCaps() */
+    int samplingFreqMask;
+    int bitsPerSampleMask;
+    int maxLpcmChannels;
+    int highestSR;
+    int highestBps;
 } edidAudioInfo;
 
 class DisplayPort : public Device
@@ -165,6 +171,10 @@ public:
     static void updateChannelMask(edidAudioInfo* info);
     static void dumpEdidData(edidAudioInfo *info);
     static bool getSinkCaps(edidAudioInfo* info, char *edidData);
+    static void updateSinkCapsSummary(edidAudioInfo *info);
+    static uint64_t hashEdid(const char *edidData);
+    static bool lookupEdidCache(const char *edidData, edidAudioInfo *info);
+    static void storeEdidCache(const char *edidData, edidAudioInfo *info);
     static int getDeviceChannelAllocation(int num_channels);
     bool isSupportedSR(edidAudioInfo* info, int sr);
     int getMaxChannel();
@@ -68,6 +68,8 @@
 #include "sp_vi.h"
 #include "sp_rx.h"
 #include "cps_data_router.h"
+#include "SpkrTelemetry.h"
+#include "SpkrTempSampler.h"
 #include <tinyalsa/asoundlib.h>
 #include <mutex>
 #include <condition_variable>
@@ -130,6 +132,7 @@ protected :
     static speaker_prot_cal_state spkrCalState;
     spkr_prot_proc_state spkrProcessingState;
     int *spkerTempList;
+    SpkrTempSampler tempSampler;
     static bool isSpkrInUse;
     static bool startXmaxLogging;
     static bool calThrdCreated;
@@ -154,6 +157,12 @@ protected :
     static int numberOfRequest;
     static struct pal_device_info vi_device;
     static struct pal_device_info cps_device;
+    /* prebuilt Xmax/Tmax query, reused by the logging thread */
+    struct mixer_ctl *xmaxTmaxCtl;
+    uint8_t *xmaxTmaxQuery;
+    uint8_t *xmaxTmaxResp;
+    size_t xmaxTmaxPayloadSize;
+    static SpkrTelemetry xmaxTmaxTelemetry;
 
 private :
 
@@ -166,6 +175,7 @@ public:
     static std::mutex calibrationMutex;
     void spkrCalibrationThread();
     void startSpkrXmaxTmaxLogging();
+    int initTempSampler();
     int getSpeakerTemperature(int spkr_pos);
     void spkrCalibrateWait();
     int spkrStartCalibration();
@@ -198,6 +208,9 @@ public:
     int32_t getCalibrationData(void **param);
     int32_t getFTMParameter(void **param);
     int32_t getSpkrXmaxTmaxData();
+    int32_t prepareSpkrXmaxTmaxQuery();
+    void releaseSpkrXmaxTmaxQuery();
+    int32_t getSpkrXmaxTmaxStats(void **param);
     void disconnectFeandBe(std::vector<int> pcmDevIds, std::string backEndName);
 };
 
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef SPKR_TELEMETRY_H
+#define SPKR_TELEMETRY_H
+
+#include <atomic>
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "PalDefs.h"
+#include "sp_rx.h"
+
+#define SPKR_TELEMETRY_RING_SIZE 64
+#define SPKR_TELEMETRY_FLUSH_BATCH 16
+#define SPKR_TELEMETRY_FLUSH_INTERVAL_MS (30 * 1000)
+
+/*
+ * Xmax/Tmax samples of the speaker protection module. The logging thread
+ * pushes raw binary samples to a fixed ring; they are converted to text
+ * and appended to the log file in batches, at most once per flush interval
+ * unless the ring fills up. Counters and last/peak values are atomics so
+ * getStats() never blocks the logging thread.
+ */
+class SpkrTelemetry
+{
+public:
+    SpkrTelemetry();
+    ~SpkrTelemetry();
+    SpkrTelemetry(const SpkrTelemetry &) = delete;
+    SpkrTelemetry & operator=(const SpkrTelemetry &) = delete;
+
+    /* starts a new session, resetting the ring and the stats */
+    int open(const char *path);
+    void close();
+    void push(const param_id_sp_tmax_xmax_logging_t *value);
+    int flush(bool force);
+    void getStats(pal_param_sp_xmax_tmax_stats_t *stats) const;
+
+private:
+    struct sample {
+        time_t timestamp;
+        uint32_t num_ch;
+        int32_t max_excursion[PAL_SP_XMAX_TMAX_MAX_CH];
+        int32_t max_temperature[PAL_SP_XMAX_TMAX_MAX_CH];
+    };
+
+    int writeSample(const struct sample *s);
+    static uint64_t getTimeMs();
+
+    struct sample ring[SPKR_TELEMETRY_RING_SIZE];
+    uint32_t head;
+    uint32_t tail;
+    FILE *fp;
+    uint64_t lastFlushMs;
+    std::atomic<uint64_t> numSamples;
+    std::atomic<uint64_t> numDropped;
+    std::atomic<uint64_t> numFlushed;
+    std::atomic<uint32_t> numFlushErrors;
+    std::atomic<uint32_t> numCh;
+    std::atomic<int32_t> lastXmax[PAL_SP_XMAX_TMAX_MAX_CH];
+    std::atomic<int32_t> lastTmax[PAL_SP_XMAX_TMAX_MAX_CH];
+    std::atomic<int32_t> peakXmax[PAL_SP_XMAX_TMAX_MAX_CH];
+    std::atomic<int32_t> peakTmax[PAL_SP_XMAX_TMAX_MAX_CH];
+};
+
+#endif
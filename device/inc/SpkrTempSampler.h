@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef SPKR_TEMP_SAMPLER_H
+#define SPKR_TEMP_SAMPLER_H
+
+#include <condition_variable>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <tinyalsa/asoundlib.h>
+
+/* reads within this window are served from the cache */
+#define SPKR_TEMP_CACHE_MS 1000
+/* change in degrees C a channel must move before waiters are woken */
+#define SPKR_TEMP_HYSTERESIS 2
+
+/*
+ * Speaker temperature sampler. Per channel WSA temperature controls are
+ * resolved once and read together in a single pass; the time-stamped result
+ * is shared by all callers within SPKR_TEMP_CACHE_MS. Callers waiting for
+ * the temperature to settle block in waitForChange() for a bounded time and
+ * are woken when a sample moves a channel by SPKR_TEMP_HYSTERESIS or more,
+ * or when the owner calls wakeWaiters() because their wait condition
+ * changed.
+ */
+class SpkrTempSampler
+{
+public:
+    SpkrTempSampler();
+    ~SpkrTempSampler() {}
+    SpkrTempSampler(const SpkrTempSampler &) = delete;
+    SpkrTempSampler & operator=(const SpkrTempSampler &) = delete;
+
+    int init(struct mixer *mixer, const std::vector<std::string> &ctlNames);
+    bool isInitialized();
+    /* fills temps[0..numCh), -EINVAL for channels without a valid control */
+    int getTemperatures(int *temps, int numCh, bool force = false);
+    int getTemperature(int ch);
+    /* true if all valid channels are within [minTemp, maxTemp] */
+    bool isInRange(int minTemp, int maxTemp);
+    /*
+     * returns true if a channel changed before timeoutMs or wakeWaiters();
+     * as the temperature is only read when asked for, a fresh sample is
+     * taken once the timeout expires
+     */
+    bool waitForChange(uint32_t timeoutMs);
+    void wakeWaiters();
+
+private:
+    int sample_l(bool force);
+    static uint64_t getTimeMs();
+
+    std::mutex lock;
+    std::condition_variable cond;
+    struct mixer *mixer;
+    std::vector<struct mixer_ctl *> ctls;
+    std::vector<int> cache;
+    std::vector<int> reported;
+    uint64_t sampledMs;
+    uint32_t generation;
+    uint32_t wakeups;
+    bool outOfRange;
+};
+
+#endif
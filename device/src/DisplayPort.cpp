@@ -65,6 +65,288 @@ static struct extDispState {
     int type = EXT_DISPLAY_TYPE_NONE;
 } extDisp[MAX_CONTROLLERS][MAX_STREAMS_PER_CONTROLLER];
 
+/* CEA-861 short audio descriptor sampling frequency bits */
+static const struct edidRateBit {
+    int rate;
+    unsigned long bit;
+} edidRates[] = {
+    {32000,  BIT(0)},
+    {44100,  BIT(1)},
+    {48000,  BIT(2)},
+    {88200,  BIT(3)},
+    {96000,  BIT(4)},
+    {176400, BIT(5)},
+    {192000, BIT(6)},
+};
+
+/* LPCM bits per sample bits, only 16 and 24 bit are rendered */
+static const struct edidBpsBit {
+    int bps;
+    unsigned long bit;
+} edidBps[] = {
+    {16, BIT(0)},
+    {24, BIT(2)},
+};
+
+/*
+ * Channel allocation (CA) values as defined in CEA-861 section 6.6.2,
+ * indexed by CA. Each entry holds the speaker allocation the CA is
+ * derived from and, if LPASS can render it, its channel map and mask.
+ */
+static const struct channelAllocationInfo {
+    uint16_t spkrAlloc;
+    bool lpassSupported;
+    uint8_t chMap[MAX_CHANNELS_SUPPORTED];
+    unsigned int channelMask;
+} channelAllocations[] = {
+    /* 0x00 */ {BIT(0), true,
+                {PCM_CHANNEL_L, PCM_CHANNEL_R},
+                AUDIO_CHANNEL_OUT_STEREO},
+    /* 0x01 */ {BIT(0)|BIT(1), true,
+                {PCM_CHANNEL_L, PCM_CHANNEL_R, PCM_CHANNEL_LFE},
+                AUDIO_CHANNEL_OUT_2POINT1},
+    /* 0x02 */ {BIT(0)|BIT(2), true,
+                {PCM_CHANNEL_L, PCM_CHANNEL_R, PCM_CHANNEL_C},
+                AUDIO_CHANNEL_OUT_STEREO |
+                AUDIO_CHANNEL_OUT_FRONT_CENTER},
+    /* 0x03 */ {BIT(0)|BIT(1)|BIT(2), true,
+                {PCM_CHANNEL_L, PCM_CHANNEL_R, PCM_CHANNEL_LFE, PCM_CHANNEL_C},
+                AUDIO_CHANNEL_OUT_2POINT1 |
+                AUDIO_CHANNEL_OUT_FRONT_CENTER},
+    /* 0x04 */ {BIT(0)|BIT(4), true,
+                {PCM_CHANNEL_L, PCM_CHANNEL_R, PCM_CHANNEL_CS},
+                AUDIO_CHANNEL_OUT_STEREO |
+                AUDIO_CHANNEL_OUT_BACK_CENTER},
+    /* 0x05 */ {BIT(0)|BIT(1)|BIT(4), true,
+                {PCM_CHANNEL_L, PCM_CHANNEL_R, PCM_CHANNEL_LFE, PCM_CHANNEL_CS},
+                AUDIO_CHANNEL_OUT_2POINT1 |
+                AUDIO_CHANNEL_OUT_LOW_FREQUENCY |
+                AUDIO_CHANNEL_OUT_BACK_CENTER},
+    /* 0x06 */ {BIT(0)|BIT(2)|BIT(4), true,
+                {PCM_CHANNEL_L, PCM_CHANNEL_R, PCM_CHANNEL_C, PCM_CHANNEL_CS},
+                AUDIO_CHANNEL_OUT_SURROUND},
+    /* 0x07 */ {BIT(0)|BIT(1)|BIT(2)|BIT(4), true,
+                {PCM_CHANNEL_L, PCM_CHANNEL_R, PCM_CHANNEL_LFE, PCM_CHANNEL_C,
+                 PCM_CHANNEL_CS},
+                AUDIO_CHANNEL_OUT_SURROUND |
+                AUDIO_CHANNEL_OUT_LOW_FREQUENCY},
+    /* 0x08 */ {BIT(0)|BIT(3), true,
+                {PCM_CHANNEL_L, PCM_CHANNEL_R, PCM_CHANNEL_LS, PCM_CHANNEL_RS},
+                AUDIO_CHANNEL_OUT_QUAD},
+    /* 0x09 */ {BIT(0)|BIT(1)|BIT(3), true,
+                {PCM_CHANNEL_L, PCM_CHANNEL_R, PCM_CHANNEL_LFE, PCM_CHANNEL_LS,
+                 PCM_CHANNEL_RS},
+                AUDIO_CHANNEL_OUT_QUAD |
+                AUDIO_CHANNEL_OUT_LOW_FREQUENCY},
+    /* 0x0a */ {BIT(0)|BIT(2)|BIT(3), true,
+                {PCM_CHANNEL_L, PCM_CHANNEL_R, PCM_CHANNEL_C, PCM_CHANNEL_LS,
+                 PCM_CHANNEL_RS},
+                AUDIO_CHANNEL_OUT_PENTA},
+    /* 0x0b */ {BIT(0)|BIT(1)|BIT(2)|BIT(3), true,
+                {PCM_CHANNEL_L, PCM_CHANNEL_R, PCM_CHANNEL_LFE, PCM_CHANNEL_C,
+                 PCM_CHANNEL_LS, PCM_CHANNEL_RS},
+                AUDIO_CHANNEL_OUT_5POINT1},
+    /* 0x0c */ {BIT(0)|BIT(3)|BIT(4), true,
+                {PCM_CHANNEL_L, PCM_CHANNEL_R, PCM_CHANNEL_LS, PCM_CHANNEL_RS,
+                 PCM_CHANNEL_CS},
+                AUDIO_CHANNEL_OUT_QUAD |
+                AUDIO_CHANNEL_OUT_BACK_CENTER},
+    /* 0x0d */ {BIT(0)|BIT(1)|BIT(3)|BIT(4), true,
+                {PCM_CHANNEL_L, PCM_CHANNEL_R, PCM_CHANNEL_LFE, PCM_CHANNEL_LS,
+                 PCM_CHANNEL_RS, PCM_CHANNEL_CS},
+                AUDIO_CHANNEL_OUT_QUAD |
+                AUDIO_CHANNEL_OUT_LOW_FREQUENCY |
+                AUDIO_CHANNEL_OUT_BACK_CENTER},
+    /* 0x0e */ {BIT(0)|BIT(2)|BIT(3)|BIT(4), true,
+                {PCM_CHANNEL_L, PCM_CHANNEL_R, PCM_CHANNEL_C, PCM_CHANNEL_LS,
+                 PCM_CHANNEL_RS, PCM_CHANNEL_CS},
+                AUDIO_CHANNEL_OUT_PENTA |
+                AUDIO_CHANNEL_OUT_BACK_CENTER},
+    /* 0x0f */ {BIT(0)|BIT(1)|BIT(2)|BIT(3)|BIT(4), true,
+                {PCM_CHANNEL_L, PCM_CHANNEL_R, PCM_CHANNEL_LFE, PCM_CHANNEL_C,
+                 PCM_CHANNEL_LS, PCM_CHANNEL_RS, PCM_CHANNEL_CS},
+                AUDIO_CHANNEL_OUT_5POINT1 |
+                AUDIO_CHANNEL_OUT_BACK_CENTER},
+    /* 0x10 */ {BIT(0)|BIT(3)|BIT(6), true,
+                {PCM_CHANNEL_L, PCM_CHANNEL_R, PCM_CHANNEL_LS, PCM_CHANNEL_RS,
+                 PCM_CHANNEL_LB, PCM_CHANNEL_RB},
+                AUDIO_CHANNEL_OUT_QUAD |
+                AUDIO_CHANNEL_OUT_SIDE_LEFT |
+                AUDIO_CHANNEL_OUT_SIDE_RIGHT},
+    /* 0x11 */ {BIT(0)|BIT(1)|BIT(3)|BIT(6), true,
+                {PCM_CHANNEL_L, PCM_CHANNEL_R, PCM_CHANNEL_LFE, PCM_CHANNEL_LS,
+                 PCM_CHANNEL_RS, PCM_CHANNEL_LB, PCM_CHANNEL_RB},
+                AUDIO_CHANNEL_OUT_QUAD |
+                AUDIO_CHANNEL_OUT_LOW_FREQUENCY |
+                AUDIO_CHANNEL_OUT_SIDE_LEFT |
+                AUDIO_CHANNEL_OUT_SIDE_RIGHT},
+    /* 0x12 */ {BIT(0)|BIT(2)|BIT(3)|BIT(6), true,
+                {PCM_CHANNEL_L, PCM_CHANNEL_R, PCM_CHANNEL_C, PCM_CHANNEL_LS,
+                 PCM_CHANNEL_RS, PCM_CHANNEL_LB, PCM_CHANNEL_RB},
+                AUDIO_CHANNEL_OUT_QUAD |
+                AUDIO_CHANNEL_OUT_FRONT_CENTER |
+                AUDIO_CHANNEL_OUT_SIDE_LEFT |
+                AUDIO_CHANNEL_OUT_SIDE_RIGHT},
+    /* 0x13 */ {BIT(0)|BIT(1)|BIT(2)|BIT(3)|BIT(6), true,
+                {PCM_CHANNEL_L, PCM_CHANNEL_R, PCM_CHANNEL_LFE, PCM_CHANNEL_C,
+                 PCM_CHANNEL_LS, PCM_CHANNEL_RS, PCM_CHANNEL_LB, PCM_CHANNEL_RB},
+                AUDIO_CHANNEL_OUT_7POINT1},
+    /* 0x14 */ {BIT(0)|BIT(5), true,
+                {PCM_CHANNEL_L, PCM_CHANNEL_R, PCM_CHANNEL_FLC, PCM_CHANNEL_FRC},
+                AUDIO_CHANNEL_OUT_FRONT_LEFT |
+                AUDIO_CHANNEL_OUT_FRONT_RIGHT |
+                AUDIO_CHANNEL_OUT_FRONT_LEFT_OF_CENTER |
+                AUDIO_CHANNEL_OUT_FRONT_RIGHT_OF_CENTER},
+    /* 0x15 */ {BIT(0)|BIT(1)|BIT(5), true,
+                {PCM_CHANNEL_L, PCM_CHANNEL_R, PCM_CHANNEL_LFE, PCM_CHANNEL_FLC,
+                 PCM_CHANNEL_FRC},
+                AUDIO_CHANNEL_OUT_2POINT1 |
+                AUDIO_CHANNEL_OUT_FRONT_LEFT_OF_CENTER |
+                AUDIO_CHANNEL_OUT_FRONT_RIGHT_OF_CENTER},
+    /* 0x16 */ {BIT(0)|BIT(2)|BIT(5), true,
+                {PCM_CHANNEL_L, PCM_CHANNEL_R, PCM_CHANNEL_C, PCM_CHANNEL_FLC,
+                 PCM_CHANNEL_FRC},
+                AUDIO_CHANNEL_OUT_FRONT_LEFT |
+                AUDIO_CHANNEL_OUT_FRONT_RIGHT |
+                AUDIO_CHANNEL_OUT_FRONT_CENTER |
+                AUDIO_CHANNEL_OUT_FRONT_LEFT_OF_CENTER |
+                AUDIO_CHANNEL_OUT_FRONT_RIGHT_OF_CENTER},
+    /* 0x17 */ {BIT(0)|BIT(1)|BIT(2)|BIT(5), true,
+                {PCM_CHANNEL_L, PCM_CHANNEL_R, PCM_CHANNEL_LFE, PCM_CHANNEL_C,
+                 PCM_CHANNEL_FLC, PCM_CHANNEL_FRC},
+                AUDIO_CHANNEL_OUT_2POINT1 |
+                AUDIO_CHANNEL_OUT_FRONT_CENTER |
+                AUDIO_CHANNEL_OUT_FRONT_LEFT_OF_CENTER |
+                AUDIO_CHANNEL_OUT_FRONT_RIGHT_OF_CENTER},
+    /* 0x18 */ {BIT(0)|BIT(4)|BIT(5), true,
+                {PCM_CHANNEL_L, PCM_CHANNEL_R, PCM_CHANNEL_CS, PCM_CHANNEL_FLC,
+                 PCM_CHANNEL_FRC},
+                AUDIO_CHANNEL_OUT_FRONT_LEFT |
+                AUDIO_CHANNEL_OUT_FRONT_RIGHT |
+                AUDIO_CHANNEL_OUT_BACK_CENTER |
+                AUDIO_CHANNEL_OUT_FRONT_LEFT_OF_CENTER |
+                AUDIO_CHANNEL_OUT_FRONT_RIGHT_OF_CENTER},
+    /* 0x19 */ {BIT(0)|BIT(1)|BIT(4)|BIT(5), true,
+                {PCM_CHANNEL_L, PCM_CHANNEL_R, PCM_CHANNEL_LFE, PCM_CHANNEL_CS,
+                 PCM_CHANNEL_FLC, PCM_CHANNEL_FRC},
+                AUDIO_CHANNEL_OUT_2POINT1 |
+                AUDIO_CHANNEL_OUT_BACK_CENTER |
+                AUDIO_CHANNEL_OUT_FRONT_LEFT_OF_CENTER |
+                AUDIO_CHANNEL_OUT_FRONT_RIGHT_OF_CENTER},
+    /* 0x1a */ {BIT(0)|BIT(2)|BIT(4)|BIT(5), true,
+                {PCM_CHANNEL_L, PCM_CHANNEL_R, PCM_CHANNEL_C, PCM_CHANNEL_CS,
+                 PCM_CHANNEL_FLC, PCM_CHANNEL_FRC},
+                AUDIO_CHANNEL_OUT_SURROUND |
+                AUDIO_CHANNEL_OUT_FRONT_LEFT_OF_CENTER |
+                AUDIO_CHANNEL_OUT_FRONT_RIGHT_OF_CENTER},
+    /* 0x1b */ {BIT(0)|BIT(1)|BIT(2)|BIT(4)|BIT(5), true,
+                {PCM_CHANNEL_L, PCM_CHANNEL_R, PCM_CHANNEL_LFE, PCM_CHANNEL_C,
+                 PCM_CHANNEL_CS, PCM_CHANNEL_FLC, PCM_CHANNEL_FRC},
+                AUDIO_CHANNEL_OUT_SURROUND |
+                AUDIO_CHANNEL_OUT_LOW_FREQUENCY |
+                AUDIO_CHANNEL_OUT_FRONT_LEFT_OF_CENTER |
+                AUDIO_CHANNEL_OUT_FRONT_RIGHT_OF_CENTER},
+    /* 0x1c */ {BIT(0)|BIT(3)|BIT(5), true,
+                {PCM_CHANNEL_L, PCM_CHANNEL_R, PCM_CHANNEL_LS, PCM_CHANNEL_RS,
+                 PCM_CHANNEL_FLC, PCM_CHANNEL_FRC},
+                AUDIO_CHANNEL_OUT_QUAD |
+                AUDIO_CHANNEL_OUT_FRONT_LEFT_OF_CENTER |
+                AUDIO_CHANNEL_OUT_FRONT_RIGHT_OF_CENTER},
+    /* 0x1d */ {BIT(0)|BIT(1)|BIT(3)|BIT(5), true,
+                {PCM_CHANNEL_L, PCM_CHANNEL_R, PCM_CHANNEL_LFE, PCM_CHANNEL_LS,
+                 PCM_CHANNEL_RS, PCM_CHANNEL_FLC, PCM_CHANNEL_FRC},
+                AUDIO_CHANNEL_OUT_QUAD |
+                AUDIO_CHANNEL_OUT_LOW_FREQUENCY |
+                AUDIO_CHANNEL_OUT_FRONT_LEFT_OF_CENTER |
+                AUDIO_CHANNEL_OUT_FRONT_RIGHT_OF_CENTER},
+    /* 0x1e */ {BIT(0)|BIT(2)|BIT(3)|BIT(5), true,
+                {PCM_CHANNEL_L, PCM_CHANNEL_R, PCM_CHANNEL_C, PCM_CHANNEL_LS,
+                 PCM_CHANNEL_RS, PCM_CHANNEL_FLC, PCM_CHANNEL_FRC},
+                AUDIO_CHANNEL_OUT_PENTA |
+                AUDIO_CHANNEL_OUT_FRONT_LEFT_OF_CENTER |
+                AUDIO_CHANNEL_OUT_FRONT_RIGHT_OF_CENTER},
+    /* 0x1f */ {BIT(0)|BIT(1)|BIT(2)|BIT(3)|BIT(5), true,
+                {PCM_CHANNEL_L, PCM_CHANNEL_R, PCM_CHANNEL_LFE, PCM_CHANNEL_C,
+                 PCM_CHANNEL_LS, PCM_CHANNEL_RS, PCM_CHANNEL_FLC, PCM_CHANNEL_FRC},
+                AUDIO_CHANNEL_OUT_5POINT1 |
+                AUDIO_CHANNEL_OUT_FRONT_LEFT_OF_CENTER |
+                AUDIO_CHANNEL_OUT_FRONT_RIGHT_OF_CENTER},
+    /* 0x20 */ {BIT(0)|BIT(2)|BIT(3)|BIT(10), false,
+                {0},
+                0},
+    /* 0x21 */ {BIT(0)|BIT(1)|BIT(2)|BIT(3)|BIT(10), false,
+                {0},
+                0},
+    /* 0x22 */ {BIT(0)|BIT(2)|BIT(3)|BIT(9), false,
+                {0},
+                0},
+    /* 0x23 */ {BIT(0)|BIT(1)|BIT(2)|BIT(3)|BIT(9), false,
+                {0},
+                0},
+    /* 0x24 */ {BIT(0)|BIT(3)|BIT(8), false,
+                {0},
+                0},
+    /* 0x25 */ {BIT(0)|BIT(1)|BIT(3)|BIT(8), false,
+                {0},
+                0},
+    /* 0x26 */ {BIT(0)|BIT(3)|BIT(7), false,
+                {0},
+                0},
+    /* 0x27 */ {BIT(0)|BIT(1)|BIT(3)|BIT(7), false,
+                {0},
+                0},
+    /* 0x28 */ {BIT(0)|BIT(2)|BIT(3)|BIT(4)|BIT(9), false,
+                {0},
+                0},
+    /* 0x29 */ {BIT(0)|BIT(1)|BIT(2)|BIT(3)|BIT(4)|BIT(9), false,
+                {0},
+                0},
+    /* 0x2a */ {BIT(0)|BIT(2)|BIT(3)|BIT(4)|BIT(10), false,
+                {0},
+                0},
+    /* 0x2b */ {BIT(0)|BIT(1)|BIT(2)|BIT(3)|BIT(4)|BIT(10), false,
+                {0},
+                0},
+    /* 0x2c */ {BIT(0)|BIT(2)|BIT(3)|BIT(9)|BIT(10), false,
+                {0},
+                0},
+    /* 0x2d */ {BIT(0)|BIT(1)|BIT(2)|BIT(3)|BIT(9)|BIT(10), false,
+                {0},
+                0},
+    /* 0x2e */ {BIT(0)|BIT(2)|BIT(3)|BIT(8), false,
+                {0},
+                0},
+    /* 0x2f */ {BIT(0)|BIT(1)|BIT(2)|BIT(3)|BIT(8), true,
+                {PCM_CHANNEL_L, PCM_CHANNEL_R, PCM_CHANNEL_LFE, PCM_CHANNEL_C,
+                 PCM_CHANNEL_LS, PCM_CHANNEL_RS},
+                AUDIO_CHANNEL_OUT_5POINT1POINT2},
+    /* 0x30 */ {BIT(0)|BIT(2)|BIT(3)|BIT(7), false,
+                {0},
+                0},
+    /* 0x31 */ {BIT(0)|BIT(1)|BIT(2)|BIT(3)|BIT(7), false,
+                {0},
+                0},
+};
+
+#define NUM_CHANNEL_ALLOCATIONS \
+    (sizeof(channelAllocations) / sizeof(channelAllocations[0]))
+
+/*
+ * Decoded sink capabilities keyed by the raw SAD bytes read from the EDID
+ * control, so reconnecting a known sink skips decoding.
+ */
+#define EDID_CACHE_ENTRIES 4
+
+static struct edidCacheEntry {
+    bool valid = false;
+    uint64_t hash = 0;
+    char raw[MAX_SAD_BLOCKS * SAD_BLOCK_SIZE + 1] = {0};
+    edidAudioInfo info = {};
+    uint32_t lastUse = 0;
+} edidCache[EDID_CACHE_ENTRIES];
+static uint32_t edidCacheTick = 0;
+static std::mutex edidCacheMutex;
+
 std::shared_ptr<Device> DisplayPort::objRx = nullptr;
 std::shared_ptr<Device> DisplayPort::objTx = nullptr;
 
@@ -654,9 +936,12 @@ int DisplayPort::getEdidInfo(struct audio_mixer *mixer, int controller, int stre
 
     PAL_VERBOSE(LOG_TAG," received edid data: count %d", edidData[0]);
 
-    if (!getSinkCaps((struct edidAudioInfo *)state->edidInfo, edidData)) {
-        PAL_ERR(LOG_TAG," Failed to get extn disp sink capabilities");
-        goto fail;
+    if (!lookupEdidCache(edidData, (struct edidAudioInfo *)state->edidInfo)) {
+        if (!getSinkCaps((struct edidAudioInfo *)state->edidInfo, edidData)) {
+            PAL_ERR(LOG_TAG," Failed to get extn disp sink capabilities");
+            goto fail;
+        }
+        storeEdidCache(edidData, (struct edidAudioInfo *)state->edidInfo);
     }
     state->valid = true;
     return 0;
@@ -827,38 +1112,15 @@ const char * DisplayPort::edidFormatToStr(unsigned char format)
 
 bool DisplayPort::isSampleRateSupported(unsigned char srByte, int samplingRate)
 {
-    int result = 0;
+    size_t i;
+
     // Codec Supports Sample rate in range of 48K-192K
     PAL_VERBOSE(LOG_TAG," srByte: %d, samplingRate: %d", srByte, samplingRate);
-    switch (samplingRate) {
-    case 192000:
-        result = (srByte & BIT(6));
-        break;
-    case 176400:
-        result = (srByte & BIT(5));
-        break;
-    case 96000:
-        result = (srByte & BIT(4));
-        break;
-    case 88200:
-        result = (srByte & BIT(3));
-        break;
-    case 48000:
-        result = (srByte & BIT(2));
-        break;
-    case 44100:
-        result = (srByte & BIT(1));
-        break;
-    case 32000:
-        result = (srByte & BIT(0));
-        break;
-     default:
-        break;
+    for (i = 0; i < sizeof(edidRates) / sizeof(edidRates[0]); i++) {
+        if (edidRates[i].rate == samplingRate)
+            return (srByte & edidRates[i].bit) != 0;
     }
 
-    if (result)
-        return true;
-
     return false;
 }
 
@@ -874,54 +1136,29 @@ unsigned char DisplayPort::getEdidBpsByte(unsigned char byte,
 
 bool DisplayPort::isSupportedBps(unsigned char bpsByte, int bps)
 {
-    int result = 0;
+    size_t i;
 
-    switch (bps) {
-    case 24:
-        PAL_VERBOSE(LOG_TAG,"24bit");
-        result = (bpsByte & BIT(2));
-        break;
-    case 16:
-        PAL_VERBOSE(LOG_TAG,"16bit");
-        result = (bpsByte & BIT(0));
-        break;
-     default:
-        break;
+    for (i = 0; i < sizeof(edidBps) / sizeof(edidBps[0]); i++) {
+        if (edidBps[i].bps == bps) {
+            PAL_VERBOSE(LOG_TAG,"%dbit", bps);
+            return (bpsByte & edidBps[i].bit) != 0;
+        }
     }
 
-    if (result)
-        return true;
-
     return false;
 }
 
 int DisplayPort::getHighestEdidSF(unsigned char byte)
 {
-    int nfreq = 0;
-
-    if (byte & BIT(6)) {
-        PAL_VERBOSE(LOG_TAG,"Highest: 192kHz");
-        nfreq = 192000;
-    } else if (byte & BIT(5)) {
-        PAL_VERBOSE(LOG_TAG,"Highest: 176kHz");
-        nfreq = 176000;
-    } else if (byte & BIT(4)) {
-        PAL_VERBOSE(LOG_TAG,"Highest: 96kHz");
-        nfreq = 96000;
-    } else if (byte & BIT(3)) {
-        PAL_VERBOSE(LOG_TAG,"Highest: 88.2kHz");
-        nfreq = 88200;
-    } else if (byte & BIT(2)) {
-        PAL_VERBOSE(LOG_TAG,"Highest: 48kHz");
-        nfreq = 48000;
-    } else if (byte & BIT(1)) {
-        PAL_VERBOSE(LOG_TAG,"Highest: 44.1kHz");
-        nfreq = 44100;
-    } else if (byte & BIT(0)) {
-        PAL_VERBOSE(LOG_TAG,"Highest: 32kHz");
-        nfreq = 32000;
-    }
-    return nfreq;
+    int i;
+
+    for (i = sizeof(edidRates) / sizeof(edidRates[0]) - 1; i >= 0; i--) {
+        if (byte & edidRates[i].bit) {
+            PAL_VERBOSE(LOG_TAG,"Highest: %dHz", edidRates[i].rate);
+            return edidRates[i].rate;
+        }
+    }
+    return 0;
 }
 
 void DisplayPort::updateChannelMap(edidAudioInfo* info)
@@ -1040,8 +1277,9 @@ void DisplayPort::dumpSpeakerAllocation(edidAudioInfo* info)
 
 void DisplayPort::updateChannelAllocation(edidAudioInfo* info)
 {
-    int16_t ca;
+    int16_t ca = 0x0;
     int16_t spkrAlloc;
+    size_t i;
 
     if (!info)
         return;
@@ -1054,60 +1292,12 @@ void DisplayPort::updateChannelAllocation(edidAudioInfo* info)
                                               info->speakerAllocation[1]);
     PAL_VERBOSE(LOG_TAG,"spkrAlloc: %x", spkrAlloc);
 
-    /* The below switch case calculates channel allocation values
-       as defined in CEA-861 section 6.6.2 */
-    switch (spkrAlloc) {
-    case BIT(0):                                           ca = 0x00; break;
-    case BIT(0)|BIT(1):                                    ca = 0x01; break;
-    case BIT(0)|BIT(2):                                    ca = 0x02; break;
-    case BIT(0)|BIT(1)|BIT(2):                             ca = 0x03; break;
-    case BIT(0)|BIT(4):                                    ca = 0x04; break;
-    case BIT(0)|BIT(1)|BIT(4):                             ca = 0x05; break;
-    case BIT(0)|BIT(2)|BIT(4):                             ca = 0x06; break;
-    case BIT(0)|BIT(1)|BIT(2)|BIT(4):                      ca = 0x07; break;
-    case BIT(0)|BIT(3):                                    ca = 0x08; break;
-    case BIT(0)|BIT(1)|BIT(3):                             ca = 0x09; break;
-    case BIT(0)|BIT(2)|BIT(3):                             ca = 0x0A; break;
-    case BIT(0)|BIT(1)|BIT(2)|BIT(3):                      ca = 0x0B; break;
-    case BIT(0)|BIT(3)|BIT(4):                             ca = 0x0C; break;
-    case BIT(0)|BIT(1)|BIT(3)|BIT(4):                      ca = 0x0D; break;
-    case BIT(0)|BIT(2)|BIT(3)|BIT(4):                      ca = 0x0E; break;
-    case BIT(0)|BIT(1)|BIT(2)|BIT(3)|BIT(4):               ca = 0x0F; break;
-    case BIT(0)|BIT(3)|BIT(6):                             ca = 0x10; break;
-    case BIT(0)|BIT(1)|BIT(3)|BIT(6):                      ca = 0x11; break;
-    case BIT(0)|BIT(2)|BIT(3)|BIT(6):                      ca = 0x12; break;
-    case BIT(0)|BIT(1)|BIT(2)|BIT(3)|BIT(6):               ca = 0x13; break;
-    case BIT(0)|BIT(5):                                    ca = 0x14; break;
-    case BIT(0)|BIT(1)|BIT(5):                             ca = 0x15; break;
-    case BIT(0)|BIT(2)|BIT(5):                             ca = 0x16; break;
-    case BIT(0)|BIT(1)|BIT(2)|BIT(5):                      ca = 0x17; break;
-    case BIT(0)|BIT(4)|BIT(5):                             ca = 0x18; break;
-    case BIT(0)|BIT(1)|BIT(4)|BIT(5):                      ca = 0x19; break;
-    case BIT(0)|BIT(2)|BIT(4)|BIT(5):                      ca = 0x1A; break;
-    case BIT(0)|BIT(1)|BIT(2)|BIT(4)|BIT(5):               ca = 0x1B; break;
-    case BIT(0)|BIT(3)|BIT(5):                             ca = 0x1C; break;
-    case BIT(0)|BIT(1)|BIT(3)|BIT(5):                      ca = 0x1D; break;
-    case BIT(0)|BIT(2)|BIT(3)|BIT(5):                      ca = 0x1E; break;
-    case BIT(0)|BIT(1)|BIT(2)|BIT(3)|BIT(5):               ca = 0x1F; break;
-    case BIT(0)|BIT(2)|BIT(3)|BIT(10):                     ca = 0x20; break;
-    case BIT(0)|BIT(1)|BIT(2)|BIT(3)|BIT(10):              ca = 0x21; break;
-    case BIT(0)|BIT(2)|BIT(3)|BIT(9):                      ca = 0x22; break;
-    case BIT(0)|BIT(1)|BIT(2)|BIT(3)|BIT(9):               ca = 0x23; break;
-    case BIT(0)|BIT(3)|BIT(8):                             ca = 0x24; break;
-    case BIT(0)|BIT(1)|BIT(3)|BIT(8):                      ca = 0x25; break;
-    case BIT(0)|BIT(3)|BIT(7):                             ca = 0x26; break;
-    case BIT(0)|BIT(1)|BIT(3)|BIT(7):                      ca = 0x27; break;
-    case BIT(0)|BIT(2)|BIT(3)|BIT(4)|BIT(9):               ca = 0x28; break;
-    case BIT(0)|BIT(1)|BIT(2)|BIT(3)|BIT(4)|BIT(9):        ca = 0x29; break;
-    case BIT(0)|BIT(2)|BIT(3)|BIT(4)|BIT(10):              ca = 0x2A; break;
-    case BIT(0)|BIT(1)|BIT(2)|BIT(3)|BIT(4)|BIT(10):       ca = 0x2B; break;
-    case BIT(0)|BIT(2)|BIT(3)|BIT(9)|BIT(10):              ca = 0x2C; break;
-    case BIT(0)|BIT(1)|BIT(2)|BIT(3)|BIT(9)|BIT(10):       ca = 0x2D; break;
-    case BIT(0)|BIT(2)|BIT(3)|BIT(8):                      ca = 0x2E; break;
-    case BIT(0)|BIT(1)|BIT(2)|BIT(3)|BIT(8):               ca = 0x2F; break;
-    case BIT(0)|BIT(2)|BIT(3)|BIT(7):                      ca = 0x30; break;
-    case BIT(0)|BIT(1)|BIT(2)|BIT(3)|BIT(7):               ca = 0x31; break;
-    default:                                               ca = 0x0;  break;
+    /* unknown speaker allocations fall back to stereo, ca 0x00 */
+    for (i = 0; i < NUM_CHANNEL_ALLOCATIONS; i++) {
+        if (channelAllocations[i].spkrAlloc == (uint16_t)spkrAlloc) {
+            ca = i;
+            break;
+        }
     }
     PAL_DBG(LOG_TAG," channel allocation: %x", ca);
     info->channelAllocation = ca;
@@ -1118,8 +1308,8 @@ void DisplayPort::retrieveChannelMapLpass(int ca, uint8_t *ch_map, int ch_map_si
     if (!ch_map)
         return;
 
-    if (((ca < 0) || (ca > 0x1f)) &&
-         (ca != 0x2f)) {
+    if ((ca < 0) || (ca >= (int)NUM_CHANNEL_ALLOCATIONS) ||
+        !channelAllocations[ca].lpassSupported) {
         PAL_ERR(LOG_TAG,"Channel allocation out of supported range");
         return;
     }
@@ -1128,258 +1318,7 @@ void DisplayPort::retrieveChannelMapLpass(int ca, uint8_t *ch_map, int ch_map_si
     if (ch_map_size < MAX_CHANNELS_SUPPORTED)
         return;
 
-    memset(ch_map, 0, MAX_CHANNELS_SUPPORTED);
-
-    switch(ca) {
-    case 0x0:
-        ch_map[0] = PCM_CHANNEL_L;
-        ch_map[1] = PCM_CHANNEL_R;
-        break;
-    case 0x1:
-        ch_map[0] = PCM_CHANNEL_L;
-        ch_map[1] = PCM_CHANNEL_R;
-        ch_map[2] = PCM_CHANNEL_LFE;
-        break;
-    case 0x2:
-        ch_map[0] = PCM_CHANNEL_L;
-        ch_map[1] = PCM_CHANNEL_R;
-        ch_map[2] = PCM_CHANNEL_C;
-        break;
-    case 0x3:
-        ch_map[0] = PCM_CHANNEL_L;
-        ch_map[1] = PCM_CHANNEL_R;
-        ch_map[2] = PCM_CHANNEL_LFE;
-        ch_map[3] = PCM_CHANNEL_C;
-        break;
-    case 0x4:
-        ch_map[0] = PCM_CHANNEL_L;
-        ch_map[1] = PCM_CHANNEL_R;
-        ch_map[2] = PCM_CHANNEL_CS;
-        break;
-    case 0x5:
-        ch_map[0] = PCM_CHANNEL_L;
-        ch_map[1] = PCM_CHANNEL_R;
-        ch_map[2] = PCM_CHANNEL_LFE;
-        ch_map[3] = PCM_CHANNEL_CS;
-        break;
-    case 0x6:
-        ch_map[0] = PCM_CHANNEL_L;
-        ch_map[1] = PCM_CHANNEL_R;
-        ch_map[2] = PCM_CHANNEL_C;
-        ch_map[3] = PCM_CHANNEL_CS;
-        break;
-    case 0x7:
-        ch_map[0] = PCM_CHANNEL_L;
-        ch_map[1] = PCM_CHANNEL_R;
-        ch_map[2] = PCM_CHANNEL_LFE;
-        ch_map[3] = PCM_CHANNEL_C;
-        ch_map[4] = PCM_CHANNEL_CS;
-        break;
-    case 0x8:
-        ch_map[0] = PCM_CHANNEL_L;
-        ch_map[1] = PCM_CHANNEL_R;
-        ch_map[2] = PCM_CHANNEL_LS;
-        ch_map[3] = PCM_CHANNEL_RS;
-        break;
-    case 0x9:
-        ch_map[0] = PCM_CHANNEL_L;
-        ch_map[1] = PCM_CHANNEL_R;
-        ch_map[2] = PCM_CHANNEL_LFE;
-        ch_map[3] = PCM_CHANNEL_LS;
-        ch_map[4] = PCM_CHANNEL_RS;
-        break;
-    case 0xa:
-        ch_map[0] = PCM_CHANNEL_L;
-        ch_map[1] = PCM_CHANNEL_R;
-        ch_map[2] = PCM_CHANNEL_C;
-        ch_map[3] = PCM_CHANNEL_LS;
-        ch_map[4] = PCM_CHANNEL_RS;
-        break;
-    case 0xb:
-        ch_map[0] = PCM_CHANNEL_L;
-        ch_map[1] = PCM_CHANNEL_R;
-        ch_map[2] = PCM_CHANNEL_LFE;
-        ch_map[3] = PCM_CHANNEL_C;
-        ch_map[4] = PCM_CHANNEL_LS;
-        ch_map[5] = PCM_CHANNEL_RS;
-        break;
-    case 0xc:
-        ch_map[0] = PCM_CHANNEL_L;
-        ch_map[1] = PCM_CHANNEL_R;
-        ch_map[2] = PCM_CHANNEL_LS;
-        ch_map[3] = PCM_CHANNEL_RS;
-        ch_map[4] = PCM_CHANNEL_CS;
-        break;
-    case 0xd:
-        ch_map[0] = PCM_CHANNEL_L;
-        ch_map[1] = PCM_CHANNEL_R;
-        ch_map[2] = PCM_CHANNEL_LFE;
-        ch_map[3] = PCM_CHANNEL_LS;
-        ch_map[4] = PCM_CHANNEL_RS;
-        ch_map[5] = PCM_CHANNEL_CS;
-        break;
-    case 0xe:
-        ch_map[0] = PCM_CHANNEL_L;
-        ch_map[1] = PCM_CHANNEL_R;
-        ch_map[2] = PCM_CHANNEL_C;
-        ch_map[3] = PCM_CHANNEL_LS;
-        ch_map[4] = PCM_CHANNEL_RS;
-        ch_map[5] = PCM_CHANNEL_CS;
-        break;
-    case 0xf:
-        ch_map[0] = PCM_CHANNEL_L;
-        ch_map[1] = PCM_CHANNEL_R;
-        ch_map[2] = PCM_CHANNEL_LFE;
-        ch_map[3] = PCM_CHANNEL_C;
-        ch_map[4] = PCM_CHANNEL_LS;
-        ch_map[5] = PCM_CHANNEL_RS;
-        ch_map[6] = PCM_CHANNEL_CS;
-        break;
-    case 0x10:
-        ch_map[0] = PCM_CHANNEL_L;
-        ch_map[1] = PCM_CHANNEL_R;
-        ch_map[2] = PCM_CHANNEL_LS;
-        ch_map[3] = PCM_CHANNEL_RS;
-        ch_map[4] = PCM_CHANNEL_LB;
-        ch_map[5] = PCM_CHANNEL_RB;
-        break;
-    case 0x11:
-        ch_map[0] = PCM_CHANNEL_L;
-        ch_map[1] = PCM_CHANNEL_R;
-        ch_map[2] = PCM_CHANNEL_LFE;
-        ch_map[3] = PCM_CHANNEL_LS;
-        ch_map[4] = PCM_CHANNEL_RS;
-        ch_map[5] = PCM_CHANNEL_LB;
-        ch_map[6] = PCM_CHANNEL_RB;
-        break;
-    case 0x12:
-        ch_map[0] = PCM_CHANNEL_L;
-        ch_map[1] = PCM_CHANNEL_R;
-        ch_map[2] = PCM_CHANNEL_C;
-        ch_map[3] = PCM_CHANNEL_LS;
-        ch_map[4] = PCM_CHANNEL_RS;
-        ch_map[5] = PCM_CHANNEL_LB;
-        ch_map[6] = PCM_CHANNEL_RB;
-        break;
-    case 0x13:
-        ch_map[0] = PCM_CHANNEL_L;
-        ch_map[1] = PCM_CHANNEL_R;
-        ch_map[2] = PCM_CHANNEL_LFE;
-        ch_map[3] = PCM_CHANNEL_C;
-        ch_map[4] = PCM_CHANNEL_LS;
-        ch_map[5] = PCM_CHANNEL_RS;
-        ch_map[6] = PCM_CHANNEL_LB;
-        ch_map[7] = PCM_CHANNEL_RB;
-        break;
-    case 0x14:
-        ch_map[0] = PCM_CHANNEL_L;
-        ch_map[1] = PCM_CHANNEL_R;
-        ch_map[2] = PCM_CHANNEL_FLC;
-        ch_map[3] = PCM_CHANNEL_FRC;
-        break;
-    case 0x15:
-        ch_map[0] = PCM_CHANNEL_L;
-        ch_map[1] = PCM_CHANNEL_R;
-        ch_map[2] = PCM_CHANNEL_LFE;
-        ch_map[3] = PCM_CHANNEL_FLC;
-        ch_map[4] = PCM_CHANNEL_FRC;
-        break;
-    case 0x16:
-        ch_map[0] = PCM_CHANNEL_L;
-        ch_map[1] = PCM_CHANNEL_R;
-        ch_map[2] = PCM_CHANNEL_C;
-        ch_map[3] = PCM_CHANNEL_FLC;
-        ch_map[4] = PCM_CHANNEL_FRC;
-        break;
-    case 0x17:
-        ch_map[0] = PCM_CHANNEL_L;
-        ch_map[1] = PCM_CHANNEL_R;
-        ch_map[2] = PCM_CHANNEL_LFE;
-        ch_map[3] = PCM_CHANNEL_C;
-        ch_map[4] = PCM_CHANNEL_FLC;
-        ch_map[5] = PCM_CHANNEL_FRC;
-        break;
-    case 0x18:
-        ch_map[0] = PCM_CHANNEL_L;
-        ch_map[1] = PCM_CHANNEL_R;
-        ch_map[2] = PCM_CHANNEL_CS;
-        ch_map[3] = PCM_CHANNEL_FLC;
-        ch_map[4] = PCM_CHANNEL_FRC;
-        break;
-    case 0x19:
-        ch_map[0] = PCM_CHANNEL_L;
-        ch_map[1] = PCM_CHANNEL_R;
-        ch_map[2] = PCM_CHANNEL_LFE;
-        ch_map[3] = PCM_CHANNEL_CS;
-        ch_map[4] = PCM_CHANNEL_FLC;
-        ch_map[5] = PCM_CHANNEL_FRC;
-        break;
-    case 0x1a:
-        ch_map[0] = PCM_CHANNEL_L;
-        ch_map[1] = PCM_CHANNEL_R;
-        ch_map[2] = PCM_CHANNEL_C;
-        ch_map[3] = PCM_CHANNEL_CS;
-        ch_map[4] = PCM_CHANNEL_FLC;
-        ch_map[5] = PCM_CHANNEL_FRC;
-        break;
-    case 0x1b:
-        ch_map[0] = PCM_CHANNEL_L;
-        ch_map[1] = PCM_CHANNEL_R;
-        ch_map[2] = PCM_CHANNEL_LFE;
-        ch_map[3] = PCM_CHANNEL_C;
-        ch_map[4] = PCM_CHANNEL_CS;
-        ch_map[5] = PCM_CHANNEL_FLC;
-        ch_map[6] = PCM_CHANNEL_FRC;
-        break;
-    case 0x1c:
-        ch_map[0] = PCM_CHANNEL_L;
-        ch_map[1] = PCM_CHANNEL_R;
-        ch_map[2] = PCM_CHANNEL_LS;
-        ch_map[3] = PCM_CHANNEL_RS;
-        ch_map[4] = PCM_CHANNEL_FLC;
-        ch_map[5] = PCM_CHANNEL_FRC;
-        break;
-    case 0x1d:
-        ch_map[0] = PCM_CHANNEL_L;
-        ch_map[1] = PCM_CHANNEL_R;
-        ch_map[2] = PCM_CHANNEL_LFE;
-        ch_map[3] = PCM_CHANNEL_LS;
-        ch_map[4] = PCM_CHANNEL_RS;
-        ch_map[5] = PCM_CHANNEL_FLC;
-        ch_map[6] = PCM_CHANNEL_FRC;
-        break;
-    case 0x1e:
-        ch_map[0] = PCM_CHANNEL_L;
-        ch_map[1] = PCM_CHANNEL_R;
-        ch_map[2] = PCM_CHANNEL_C;
-        ch_map[3] = PCM_CHANNEL_LS;
-        ch_map[4] = PCM_CHANNEL_RS;
-        ch_map[5] = PCM_CHANNEL_FLC;
-        ch_map[6] = PCM_CHANNEL_FRC;
-        break;
-    case 0x1f:
-        ch_map[0] = PCM_CHANNEL_L;
-        ch_map[1] = PCM_CHANNEL_R;
-        ch_map[2] = PCM_CHANNEL_LFE;
-        ch_map[3] = PCM_CHANNEL_C;
-        ch_map[4] = PCM_CHANNEL_LS;
-        ch_map[5] = PCM_CHANNEL_RS;
-        ch_map[6] = PCM_CHANNEL_FLC;
-        ch_map[7] = PCM_CHANNEL_FRC;
-        break;
-    case 0x2f:
-        ch_map[0] = PCM_CHANNEL_L;
-        ch_map[1] = PCM_CHANNEL_R;
-        ch_map[2] = PCM_CHANNEL_LFE;
-        ch_map[3] = PCM_CHANNEL_C;
-        ch_map[4] = PCM_CHANNEL_LS;
-        ch_map[5] = PCM_CHANNEL_RS;
-        ch_map[6] = 0; // PCM_CHANNEL_TFL; but not defined by LPASS
-        ch_map[7] = 0; // PCM_CHANNEL_TFR; but not defined by LPASS
-        break;
-    default:
-        break;
-    }
+    memcpy(ch_map, channelAllocations[ca].chMap, MAX_CHANNELS_SUPPORTED);
     PAL_DBG(LOG_TAG," channel map updated to [%d %d %d %d %d %d %d %d ]",
           ch_map[0], ch_map[1], ch_map[2],
           ch_map[3], ch_map[4], ch_map[5],
@@ -1399,9 +1338,9 @@ void DisplayPort::updateChannelMask(edidAudioInfo* info)
 {
     if (!info)
         return;
-    if (((info->channelAllocation < 0) ||
-         (info->channelAllocation > 0x1f)) &&
-         (info->channelAllocation != 0x2f)) {
+    if ((info->channelAllocation < 0) ||
+        (info->channelAllocation >= (int)NUM_CHANNEL_ALLOCATIONS) ||
+        !channelAllocations[info->channelAllocation].lpassSupported) {
         PAL_ERR(LOG_TAG,"Channel allocation out of supported range");
         return;
     }
@@ -1409,162 +1348,7 @@ void DisplayPort::updateChannelMask(edidAudioInfo* info)
     // Don't distinguish channel mask below?
     // AUDIO_CHANNEL_OUT_5POINT1 and AUDIO_CHANNEL_OUT_5POINT1_SIDE
     // AUDIO_CHANNEL_OUT_QUAD and AUDIO_CHANNEL_OUT_QUAD_SIDE
-    switch(info->channelAllocation) {
-    case 0x0:
-        info->channelMask = AUDIO_CHANNEL_OUT_STEREO;
-        break;
-    case 0x1:
-        info->channelMask = AUDIO_CHANNEL_OUT_2POINT1;
-        break;
-    case 0x2:
-        info->channelMask = AUDIO_CHANNEL_OUT_STEREO;
-        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_CENTER;
-        break;
-    case 0x3:
-        info->channelMask = AUDIO_CHANNEL_OUT_2POINT1;
-        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_CENTER;
-        break;
-    case 0x4:
-        info->channelMask = AUDIO_CHANNEL_OUT_STEREO;
-        info->channelMask |= AUDIO_CHANNEL_OUT_BACK_CENTER;
-        break;
-    case 0x5:
-        info->channelMask = AUDIO_CHANNEL_OUT_2POINT1;
-        info->channelMask |= AUDIO_CHANNEL_OUT_LOW_FREQUENCY;
-        info->channelMask |= AUDIO_CHANNEL_OUT_BACK_CENTER;
-        break;
-    case 0x6:
-        info->channelMask = AUDIO_CHANNEL_OUT_SURROUND;
-        break;
-    case 0x7:
-        info->channelMask = AUDIO_CHANNEL_OUT_SURROUND;
-        info->channelMask |= AUDIO_CHANNEL_OUT_LOW_FREQUENCY;
-        break;
-    case 0x8:
-        info->channelMask = AUDIO_CHANNEL_OUT_QUAD;
-        break;
-    case 0x9:
-        info->channelMask = AUDIO_CHANNEL_OUT_QUAD;
-        info->channelMask |= AUDIO_CHANNEL_OUT_LOW_FREQUENCY;
-        break;
-    case 0xa:
-        info->channelMask = AUDIO_CHANNEL_OUT_PENTA;
-        break;
-    case 0xb:
-        info->channelMask = AUDIO_CHANNEL_OUT_5POINT1;
-        break;
-    case 0xc:
-        info->channelMask = AUDIO_CHANNEL_OUT_QUAD;
-        info->channelMask |= AUDIO_CHANNEL_OUT_BACK_CENTER;
-        break;
-    case 0xd:
-        info->channelMask = AUDIO_CHANNEL_OUT_QUAD;
-        info->channelMask |= AUDIO_CHANNEL_OUT_LOW_FREQUENCY;
-        info->channelMask |= AUDIO_CHANNEL_OUT_BACK_CENTER;
-        break;
-    case 0xe:
-        info->channelMask = AUDIO_CHANNEL_OUT_PENTA;
-        info->channelMask |= AUDIO_CHANNEL_OUT_BACK_CENTER;
-        break;
-    case 0xf:
-        info->channelMask = AUDIO_CHANNEL_OUT_5POINT1;
-        info->channelMask |= AUDIO_CHANNEL_OUT_BACK_CENTER;
-        break;
-    case 0x10:
-        info->channelMask = AUDIO_CHANNEL_OUT_QUAD;
-        info->channelMask |= AUDIO_CHANNEL_OUT_SIDE_LEFT;
-        info->channelMask |= AUDIO_CHANNEL_OUT_SIDE_RIGHT;
-        break;
-    case 0x11:
-        info->channelMask = AUDIO_CHANNEL_OUT_QUAD;
-        info->channelMask |= AUDIO_CHANNEL_OUT_LOW_FREQUENCY;
-        info->channelMask |= AUDIO_CHANNEL_OUT_SIDE_LEFT;
-        info->channelMask |= AUDIO_CHANNEL_OUT_SIDE_RIGHT;
-        break;
-    case 0x12:
-        info->channelMask = AUDIO_CHANNEL_OUT_QUAD;
-        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_CENTER;
-        info->channelMask |= AUDIO_CHANNEL_OUT_SIDE_LEFT;
-        info->channelMask |= AUDIO_CHANNEL_OUT_SIDE_RIGHT;
-        break;
-    case 0x13:
-        info->channelMask = AUDIO_CHANNEL_OUT_7POINT1;
-        break;
-    case 0x14:
-        info->channelMask = AUDIO_CHANNEL_OUT_FRONT_LEFT;
-        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_RIGHT;
-        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_LEFT_OF_CENTER;
-        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_RIGHT_OF_CENTER;
-        break;
-    case 0x15:
-        info->channelMask = AUDIO_CHANNEL_OUT_2POINT1;
-        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_LEFT_OF_CENTER;
-        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_RIGHT_OF_CENTER;
-        break;
-    case 0x16:
-        info->channelMask = AUDIO_CHANNEL_OUT_FRONT_LEFT;
-        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_RIGHT;
-        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_CENTER;
-        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_LEFT_OF_CENTER;
-        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_RIGHT_OF_CENTER;
-        break;
-    case 0x17:
-        info->channelMask = AUDIO_CHANNEL_OUT_2POINT1;
-        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_CENTER;
-        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_LEFT_OF_CENTER;
-        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_RIGHT_OF_CENTER;
-        break;
-    case 0x18:
-        info->channelMask = AUDIO_CHANNEL_OUT_FRONT_LEFT;
-        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_RIGHT;
-        info->channelMask |= AUDIO_CHANNEL_OUT_BACK_CENTER;
-        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_LEFT_OF_CENTER;
-        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_RIGHT_OF_CENTER;
-        break;
-    case 0x19:
-        info->channelMask = AUDIO_CHANNEL_OUT_2POINT1;
-        info->channelMask |= AUDIO_CHANNEL_OUT_BACK_CENTER;
-        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_LEFT_OF_CENTER;
-        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_RIGHT_OF_CENTER;
-        break;
-    case 0x1a:
-        info->channelMask = AUDIO_CHANNEL_OUT_SURROUND;
-        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_LEFT_OF_CENTER;
-        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_RIGHT_OF_CENTER;
-        break;
-    case 0x1b:
-        info->channelMask = AUDIO_CHANNEL_OUT_SURROUND;
-        info->channelMask |= AUDIO_CHANNEL_OUT_LOW_FREQUENCY;
-        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_LEFT_OF_CENTER;
-        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_RIGHT_OF_CENTER;
-        break;
-    case 0x1c:
-        info->channelMask = AUDIO_CHANNEL_OUT_QUAD;
-        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_LEFT_OF_CENTER;
-        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_RIGHT_OF_CENTER;
-        break;
-    case 0x1d:
-        info->channelMask = AUDIO_CHANNEL_OUT_QUAD;
-        info->channelMask |= AUDIO_CHANNEL_OUT_LOW_FREQUENCY;
-        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_LEFT_OF_CENTER;
-        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_RIGHT_OF_CENTER;
-        break;
-    case 0x1e:
-        info->channelMask = AUDIO_CHANNEL_OUT_PENTA;
-        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_LEFT_OF_CENTER;
-        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_RIGHT_OF_CENTER;
-        break;
-    case 0x1f:
-        info->channelMask = AUDIO_CHANNEL_OUT_5POINT1;
-        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_LEFT_OF_CENTER;
-        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_RIGHT_OF_CENTER;
-        break;
-    case 0x2f:
-        info->channelMask = AUDIO_CHANNEL_OUT_5POINT1POINT2;
-        break;
-    default:
-        break;
-    }
+    info->channelMask = channelAllocations[info->channelAllocation].channelMask;
     PAL_DBG(LOG_TAG," channel mask updated to %d", info->channelMask);
 }
 
@@ -1668,14 +1452,108 @@ bool DisplayPort::getSinkCaps(edidAudioInfo* info, char *edidData)
         PAL_VERBOSE(LOG_TAG,"info->audioBlocksArray[i].bitsPerSampleBitmask %d",
               info->audioBlocksArray[i].bitsPerSampleBitmask);
     }
+    updateSinkCapsSummary(info);
     dumpSpeakerAllocation(info);
     dumpEdidData(info);
     return true;
 }
 
+void DisplayPort::updateSinkCapsSummary(edidAudioInfo *info)
+{
+    int i;
+
+    if (!info)
+        return;
+
+    info->samplingFreqMask = 0;
+    info->bitsPerSampleMask = 0;
+    info->maxLpcmChannels = 0;
+    for (i = 0; i < info->audioBlocks && i < MAX_EDID_BLOCKS; i++) {
+        info->samplingFreqMask |= info->audioBlocksArray[i].samplingFreqBitmask;
+        info->bitsPerSampleMask |= info->audioBlocksArray[i].bitsPerSampleBitmask;
+        if (info->audioBlocksArray[i].formatId == LPCM &&
+            info->maxLpcmChannels < info->audioBlocksArray[i].channels)
+            info->maxLpcmChannels = info->audioBlocksArray[i].channels;
+    }
+
+    info->highestSR = getHighestEdidSF(info->samplingFreqMask);
+    if (isSupportedBps(info->bitsPerSampleMask, 24))
+        info->highestBps = 24;
+    else if (isSupportedBps(info->bitsPerSampleMask, BITWIDTH_16))
+        info->highestBps = BITWIDTH_16;
+    else
+        info->highestBps = 0;
+
+    PAL_DBG(LOG_TAG," sink caps: sr mask 0x%x, bps mask 0x%x, max lpcm channels %d",
+            info->samplingFreqMask, info->bitsPerSampleMask, info->maxLpcmChannels);
+}
+
+uint64_t DisplayPort::hashEdid(const char *edidData)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    int length = (unsigned char)edidData[0];
+    int i;
+
+    for (i = 0; i <= length; i++) {
+        hash ^= (unsigned char)edidData[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+bool DisplayPort::lookupEdidCache(const char *edidData, edidAudioInfo *info)
+{
+    std::lock_guard<std::mutex> lock(edidCacheMutex);
+    uint64_t hash = hashEdid(edidData);
+    int length = (unsigned char)edidData[0];
+    int i;
+
+    for (i = 0; i < EDID_CACHE_ENTRIES; i++) {
+        struct edidCacheEntry *entry = &edidCache[i];
+
+        if (!entry->valid || entry->hash != hash ||
+            memcmp(entry->raw, edidData, length + 1))
+            continue;
+
+        memcpy(info, &entry->info, sizeof(edidAudioInfo));
+        entry->lastUse = ++edidCacheTick;
+        PAL_DBG(LOG_TAG," edid cache hit, hash 0x%llx",
+                (unsigned long long)hash);
+        return true;
+    }
+    return false;
+}
+
+void DisplayPort::storeEdidCache(const char *edidData, edidAudioInfo *info)
+{
+    std::lock_guard<std::mutex> lock(edidCacheMutex);
+    struct edidCacheEntry *entry = &edidCache[0];
+    int length = (unsigned char)edidData[0];
+    int i;
+
+    if (length >= (int)sizeof(entry->raw))
+        return;
+
+    /* take a free slot, else evict the least recently used sink */
+    for (i = 0; i < EDID_CACHE_ENTRIES; i++) {
+        if (!edidCache[i].valid) {
+            entry = &edidCache[i];
+            break;
+        }
+        if (edidCache[i].lastUse < entry->lastUse)
+            entry = &edidCache[i];
+    }
+
+    memset(entry->raw, 0, sizeof(entry->raw));
+    memcpy(entry->raw, edidData, length + 1);
+    memcpy(&entry->info, info, sizeof(edidAudioInfo));
+    entry->hash = hashEdid(edidData);
+    entry->lastUse = ++edidCacheTick;
+    entry->valid = true;
+}
+
 bool DisplayPort::isSupportedSR(edidAudioInfo* info, int sr)
 {
-    int i = 0;
     struct extDispState *state = NULL;
 
     state = &extDisp[dp_controller][dp_stream];
@@ -1683,14 +1561,10 @@ bool DisplayPort::isSupportedSR(edidAudioInfo* info, int sr)
     {
         info = (edidAudioInfo*) state->edidInfo;
     }
-    if (info != NULL && sr != 0) {
-        for (i = 0; i < info->audioBlocks && i < MAX_EDID_BLOCKS; i++) {
-        if (isSampleRateSupported(info->audioBlocksArray[i].samplingFreqBitmask,
-                    sr)) {
-                PAL_DBG(LOG_TAG," Returns true for sample rate [%d]", sr);
-                return true;
-            }
-        }
+    if (info != NULL && sr != 0 &&
+        isSampleRateSupported(info->samplingFreqMask, sr)) {
+        PAL_DBG(LOG_TAG," Returns true for sample rate [%d]", sr);
+        return true;
     }
     PAL_ERR(LOG_TAG," Returns false for sample rate [%d]", sr);
     return false;
@@ -1698,7 +1572,6 @@ bool DisplayPort::isSupportedSR(edidAudioInfo* info, int sr)
 
 int DisplayPort::getMaxChannel()
 {
-    int i = 0;
     struct extDispState *state = NULL;
     int max_channel = 2;
     edidAudioInfo *info = NULL;
@@ -1709,36 +1582,25 @@ int DisplayPort::getMaxChannel()
         info = (edidAudioInfo*) state->edidInfo;
     }
 
-    if (info != NULL) {
-        for (i = 0; i < info->audioBlocks && i < MAX_EDID_BLOCKS; i++) {
-            if (info->audioBlocksArray[i].formatId == LPCM) {
-                if (max_channel < info->audioBlocksArray[i].channels) {
-                    max_channel = info->audioBlocksArray[i].channels;
-                    PAL_DBG(LOG_TAG," Max channels updated to [%d]", max_channel);
-                }
-            }
-        }
+    if (info != NULL && max_channel < info->maxLpcmChannels) {
+        max_channel = info->maxLpcmChannels;
+        PAL_DBG(LOG_TAG," Max channels updated to [%d]", max_channel);
     }
     return max_channel;
 }
 
 bool DisplayPort::isSupportedBps(edidAudioInfo* info, int bps)
 {
-    int i = 0;
-
     if (bps == 16) {
         //16 bit bps is always supported
         //some oem may not update 16bit support in their edid info
         return true;
     }
 
-    if (info != NULL && bps != 0) {
-        for (i = 0; i < info->audioBlocks && i < MAX_EDID_BLOCKS; i++) {
-            if (isSupportedBps(info->audioBlocksArray[i].bitsPerSampleBitmask, bps)) {
-                PAL_VERBOSE(LOG_TAG," returns true for bit width [%d]", bps);
-                return true;
-            }
-        }
+    if (info != NULL && bps != 0 &&
+        isSupportedBps(info->bitsPerSampleMask, bps)) {
+        PAL_VERBOSE(LOG_TAG," returns true for bit width [%d]", bps);
+        return true;
     }
     PAL_VERBOSE(LOG_TAG," returns false for bit width [%d]", bps);
     return false;
@@ -1746,9 +1608,7 @@ bool DisplayPort::isSupportedBps(edidAudioInfo* info, int bps)
 
 int DisplayPort::getHighestSupportedSR()
 {
-    int sr = 0;
     int highestSR = 0;
-    int i;
     struct extDispState *state = NULL;
     edidAudioInfo *info = NULL;
 
@@ -1759,11 +1619,7 @@ int DisplayPort::getHighestSupportedSR()
     }
 
     if (info != NULL) {
-        for (i = 0; i < info->audioBlocks && i < MAX_EDID_BLOCKS; i++) {
-          sr = getHighestEdidSF(info->audioBlocksArray[i].samplingFreqBitmask);
-          if (sr > highestSR)
-            highestSR = sr;
-        }
+        highestSR = info->highestSR;
     }
     else {
         PAL_ERR(LOG_TAG," info is NULL");
@@ -1781,9 +1637,7 @@ int DisplayPort::getHighestSupportedSR()
 
 int DisplayPort::getHighestSupportedBps()
 {
-    int bpsMask = 0;
     int highestBps = 0;
-    int i;
     struct extDispState *state = NULL;
     edidAudioInfo *info = NULL;
 
@@ -1793,18 +1647,8 @@ int DisplayPort::getHighestSupportedBps()
         info = (edidAudioInfo*) state->edidInfo;
     }
 
-    if (info != NULL) {
-        for (i = 0; i < info->audioBlocks && i < MAX_EDID_BLOCKS; i++) {
-            bpsMask = info->audioBlocksArray[i].bitsPerSampleBitmask;
-            if (isSupportedBps(bpsMask, 24)) {
-                highestBps = 24;
-                break;
-            }
-            else if (isSupportedBps(bpsMask, BITWIDTH_16))
-                if (highestBps < BITWIDTH_16)
-                    highestBps = BITWIDTH_16;
-        }
-    }
+    if (info != NULL)
+        highestBps = info->highestBps;
 
     if (highestBps == 0) {
         PAL_ERR(LOG_TAG, "None of the supported BPS is highest");
@@ -79,6 +79,7 @@
 
 #define PAL_SP_XMAX_TMAX_DATA_PATH "/data/vendor/audio/spkr_xmax_tmax.txt"
 #define PAL_SP_XMAX_TMAX_LOG_PATH "/data/vendor/audio/log_spkr_xmax_tmax.cal"
+#define SPKR_XMAX_TMAX_MAX_RETRY 5
 #define FEEDBACK_MONO_1 "-mono-1"
 
 #define MIN_SPKR_IDLE_SEC (60 * 30)
@@ -148,6 +149,7 @@ uint32_t SpeakerProtection::vi_miid_II;
 uint32_t SpeakerProtection::vi_miid_I;
 struct pal_device_info SpeakerProtection::vi_device;
 struct pal_device_info SpeakerProtection::cps_device;
+SpkrTelemetry SpeakerProtection::xmaxTmaxTelemetry;
 int SpeakerProtection::calibrationCallbackStatus;
 int SpeakerProtection::numberOfRequest;
 bool SpeakerProtection::mDspCallbackRcvd;
@@ -356,10 +358,26 @@ int SpeakerProtection::getCpsDevNumber(std::string mixer_name)
     return status;
 }
 
-int SpeakerProtection::getSpeakerTemperature(int spkr_pos)
+int SpeakerProtection::initTempSampler()
 {
-    struct mixer_ctl *ctl;
+    std::vector<std::string> ctlNames;
     std::string mixer_ctl_name;
+
+    for (int i = 0; i < numberOfChannels; i++) {
+        mixer_ctl_name = rm->getSpkrTempCtrl(i);
+        if (mixer_ctl_name.empty()) {
+            PAL_DBG(LOG_TAG, "Using default mixer control");
+            mixer_ctl_name = getDefaultSpkrTempCtrl(i);
+        }
+        ctlNames.push_back(mixer_ctl_name);
+    }
+
+    PAL_DBG(LOG_TAG, "audio_mixer %pK", hwMixer);
+    return tempSampler.init(hwMixer, ctlNames);
+}
+
+int SpeakerProtection::getSpeakerTemperature(int spkr_pos)
+{
     int status = 0;
     /**
      * It is assumed that for Mono speakers only right speaker will be there.
@@ -367,22 +385,13 @@ int SpeakerProtection::getSpeakerTemperature(int spkr_pos)
      * TODO: Get the channel from RM.xml
      */
     PAL_DBG(LOG_TAG, "Enter Speaker Get Temperature %d", spkr_pos);
-    mixer_ctl_name = rm->getSpkrTempCtrl(spkr_pos);
-    if (mixer_ctl_name.empty()) {
-        PAL_DBG(LOG_TAG, "Using default mixer control");
-        mixer_ctl_name = getDefaultSpkrTempCtrl(spkr_pos);
-    }
-
-    PAL_DBG(LOG_TAG, "audio_mixer %pK", hwMixer);
-
-    ctl = mixer_get_ctl_by_name(hwMixer, mixer_ctl_name.c_str());
-    if (!ctl) {
-        PAL_ERR(LOG_TAG, "Invalid mixer control: %s\n", mixer_ctl_name.c_str());
-        status = -EINVAL;
-        return status;
+    if (!tempSampler.isInitialized()) {
+        status = initTempSampler();
+        if (status)
+            return status;
     }
 
-    status = mixer_ctl_get_value(ctl, 0);
+    status = tempSampler.getTemperature(spkr_pos);
 
     PAL_DBG(LOG_TAG, "Exiting Speaker Get Temperature %d", status);
 
@@ -1203,14 +1212,15 @@ exit:
 void SpeakerProtection::getSpeakerTemperatureList()
 {
     int i = 0;
-    int value;
     PAL_DBG(LOG_TAG, "Enter Speaker Get Temperature List");
 
-    for(i = 0; i < numberOfChannels; i++) {
-         value = getSpeakerTemperature(i);
-         PAL_DBG(LOG_TAG, "Temperature %d ", value);
-         spkerTempList[i] = value;
-    }
+    if (!tempSampler.isInitialized())
+        initTempSampler();
+
+    // all channels are read in one pass, or served from a recent sample
+    tempSampler.getTemperatures(spkerTempList, numberOfChannels);
+    for(i = 0; i < numberOfChannels; i++)
+         PAL_DBG(LOG_TAG, "Temperature %d ", spkerTempList[i]);
     PAL_DBG(LOG_TAG, "Exit Speaker Get Temperature List");
 }
 
@@ -1247,14 +1257,14 @@ void SpeakerProtection::spkrCalibrationThread()
             PAL_DBG(LOG_TAG, "Getting temperature of speakers");
             getSpeakerTemperatureList();
 
-            for (i = 0; i < numberOfChannels; i++) {
-                if ((spkerTempList[i] != -EINVAL) &&
-                    (spkerTempList[i] < TZ_TEMP_MIN_THRESHOLD ||
-                     spkerTempList[i] > TZ_TEMP_MAX_THRESHOLD)) {
-                    PAL_ERR(LOG_TAG, "Temperature out of range. Retry");
-                    spkrCalibrateWait();
-                    continue;
-                }
+            if (!tempSampler.isInRange(TZ_TEMP_MIN_THRESHOLD,
+                                       TZ_TEMP_MAX_THRESHOLD)) {
+                PAL_ERR(LOG_TAG, "Temperature out of range. Retry");
+                // sleep until the temperature moves, the speaker state
+                // changes or the thread is asked to exit; nothing else
+                // samples while the speaker is idle, so re-read on timeout
+                tempSampler.waitForChange(WAKEUP_MIN_IDLE_CHECK);
+                continue;
             }
             for (i = 0; i < numberOfChannels; i++) {
                 // Converting to Q6 format
@@ -1313,6 +1323,10 @@ SpeakerProtection::SpeakerProtection(struct pal_device *device,
     FILE *fp = NULL;
 
     spkerTempList = NULL;
+    xmaxTmaxCtl = NULL;
+    xmaxTmaxQuery = NULL;
+    xmaxTmaxResp = NULL;
+    xmaxTmaxPayloadSize = 0;
 
     if (ResourceManager::spQuickCalTime > 0 &&
         ResourceManager::spQuickCalTime < MIN_SPKR_IDLE_SEC)
@@ -1391,6 +1405,9 @@ exit:
 
 SpeakerProtection::~SpeakerProtection()
 {
+    threadExit = true;
+    tempSampler.wakeWaiters();
+
     if (spkerTempList)
         delete[] spkerTempList;
 
@@ -1401,50 +1418,52 @@ SpeakerProtection::~SpeakerProtection()
     customPayloadSize = 0;
 }
 
-int32_t SpeakerProtection::getSpkrXmaxTmaxData()
+/*
+ * Resolves the getParam control of the RX front end and builds the Xmax/Tmax
+ * query once, so that each sample of the logging thread is a plain set/get.
+ */
+int32_t SpeakerProtection::prepareSpkrXmaxTmaxQuery()
 {
     const char* getParamControl = "getParam";
+    /* Front ends used for speaker playback when no session can be queried */
+    const int legacyRxFeIds[] = {125, 105};
     char* pcmDeviceName = NULL;
-    uint8_t* payload = NULL;
     int ret = 0;
-    uint32_t miid = 0, num_ch = 0, stringLen =0;
-    int32_t pcmID = -EINVAL;
-    size_t payloadSize = 0, bytesWritten = -1;
-    struct mixer_ctl* ctl;
-    FILE* fp;
+    uint32_t miid = 0;
+    int pcmID = -EINVAL;
+    struct mixer_ctl* ctl = NULL;
     std::ostringstream cntrlName;
     std::string backendName;
+    std::shared_ptr<Device> dev = nullptr;
+    std::vector<Stream*> activeStreams;
+    Session *session = NULL;
     param_id_sp_tmax_xmax_logging_t sp_xmax_tmax;
-    param_id_sp_tmax_xmax_logging_t* sp_xmax_tmax_value;
-    PayloadBuilder* builder = new PayloadBuilder();
-
-    /* Frontend ID information for RX Session presents at SessionAlsaPCM/Compress
-     * In Kalama, there is no getter func for pcmDevIds (private attribute)
-     * Assuming there will be only one session. So hardcoded here*/
-
-    pcmID = 125;
-    pcmDeviceName = rm->getDeviceNameFromID(pcmID);
+    PayloadBuilder builder;
 
-    if (pcmDeviceName == NULL) {
-        /*To check for PAL_STREAM_COMPRESSED*/
-        pcmID = 105;
-        pcmDeviceName = rm->getDeviceNameFromID(pcmID);
-    }
-
-    if (pcmDeviceName) {
+    dev = Device::getInstance(&mDeviceAttr, rm);
+    /* keeps the stream and its session from being closed while queried */
+    rm->lockActiveStream();
+    ret = rm->getActiveStream(activeStreams, dev);
+    if ((0 == ret) && (activeStreams.size() != 0)) {
+        activeStreams[0]->getAssociatedSession(&session);
+        if (session)
+            ctl = session->getFEMixerCtl(getParamControl, &pcmID, PAL_AUDIO_OUTPUT);
+    }
+    rm->unlockActiveStream();
+
+    for (size_t i = 0; !ctl && i < sizeof(legacyRxFeIds) / sizeof(legacyRxFeIds[0]); i++) {
+        pcmDeviceName = rm->getDeviceNameFromID(legacyRxFeIds[i]);
+        if (!pcmDeviceName)
+            continue;
+        pcmID = legacyRxFeIds[i];
+        cntrlName.str("");
         cntrlName << pcmDeviceName << " " << getParamControl;
+        ctl = mixer_get_ctl_by_name(virtMixer, cntrlName.str().data());
     }
-    else {
-        PAL_ERR(LOG_TAG, "Error: %d Unable to get Device name\n", -EINVAL);
-        ret = -EINVAL;
-        goto exit;
-    }
-
-    ctl = mixer_get_ctl_by_name(virtMixer, cntrlName.str().data());
 
     if (!ctl) {
         ret = -ENOENT;
-        PAL_ERR(LOG_TAG, "Error: %d Invalid mixer control: %s\n", ret, cntrlName.str().data());
+        PAL_ERR(LOG_TAG, "Error: %d Unable to get RX getParam control", ret);
         goto exit;
     }
 
@@ -1465,99 +1484,103 @@ int32_t SpeakerProtection::getSpkrXmaxTmaxData()
     }
 
     sp_xmax_tmax.num_ch = vi_device.channels;
-    builder->payloadSPConfig(&payload, &payloadSize, miid,
+    builder.payloadSPConfig(&xmaxTmaxQuery, &xmaxTmaxPayloadSize, miid,
         PARAM_ID_SP_TMAX_XMAX_LOGGING, (void *) &sp_xmax_tmax);
 
-    if (!payloadSize) {
+    if (!xmaxTmaxPayloadSize) {
         PAL_ERR(LOG_TAG, "Payload memory allocation failed");
         ret = -EINVAL;
         goto exit;
     }
 
-    ret = mixer_ctl_set_array(ctl, payload, payloadSize);
+    xmaxTmaxResp = (uint8_t *)calloc(1, xmaxTmaxPayloadSize);
+    if (!xmaxTmaxResp) {
+        PAL_ERR(LOG_TAG, "Response memory allocation failed");
+        ret = -ENOMEM;
+        goto exit;
+    }
+    xmaxTmaxCtl = ctl;
+    PAL_DBG(LOG_TAG, "Xmax/Tmax query prepared on pcm %d, miid %x", pcmID, miid);
+
+exit:
+    if (ret)
+        releaseSpkrXmaxTmaxQuery();
+    return ret;
+}
+
+void SpeakerProtection::releaseSpkrXmaxTmaxQuery()
+{
+    if (xmaxTmaxQuery)
+        free(xmaxTmaxQuery);
+    if (xmaxTmaxResp)
+        free(xmaxTmaxResp);
+
+    xmaxTmaxQuery = NULL;
+    xmaxTmaxResp = NULL;
+    xmaxTmaxPayloadSize = 0;
+    xmaxTmaxCtl = NULL;
+}
+
+int32_t SpeakerProtection::getSpkrXmaxTmaxData()
+{
+    int ret = 0;
+    param_id_sp_tmax_xmax_logging_t* sp_xmax_tmax_value;
+
+    if (!xmaxTmaxCtl) {
+        ret = prepareSpkrXmaxTmaxQuery();
+        if (0 != ret)
+            return ret;
+    }
+
+    ret = mixer_ctl_set_array(xmaxTmaxCtl, xmaxTmaxQuery, xmaxTmaxPayloadSize);
     if (0 != ret) {
         PAL_ERR(LOG_TAG, "Set failed with return value = %d", ret);
         goto exit;
     }
 
-    memset(payload, 0, payloadSize);
+    memset(xmaxTmaxResp, 0, xmaxTmaxPayloadSize);
 
-    ret = mixer_ctl_get_array(ctl, payload, payloadSize);
+    ret = mixer_ctl_get_array(xmaxTmaxCtl, xmaxTmaxResp, xmaxTmaxPayloadSize);
     if (0 != ret) {
         PAL_ERR(LOG_TAG, "Get failed with return value = %d", ret);
         goto exit;
     }
-    else {
-        sp_xmax_tmax_value = (param_id_sp_tmax_xmax_logging_t*)(payload +
-            sizeof(struct apm_module_param_data_t));
-        fp = fopen(PAL_SP_XMAX_TMAX_DATA_PATH, "a");
-
-        if (!fp) {
-            PAL_ERR(LOG_TAG, "Unable to open file for write");
-            ret = -EBADF;
-            goto exit;
-        }
-        else {
-            num_ch = sp_xmax_tmax_value->num_ch;
-            auto currentTime = std::chrono::system_clock::now();
-            std::time_t currentTimeT = std::chrono::system_clock::to_time_t(currentTime);
-            const char* currentTimeStr = std::ctime(&currentTimeT);
-            stringLen = std::strlen(currentTimeStr);
-
-            PAL_DBG(LOG_TAG, "Current Timestamp : %s and size of string : %d", currentTimeStr, stringLen);
-            bytesWritten = fprintf(fp, "%s ", currentTimeStr);
 
-            if (bytesWritten < 0) {
-                PAL_ERR(LOG_TAG, "Error in writing to file");
-                fclose(fp);
-                ret = -EBADF;
-                goto exit;
-            }
+    sp_xmax_tmax_value = (param_id_sp_tmax_xmax_logging_t*)(xmaxTmaxResp +
+        sizeof(struct apm_module_param_data_t));
+    xmaxTmaxTelemetry.push(sp_xmax_tmax_value);
 
-            for (int i = 0; i < num_ch; i++) {
-                PAL_DBG(LOG_TAG, "Channel: %d, Max Excursion Value =%d",i, sp_xmax_tmax_value->tmax_xmax_params[i].max_excursion);
-                bytesWritten = fprintf(fp, "Ch: %d <Xmax> : %3.4f", i, (float)sp_xmax_tmax_value->tmax_xmax_params[i].max_excursion / (1 << 27));
+    // text conversion is batched, a failed flush does not stop sampling
+    if (xmaxTmaxTelemetry.flush(false))
+        PAL_ERR(LOG_TAG, "Failed to flush Xmax/Tmax samples");
 
-                if (bytesWritten < 0) {
-                    PAL_ERR(LOG_TAG, "Error in writing to file");
-                    fclose(fp);
-                    ret = -EBADF;
-                    goto exit;
-                }
+exit:
+    // the front end may have changed, resolve it again on next sample
+    if (ret)
+        releaseSpkrXmaxTmaxQuery();
+    return ret;
+}
 
-                PAL_DBG(LOG_TAG, "Channel: %d, Max Temperature Value =%d",i, sp_xmax_tmax_value->tmax_xmax_params[i].max_temperature);
-                bytesWritten = fprintf(fp, " <Tmax> : %3.4f ", (float)sp_xmax_tmax_value->tmax_xmax_params[i].max_temperature / (1 << 22));
+/* fills the pal_param_sp_xmax_tmax_stats_t buffer *param points to */
+int32_t SpeakerProtection::getSpkrXmaxTmaxStats(void **param)
+{
+    pal_param_sp_xmax_tmax_stats_t *stats = NULL;
 
-                if (bytesWritten < 0) {
-                    PAL_ERR(LOG_TAG, "Error in writing to file");
-                    fclose(fp);
-                    ret = -EBADF;
-                    goto exit;
-                }
-            }
-            bytesWritten = fprintf(fp, "\n");
-            if (bytesWritten < 0) {
-                PAL_ERR(LOG_TAG, "Error in writing to file");
-                fclose(fp);
-                ret = -EBADF;
-                goto exit;
-            }
-            fclose(fp);
-        }
+    if (!param || !*param) {
+        PAL_ERR(LOG_TAG, "Invalid Xmax/Tmax stats buffer");
+        return -EINVAL;
     }
-exit:
-    if (builder) {
-        delete builder;
-        builder = NULL;
-    }
-    return ret;
+    stats = (pal_param_sp_xmax_tmax_stats_t *)*param;
+    xmaxTmaxTelemetry.getStats(stats);
 
+    return sizeof(pal_param_sp_xmax_tmax_stats_t);
 }
 
 void SpeakerProtection::startSpkrXmaxTmaxLogging()
 {
     FILE* log_fp = NULL;
     int32_t ret = 0;
+    int failures = 0;
 
     PAL_DBG(LOG_TAG, "Enter");
 
@@ -1574,14 +1597,28 @@ void SpeakerProtection::startSpkrXmaxTmaxLogging()
         PAL_DBG(LOG_TAG, "log_spkr_xmax_tmax file deleted successfully");
     }
 
+    ret = xmaxTmaxTelemetry.open(PAL_SP_XMAX_TMAX_DATA_PATH);
+    if (ret != 0) {
+        PAL_ERR(LOG_TAG, "Failed to open %s, ret %d", PAL_SP_XMAX_TMAX_DATA_PATH, ret);
+        return;
+    }
     startXmaxLogging = true;
-    while (startXmaxLogging && (ret == 0)) {
+    while (startXmaxLogging) {
         ret = getSpkrXmaxTmaxData();
         if (ret != 0) {
-            PAL_ERR(LOG_TAG, "Failed to get Param for spkr_xmax_tmax");
+            /* the query is re-resolved on the next sample */
+            if (++failures >= SPKR_XMAX_TMAX_MAX_RETRY) {
+                PAL_ERR(LOG_TAG, "spkr_xmax_tmax failed %d times, stop logging", failures);
+                break;
+            }
+            PAL_ERR(LOG_TAG, "Failed to get Param for spkr_xmax_tmax, retry %d", failures);
+        } else {
+            failures = 0;
         }
         std::this_thread::sleep_for(std::chrono::milliseconds(1000));
     }
+    xmaxTmaxTelemetry.close();
+    releaseSpkrXmaxTmaxQuery();
 }
 
 /*
@@ -1822,6 +1859,8 @@ int32_t SpeakerProtection::spkrProtProcessingMode(bool flag)
         customPayload = NULL;
 
         spkrProtSetSpkrStatus(flag);
+        // the calibration thread re-evaluates speaker usage when woken
+        tempSampler.wakeWaiters();
         // Speaker in use. Start the Processing Mode
         rm = ResourceManager::getInstance();
         if (!rm) {
@@ -2674,6 +2713,8 @@ cps_dev_setup:
             goto exit;
         }
         spkrProtSetSpkrStatus(flag);
+        // the calibration thread re-evaluates speaker usage when woken
+        tempSampler.wakeWaiters();
         // Speaker not in use anymore. Stop the processing mode
         startXmaxLogging = false;
 
@@ -3282,6 +3323,9 @@ int32_t SpeakerProtection::getParameter(uint32_t param_id, void **param)
         case PAL_PARAM_ID_SP_MODE:
             status = getFTMParameter(param);
         break;
+        case PAL_PARAM_ID_SP_XMAX_TMAX_STATS:
+            status = getSpkrXmaxTmaxStats(param);
+        break;
         default :
             PAL_ERR(LOG_TAG, "Unsupported operation");
             status = -EINVAL;
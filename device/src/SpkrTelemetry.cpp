@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#define LOG_TAG "PAL: SpkrTelemetry"
+
+#include "SpkrTelemetry.h"
+#include "PalCommon.h"
+#include <errno.h>
+#include <limits.h>
+
+SpkrTelemetry::SpkrTelemetry()
+{
+    head = 0;
+    tail = 0;
+    fp = NULL;
+    lastFlushMs = 0;
+    numSamples = 0;
+    numDropped = 0;
+    numFlushed = 0;
+    numFlushErrors = 0;
+    numCh = 0;
+    for (int i = 0; i < PAL_SP_XMAX_TMAX_MAX_CH; i++) {
+        lastXmax[i] = 0;
+        lastTmax[i] = 0;
+        peakXmax[i] = INT_MIN;
+        peakTmax[i] = INT_MIN;
+    }
+}
+
+SpkrTelemetry::~SpkrTelemetry()
+{
+    close();
+}
+
+uint64_t SpkrTelemetry::getTimeMs()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+int SpkrTelemetry::open(const char *path)
+{
+    close();
+
+    fp = fopen(path, "a");
+    if (!fp) {
+        PAL_ERR(LOG_TAG, "Unable to open %s for write", path);
+        return -EBADF;
+    }
+
+    head = 0;
+    tail = 0;
+    lastFlushMs = getTimeMs();
+    numSamples = 0;
+    numDropped = 0;
+    numFlushed = 0;
+    numFlushErrors = 0;
+    numCh = 0;
+    for (int i = 0; i < PAL_SP_XMAX_TMAX_MAX_CH; i++) {
+        lastXmax[i] = 0;
+        lastTmax[i] = 0;
+        peakXmax[i] = INT_MIN;
+        peakTmax[i] = INT_MIN;
+    }
+    return 0;
+}
+
+void SpkrTelemetry::close()
+{
+    if (!fp)
+        return;
+
+    flush(true);
+    fclose(fp);
+    fp = NULL;
+}
+
+void SpkrTelemetry::push(const param_id_sp_tmax_xmax_logging_t *value)
+{
+    struct sample *s = NULL;
+    uint32_t ch = value->num_ch;
+
+    if (ch > PAL_SP_XMAX_TMAX_MAX_CH)
+        ch = PAL_SP_XMAX_TMAX_MAX_CH;
+
+    // ring full, overwrite the oldest sample not flushed yet
+    if (head - tail == SPKR_TELEMETRY_RING_SIZE) {
+        tail++;
+        numDropped++;
+    }
+
+    s = &ring[head % SPKR_TELEMETRY_RING_SIZE];
+    s->timestamp = time(NULL);
+    s->num_ch = ch;
+    for (uint32_t i = 0; i < ch; i++) {
+        s->max_excursion[i] = value->tmax_xmax_params[i].max_excursion;
+        s->max_temperature[i] = value->tmax_xmax_params[i].max_temperature;
+
+        lastXmax[i].store(s->max_excursion[i], std::memory_order_relaxed);
+        lastTmax[i].store(s->max_temperature[i], std::memory_order_relaxed);
+        if (s->max_excursion[i] > peakXmax[i].load(std::memory_order_relaxed))
+            peakXmax[i].store(s->max_excursion[i], std::memory_order_relaxed);
+        if (s->max_temperature[i] > peakTmax[i].load(std::memory_order_relaxed))
+            peakTmax[i].store(s->max_temperature[i], std::memory_order_relaxed);
+    }
+    head++;
+    numCh.store(ch, std::memory_order_relaxed);
+    numSamples.fetch_add(1, std::memory_order_release);
+}
+
+int SpkrTelemetry::writeSample(const struct sample *s)
+{
+    char timeStr[32] = {0};
+
+    if (!ctime_r(&s->timestamp, timeStr))
+        timeStr[0] = '\0';
+
+    if (fprintf(fp, "%s ", timeStr) < 0)
+        return -EBADF;
+
+    for (uint32_t i = 0; i < s->num_ch; i++) {
+        if (fprintf(fp, "Ch: %d <Xmax> : %3.4f <Tmax> : %3.4f ", i,
+                    (float)s->max_excursion[i] / (1 << 27),
+                    (float)s->max_temperature[i] / (1 << 22)) < 0)
+            return -EBADF;
+    }
+
+    if (fprintf(fp, "\n") < 0)
+        return -EBADF;
+
+    return 0;
+}
+
+int SpkrTelemetry::flush(bool force)
+{
+    int ret = 0;
+    uint32_t pending = head - tail;
+    uint64_t now = 0;
+
+    if (!fp || !pending)
+        return 0;
+
+    now = getTimeMs();
+    if (!force && pending < SPKR_TELEMETRY_FLUSH_BATCH &&
+        now - lastFlushMs < SPKR_TELEMETRY_FLUSH_INTERVAL_MS)
+        return 0;
+
+    while (tail != head) {
+        ret = writeSample(&ring[tail % SPKR_TELEMETRY_RING_SIZE]);
+        if (ret)
+            break;
+        tail++;
+        numFlushed++;
+    }
+
+    if (!ret && fflush(fp))
+        ret = -EBADF;
+
+    if (ret) {
+        PAL_ERR(LOG_TAG, "Error in writing to file, dropping %u samples",
+                head - tail);
+        numDropped += head - tail;
+        numFlushErrors++;
+        tail = head;
+    }
+    lastFlushMs = now;
+
+    return ret;
+}
+
+void SpkrTelemetry::getStats(pal_param_sp_xmax_tmax_stats_t *stats) const
+{
+    stats->num_samples = numSamples.load(std::memory_order_acquire);
+    stats->num_dropped = numDropped.load(std::memory_order_relaxed);
+    stats->num_flushed = numFlushed.load(std::memory_order_relaxed);
+    stats->num_flush_errors = numFlushErrors.load(std::memory_order_relaxed);
+    stats->num_ch = numCh.load(std::memory_order_relaxed);
+    for (uint32_t i = 0; i < PAL_SP_XMAX_TMAX_MAX_CH; i++) {
+        bool valid = stats->num_samples && i < stats->num_ch;
+
+        stats->last_xmax_q27[i] = lastXmax[i].load(std::memory_order_relaxed);
+        stats->last_tmax_q22[i] = lastTmax[i].load(std::memory_order_relaxed);
+        stats->peak_xmax_q27[i] = valid ?
+                peakXmax[i].load(std::memory_order_relaxed) : 0;
+        stats->peak_tmax_q22[i] = valid ?
+                peakTmax[i].load(std::memory_order_relaxed) : 0;
+    }
+}
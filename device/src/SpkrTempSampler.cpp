@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#define LOG_TAG "PAL: SpkrTempSampler"
+
+#include "SpkrTempSampler.h"
+#include "PalCommon.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <time.h>
+
+SpkrTempSampler::SpkrTempSampler()
+{
+    mixer = NULL;
+    sampledMs = 0;
+    generation = 0;
+    wakeups = 0;
+    outOfRange = false;
+}
+
+uint64_t SpkrTempSampler::getTimeMs()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+int SpkrTempSampler::init(struct mixer *mixer,
+                          const std::vector<std::string> &ctlNames)
+{
+    std::lock_guard<std::mutex> lck(lock);
+    struct mixer_ctl *ctl = NULL;
+    int numValid = 0;
+
+    if (!mixer || ctlNames.empty()) {
+        PAL_ERR(LOG_TAG, "Invalid mixer or no temperature controls");
+        return -EINVAL;
+    }
+
+    this->mixer = mixer;
+    ctls.clear();
+    for (auto &name : ctlNames) {
+        ctl = mixer_get_ctl_by_name(mixer, name.c_str());
+        if (!ctl) {
+            PAL_ERR(LOG_TAG, "Invalid mixer control: %s", name.c_str());
+        } else {
+            numValid++;
+        }
+        ctls.push_back(ctl);
+    }
+    cache.assign(ctls.size(), -EINVAL);
+    reported.assign(ctls.size(), -EINVAL);
+    sampledMs = 0;
+    outOfRange = false;
+
+    PAL_DBG(LOG_TAG, "%d of %zu temperature controls resolved", numValid,
+            ctls.size());
+    return numValid ? 0 : -EINVAL;
+}
+
+bool SpkrTempSampler::isInitialized()
+{
+    std::lock_guard<std::mutex> lck(lock);
+
+    return mixer != NULL;
+}
+
+int SpkrTempSampler::sample_l(bool force)
+{
+    uint64_t now = getTimeMs();
+    bool changed = false;
+
+    if (!mixer)
+        return -EINVAL;
+
+    if (!force && sampledMs && now - sampledMs < SPKR_TEMP_CACHE_MS)
+        return 0;
+
+    for (size_t i = 0; i < ctls.size(); i++) {
+        cache[i] = ctls[i] ? mixer_ctl_get_value(ctls[i], 0) : -EINVAL;
+        if (reported[i] == -EINVAL || cache[i] == -EINVAL ||
+            abs(cache[i] - reported[i]) >= SPKR_TEMP_HYSTERESIS) {
+            if (cache[i] != reported[i])
+                changed = true;
+            reported[i] = cache[i];
+        }
+    }
+    sampledMs = now;
+
+    if (changed) {
+        generation++;
+        cond.notify_all();
+    }
+    return 0;
+}
+
+int SpkrTempSampler::getTemperatures(int *temps, int numCh, bool force)
+{
+    std::lock_guard<std::mutex> lck(lock);
+    int status = 0;
+
+    status = sample_l(force);
+    for (int i = 0; i < numCh; i++)
+        temps[i] = (status || (size_t)i >= cache.size()) ? -EINVAL : cache[i];
+
+    return status;
+}
+
+int SpkrTempSampler::getTemperature(int ch)
+{
+    int temp = -EINVAL;
+    std::lock_guard<std::mutex> lck(lock);
+
+    if (!sample_l(false) && ch >= 0 && (size_t)ch < cache.size())
+        temp = cache[ch];
+
+    return temp;
+}
+
+bool SpkrTempSampler::isInRange(int minTemp, int maxTemp)
+{
+    std::lock_guard<std::mutex> lck(lock);
+    bool inRange = true;
+
+    if (sample_l(false))
+        return false;
+
+    // once out of range, only leave that state well inside the limits
+    if (outOfRange) {
+        minTemp += SPKR_TEMP_HYSTERESIS;
+        maxTemp -= SPKR_TEMP_HYSTERESIS;
+    }
+
+    for (size_t i = 0; i < cache.size(); i++) {
+        if (cache[i] != -EINVAL && (cache[i] < minTemp || cache[i] > maxTemp)) {
+            PAL_DBG(LOG_TAG, "Channel %zu temperature %d out of [%d, %d]", i,
+                    cache[i], minTemp, maxTemp);
+            inRange = false;
+        }
+    }
+    outOfRange = !inRange;
+
+    return inRange;
+}
+
+bool SpkrTempSampler::waitForChange(uint32_t timeoutMs)
+{
+    std::unique_lock<std::mutex> lck(lock);
+    uint32_t gen = generation;
+    uint32_t wake = wakeups;
+    auto woken = [&] { return generation != gen || wakeups != wake; };
+
+    if (cond.wait_for(lck, std::chrono::milliseconds(timeoutMs), woken))
+        return generation != gen;
+
+    // nobody sampled meanwhile, take a fresh reading before giving up
+    sample_l(true);
+    return generation != gen;
+}
+
+void SpkrTempSampler::wakeWaiters()
+{
+    std::lock_guard<std::mutex> lck(lock);
+
+    wakeups++;
+    cond.notify_all();
+}
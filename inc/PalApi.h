@@ -331,6 +331,47 @@ ssize_t pal_stream_read(pal_stream_handle_t *stream_handle, struct pal_buffer *b
   */
 ssize_t pal_stream_write(pal_stream_handle_t *stream_handle, struct pal_buffer *buf);
 
+/**
+  * Read audio buffers captured in the audio stream into an array
+  * of buffers. The buffers are filled in order under one stream
+  * validation and stream lock, each as by pal_stream_read. The
+  * capture timestamp of each buffer is populated if session was
+  * opened with timestamp flag.
+  *
+  * \param[in] stream_handle - Valid stream handle obtained
+  *       from pal_stream_open
+  * \param[in] bufs - array of pal_buffer to be filled with audio
+  *       samples and metadata.
+  * \param[in] count - number of buffers in bufs.
+  * \param[out] sizes - array of count entries, receives the number
+  *       of bytes read into each buffer.
+  *
+  * \return number of buffers read or error code if none was read.
+  */
+ssize_t pal_stream_readv(pal_stream_handle_t *stream_handle, struct pal_buffer *bufs,
+                         uint32_t count, ssize_t *sizes);
+
+/**
+  * Write an array of audio buffers of a stream for rendering.
+  * The buffers are written in order under one stream validation
+  * and stream lock, each as by pal_stream_write. Small buffers of
+  * PCM streams may be merged into one driver write; PCM writes do
+  * not take buffer timestamps, so none is lost by merging.
+  *
+  * \param[in] stream_handle - Valid stream handle obtained
+  *       from pal_stream_open
+  * \param[in] bufs - array of pal_buffer containing audio samples
+  *       and metadata.
+  * \param[in] count - number of buffers in bufs.
+  * \param[out] sizes - array of count entries, receives the number
+  *       of bytes written from each buffer.
+  *
+  * \return number of buffers written or error code if none was
+  *       written.
+  */
+ssize_t pal_stream_writev(pal_stream_handle_t *stream_handle, struct pal_buffer *bufs,
+                          uint32_t count, ssize_t *sizes);
+
 /**
   * \brief get current device on stream.
   *
@@ -969,6 +969,14 @@ typedef enum {
     PAL_PARAM_ID_ULTRASOUND_RAMPDOWN = 62,
     PAL_PARAM_ID_VOLUME_CTRL_RAMP = 63,
     PAL_PARAM_ID_ULTRASOUND_SET_GAIN = 64,
+    PAL_PARAM_ID_ST_ENGINE_ARENA_STATS = 65,
+    PAL_PARAM_ID_ST_DETECTION_LATENCY = 66,
+    PAL_PARAM_ID_SP_XMAX_TMAX_STATS = 67,
+    PAL_PARAM_ID_ST_MERGE_CACHE_STATS = 68,
+    PAL_PARAM_ID_WARM_GRAPH_POOL_STATS = 69,
+    PAL_PARAM_ID_SPAN_TRACE = 70,
+    PAL_PARAM_ID_STREAM_READY_FD = 71,
+    PAL_PARAM_ID_POWER_VOTE_STATS = 72,
 } pal_param_id_type_t;
 
 /** HDMI/DP */
@@ -1045,6 +1053,142 @@ typedef struct pal_param_mspp_linear_gain {
     int32_t gain;
 } pal_param_mspp_linear_gain_t;
 
+/* Payload For ID: PAL_PARAM_ID_ST_ENGINE_ARENA_STATS
+ * Description   : get detection buffer allocation counters, summed over
+ *                 all engines attached to a sound trigger stream
+*/
+typedef struct pal_param_st_arena_stats {
+    uint64_t alloc_count;    /* heap allocations done by the arenas */
+    uint64_t reuse_count;    /* requests served without allocation */
+    uint32_t reserved_size;  /* bytes currently held by the arenas */
+} pal_param_st_arena_stats_t;
+
+/* Stages of a voice activation detection recorded by the latency tracer */
+typedef enum {
+    PAL_ST_TRACE_DSP_EVENT = 0,     /* detection event received from DSP */
+    PAL_ST_TRACE_EVENT_PARSED,      /* detection payload parsed */
+    PAL_ST_TRACE_EVENT_THREAD,      /* engine event thread picked it up */
+    PAL_ST_TRACE_FIRST_STAGE_DONE,  /* first stage result given to stream */
+    PAL_ST_TRACE_SECOND_STAGE_DONE, /* last second stage result received */
+    PAL_ST_TRACE_CLIENT_NOTIFIED,   /* recognition callback invoked */
+    PAL_ST_TRACE_LAB_FIRST_READ,    /* first LAB data returned to client */
+    PAL_ST_TRACE_STAGE_MAX,
+} pal_st_trace_stage_t;
+
+/* Payload For ID: PAL_PARAM_ID_ST_DETECTION_LATENCY
+ * Description   : get detection latency of a sound trigger stream over
+ *                 its recent detections. All values are in microseconds
+ *                 measured from PAL_ST_TRACE_DSP_EVENT.
+*/
+typedef struct pal_param_st_latency_stats {
+    uint32_t num_notified;    /* detections notified to client */
+    uint32_t num_lab_read;    /* detections followed by a LAB read */
+    uint64_t notify_p50_us;
+    uint64_t notify_p99_us;
+    uint64_t lab_p50_us;
+    uint64_t lab_p99_us;
+    /* stage offsets of the last detection, 0 if a stage was not reached */
+    uint64_t last_stage_us[PAL_ST_TRACE_STAGE_MAX];
+} pal_param_st_latency_stats_t;
+
+/* Payload For ID: PAL_PARAM_ID_ST_MERGE_CACHE_STATS
+ * Description   : get merged sound model cache statistics of the GSL engine
+ *                 a sound trigger stream is attached to.
+*/
+typedef struct pal_param_st_merge_cache_stats {
+    uint32_t hits;            /* model set changes served from cache */
+    uint32_t misses;          /* model set changes merged by SML */
+    uint32_t evictions;
+    uint32_t num_entries;
+    uint32_t num_merges;      /* SML merge/delete operations timed */
+    uint64_t total_merge_us;
+    uint64_t max_merge_us;
+} pal_param_st_merge_cache_stats_t;
+
+/* Payload For ID: PAL_PARAM_ID_WARM_GRAPH_POOL_STATS
+ * Description   : get statistics of the pool of prepared graphs kept
+ *                 for reopening recently closed PCM streams.
+*/
+typedef struct pal_param_warm_graph_pool_stats {
+    uint32_t num_graphs;      /* graphs currently parked */
+    uint32_t parked;
+    uint32_t hits;            /* opens served from the pool */
+    uint32_t misses;          /* opens of enabled stream types set up cold */
+    uint32_t evictions;       /* graphs closed to stay within the budget */
+    uint32_t expirations;     /* graphs closed after the grace period */
+    uint32_t invalidations;   /* graphs closed on SSR or resource pressure */
+    uint64_t open_us_saved;   /* estimated from cold open/prepare times */
+} pal_param_warm_graph_pool_stats_t;
+
+#define PAL_SPAN_TRACE_PATH_LEN 128
+
+/* Payload For ID: PAL_PARAM_ID_SPAN_TRACE
+ * Description   : start or stop recording the nested timing of PAL control
+ *                 operations. Stopping writes the recorded spans as Chrome
+ *                 trace event JSON to the file named by path, which is
+ *                 always created in the PAL_SPAN_TRACE_DIR of the build:
+ *                 /data/vendor/audio/ on Android, /tmp/ on Linux builds.
+*/
+typedef struct pal_param_span_trace {
+    uint32_t enable;
+    char path[PAL_SPAN_TRACE_PATH_LEN]; /* file name without '/' or "..", empty for the default file */
+} pal_param_span_trace_t;
+
+typedef enum {
+    PAL_POWER_VOTE_SLEEPMON_LPI = 0,  /* ADSP sleep monitor LPI activity */
+    PAL_POWER_VOTE_SLEEPMON_NLPI,     /* ADSP sleep monitor activity */
+    PAL_POWER_VOTE_PM_QOS,            /* PM_QOS Vote mixer control */
+    PAL_POWER_VOTE_MAX,
+} pal_power_vote_t;
+
+struct pal_power_vote_counters {
+    uint32_t votes;       /* logical votes of streams */
+    uint32_t unvotes;
+    uint32_t pushed;      /* votes pushed to the driver */
+    uint32_t released;    /* releases pushed to the driver */
+    uint32_t suppressed;  /* logical transitions not pushed */
+    uint32_t active;      /* logical votes currently held */
+};
+
+/* Payload For ID: PAL_PARAM_ID_POWER_VOTE_STATS
+ * Description   : get the counters of the aggregated DSP power votes,
+ *                 indexed by pal_power_vote_t.
+*/
+typedef struct pal_param_power_vote_stats {
+    struct pal_power_vote_counters vote[PAL_POWER_VOTE_MAX];
+} pal_param_power_vote_stats_t;
+
+/* Payload For ID: PAL_PARAM_ID_STREAM_READY_FD
+ * Description   : get the eventfd of a PCM stream opened with
+ *                 PAL_STREAM_FLAG_NON_BLOCKING. It becomes readable once
+ *                 io that returned -EAGAIN or a short count can make
+ *                 progress, and on stop. The client reads it to rearm and
+ *                 must not close it, it is valid until pal_stream_close.
+*/
+typedef struct pal_param_stream_ready_fd {
+    int32_t fd;
+} pal_param_stream_ready_fd_t;
+
+#define PAL_SP_XMAX_TMAX_MAX_CH 4
+
+/* Payload For ID: PAL_PARAM_ID_SP_XMAX_TMAX_STATS
+ * Description   : get speaker protection Xmax/Tmax telemetry of the current
+ *                 logging session. Excursion values are in Q27 and
+ *                 temperature values in Q22 as reported by the SP module.
+ *                 The caller provides the buffer *param_payload points to.
+*/
+typedef struct pal_param_sp_xmax_tmax_stats {
+    uint64_t num_samples;     /* samples read from the SP module */
+    uint64_t num_dropped;     /* samples overwritten before being flushed */
+    uint64_t num_flushed;     /* samples written to the log file */
+    uint32_t num_flush_errors;
+    uint32_t num_ch;
+    int32_t last_xmax_q27[PAL_SP_XMAX_TMAX_MAX_CH];
+    int32_t last_tmax_q22[PAL_SP_XMAX_TMAX_MAX_CH];
+    int32_t peak_xmax_q27[PAL_SP_XMAX_TMAX_MAX_CH];
+    int32_t peak_tmax_q22[PAL_SP_XMAX_TMAX_MAX_CH];
+} pal_param_sp_xmax_tmax_stats_t;
+
 
 /* Payload For ID: PAL_PARAM_ID_DEVICE_CAPABILITY
  * Description   : get Device Capability
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef MIXER_EVENT_DISPATCHER_H
+#define MIXER_EVENT_DISPATCHER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define MIXER_EVENT_QUEUE_DEPTH 32
+
+typedef void (*session_callback)(uint64_t hdl, uint32_t event_id, void *event_data,
+                uint32_t event_size, uint32_t miid);
+
+struct mixer_event_dispatch_stats {
+    uint64_t dispatched;
+    uint64_t dropped;
+    uint64_t total_latency_us;
+    uint64_t max_latency_us;
+};
+
+/*
+ * One registered (callback, cookie) pair. Events for it are queued in a
+ * single producer/single consumer ring filled by the mixer event thread
+ * and drained by a worker thread of its own, so a slow handler only
+ * delays its own events. The worker is started on the first event and
+ * exits once the subscriber is stopped. requestStop() only keeps new
+ * events from being delivered, so it may be called with a lock the handler
+ * takes; join() then waits for the worker and must not be.
+ */
+class MixerEventSubscriber : public std::enable_shared_from_this<MixerEventSubscriber>
+{
+public:
+    MixerEventSubscriber(session_callback cb, uint64_t cookie);
+    ~MixerEventSubscriber();
+
+    /* takes ownership of buf, which holds an agm_event_cb_params */
+    bool post(void *buf);
+    void requestStop();
+    bool isFinished() const;
+    void join();
+    void stop();
+    bool matches(session_callback cb, uint64_t cookie) const {
+        return cb_ == cb && cookie_ == cookie;
+    }
+    session_callback getCallback() const { return cb_; }
+    void getStats(struct mixer_event_dispatch_stats *stats) const;
+
+private:
+    struct queued_event {
+        void *buf;
+        uint64_t enqueue_ns;
+    };
+
+    static void workerLoop(std::shared_ptr<MixerEventSubscriber> self);
+    bool pop(struct queued_event *ev);
+    void flush();
+
+    session_callback cb_;
+    uint64_t cookie_;
+    struct queued_event queue_[MIXER_EVENT_QUEUE_DEPTH];
+    std::atomic<uint32_t> head_;
+    std::atomic<uint32_t> tail_;
+    std::atomic<bool> started_;
+    std::atomic<bool> exit_;
+    std::atomic<bool> finished_;
+    std::thread worker_;
+    std::mutex worker_mutex_;
+    std::mutex wait_mutex_;
+    std::condition_variable cv_;
+    std::atomic<uint64_t> dispatched_;
+    std::atomic<uint64_t> dropped_;
+    std::atomic<uint64_t> total_latency_us_;
+    std::atomic<uint64_t> max_latency_us_;
+};
+
+typedef std::map<int, std::shared_ptr<MixerEventSubscriber>> mixer_event_sub_map_t;
+
+/*
+ * Routes AGM mixer events by pcm id to their subscriber. The pcm id to
+ * subscriber table is copy-on-write: registration builds a new table and
+ * publishes it atomically, and the mixer event thread only reads
+ * snapshots, so it never waits on registration. Deregistration doesn't
+ * wait for a handler in progress either: removed subscribers are retired
+ * and their workers joined once they have exited, on a later
+ * registration or in stopAll(). As with the synchronous dispatch this
+ * replaces, a handler that already started may still return after
+ * deregisterCallback() did.
+ */
+class MixerEventDispatcher
+{
+public:
+    MixerEventDispatcher();
+    ~MixerEventDispatcher();
+
+    int registerCallback(const std::vector<int> &DevIds, session_callback cb,
+                         uint64_t cookie);
+    int deregisterCallback(const std::vector<int> &DevIds, session_callback cb);
+    /* takes ownership of buf, which holds an agm_event_cb_params */
+    int dispatch(int pcm_id, void *buf);
+    void getStats(struct mixer_event_dispatch_stats *stats);
+    void stopAll();
+
+private:
+    std::shared_ptr<const mixer_event_sub_map_t> getTable();
+    void retireUnreferenced_l(const mixer_event_sub_map_t &old_table,
+                              const mixer_event_sub_map_t &new_table);
+    void reapRetired_l();
+
+    std::shared_ptr<const mixer_event_sub_map_t> table_;
+    std::vector<std::shared_ptr<MixerEventSubscriber>> retired_;
+    struct mixer_event_dispatch_stats retired_stats_;
+    std::mutex update_mutex_;
+};
+
+#endif // MIXER_EVENT_DISPATCHER_H
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef MIXER_PATH_PLANNER_H
+#define MIXER_PATH_PLANNER_H
+
+#include <expat.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <tinyalsa/asoundlib.h>
+
+/*
+ * Precompiled mixer paths. Each path of the mixer paths xml is flattened
+ * once, nested paths included, into a plan of (control handle, target
+ * values). Applying or resetting a path only writes the controls whose
+ * last written value differs from the target; controls that cannot be
+ * read back have no known value and are always written. Reset walks the
+ * plan in reverse, like audio_route.
+ *
+ * Once initialized the planner has to be the only writer of path controls,
+ * so all named paths go through enableDevice()/disableDevice(); audio_route
+ * is still used to parse and apply the initial mixer state, and as fallback
+ * if the planner could not be initialized.
+ */
+class MixerPathPlanner
+{
+public:
+    static std::shared_ptr<MixerPathPlanner> getInstance();
+    MixerPathPlanner();
+    ~MixerPathPlanner() {}
+    MixerPathPlanner(const MixerPathPlanner &) = delete;
+    MixerPathPlanner & operator=(const MixerPathPlanner &) = delete;
+
+    /* to be called after audio_route_init() applied the initial state */
+    int init(struct mixer *mixer, const char *xmlFile);
+    void deinit();
+    bool isInitialized();
+    /* -ENODEV if not initialized, -EINVAL for unknown paths */
+    int applyPath(const char *name);
+    int resetPath(const char *name);
+    /* control writes issued and avoided since init */
+    void getStats(uint32_t *numTransitions, uint32_t *numWrites,
+                  uint32_t *numSkipped);
+
+private:
+    struct control {
+        struct mixer_ctl *ctl;
+        enum mixer_ctl_type type;
+        std::vector<int> resetValues;
+        std::vector<int> applied;
+        /* applied is only trusted while known, never for unreadable controls */
+        bool readable;
+        bool known;
+    };
+    struct setting {
+        uint32_t ctl;
+        std::vector<int> values;
+        std::vector<bool> mask;
+    };
+    typedef std::vector<struct setting> plan_t;
+
+    static void startTag(void *userdata, const XML_Char *tag,
+                         const XML_Char **attr);
+    static void endTag(void *userdata, const XML_Char *tag);
+    int parse(const char *xmlFile);
+    int getControl(const char *name, uint32_t *index);
+    void addSetting(plan_t &plan, const char *name, const char *id,
+                    const char *value);
+    void includePath(plan_t &plan, const char *name);
+    int runPlan(const char *name, bool reset);
+    int writeControl(struct control &c, const std::vector<int> &values,
+                     const std::vector<bool> &mask);
+
+    static std::shared_ptr<MixerPathPlanner> instance;
+    std::mutex lock;
+    struct mixer *mixer;
+    std::vector<struct control> controls;
+    std::map<std::string, uint32_t> controlIndex;
+    std::map<std::string, plan_t> plans;
+    /* parser state */
+    std::string curPath;
+    int depth;
+    bool initialized;
+    uint32_t numTransitions;
+    uint32_t numWrites;
+    uint32_t numSkipped;
+};
+
+#endif //MIXER_PATH_PLANNER_H
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef PAL_EXECUTOR_H
+#define PAL_EXECUTOR_H
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#define PAL_EXECUTOR_WORKERS 2
+#define PAL_EXECUTOR_BLOCKING_WORKERS 2
+/* 1 ms ticks, 64 slots per level: 64 ms, 4 s, 4 min and 4.7 h wheels */
+#define PAL_EXECUTOR_WHEEL_BITS 6
+#define PAL_EXECUTOR_WHEEL_SLOTS (1 << PAL_EXECUTOR_WHEEL_BITS)
+#define PAL_EXECUTOR_WHEEL_LEVELS 4
+
+/*
+ * PAL wide executor for deferred work and notifications that used to run
+ * on a mostly idle thread per object. Tasks are posted with a key, usually
+ * the posting object; tasks of one key run one at a time in posting order,
+ * tasks of different keys run concurrently on a fixed worker pool. Delayed
+ * tasks are kept in a hierarchical timer wheel, the timer thread sleeps
+ * until the next expiry and does not wake up while no timer is armed.
+ * Threads are started on first use. Tasks on the shared instance must not
+ * block for long; work that does, such as stopping a detection stream on
+ * the DSP or calling back into a client, goes to the blocking instance so
+ * it cannot hold up the timers and tasks of everybody else. An object
+ * doing blocking reads keeps its own thread.
+ */
+class PalExecutor
+{
+public:
+    typedef std::function<void()> task_t;
+
+    static std::shared_ptr<PalExecutor> getInstance();
+    static std::shared_ptr<PalExecutor> getBlockingInstance();
+    PalExecutor(uint32_t numWorkers = PAL_EXECUTOR_WORKERS);
+    ~PalExecutor();
+    PalExecutor(const PalExecutor &) = delete;
+    PalExecutor & operator=(const PalExecutor &) = delete;
+
+    void deinit();
+    void post(const void *key, task_t task);
+    /* returns the timer id to cancel the task with, never 0 */
+    uint64_t postDelayed(const void *key, uint32_t delayMs, task_t task);
+    /* false if the timer already fired or was cancelled */
+    bool cancelTimer(uint64_t id);
+    /*
+     * Drops the queued tasks and armed timers of the key and waits for its
+     * running task, unless called from that task. Call it before the key
+     * object goes away, without holding locks its tasks take.
+     */
+    void cancel(const void *key);
+
+private:
+    struct timer {
+        uint64_t id;
+        const void *key;
+        uint64_t expiry;
+        uint32_t level;
+        uint32_t slot;
+        task_t task;
+    };
+
+    struct strand {
+        std::deque<task_t> tasks;
+        bool running = false;
+        std::thread::id runner;
+    };
+
+    uint64_t nowTick();
+    void startWorkers_l();
+    void post_l(const void *key, task_t task);
+    void addTimer_l(std::list<struct timer> &from,
+                    std::list<struct timer>::iterator it);
+    void cascade_l(uint32_t level);
+    void advance_l(uint64_t tick);
+    bool nextExpiry_l(uint64_t &tick);
+    void timerLoop();
+    void workerLoop();
+
+    static std::shared_ptr<PalExecutor> instance;
+    static std::shared_ptr<PalExecutor> blockingInstance;
+    uint32_t numWorkers;
+    std::mutex lock;
+    std::condition_variable timerCv;
+    std::condition_variable workCv;
+    std::condition_variable idleCv;
+    std::thread timerThread;
+    std::vector<std::thread> workers;
+    bool exitThreads;
+    std::chrono::steady_clock::time_point epoch;
+    uint64_t curTick;
+    uint64_t nextTimerId;
+    std::list<struct timer> wheel[PAL_EXECUTOR_WHEEL_LEVELS][PAL_EXECUTOR_WHEEL_SLOTS];
+    std::unordered_map<uint64_t, std::list<struct timer>::iterator> timers;
+    std::unordered_map<const void *, struct strand> strands;
+    /* keys with queued tasks and no task running */
+    std::deque<const void *> ready;
+};
+
+#endif //PAL_EXECUTOR_H
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef PAL_VOTE_AGGREGATOR_H
+#define PAL_VOTE_AGGREGATOR_H
+
+#include "PalDefs.h"
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <stdint.h>
+
+/* a released vote is pushed only if no stream votes again meanwhile */
+#define PAL_VOTE_RELEASE_DELAY_MS 100
+/* a pushed vote stays applied at least this long */
+#define PAL_VOTE_MIN_HOLD_MS 500
+/* a failed push is retried this often, the release delay apart */
+#define PAL_VOTE_PUSH_RETRIES 3
+
+/*
+ * Reference counts the logical votes of streams for one power resource,
+ * such as the ADSP sleep monitor activity or the PM QoS vote, and pushes
+ * only net state changes. The first vote is pushed right away, the release
+ * of the last one is deferred on the PalExecutor by the release delay and
+ * the rest of the minimum hold time, so start/stop churn does not toggle
+ * the DSP power state. Callers keep their logical vote when a push fails,
+ * so a failed push is retried for the driver state to match the votes.
+ */
+class PalVoteAggregator
+{
+public:
+    /* pushes the state to the driver, called with the aggregator lock held */
+    typedef std::function<int(bool enable)> apply_t;
+
+    PalVoteAggregator(const char *name, apply_t apply);
+    ~PalVoteAggregator();
+    PalVoteAggregator(const PalVoteAggregator &) = delete;
+    PalVoteAggregator & operator=(const PalVoteAggregator &) = delete;
+
+    int vote(bool enable);
+    void getStats(struct pal_power_vote_counters *stats);
+
+private:
+    /* pushes the net state if it differs from the applied one */
+    void update(uint32_t seq);
+    int push_l(bool enable);
+
+    const char *name;
+    apply_t apply;
+    std::mutex lock;
+    int32_t count;
+    bool applied;
+    uint64_t releaseTimer;
+    uint32_t releaseSeq;
+    uint32_t retries;
+    std::chrono::steady_clock::time_point appliedAt;
+    struct pal_power_vote_counters counters;
+};
+
+#endif //PAL_VOTE_AGGREGATOR_H
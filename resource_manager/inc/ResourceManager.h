@@ -55,9 +55,12 @@
 #include "PalDefs.h"
 #include "ChargerListener.h"
 #include "SndCardMonitor.h"
+#include "MixerEventDispatcher.h"
 #include "ContextManager.h"
 #include "SoundTriggerPlatformInfo.h"
 #include "SignalHandler.h"
+#include "PalVoteAggregator.h"
+#include "StreamConcurrencyState.h"
 
 typedef enum {
     RX_HOSTLESS = 1,
@@ -84,6 +87,9 @@ typedef enum {
 #define AUDIO_PARAMETER_KEY_UPD_DUTY_CYCLE "upd_duty_cycle_enable"
 #define AUDIO_PARAMETER_KEY_UPD_VIRTUAL_PORT "upd_virtual_port"
 #define AUDIO_PARAMETER_KEY_SPKR_XMAX_TMAX_LOG "spkr_xmax_tmax_logging_enable"
+#define AUDIO_PARAMETER_KEY_WARM_GRAPH_POOL_STREAMS "warm_graph_pool_streams"
+#define AUDIO_PARAMETER_KEY_WARM_GRAPH_POOL_SIZE "warm_graph_pool_size"
+#define AUDIO_PARAMETER_KEY_WARM_GRAPH_POOL_TIMEOUT "warm_graph_pool_timeout_ms"
 #define MAX_PCM_NAME_SIZE 50
 #define MAX_STREAM_INSTANCES (sizeof(uint64_t) << 3)
 #define MIN_USECASE_PRIORITY 0xFFFFFFFF
@@ -359,8 +365,6 @@ enum NTStreamTypes_t : uint32_t {
     NT_PATH_DECODE
 };
 
-typedef void (*session_callback)(uint64_t hdl, uint32_t event_id, void *event_data,
-                uint32_t event_size, uint32_t miid);
 bool isPalPCMFormat(uint32_t fmt_id);
 
 typedef void* (*adm_init_t)();
@@ -471,6 +475,9 @@ private:
     void onVUIStreamRegistered();
     void onVUIStreamDeregistered();
     int setUltrasoundGain(pal_ultrasound_gain_t gain, Stream *s);
+    void updateConcurrencyState_l(Stream *s, bool registered);
+    void updateDeviceConcurrencyState_l(std::shared_ptr<Device> d, Stream *s,
+                                        bool registered);
 protected:
     std::list <Stream*> mActiveStreams;
     std::list <StreamPCM*> active_streams_ll;
@@ -496,6 +503,7 @@ protected:
     std::vector <std::shared_ptr<Device>> plugin_devices_;
     std::vector <pal_device_id_t> avail_devices_;
     std::map<Stream*, std::pair<uint32_t, bool>> mActiveStreamUserCounter;
+    StreamConcurrencyState concState;
     bool bOverwriteFlag;
     bool screen_state_ = true;
     bool charging_state_;
@@ -510,7 +518,6 @@ protected:
     static std::mutex mGraphMutex;
     static std::mutex mActiveStreamMutex;
     static std::mutex mValidStreamMutex;
-    static std::mutex mSleepMonitorMutex;
     static std::mutex mListFrontEndsMutex;
     static int snd_virt_card;
     static int snd_hw_card;
@@ -551,6 +558,12 @@ protected:
     static std::map<std::string, int> spkrPosTable;
     static std::map<int, std::string> spkrTempCtrlsMap;
     static std::map<uint32_t, uint32_t> btSlimClockSrcMap;
+    /* resource manager xml kept in memory until its lazy sections are parsed */
+    static std::shared_ptr<const std::string> xmlBuf;
+    static std::string xmlRootTag;
+    static size_t xmlPrologEnd;
+    static std::map<std::string, std::vector<std::pair<size_t, size_t>>> xmlLazySections;
+    static std::recursive_mutex xmlSectionMutex;
     static std::vector<deviceIn> deviceInfo;
     static std::vector<tx_ecinfo> txEcInfo;
     static struct vsid_info vsidInfo;
@@ -562,6 +575,9 @@ protected:
     /* condition variable for which ssrHandlerLoop will wait */
     static std::condition_variable cv;
     static std::mutex cvMutex;
+    /* condition variable signalled on sound card state change */
+    static std::condition_variable cardStateCv;
+    static std::mutex cardStateMutex;
     static std::queue<card_status_t> msgQ;
     static std::thread workerThread;
     std::vector<std::pair<std::string, InstanceListNode_t>> STInstancesLists;
@@ -579,14 +595,16 @@ protected:
     static int wake_unlock_fd;
     static uint32_t wake_lock_cnt;
     static bool lpi_logging_;
-    std::map<int, std::pair<session_callback, uint64_t>> mixerEventCallbackMap;
+    MixerEventDispatcher mixerEventDispatcher;
     static std::thread mixerEventTread;
     std::shared_ptr<CaptureProfile> SoundTriggerCaptureProfile;
     ResourceManager();
     ContextManager *ctxMgr;
-    int32_t lpi_counter_;
-    int32_t nlpi_counter_;
     int sleepmon_fd_;
+    /* aggregated DSP power votes, indexed by pal_power_vote_t */
+    std::array<std::shared_ptr<PalVoteAggregator>, PAL_POWER_VOTE_MAX> mPowerVotes;
+    int pushSleepMonitorVote(uint32_t command);
+    int setPmQosMixerCtl(bool enable);
     static std::map<group_dev_config_idx_t, std::shared_ptr<group_dev_config_t>> groupDevConfigMap;
     std::array<std::shared_ptr<nonTunnelInstMap_t>, DEFAULT_NT_SESSION_TYPE_COUNT> mNTStreamInstancesList;
     int32_t scoOutConnectCount = 0;
@@ -598,6 +616,8 @@ public:
     static bool mixerClosed;
     enum card_status_t cardState;
     bool ssrStarted = false;
+    /* waits up to timeoutUs, returns early once the sound card is online */
+    void waitForCardOnline(uint32_t timeoutUs);
     /* Variable to cache a2dp suspended state for a2dp device */
     static bool a2dp_suspended;
     /* Variable to store whether Speaker protection is enabled or not */
@@ -681,6 +701,7 @@ public:
     adm_request_focus_v2_1_t  admRequestFocus_v2_1Fn = NULL;
     void *admData = NULL;
     void *admLibHdl = NULL;
+    std::once_flag admLibOnce;
     static void *cl_lib_handle;
     static cl_init_t cl_init;
     static cl_deinit_t cl_deinit;
@@ -743,11 +764,14 @@ public:
     static void getFileNameExtn(const char* in_snd_card_name, char* file_name_extn,
                                 char* file_name_extn_wo_variant);
     int init_audio();
+    /* loads the ADM library once, on first use by a session */
     void loadAdmLib();
     static int init();
     static void deinit();
     static std::shared_ptr<ResourceManager> getInstance();
     static int XmlParser(std::string xmlFile);
+    static int XmlSectionParser(std::string xmlFile);
+    static void loadXmlSection(const char *section);
     static void updatePcmId(int32_t deviceId, int32_t pcmId);
     static void updateLinkName(int32_t deviceId, std::string linkName);
     static void updateSndName(int32_t deviceId, std::string sndName);
@@ -900,6 +924,10 @@ public:
     static void processBTCodecInfo(const XML_Char **attr, const int attr_count);
     static void startTag(void *userdata __unused, const XML_Char *tag_name, const XML_Char **attr);
     static void snd_data_handler(void *userdata, const XML_Char *s, int len);
+    static int indexXmlSections(const std::string &xml,
+            std::map<std::string, std::vector<std::pair<size_t, size_t>>> &sections);
+    static int parseXmlSections(const std::string &xml,
+            const std::vector<std::pair<size_t, size_t>> &ranges);
     static void processDeviceIdProp(struct xml_userdata *data, const XML_Char *tag_name);
     static void processDeviceCapability(struct xml_userdata *data, const XML_Char *tag_name);
     static void process_group_device_config(struct xml_userdata *data, const char* tag, const char** attr);
@@ -919,6 +947,7 @@ public:
     static int setSignalHandlerEnableParam(struct str_parms *parms,char *value, int len);
     static int setMuxconfigEnableParam(struct str_parms *parms,char *value, int len);
     static int setSpkrXmaxTmaxLoggingParam(struct str_parms* parms, char* value, int len);
+    static int setWarmGraphPoolParams(struct str_parms *parms, char *value, int len);
     static bool isLpiLoggingEnabled();
     static void processConfigParams(const XML_Char **attr);
     static bool isValidDevId(int deviceId);
@@ -937,6 +966,8 @@ public:
     static bool isBtScoDevice(pal_device_id_t id);
     static bool isBtDevice(pal_device_id_t id);
     int32_t a2dpSuspend(pal_device_id_t dev_id);
+    void waitForStalePcmDrained(std::vector<std::tuple<Stream *, uint64_t, uint32_t>> &streams,
+                                uint32_t maxLatencyMs);
     int32_t a2dpResume(pal_device_id_t dev_id);
     int32_t a2dpCaptureSuspend(pal_device_id_t dev_id);
     int32_t a2dpCaptureResume(pal_device_id_t dev_id);
@@ -982,6 +1013,7 @@ public:
     bool doDevAttrDiffer(struct pal_device *inDevAttr,
                          struct pal_device *curDevAttr);
     int32_t voteSleepMonitor(Stream *str, bool vote, bool force_nlpi_vote = false);
+    int32_t votePmQos(bool vote);
     bool checkAndUpdateDeferSwitchState(bool stream_active);
     static uint32_t palFormatToBitwidthLookup(const pal_audio_fmt_t format);
     void chargerListenerFeatureInit();
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef SSR_ORCHESTRATOR_H
+#define SSR_ORCHESTRATOR_H
+
+#include <functional>
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+#define SSR_RESTORE_MAX_WORKERS 4
+
+class Stream;
+class ResourceManager;
+
+/*
+ * Restores streams after the sound card came back online. Streams are
+ * split into groups that have to be restored in order: streams sharing a
+ * device, the voice call streams, the detection streams sharing the
+ * capture path and TX streams with the RX streams they take their echo
+ * reference from. Groups are restored concurrently on up to
+ * SSR_RESTORE_MAX_WORKERS threads, streams within a group in the order
+ * they were registered, except that a TX stream restarts after the RX
+ * streams it takes its echo reference from.
+ */
+class SsrOrchestrator
+{
+public:
+    /* what the grouping needs to know about a stream */
+    struct streamInfo {
+        /* 0, or the class of streams restored in order with each other */
+        int restoreClass;
+        std::vector<int> deviceIds;
+        /* indices of the RX streams this TX stream takes its EC ref from */
+        std::vector<size_t> ecRefs;
+    };
+
+    /*
+     * The caller holds the user counter of each stream and must not hold
+     * the active stream lock; the counters are released once restored.
+     */
+    static void restoreStreams(std::shared_ptr<ResourceManager> rm,
+                               const std::vector<Stream *> &streams);
+    /* splits streams into groups of indices, each in restore order */
+    static void planGroups(const std::vector<streamInfo> &streams,
+                           std::vector<std::vector<size_t>> &groups);
+    /* restores the groups concurrently, returns the number of workers */
+    static size_t runGroups(const std::vector<std::vector<size_t>> &groups,
+                            std::function<void(size_t)> restore);
+
+private:
+    static void getStreamInfo(std::shared_ptr<ResourceManager> rm,
+                              const std::vector<Stream *> &streams,
+                              std::vector<streamInfo> &infos);
+    static void restoreStream(std::shared_ptr<ResourceManager> rm, Stream *str);
+};
+
+#endif //SSR_ORCHESTRATOR_H
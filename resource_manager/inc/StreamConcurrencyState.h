@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef STREAM_CONCURRENCY_STATE_H
+#define STREAM_CONCURRENCY_STATE_H
+
+#include "PalDefs.h"
+#include <list>
+#include <map>
+#include <set>
+#include <stdint.h>
+#include <unordered_map>
+
+class Stream;
+class Device;
+
+/*
+ * Registered streams and device users counted by stream type, direction
+ * and device, with the streams of each type and the TX streams kept in
+ * registration order. Kept in step with mActiveStreams and active_devices
+ * by ResourceManager, so the validity and concurrency checks neither walk
+ * the stream lists nor query the attributes of every stream. Streams and
+ * devices are only used as keys, the caller provides the locking.
+ */
+struct StreamConcurrencyState {
+    struct streamInfo {
+        pal_stream_type_t type;
+        bool isTx;
+        bool isWfdTx;
+        std::list<Stream*>::iterator typePos;
+        std::list<Stream*>::iterator txPos;
+    };
+
+    /* returns false if the stream is tracked already */
+    bool addStream(Stream *s, const struct pal_stream_attributes *attr);
+    /* returns false if the stream is not tracked */
+    bool removeStream(Stream *s);
+    void addDeviceUser(Device *d, int deviceId, Stream *s);
+    void removeDeviceUser(Device *d, int deviceId, Stream *s);
+    /*
+     * Streams counted against the session limit of a stream type, grouped
+     * the way ResourceManager::registerStream lists them.
+     */
+    uint32_t numSessions(pal_stream_type_t type) const;
+
+    std::unordered_map<Stream*, struct streamInfo> streams;
+    std::list<Stream*> byType[PAL_STREAM_MAX];
+    std::list<Stream*> txStreams;
+    uint32_t numByType[PAL_STREAM_MAX] = {};
+    uint32_t numTx = 0;
+    uint32_t numRx = 0;
+    uint32_t numWfdTx = 0;
+    std::set<std::pair<Device*, Stream*>> deviceUsers;
+    std::map<int, uint32_t> numByDevice;
+};
+
+#endif //STREAM_CONCURRENCY_STATE_H
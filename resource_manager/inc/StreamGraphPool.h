@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef STREAM_GRAPH_POOL_H
+#define STREAM_GRAPH_POOL_H
+
+#include <chrono>
+#include <condition_variable>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include <tinyalsa/asoundlib.h>
+#include "PalDefs.h"
+
+#define WARM_GRAPH_POOL_DEFAULT_SIZE 2
+#define WARM_GRAPH_POOL_DEFAULT_TIMEOUT_MS 3000
+
+/*
+ * Front end, graph configuration and prepared pcm of a closed session,
+ * identified by the KVs and backends the graph was set up with.
+ */
+struct warmGraph {
+    std::string key;
+    struct pal_stream_attributes sAttr;
+    int lDirection;
+    std::vector<int> pcmDevIds;
+    std::vector<std::pair<int32_t, std::string>> backEnds;
+    struct pcm *pcm;
+    struct pcm_config config;
+    std::chrono::steady_clock::time_point expiry;
+};
+
+/*
+ * Opt-in pool of recently closed PCM graphs. A session closing a stream
+ * type enabled for the pool parks its graph instead of tearing it down;
+ * a matching open within the grace period takes it over and skips the
+ * KV population, metadata and pcm_open/prepare steps. Graphs are closed
+ * on expiry, LRU eviction, SSR or front end shortage, and when another
+ * session frees the device metadata of one of their backends. The backend media
+ * config is part of the key, so a graph is never taken over by a session
+ * whose devices run at a different config.
+ */
+class StreamGraphPool
+{
+public:
+    static std::shared_ptr<StreamGraphPool> getInstance();
+    StreamGraphPool();
+    ~StreamGraphPool();
+    StreamGraphPool(const StreamGraphPool &) = delete;
+    StreamGraphPool & operator=(const StreamGraphPool &) = delete;
+
+    void deinit();
+    void setStreamTypes(const std::vector<uint32_t> &types);
+    void setBudget(uint32_t maxGraphs);
+    void setGracePeriod(uint32_t ms);
+    bool isEnabled(pal_stream_type_t type);
+    /* false if the caller has to close the graph itself */
+    bool park(struct warmGraph &graph);
+    bool take(const std::string &key, struct warmGraph &graph);
+    /* returns the number of graphs closed */
+    uint32_t invalidate(const char *reason);
+    uint32_t invalidateBackEnd(const std::string &backEnd, const char *reason);
+    void recordColdOpen(pal_stream_type_t type, uint64_t us);
+    void recordColdPrepare(pal_stream_type_t type, uint64_t us);
+    void recordWarmPrepare(pal_stream_type_t type);
+    void getStats(pal_param_warm_graph_pool_stats_t *stats);
+
+private:
+    struct openCost {
+        uint64_t openUs;
+        uint64_t prepareUs;
+    };
+
+    static void closeGraph(struct warmGraph &graph);
+    void closeGraphs(std::list<struct warmGraph> &graphs);
+    void reaperLoop();
+
+    static std::shared_ptr<StreamGraphPool> instance;
+    std::mutex lock;
+    std::condition_variable cv;
+    std::thread reaper;
+    bool exitReaper;
+    std::set<uint32_t> streamTypes;
+    uint32_t budget;
+    std::chrono::milliseconds gracePeriod;
+    /* most recently parked first */
+    std::list<struct warmGraph> graphs;
+    std::map<uint32_t, struct openCost> coldCost;
+    pal_param_warm_graph_pool_stats_t stats;
+};
+
+#endif //STREAM_GRAPH_POOL_H
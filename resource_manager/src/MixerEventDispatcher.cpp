@@ -0,0 +1,394 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#define LOG_TAG "PAL: MixerEventDispatcher"
+
+#include "MixerEventDispatcher.h"
+
+#include <agm/agm_api.h>
+#include <algorithm>
+#include <set>
+#include <time.h>
+
+#include "PalCommon.h"
+
+static uint64_t getTimeNs()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+MixerEventSubscriber::MixerEventSubscriber(session_callback cb, uint64_t cookie)
+    : cb_(cb),
+      cookie_(cookie),
+      head_(0),
+      tail_(0),
+      started_(false),
+      exit_(false),
+      finished_(false),
+      dispatched_(0),
+      dropped_(0),
+      total_latency_us_(0),
+      max_latency_us_(0)
+{
+    memset(queue_, 0, sizeof(queue_));
+}
+
+MixerEventSubscriber::~MixerEventSubscriber()
+{
+    stop();
+    flush();
+}
+
+bool MixerEventSubscriber::post(void *buf)
+{
+    uint32_t tail = tail_.load(std::memory_order_relaxed);
+
+    if (exit_.load(std::memory_order_acquire) ||
+        tail - head_.load(std::memory_order_acquire) >= MIXER_EVENT_QUEUE_DEPTH) {
+        dropped_++;
+        PAL_ERR(LOG_TAG, "drop event for cookie %llx, %s, %llu dropped",
+                (unsigned long long)cookie_,
+                exit_.load() ? "subscriber stopped" : "queue full",
+                (unsigned long long)dropped_.load());
+        free(buf);
+        return false;
+    }
+
+    queue_[tail % MIXER_EVENT_QUEUE_DEPTH].buf = buf;
+    queue_[tail % MIXER_EVENT_QUEUE_DEPTH].enqueue_ns = getTimeNs();
+    tail_.store(tail + 1, std::memory_order_release);
+
+    if (!started_.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lck(worker_mutex_);
+        if (!started_.load() && !exit_.load()) {
+            worker_ = std::thread(workerLoop, shared_from_this());
+            started_.store(true, std::memory_order_release);
+        }
+    }
+
+    {
+        /* pairs with the predicate check in workerLoop to avoid lost wakeups */
+        std::lock_guard<std::mutex> lck(wait_mutex_);
+    }
+    cv_.notify_one();
+
+    return true;
+}
+
+bool MixerEventSubscriber::pop(struct queued_event *ev)
+{
+    uint32_t head = head_.load(std::memory_order_relaxed);
+
+    if (head == tail_.load(std::memory_order_acquire))
+        return false;
+
+    *ev = queue_[head % MIXER_EVENT_QUEUE_DEPTH];
+    head_.store(head + 1, std::memory_order_release);
+
+    return true;
+}
+
+void MixerEventSubscriber::flush()
+{
+    struct queued_event ev;
+    uint32_t count = 0;
+
+    while (pop(&ev)) {
+        dropped_++;
+        count++;
+        free(ev.buf);
+    }
+    if (count)
+        PAL_ERR(LOG_TAG, "drop %u queued events for cookie %llx, subscriber stopped",
+                count, (unsigned long long)cookie_);
+}
+
+void MixerEventSubscriber::workerLoop(std::shared_ptr<MixerEventSubscriber> self)
+{
+    struct queued_event ev;
+    struct agm_event_cb_params *params = nullptr;
+    uint64_t latency_us = 0;
+    uint64_t max_latency = 0;
+
+    PAL_DBG(LOG_TAG, "Enter, cookie %llx", (unsigned long long)self->cookie_);
+    while (!self->exit_.load(std::memory_order_acquire)) {
+        if (!self->pop(&ev)) {
+            std::unique_lock<std::mutex> lck(self->wait_mutex_);
+            self->cv_.wait(lck, [&self] {
+                return self->exit_.load() ||
+                       self->head_.load() != self->tail_.load();
+            });
+            continue;
+        }
+
+        latency_us = (getTimeNs() - ev.enqueue_ns) / 1000;
+        self->total_latency_us_ += latency_us;
+        max_latency = self->max_latency_us_.load();
+        while (latency_us > max_latency &&
+               !self->max_latency_us_.compare_exchange_weak(max_latency, latency_us));
+
+        if (self->exit_.load(std::memory_order_acquire)) {
+            self->dropped_++;
+            PAL_ERR(LOG_TAG, "drop event for cookie %llx, subscriber stopped",
+                    (unsigned long long)self->cookie_);
+            free(ev.buf);
+            break;
+        }
+
+        params = (struct agm_event_cb_params *)ev.buf;
+        self->cb_(self->cookie_, params->event_id, (void *)params->event_payload,
+                  params->event_payload_size, params->source_module_id);
+        self->dispatched_++;
+        free(ev.buf);
+    }
+    /* count what is left as dropped before the stats are taken on reaping */
+    self->flush();
+    PAL_DBG(LOG_TAG, "Exit, cookie %llx", (unsigned long long)self->cookie_);
+    self->finished_.store(true, std::memory_order_release);
+}
+
+void MixerEventSubscriber::requestStop()
+{
+    {
+        std::lock_guard<std::mutex> lck(worker_mutex_);
+        exit_.store(true, std::memory_order_release);
+    }
+    {
+        std::lock_guard<std::mutex> lck(wait_mutex_);
+    }
+    cv_.notify_one();
+}
+
+/* true once the worker, if it was ever started, has returned */
+bool MixerEventSubscriber::isFinished() const
+{
+    return !started_.load(std::memory_order_acquire) ||
+           finished_.load(std::memory_order_acquire);
+}
+
+void MixerEventSubscriber::join()
+{
+    std::thread worker;
+
+    {
+        std::lock_guard<std::mutex> lck(worker_mutex_);
+        worker = std::move(worker_);
+    }
+
+    if (!worker.joinable())
+        return;
+
+    /* a handler stopping the dispatcher can't wait for itself */
+    if (worker.get_id() == std::this_thread::get_id()) {
+        worker.detach();
+        return;
+    }
+    worker.join();
+}
+
+void MixerEventSubscriber::stop()
+{
+    requestStop();
+    join();
+}
+
+void MixerEventSubscriber::getStats(struct mixer_event_dispatch_stats *stats) const
+{
+    stats->dispatched += dispatched_.load();
+    stats->dropped += dropped_.load();
+    stats->total_latency_us += total_latency_us_.load();
+    if (max_latency_us_.load() > stats->max_latency_us)
+        stats->max_latency_us = max_latency_us_.load();
+}
+
+MixerEventDispatcher::MixerEventDispatcher()
+    : table_(std::make_shared<const mixer_event_sub_map_t>())
+{
+    memset(&retired_stats_, 0, sizeof(retired_stats_));
+}
+
+MixerEventDispatcher::~MixerEventDispatcher()
+{
+    stopAll();
+}
+
+std::shared_ptr<const mixer_event_sub_map_t> MixerEventDispatcher::getTable()
+{
+    return std::atomic_load(&table_);
+}
+
+void MixerEventDispatcher::retireUnreferenced_l(const mixer_event_sub_map_t &old_table,
+                                                const mixer_event_sub_map_t &new_table)
+{
+    bool referenced = false;
+
+    for (auto &old_entry : old_table) {
+        referenced = false;
+        for (auto &new_entry : new_table) {
+            if (new_entry.second == old_entry.second) {
+                referenced = true;
+                break;
+            }
+        }
+        if (referenced)
+            continue;
+        /* one subscriber may be listed for several pcm ids */
+        if (std::find(retired_.begin(), retired_.end(), old_entry.second) !=
+                retired_.end())
+            continue;
+        old_entry.second->requestStop();
+        retired_.push_back(old_entry.second);
+    }
+}
+
+/* join the retired workers that have exited, without waiting for the others */
+void MixerEventDispatcher::reapRetired_l()
+{
+    auto it = retired_.begin();
+
+    while (it != retired_.end()) {
+        if (!(*it)->isFinished()) {
+            it++;
+            continue;
+        }
+        (*it)->join();
+        (*it)->getStats(&retired_stats_);
+        it = retired_.erase(it);
+    }
+}
+
+/* NOTE: there should be only one callback for each pcm id
+ * so when new different callback register with same pcm id
+ * older one will be overwritten
+ */
+int MixerEventDispatcher::registerCallback(const std::vector<int> &DevIds,
+                                           session_callback cb, uint64_t cookie)
+{
+    std::shared_ptr<const mixer_event_sub_map_t> old_table;
+    std::shared_ptr<mixer_event_sub_map_t> new_table;
+    std::shared_ptr<MixerEventSubscriber> sub = nullptr;
+
+    std::lock_guard<std::mutex> lck(update_mutex_);
+    old_table = getTable();
+    new_table = std::make_shared<mixer_event_sub_map_t>(*old_table);
+
+    /* reuse the subscriber if this callback already listens on other pcm ids */
+    for (auto &entry : *new_table) {
+        if (entry.second->matches(cb, cookie)) {
+            sub = entry.second;
+            break;
+        }
+    }
+    if (!sub)
+        sub = std::make_shared<MixerEventSubscriber>(cb, cookie);
+
+    for (int i = 0; i < DevIds.size(); i++) {
+        if (new_table->find(DevIds[i]) != new_table->end())
+            PAL_DBG(LOG_TAG, "callback exists for pcm id %d, overwrite",
+                DevIds[i]);
+        (*new_table)[DevIds[i]] = sub;
+    }
+
+    std::atomic_store(&table_,
+        std::shared_ptr<const mixer_event_sub_map_t>(new_table));
+    retireUnreferenced_l(*old_table, *new_table);
+    reapRetired_l();
+
+    return 0;
+}
+
+int MixerEventDispatcher::deregisterCallback(const std::vector<int> &DevIds,
+                                             session_callback cb)
+{
+    std::shared_ptr<const mixer_event_sub_map_t> old_table;
+    std::shared_ptr<mixer_event_sub_map_t> new_table;
+    mixer_event_sub_map_t::iterator it;
+
+    std::lock_guard<std::mutex> lck(update_mutex_);
+    old_table = getTable();
+    new_table = std::make_shared<mixer_event_sub_map_t>(*old_table);
+
+    for (int i = 0; i < DevIds.size(); i++) {
+        it = new_table->find(DevIds[i]);
+        if (it != new_table->end()) {
+            PAL_DBG(LOG_TAG, "callback found for pcm id %d, remove",
+                DevIds[i]);
+            if (cb == it->second->getCallback()) {
+                new_table->erase(it);
+            } else {
+                PAL_ERR(LOG_TAG, "No matching callback found for pcm id %d",
+                    DevIds[i]);
+            }
+        } else {
+            PAL_ERR(LOG_TAG, "No callback found for pcm id %d", DevIds[i]);
+        }
+    }
+
+    std::atomic_store(&table_,
+        std::shared_ptr<const mixer_event_sub_map_t>(new_table));
+
+    /* no new callback of the removed subscribers starts after this */
+    retireUnreferenced_l(*old_table, *new_table);
+    reapRetired_l();
+
+    return 0;
+}
+
+int MixerEventDispatcher::dispatch(int pcm_id, void *buf)
+{
+    std::shared_ptr<const mixer_event_sub_map_t> table = getTable();
+    mixer_event_sub_map_t::const_iterator it;
+
+    it = table->find(pcm_id);
+    if (it == table->end()) {
+        PAL_ERR(LOG_TAG, "Invalid session callback for pcm id %d", pcm_id);
+        free(buf);
+        return -EINVAL;
+    }
+
+    return it->second->post(buf) ? 0 : -ENOSPC;
+}
+
+void MixerEventDispatcher::getStats(struct mixer_event_dispatch_stats *stats)
+{
+    std::shared_ptr<const mixer_event_sub_map_t> table = getTable();
+    std::set<MixerEventSubscriber *> counted;
+
+    {
+        std::lock_guard<std::mutex> lck(update_mutex_);
+        reapRetired_l();
+        *stats = retired_stats_;
+        for (auto &sub : retired_)
+            sub->getStats(stats);
+    }
+    for (auto &entry : *table) {
+        /* one subscriber may be registered for several pcm ids */
+        if (counted.insert(entry.second.get()).second)
+            entry.second->getStats(stats);
+    }
+}
+
+void MixerEventDispatcher::stopAll()
+{
+    std::shared_ptr<const mixer_event_sub_map_t> old_table;
+    std::vector<std::shared_ptr<MixerEventSubscriber>> retired;
+
+    {
+        std::lock_guard<std::mutex> lck(update_mutex_);
+        old_table = getTable();
+        std::atomic_store(&table_,
+            std::make_shared<const mixer_event_sub_map_t>());
+        retired.swap(retired_);
+    }
+
+    /* teardown: unlike deregistration, wait for the handlers in progress */
+    for (auto &entry : *old_table)
+        entry.second->stop();
+    for (auto &sub : retired)
+        sub->stop();
+}
@@ -0,0 +1,446 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#define LOG_TAG "PAL: MixerPathPlanner"
+
+#include "MixerPathPlanner.h"
+#include "PalCommon.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+std::shared_ptr<MixerPathPlanner> MixerPathPlanner::instance = nullptr;
+
+std::shared_ptr<MixerPathPlanner> MixerPathPlanner::getInstance()
+{
+    static std::mutex instanceLock;
+    std::lock_guard<std::mutex> lck(instanceLock);
+
+    if (!instance)
+        instance = std::make_shared<MixerPathPlanner>();
+
+    return instance;
+}
+
+MixerPathPlanner::MixerPathPlanner()
+{
+    mixer = NULL;
+    depth = 0;
+    initialized = false;
+    numTransitions = 0;
+    numWrites = 0;
+    numSkipped = 0;
+}
+
+int MixerPathPlanner::init(struct mixer *mixer, const char *xmlFile)
+{
+    std::lock_guard<std::mutex> lck(lock);
+    int status = 0;
+
+    if (!mixer || !xmlFile) {
+        PAL_ERR(LOG_TAG, "Invalid mixer or xml file");
+        return -EINVAL;
+    }
+
+    this->mixer = mixer;
+    controls.clear();
+    controlIndex.clear();
+    plans.clear();
+    status = parse(xmlFile);
+    if (status) {
+        PAL_ERR(LOG_TAG, "Failed to compile %s, status %d", xmlFile, status);
+        controls.clear();
+        controlIndex.clear();
+        plans.clear();
+        this->mixer = NULL;
+        return status;
+    }
+
+    numTransitions = 0;
+    numWrites = 0;
+    numSkipped = 0;
+    initialized = true;
+    PAL_INFO(LOG_TAG, "compiled %zu paths over %zu controls from %s",
+             plans.size(), controls.size(), xmlFile);
+    return 0;
+}
+
+void MixerPathPlanner::deinit()
+{
+    std::lock_guard<std::mutex> lck(lock);
+
+    initialized = false;
+    controls.clear();
+    controlIndex.clear();
+    plans.clear();
+    mixer = NULL;
+}
+
+bool MixerPathPlanner::isInitialized()
+{
+    std::lock_guard<std::mutex> lck(lock);
+
+    return initialized;
+}
+
+int MixerPathPlanner::parse(const char *xmlFile)
+{
+    XML_Parser parser;
+    FILE *file = NULL;
+    int ret = 0;
+    int bytes_read;
+    void *buf = NULL;
+
+    file = fopen(xmlFile, "r");
+    if (!file) {
+        PAL_ERR(LOG_TAG, "Failed to open xml file name %s", xmlFile);
+        return -ENOENT;
+    }
+
+    parser = XML_ParserCreate(NULL);
+    if (!parser) {
+        ret = -EINVAL;
+        PAL_ERR(LOG_TAG, "Failed to create XML ret %d", ret);
+        goto closeFile;
+    }
+
+    curPath.clear();
+    depth = 0;
+    XML_SetUserData(parser, this);
+    XML_SetElementHandler(parser, startTag, endTag);
+
+    while (1) {
+        buf = XML_GetBuffer(parser, 1024);
+        if (buf == NULL) {
+            ret = -EINVAL;
+            PAL_ERR(LOG_TAG, "XML_Getbuffer failed ret %d", ret);
+            goto freeParser;
+        }
+
+        bytes_read = fread(buf, 1, 1024, file);
+        if (bytes_read < 0) {
+            ret = -EINVAL;
+            PAL_ERR(LOG_TAG, "fread failed ret %d", ret);
+            goto freeParser;
+        }
+
+        if (XML_ParseBuffer(parser, bytes_read, bytes_read == 0) == XML_STATUS_ERROR) {
+            ret = -EINVAL;
+            PAL_ERR(LOG_TAG, "XML ParseBuffer failed for %s file ret %d", xmlFile, ret);
+            goto freeParser;
+        }
+        if (bytes_read == 0)
+            break;
+    }
+
+freeParser:
+    XML_ParserFree(parser);
+closeFile:
+    fclose(file);
+    return ret;
+}
+
+void MixerPathPlanner::startTag(void *userdata, const XML_Char *tag,
+                                const XML_Char **attr)
+{
+    MixerPathPlanner *planner = (MixerPathPlanner *)userdata;
+    const char *name = NULL;
+    const char *id = NULL;
+    const char *value = NULL;
+
+    for (int i = 0; attr[i]; i += 2) {
+        if (!strcmp(attr[i], "name"))
+            name = attr[i + 1];
+        else if (!strcmp(attr[i], "id"))
+            id = attr[i + 1];
+        else if (!strcmp(attr[i], "value"))
+            value = attr[i + 1];
+    }
+
+    planner->depth++;
+    // depth 1 is <mixer>, its direct <ctl>s are the initial state
+    if (planner->depth == 2 && !strcmp(tag, "path") && name) {
+        planner->curPath = name;
+        planner->plans[planner->curPath].clear();
+    } else if (planner->depth == 3 && !planner->curPath.empty() && name) {
+        plan_t &plan = planner->plans[planner->curPath];
+
+        if (!strcmp(tag, "ctl") && value)
+            planner->addSetting(plan, name, id, value);
+        else if (!strcmp(tag, "path"))
+            planner->includePath(plan, name);
+    }
+}
+
+void MixerPathPlanner::endTag(void *userdata, const XML_Char *tag)
+{
+    MixerPathPlanner *planner = (MixerPathPlanner *)userdata;
+
+    if (planner->depth == 2 && !strcmp(tag, "path"))
+        planner->curPath.clear();
+    planner->depth--;
+}
+
+int MixerPathPlanner::getControl(const char *name, uint32_t *index)
+{
+    struct control c;
+    unsigned int numValues = 0;
+
+    auto iter = controlIndex.find(name);
+    if (iter != controlIndex.end()) {
+        *index = iter->second;
+        return 0;
+    }
+
+    c.ctl = mixer_get_ctl_by_name(mixer, name);
+    if (!c.ctl) {
+        PAL_ERR(LOG_TAG, "Invalid mixer control: %s", name);
+        return -EINVAL;
+    }
+    c.type = mixer_ctl_get_type(c.ctl);
+    numValues = mixer_ctl_get_num_values(c.ctl);
+    c.resetValues.assign(numValues, 0);
+    c.readable = true;
+
+    /* audio_route has applied the initial state, that is what reset restores */
+    if (c.type == MIXER_CTL_TYPE_BYTE) {
+        std::vector<uint8_t> bytes(numValues);
+
+        if (numValues && mixer_ctl_get_array(c.ctl, bytes.data(), numValues)) {
+            // keep it in the plans, its writes are just never skipped
+            PAL_INFO(LOG_TAG, "mixer control %s not readable, always written", name);
+            c.readable = false;
+        } else {
+            for (unsigned int i = 0; i < numValues; i++)
+                c.resetValues[i] = bytes[i];
+        }
+    } else {
+        for (unsigned int i = 0; i < numValues; i++)
+            c.resetValues[i] = mixer_ctl_get_value(c.ctl, i);
+    }
+    c.applied = c.resetValues;
+    c.known = c.readable;
+
+    controls.push_back(c);
+    *index = controls.size() - 1;
+    controlIndex[name] = *index;
+    return 0;
+}
+
+void MixerPathPlanner::addSetting(plan_t &plan, const char *name,
+                                  const char *id, const char *value)
+{
+    struct setting s;
+    struct setting *dst = NULL;
+    uint32_t index = 0;
+    unsigned int numValues = 0;
+    int v = 0;
+
+    if (getControl(name, &index))
+        return;
+
+    struct control &c = controls[index];
+    numValues = c.resetValues.size();
+    s.ctl = index;
+    s.values.assign(numValues, 0);
+    s.mask.assign(numValues, false);
+
+    if (c.type == MIXER_CTL_TYPE_ENUM) {
+        unsigned int numEnums = mixer_ctl_get_num_enums(c.ctl);
+        const char *str = NULL;
+
+        v = -1;
+        for (unsigned int i = 0; i < numEnums; i++) {
+            str = mixer_ctl_get_enum_string(c.ctl, i);
+            if (str && !strcmp(str, value)) {
+                v = i;
+                break;
+            }
+        }
+        if (v < 0) {
+            PAL_ERR(LOG_TAG, "Invalid enum value %s for %s", value, name);
+            return;
+        }
+    }
+
+    if (c.type == MIXER_CTL_TYPE_BYTE && !id) {
+        // byte arrays are given as a list of numbers
+        const char *ptr = value;
+        char *end = NULL;
+
+        for (unsigned int i = 0; i < numValues && *ptr; i++) {
+            s.values[i] = strtol(ptr, &end, 0);
+            if (end == ptr)
+                break;
+            s.mask[i] = true;
+            ptr = end;
+            while (*ptr == ' ' || *ptr == ',')
+                ptr++;
+        }
+    } else {
+        if (c.type != MIXER_CTL_TYPE_ENUM)
+            v = strtol(value, NULL, 0);
+
+        if (id) {
+            unsigned int i = strtoul(id, NULL, 0);
+
+            if (i >= numValues) {
+                PAL_ERR(LOG_TAG, "Invalid id %u for %s", i, name);
+                return;
+            }
+            s.values[i] = v;
+            s.mask[i] = true;
+        } else {
+            s.values.assign(numValues, v);
+            s.mask.assign(numValues, true);
+        }
+    }
+
+    // later settings of the same control override earlier ones
+    for (auto &p : plan) {
+        if (p.ctl == index) {
+            dst = &p;
+            break;
+        }
+    }
+    if (!dst) {
+        plan.push_back(s);
+        return;
+    }
+    for (unsigned int i = 0; i < numValues; i++) {
+        if (s.mask[i]) {
+            dst->values[i] = s.values[i];
+            dst->mask[i] = true;
+        }
+    }
+}
+
+void MixerPathPlanner::includePath(plan_t &plan, const char *name)
+{
+    bool merged = false;
+
+    auto iter = plans.find(name);
+    if (iter == plans.end()) {
+        PAL_ERR(LOG_TAG, "Path %s used before it is defined", name);
+        return;
+    }
+
+    for (auto &s : iter->second) {
+        merged = false;
+        for (auto &p : plan) {
+            if (p.ctl != s.ctl)
+                continue;
+            for (unsigned int i = 0; i < s.mask.size(); i++) {
+                if (s.mask[i]) {
+                    p.values[i] = s.values[i];
+                    p.mask[i] = true;
+                }
+            }
+            merged = true;
+            break;
+        }
+        if (!merged)
+            plan.push_back(s);
+    }
+}
+
+int MixerPathPlanner::writeControl(struct control &c,
+                                   const std::vector<int> &values,
+                                   const std::vector<bool> &mask)
+{
+    int ret = 0;
+
+    if (c.type == MIXER_CTL_TYPE_BYTE) {
+        std::vector<uint8_t> bytes(values.begin(), values.end());
+
+        numWrites++;
+        return mixer_ctl_set_array(c.ctl, bytes.data(), bytes.size());
+    }
+
+    for (unsigned int i = 0; i < values.size(); i++) {
+        // without a known value only the values of the path are written
+        if (c.known ? values[i] == c.applied[i] : !mask[i])
+            continue;
+        numWrites++;
+        ret = mixer_ctl_set_value(c.ctl, i, values[i]);
+        if (ret)
+            break;
+    }
+    return ret;
+}
+
+int MixerPathPlanner::runPlan(const char *name, bool reset)
+{
+    std::lock_guard<std::mutex> lck(lock);
+    std::vector<int> target;
+    uint32_t written = 0;
+    int status = 0;
+    int ret = 0;
+
+    if (!initialized)
+        return -ENODEV;
+
+    auto iter = plans.find(name);
+    if (iter == plans.end()) {
+        PAL_ERR(LOG_TAG, "unable to find path %s", name);
+        return -EINVAL;
+    }
+
+    plan_t &plan = iter->second;
+
+    numTransitions++;
+    for (size_t n = 0; n < plan.size(); n++) {
+        // reset undoes the path in reverse order
+        struct setting &s = reset ? plan[plan.size() - 1 - n] : plan[n];
+        struct control &c = controls[s.ctl];
+
+        target = c.applied;
+        for (unsigned int i = 0; i < s.mask.size(); i++) {
+            if (s.mask[i])
+                target[i] = reset ? c.resetValues[i] : s.values[i];
+        }
+        if (c.known && target == c.applied) {
+            numSkipped++;
+            continue;
+        }
+
+        ret = writeControl(c, target, s.mask);
+        if (ret) {
+            PAL_ERR(LOG_TAG, "Failed to set %s, ret %d", mixer_ctl_get_name(c.ctl), ret);
+            // value unknown now, make the next transition write it again
+            c.known = false;
+            status = ret;
+            continue;
+        }
+        c.applied = target;
+        c.known = c.readable;
+        written++;
+    }
+
+    PAL_DBG(LOG_TAG, "%s path %s: %u of %zu controls written",
+            reset ? "reset" : "apply", name, written, plan.size());
+    return status;
+}
+
+int MixerPathPlanner::applyPath(const char *name)
+{
+    return runPlan(name, false);
+}
+
+int MixerPathPlanner::resetPath(const char *name)
+{
+    return runPlan(name, true);
+}
+
+void MixerPathPlanner::getStats(uint32_t *numTransitions, uint32_t *numWrites,
+                                uint32_t *numSkipped)
+{
+    std::lock_guard<std::mutex> lck(lock);
+
+    *numTransitions = this->numTransitions;
+    *numWrites = this->numWrites;
+    *numSkipped = this->numSkipped;
+}
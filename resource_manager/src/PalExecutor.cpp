@@ -0,0 +1,318 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#define LOG_TAG "PAL: PalExecutor"
+
+#include "PalExecutor.h"
+#include "PalCommon.h"
+#include <algorithm>
+
+#define WHEEL_SHIFT(level) ((level) * PAL_EXECUTOR_WHEEL_BITS)
+#define WHEEL_SPAN(level) (1ULL << WHEEL_SHIFT(level))
+
+std::shared_ptr<PalExecutor> PalExecutor::instance = nullptr;
+std::shared_ptr<PalExecutor> PalExecutor::blockingInstance = nullptr;
+
+std::shared_ptr<PalExecutor> PalExecutor::getInstance()
+{
+    static std::mutex instanceLock;
+    std::lock_guard<std::mutex> lck(instanceLock);
+
+    if (!instance)
+        instance = std::make_shared<PalExecutor>();
+
+    return instance;
+}
+
+std::shared_ptr<PalExecutor> PalExecutor::getBlockingInstance()
+{
+    static std::mutex instanceLock;
+    std::lock_guard<std::mutex> lck(instanceLock);
+
+    if (!blockingInstance)
+        blockingInstance = std::make_shared<PalExecutor>(PAL_EXECUTOR_BLOCKING_WORKERS);
+
+    return blockingInstance;
+}
+
+PalExecutor::PalExecutor(uint32_t workerCount)
+{
+    numWorkers = workerCount ? workerCount : 1;
+    exitThreads = false;
+    epoch = std::chrono::steady_clock::now();
+    curTick = 0;
+    nextTimerId = 1;
+}
+
+PalExecutor::~PalExecutor()
+{
+    deinit();
+}
+
+void PalExecutor::deinit()
+{
+    std::unique_lock<std::mutex> lck(lock);
+    std::vector<std::thread> stopped;
+
+    exitThreads = true;
+    stopped.swap(workers);
+    lck.unlock();
+    timerCv.notify_all();
+    workCv.notify_all();
+    if (timerThread.joinable())
+        timerThread.join();
+    for (auto &t : stopped)
+        t.join();
+
+    lck.lock();
+    for (auto &level : wheel) {
+        for (auto &slot : level)
+            slot.clear();
+    }
+    timers.clear();
+    strands.clear();
+    ready.clear();
+    exitThreads = false;
+}
+
+uint64_t PalExecutor::nowTick()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - epoch).count();
+}
+
+void PalExecutor::startWorkers_l()
+{
+    if (!workers.empty())
+        return;
+
+    for (uint32_t i = 0; i < numWorkers; i++)
+        workers.emplace_back(&PalExecutor::workerLoop, this);
+}
+
+void PalExecutor::post_l(const void *key, task_t task)
+{
+    struct strand &s = strands[key];
+
+    s.tasks.push_back(std::move(task));
+    /* a running strand is requeued by its worker */
+    if (!s.running && s.tasks.size() == 1) {
+        ready.push_back(key);
+        workCv.notify_one();
+    }
+}
+
+void PalExecutor::post(const void *key, task_t task)
+{
+    std::lock_guard<std::mutex> lck(lock);
+
+    startWorkers_l();
+    post_l(key, std::move(task));
+}
+
+void PalExecutor::addTimer_l(std::list<struct timer> &from,
+                             std::list<struct timer>::iterator it)
+{
+    uint64_t delta = it->expiry > curTick ? it->expiry - curTick : 0;
+    uint64_t expiry = it->expiry;
+    uint32_t level = 0;
+
+    while (level < PAL_EXECUTOR_WHEEL_LEVELS - 1 && delta >= WHEEL_SPAN(level + 1))
+        level++;
+    /* beyond the last wheel, park it in the farthest slot and re-add later */
+    if (delta >= WHEEL_SPAN(PAL_EXECUTOR_WHEEL_LEVELS))
+        expiry = curTick + WHEEL_SPAN(PAL_EXECUTOR_WHEEL_LEVELS) - 1;
+
+    it->level = level;
+    it->slot = (expiry >> WHEEL_SHIFT(level)) & (PAL_EXECUTOR_WHEEL_SLOTS - 1);
+    /* splice keeps the iterator stored in timers valid */
+    wheel[level][it->slot].splice(wheel[level][it->slot].end(), from, it);
+}
+
+uint64_t PalExecutor::postDelayed(const void *key, uint32_t delayMs, task_t task)
+{
+    std::list<struct timer> pending;
+    uint64_t id = 0;
+
+    std::lock_guard<std::mutex> lck(lock);
+    startWorkers_l();
+    if (!timerThread.joinable())
+        timerThread = std::thread(&PalExecutor::timerLoop, this);
+
+    id = nextTimerId++;
+    /* the timer thread does not advance an empty wheel, catch up first */
+    if (timers.empty())
+        curTick = std::max(curTick, nowTick());
+    /* round up, a task never runs before its delay expired */
+    pending.push_back({id, key, std::max(nowTick() + delayMs + 1, curTick + 1),
+                       0, 0, std::move(task)});
+    timers[id] = pending.begin();
+    addTimer_l(pending, pending.begin());
+    timerCv.notify_one();
+
+    return id;
+}
+
+bool PalExecutor::cancelTimer(uint64_t id)
+{
+    std::lock_guard<std::mutex> lck(lock);
+    auto it = timers.find(id);
+
+    if (it == timers.end())
+        return false;
+
+    wheel[it->second->level][it->second->slot].erase(it->second);
+    timers.erase(it);
+
+    return true;
+}
+
+void PalExecutor::cancel(const void *key)
+{
+    std::unique_lock<std::mutex> lck(lock);
+    auto it = timers.begin();
+
+    while (it != timers.end()) {
+        if (it->second->key == key) {
+            wheel[it->second->level][it->second->slot].erase(it->second);
+            it = timers.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    auto s = strands.find(key);
+    if (s == strands.end())
+        return;
+
+    s->second.tasks.clear();
+    if (!s->second.running) {
+        ready.erase(std::remove(ready.begin(), ready.end(), key), ready.end());
+        strands.erase(s);
+        return;
+    }
+
+    /* a task cancelling its own key returns to its worker, which drops the strand */
+    if (s->second.runner == std::this_thread::get_id())
+        return;
+
+    idleCv.wait(lck, [&] { return !strands.count(key); });
+}
+
+void PalExecutor::cascade_l(uint32_t level)
+{
+    uint32_t slot = (curTick >> WHEEL_SHIFT(level)) & (PAL_EXECUTOR_WHEEL_SLOTS - 1);
+    std::list<struct timer> expiring;
+
+    expiring.swap(wheel[level][slot]);
+    while (!expiring.empty())
+        addTimer_l(expiring, expiring.begin());
+}
+
+void PalExecutor::advance_l(uint64_t tick)
+{
+    uint64_t next = 0;
+
+    while (curTick < tick) {
+        /* nothing is due before the next non-empty slot, jump straight to it */
+        if (!nextExpiry_l(next) || next > tick) {
+            curTick = tick;
+            break;
+        }
+        curTick = next;
+        /* higher wheels first, their timers may land in the current slot */
+        for (int level = PAL_EXECUTOR_WHEEL_LEVELS - 1; level > 0; level--) {
+            if (!(curTick & (WHEEL_SPAN(level) - 1)))
+                cascade_l(level);
+        }
+
+        auto &slot = wheel[0][curTick & (PAL_EXECUTOR_WHEEL_SLOTS - 1)];
+        for (auto it = slot.begin(); it != slot.end();) {
+            if (it->expiry > curTick) {
+                ++it;
+                continue;
+            }
+            post_l(it->key, std::move(it->task));
+            timers.erase(it->id);
+            it = slot.erase(it);
+        }
+    }
+}
+
+bool PalExecutor::nextExpiry_l(uint64_t &tick)
+{
+    uint64_t base = 0;
+    uint64_t next = 0;
+    bool found = false;
+
+    if (timers.empty())
+        return false;
+
+    /* a slot in a higher wheel is due when it gets cascaded */
+    for (uint32_t level = 0; level < PAL_EXECUTOR_WHEEL_LEVELS; level++) {
+        base = curTick >> WHEEL_SHIFT(level);
+        for (uint64_t k = 1; k <= PAL_EXECUTOR_WHEEL_SLOTS; k++) {
+            if (wheel[level][(base + k) & (PAL_EXECUTOR_WHEEL_SLOTS - 1)].empty())
+                continue;
+            next = (base + k) << WHEEL_SHIFT(level);
+            if (!found || next < tick)
+                tick = next;
+            found = true;
+            break;
+        }
+    }
+
+    return found;
+}
+
+void PalExecutor::timerLoop()
+{
+    std::unique_lock<std::mutex> lck(lock);
+    uint64_t tick = 0;
+
+    PAL_DBG(LOG_TAG, "Enter");
+    while (!exitThreads) {
+        advance_l(nowTick());
+        if (!nextExpiry_l(tick))
+            timerCv.wait(lck);
+        else
+            timerCv.wait_until(lck, epoch + std::chrono::milliseconds(tick));
+    }
+    PAL_DBG(LOG_TAG, "Exit");
+}
+
+void PalExecutor::workerLoop()
+{
+    std::unique_lock<std::mutex> lck(lock);
+    const void *key = NULL;
+    task_t task;
+
+    while (true) {
+        workCv.wait(lck, [&] { return exitThreads || !ready.empty(); });
+        if (exitThreads)
+            break;
+
+        key = ready.front();
+        ready.pop_front();
+        struct strand &s = strands[key];
+        task = std::move(s.tasks.front());
+        s.tasks.pop_front();
+        s.running = true;
+        s.runner = std::this_thread::get_id();
+        lck.unlock();
+
+        task();
+        task = nullptr;
+
+        lck.lock();
+        /* strands are only erased while idle, the reference is still valid */
+        s.running = false;
+        if (!s.tasks.empty() && !exitThreads)
+            ready.push_back(key);
+        else
+            strands.erase(key);
+        idleCv.notify_all();
+    }
+}
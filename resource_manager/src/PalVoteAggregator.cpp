@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#define LOG_TAG "PAL: PalVoteAggregator"
+
+#include "PalVoteAggregator.h"
+#include "PalExecutor.h"
+#include "PalCommon.h"
+#include <string.h>
+
+PalVoteAggregator::PalVoteAggregator(const char *voteName, apply_t applyFn)
+{
+    name = voteName;
+    apply = applyFn;
+    count = 0;
+    applied = false;
+    releaseTimer = 0;
+    releaseSeq = 0;
+    retries = 0;
+    memset(&counters, 0, sizeof(counters));
+}
+
+PalVoteAggregator::~PalVoteAggregator()
+{
+    PalExecutor::getInstance()->cancel(this);
+
+    /* push a release still pending */
+    std::lock_guard<std::mutex> lck(lock);
+    if (applied && !count)
+        apply(false);
+}
+
+int PalVoteAggregator::vote(bool enable)
+{
+    std::lock_guard<std::mutex> lck(lock);
+    bool pending = false;
+    int64_t heldMs = 0;
+    uint32_t delayMs = PAL_VOTE_RELEASE_DELAY_MS;
+    uint32_t seq = 0;
+
+    if (enable) {
+        counters.votes++;
+        /* votes after a failed first push retry it */
+        if (++count > 1 && applied)
+            return 0;
+
+        /* a release which already fired finds its sequence outdated */
+        releaseSeq++;
+        if (releaseTimer) {
+            PalExecutor::getInstance()->cancelTimer(releaseTimer);
+            releaseTimer = 0;
+            pending = true;
+        }
+        if (applied) {
+            if (pending)
+                counters.suppressed += 2;
+            PAL_VERBOSE(LOG_TAG, "%s vote kept applied", name);
+            return 0;
+        }
+
+        retries = 0;
+        return push_l(true);
+    }
+
+    counters.unvotes++;
+    if (count <= 0) {
+        PAL_ERR(LOG_TAG, "%s unvote without vote", name);
+        count = 0;
+        return 0;
+    }
+    if (--count > 0 || !applied)
+        return 0;
+
+    heldMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - appliedAt).count();
+    if (heldMs + delayMs < PAL_VOTE_MIN_HOLD_MS)
+        delayMs = PAL_VOTE_MIN_HOLD_MS - heldMs;
+
+    PAL_VERBOSE(LOG_TAG, "%s release deferred by %u ms", name, delayMs);
+    retries = 0;
+    seq = ++releaseSeq;
+    releaseTimer = PalExecutor::getInstance()->postDelayed(this, delayMs,
+            [this, seq] { update(seq); });
+
+    return 0;
+}
+
+void PalVoteAggregator::update(uint32_t seq)
+{
+    std::lock_guard<std::mutex> lck(lock);
+    bool enable = count > 0;
+
+    if (seq != releaseSeq || enable == applied)
+        return;
+
+    releaseTimer = 0;
+    push_l(enable);
+}
+
+int PalVoteAggregator::push_l(bool enable)
+{
+    uint32_t seq = 0;
+    int ret = 0;
+
+    ret = apply(enable);
+    if (ret) {
+        PAL_ERR(LOG_TAG, "Failed to push %s %s, ret %d", name,
+                enable ? "vote" : "release", ret);
+        if (retries++ < PAL_VOTE_PUSH_RETRIES) {
+            seq = ++releaseSeq;
+            releaseTimer = PalExecutor::getInstance()->postDelayed(this,
+                    PAL_VOTE_RELEASE_DELAY_MS, [this, seq] { update(seq); });
+        }
+        return ret;
+    }
+
+    applied = enable;
+    if (enable) {
+        appliedAt = std::chrono::steady_clock::now();
+        counters.pushed++;
+    } else {
+        counters.released++;
+    }
+    return 0;
+}
+
+void PalVoteAggregator::getStats(struct pal_power_vote_counters *stats)
+{
+    std::lock_guard<std::mutex> lck(lock);
+
+    *stats = counters;
+    stats->active = count;
+}
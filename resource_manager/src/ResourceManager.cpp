@@ -34,6 +34,7 @@
 
 #define LOG_TAG "PAL: ResourceManager"
 #include "ResourceManager.h"
+#include "PalInitGraph.h"
 #include "Session.h"
 #include "Device.h"
 #include "Stream.h"
@@ -59,6 +60,9 @@
 #include "DisplayPort.h"
 #include "Handset.h"
 #include "SndCardMonitor.h"
+#include "StreamGraphPool.h"
+#include "SsrOrchestrator.h"
+#include "PalSpanTracer.h"
 #include "UltrasoundDevice.h"
 #include "ECRefDevice.h"
 #include <agm/agm_api.h>
@@ -66,6 +70,7 @@
 #include <unistd.h>
 #include <dlfcn.h>
 #include <mutex>
+#include <chrono>
 #include "kvh2xml.h"
 #include <sys/ioctl.h>
 
@@ -429,7 +434,6 @@ std::mutex ResourceManager::mChargerBoostMutex;
 std::mutex ResourceManager::mGraphMutex;
 std::mutex ResourceManager::mActiveStreamMutex;
 std::mutex ResourceManager::mValidStreamMutex;
-std::mutex ResourceManager::mSleepMonitorMutex;
 std::mutex ResourceManager::mListFrontEndsMutex;
 std::vector <int> ResourceManager::listAllFrontEndIds = {0};
 std::vector <int> ResourceManager::listFreeFrontEndIds = {0};
@@ -469,6 +473,8 @@ vui_dmgr_deinit_t ResourceManager::vui_dmgr_deinit = NULL;
 std::mutex ResourceManager::cvMutex;
 std::queue<card_status_t> ResourceManager::msgQ;
 std::condition_variable ResourceManager::cv;
+std::mutex ResourceManager::cardStateMutex;
+std::condition_variable ResourceManager::cardStateCv;
 std::thread ResourceManager::workerThread;
 std::thread ResourceManager::mixerEventTread;
 bool ResourceManager::mixerClosed = false;
@@ -549,6 +555,22 @@ std::vector<struct pal_amp_db_and_gain_table> ResourceManager::gainLvlMap;
 std::map<std::pair<uint32_t, std::string>, std::string> ResourceManager::btCodecMap;
 std::map<int, std::string> ResourceManager::spkrTempCtrlsMap;
 std::map<uint32_t, uint32_t> ResourceManager::btSlimClockSrcMap;
+std::shared_ptr<const std::string> ResourceManager::xmlBuf = nullptr;
+std::string ResourceManager::xmlRootTag;
+size_t ResourceManager::xmlPrologEnd = 0;
+std::map<std::string, std::vector<std::pair<size_t, size_t>>> ResourceManager::xmlLazySections;
+std::recursive_mutex ResourceManager::xmlSectionMutex;
+
+/*
+ * Resource manager xml sections only needed once the feature using them is
+ * set up, parsed on first use instead of on the path to the first stream.
+ */
+static const char *lazyXmlSections[] = {
+    "sound_trigger_platform_info",
+    "bt_codecs",
+    "gain_db_to_level_mapping",
+    "group_device_cfg",
+};
 
 std::shared_ptr<group_dev_config_t> ResourceManager::activeGroupDevConfig = nullptr;
 std::shared_ptr<group_dev_config_t> ResourceManager::currentGroupDevConfig = nullptr;
@@ -815,26 +837,60 @@ ResourceManager::ResourceManager()
     mHighestPriorityActiveStream = nullptr;
     mPriorityHighestPriorityActiveStream = 0;
 
-    ret = ResourceManager::XmlParser(SNDPARSER);
-    if (ret) {
-        PAL_ERR(LOG_TAG, "error in snd xml parsing ret %d", ret);
-        throw std::runtime_error("error in snd xml parsing");
-    }
+    /*
+     * The sound card chain is serial, the usecase xml, the AGM crash
+     * callback and the wake locks do not depend on it and overlap with
+     * the wait for the mixer.
+     */
+    PalInitGraph bringUp("rm bring-up");
+    int sndXml = bringUp.addStep("snd_xml", {}, [] {
+        int ret = ResourceManager::XmlParser(SNDPARSER);
+        if (ret)
+            PAL_ERR(LOG_TAG, "error in snd xml parsing ret %d", ret);
+        return ret;
+    });
+    int audio = bringUp.addStep("init_audio", {sndXml}, [this] {
+        int ret = ResourceManager::init_audio();
+        if (ret)
+            PAL_ERR(LOG_TAG, "error in init audio route and audio mixer ret %d", ret);
+        return ret;
+    });
+    bringUp.addStep("rm_xml", {audio}, [this] {
+        int ret = ResourceManager::XmlSectionParser(rmngr_xml_file);
+        if (ret == -ENOENT) // try resourcemanager xml without variant name
+            ret = ResourceManager::XmlSectionParser(rmngr_xml_file_wo_variant);
+        if (ret)
+            PAL_ERR(LOG_TAG, "error in resource xml parsing ret %d", ret);
+        return ret;
+    });
+    bringUp.addStep("usecase_xml", {}, [] {
+        int ret = PayloadBuilder::init();
+        if (ret) {
+            PAL_ERR(LOG_TAG, "Failed to parse usecase manager xml ret %d", ret);
+        } else {
+            PAL_INFO(LOG_TAG, "usecase manager xml parsing successful");
+        }
+        return ret;
+    });
+    bringUp.addStep("agm_crash_cb", {}, [this] {
+        // Get AGM service handle
+        int ret = agm_register_service_crash_callback(&agmServiceCrashHandler,
+                                                       (uint64_t)this);
+        if (ret) {
+            PAL_ERR(LOG_TAG, "AGM service not up%d", ret);
+        }
+        return 0;
+    });
+    bringUp.addStep("wake_locks", {}, [] {
+        ResourceManager::initWakeLocks();
+        return 0;
+    });
 
-    ret = ResourceManager::init_audio();
-    if (ret) {
-        PAL_ERR(LOG_TAG, "error in init audio route and audio mixer ret %d", ret);
-        throw std::runtime_error("error in init audio route and audio mixer");
-    }
+    ret = bringUp.run();
+    if (ret)
+        throw std::runtime_error("error in resource manager bring-up");
 
     cardState = CARD_STATUS_ONLINE;
-    ret = ResourceManager::XmlParser(rmngr_xml_file);
-    if (ret == -ENOENT) // try resourcemanager xml without variant name
-        ret = ResourceManager::XmlParser(rmngr_xml_file_wo_variant);
-    if (ret) {
-        PAL_ERR(LOG_TAG, "error in resource xml parsing ret %d", ret);
-        throw std::runtime_error("error in resource xml parsing");
-    }
 
     if (IsVirtualPortForUPDEnabled()) {
         updateVirtualBackendName();
@@ -842,7 +898,7 @@ ResourceManager::ResourceManager()
     }
 
     if (isHifiFilterEnabled)
-        audio_route_apply_and_update_path(audio_route, "hifi-filter-coefficients");
+        enableDevice(audio_route, "hifi-filter-coefficients");
 
     char propValue[PROPERTY_VALUE_MAX];
     bool isBuildDebuggable = false;
@@ -864,12 +920,22 @@ ResourceManager::ResourceManager()
     }
 
 #if defined(ADSP_SLEEP_MONITOR)
-    lpi_counter_ = 0;
-    nlpi_counter_ = 0;
     sleepmon_fd_ = open(ADSPSLEEPMON_DEVICE_NAME, O_RDWR);
     if (sleepmon_fd_ == -1)
         PAL_ERR(LOG_TAG, "Failed to open ADSP sleep monitor file");
+    mPowerVotes[PAL_POWER_VOTE_SLEEPMON_LPI] = std::make_shared<PalVoteAggregator>(
+        "sleepmon lpi", [this](bool enable) {
+            return pushSleepMonitorVote(enable ? ADSPSLEEPMON_AUDIO_ACTIVITY_LPI_START :
+                                                 ADSPSLEEPMON_AUDIO_ACTIVITY_LPI_STOP);
+        });
+    mPowerVotes[PAL_POWER_VOTE_SLEEPMON_NLPI] = std::make_shared<PalVoteAggregator>(
+        "sleepmon nlpi", [this](bool enable) {
+            return pushSleepMonitorVote(enable ? ADSPSLEEPMON_AUDIO_ACTIVITY_START :
+                                                 ADSPSLEEPMON_AUDIO_ACTIVITY_STOP);
+        });
 #endif
+    mPowerVotes[PAL_POWER_VOTE_PM_QOS] = std::make_shared<PalVoteAggregator>(
+        "pm qos", [this](bool enable) { return setPmQosMixerCtl(enable); });
     listAllFrontEndIds.clear();
     listFreeFrontEndIds.clear();
     listAllPcmPlaybackFrontEnds.clear();
@@ -947,27 +1013,11 @@ ResourceManager::ResourceManager()
      for (int i = 0; i < max_nt_sessions; i++)
           listAllNonTunnelSessionIds.push_back(maxDeviceIdInUse + i);
 
-    // Get AGM service handle
-    ret = agm_register_service_crash_callback(&agmServiceCrashHandler,
-                                               (uint64_t)this);
-    if (ret) {
-        PAL_ERR(LOG_TAG, "AGM service not up%d", ret);
-    }
-
     auto encodeMap = std::make_shared<std::unordered_map<uint32_t, bool>>();
     auto decodeMap = std::make_shared<std::unordered_map<uint32_t, bool>>();
     mNTStreamInstancesList[NT_PATH_ENCODE] = encodeMap;
     mNTStreamInstancesList[NT_PATH_DECODE] = decodeMap;
 
-    ResourceManager::loadAdmLib();
-    ResourceManager::initWakeLocks();
-    ret = PayloadBuilder::init();
-    if (ret) {
-        throw std::runtime_error("Failed to parse usecase manager xml");
-    } else {
-        PAL_INFO(LOG_TAG, "usecase manager xml parsing successful");
-    }
-
     PAL_DBG(LOG_TAG, "Creating ContextManager");
     ctxMgr = new ContextManager();
     if (!ctxMgr) {
@@ -1027,6 +1077,9 @@ ResourceManager::~ResourceManager()
         delete ctxMgr;
     }
 
+    /* pushes releases still deferred */
+    for (auto &powerVote : mPowerVotes)
+        powerVote.reset();
     if (sleepmon_fd_ >= 0)
         close(sleepmon_fd_);
 #ifdef SOC_PERIPHERAL_PROT
@@ -1124,40 +1177,42 @@ void ResourceManager::loadSocPeripheralLib()
 
 void ResourceManager::loadAdmLib()
 {
-    if (access(ADM_LIBRARY_PATH, R_OK) == 0) {
-        admLibHdl = dlopen(ADM_LIBRARY_PATH, RTLD_NOW);
-        if (admLibHdl == NULL) {
-            PAL_ERR(LOG_TAG, "DLOPEN failed for %s %s", ADM_LIBRARY_PATH, dlerror());
-        } else {
-            PAL_VERBOSE(LOG_TAG, "DLOPEN successful for %s", ADM_LIBRARY_PATH);
-            admInitFn = (adm_init_t)
-                dlsym(admLibHdl, "adm_init");
-            admDeInitFn = (adm_deinit_t)
-                dlsym(admLibHdl, "adm_deinit");
-            admRegisterInputStreamFn = (adm_register_input_stream_t)
-                dlsym(admLibHdl, "adm_register_input_stream");
-            admRegisterOutputStreamFn = (adm_register_output_stream_t)
-                dlsym(admLibHdl, "adm_register_output_stream");
-            admDeregisterStreamFn = (adm_deregister_stream_t)
-                dlsym(admLibHdl, "adm_deregister_stream");
-            admRequestFocusFn = (adm_request_focus_t)
-                dlsym(admLibHdl, "adm_request_focus");
-            admAbandonFocusFn = (adm_abandon_focus_t)
-                dlsym(admLibHdl, "adm_abandon_focus");
-            admSetConfigFn = (adm_set_config_t)
-                dlsym(admLibHdl, "adm_set_config");
-            admRequestFocusV2Fn = (adm_request_focus_v2_t)
-                dlsym(admLibHdl, "adm_request_focus_v2");
-            admOnRoutingChangeFn = (adm_on_routing_change_t)
-                dlsym(admLibHdl, "adm_on_routing_change");
-            admRequestFocus_v2_1Fn = (adm_request_focus_v2_1_t)
-                dlsym(admLibHdl, "adm_request_focus_v2_1");
-
-            dlerror(); // clear error during dlsym, if any.
-            if (admInitFn)
-                admData = admInitFn();
-        }
-    }
+    std::call_once(admLibOnce, [this] {
+        if (access(ADM_LIBRARY_PATH, R_OK) == 0) {
+            admLibHdl = dlopen(ADM_LIBRARY_PATH, RTLD_NOW);
+            if (admLibHdl == NULL) {
+                PAL_ERR(LOG_TAG, "DLOPEN failed for %s %s", ADM_LIBRARY_PATH, dlerror());
+            } else {
+                PAL_VERBOSE(LOG_TAG, "DLOPEN successful for %s", ADM_LIBRARY_PATH);
+                admInitFn = (adm_init_t)
+                    dlsym(admLibHdl, "adm_init");
+                admDeInitFn = (adm_deinit_t)
+                    dlsym(admLibHdl, "adm_deinit");
+                admRegisterInputStreamFn = (adm_register_input_stream_t)
+                    dlsym(admLibHdl, "adm_register_input_stream");
+                admRegisterOutputStreamFn = (adm_register_output_stream_t)
+                    dlsym(admLibHdl, "adm_register_output_stream");
+                admDeregisterStreamFn = (adm_deregister_stream_t)
+                    dlsym(admLibHdl, "adm_deregister_stream");
+                admRequestFocusFn = (adm_request_focus_t)
+                    dlsym(admLibHdl, "adm_request_focus");
+                admAbandonFocusFn = (adm_abandon_focus_t)
+                    dlsym(admLibHdl, "adm_abandon_focus");
+                admSetConfigFn = (adm_set_config_t)
+                    dlsym(admLibHdl, "adm_set_config");
+                admRequestFocusV2Fn = (adm_request_focus_v2_t)
+                    dlsym(admLibHdl, "adm_request_focus_v2");
+                admOnRoutingChangeFn = (adm_on_routing_change_t)
+                    dlsym(admLibHdl, "adm_on_routing_change");
+                admRequestFocus_v2_1Fn = (adm_request_focus_v2_1_t)
+                    dlsym(admLibHdl, "adm_request_focus_v2_1");
+
+                dlerror(); // clear error during dlsym, if any.
+                if (admInitFn)
+                    admData = admInitFn();
+            }
+        }
+    });
 }
 
 int ResourceManager::initWakeLocks(void) {
@@ -1247,6 +1302,7 @@ void ResourceManager::ssrHandlingLoop(std::shared_ptr<ResourceManager> rm)
     uint32_t eventData;
     pal_global_callback_event_t event;
     pal_stream_type_t type;
+    std::vector<Stream *> restoreList;
 
     PAL_VERBOSE(LOG_TAG,"ssr Handling thread started");
 
@@ -1262,8 +1318,15 @@ void ResourceManager::ssrHandlingLoop(std::shared_ptr<ResourceManager> rm)
             if (state == CARD_STATUS_NONE)
                 break;
 
+            /* parked graphs do not survive the DSP restart */
+            if (state == CARD_STATUS_OFFLINE)
+                StreamGraphPool::getInstance()->invalidate("ssr");
+
             mActiveStreamMutex.lock();
+            cardStateMutex.lock();
             rm->cardState = state;
+            cardStateMutex.unlock();
+            cardStateCv.notify_all();
             if (state != prevState) {
                 if (rm->globalCb) {
                     PAL_DBG(LOG_TAG, "Notifying client about sound card state %d global cb %pK",
@@ -1342,6 +1405,7 @@ void ResourceManager::ssrHandlingLoop(std::shared_ptr<ResourceManager> rm)
                 }
 
                 SoundTriggerCaptureProfile = GetCaptureProfileByPriority(nullptr);
+                restoreList.clear();
                 for (auto str: rm->mActiveStreams) {
                     lockValidStreamMutex();
                     ret = increaseStreamUserCounter(str);
@@ -1350,18 +1414,12 @@ void ResourceManager::ssrHandlingLoop(std::shared_ptr<ResourceManager> rm)
                         PAL_ERR(LOG_TAG, "Error incrementing the stream counter for the stream handle: %pK", str);
                         continue;
                     }
-                    ret = str->ssrUpHandler();
-                    if (0 != ret) {
-                        PAL_ERR(LOG_TAG, "Ssr up handling failed for %pK ret %d",
-                                          str, ret);
-                    }
-                    lockValidStreamMutex();
-                    ret = decreaseStreamUserCounter(str);
-                    unlockValidStreamMutex();
-                    if (0 != ret) {
-                        PAL_ERR(LOG_TAG, "Error decrementing the stream counter for the stream handle: %pK", str);
-                    }
+                    restoreList.push_back(str);
                 }
+                /* held user counters keep the streams alive while restoring */
+                mActiveStreamMutex.unlock();
+                SsrOrchestrator::restoreStreams(rm, restoreList);
+                mActiveStreamMutex.lock();
                 prevState = state;
             } else {
                 PAL_ERR(LOG_TAG, "Invalid state. state %d", state);
@@ -1373,6 +1431,14 @@ void ResourceManager::ssrHandlingLoop(std::shared_ptr<ResourceManager> rm)
     PAL_INFO(LOG_TAG, "ssr Handling thread ended");
 }
 
+void ResourceManager::waitForCardOnline(uint32_t timeoutUs)
+{
+    std::unique_lock<std::mutex> lck(cardStateMutex);
+
+    cardStateCv.wait_for(lck, std::chrono::microseconds(timeoutUs),
+            [this] { return cardState != CARD_STATUS_OFFLINE; });
+}
+
 int ResourceManager::initSndMonitor()
 {
     int ret = 0;
@@ -1524,9 +1590,14 @@ int ResourceManager::init_audio()
             mixer_close(audio_virt_mixer);
             mixer_close(audio_hw_mixer);
             status = -EINVAL;
+        } else {
+            strlcpy(mixer_xml_file, mixer_xml_file_wo_variant, XML_PATH_MAX_LENGTH);
         }
     }
-    // audio_route init success
+    // audio_route init success, compile the paths it applies from now on
+    if (audio_route &&
+        MixerPathPlanner::getInstance()->init(audio_hw_mixer, mixer_xml_file))
+        PAL_ERR(LOG_TAG, "mixer path plans unavailable, using audio route");
 exit:
     PAL_DBG(LOG_TAG, "Exit, status %d. audio route init with card %d mixer path %s", status,
             snd_hw_card, mixer_xml_file);
@@ -1702,32 +1773,48 @@ void ResourceManager::deInitContextManager()
     }
 }
 
+/*
+ * The steps are best effort as before and return 0 on their own failures,
+ * only a step which throws fails init.
+ */
 int ResourceManager::init()
 {
-    std::shared_ptr<Device> dev = nullptr;
-
-    // Initialize Speaker Protection calibration mode
-    struct pal_device dattr;
+    PalInitGraph bringUp("rm init");
+    int speaker = 0;
 
     mixerEventTread = std::thread(mixerEventWaitThreadLoop, rm);
 
-    //Initialize audio_charger_listener
-    if (rm && isChargeConcurrencyEnabled)
-        rm->chargerListenerFeatureInit();
+    speaker = bringUp.addStep("speaker", {}, [] {
+        std::shared_ptr<Device> dev = nullptr;
+        // Initialize Speaker Protection calibration mode
+        struct pal_device dattr;
 
-    // Get the speaker instance and activate speaker protection
-    dattr.id = PAL_DEVICE_OUT_SPEAKER;
-    dev = std::dynamic_pointer_cast<Device>(Device::getInstance(&dattr , rm));
-    if (dev) {
-        PAL_DBG(LOG_TAG, "Speaker instance created");
-    }
-    else
-        PAL_DBG(LOG_TAG, "Speaker instance not created");
+        // Get the speaker instance and activate speaker protection
+        dattr.id = PAL_DEVICE_OUT_SPEAKER;
+        dev = std::dynamic_pointer_cast<Device>(Device::getInstance(&dattr , rm));
+        if (dev) {
+            PAL_DBG(LOG_TAG, "Speaker instance created");
+        }
+        else
+            PAL_DBG(LOG_TAG, "Speaker instance not created");
+        return 0;
+    });
+
+    /* charger events may reconfigure the speaker, listen once it exists */
+    bringUp.addStep("charger_listener", {speaker}, [] {
+        //Initialize audio_charger_listener
+        if (rm && isChargeConcurrencyEnabled)
+            rm->chargerListenerFeatureInit();
+        return 0;
+    });
 
-    PAL_INFO(LOG_TAG, "Initialize voiceui dmgr");
-    voiceuiDmgrManagerInit();
+    bringUp.addStep("vui_dmgr", {}, [] {
+        PAL_INFO(LOG_TAG, "Initialize voiceui dmgr");
+        voiceuiDmgrManagerInit();
+        return 0;
+    });
 
-    return 0;
+    return bringUp.run();
 }
 
 bool ResourceManager::isLpiLoggingEnabled()
@@ -1752,14 +1839,12 @@ int32_t ResourceManager::voteSleepMonitor(Stream *str, bool vote, bool force_nlp
     int fd = 0;
     pal_stream_type_t type;
     bool lpi_stream = false;
-    struct adspsleepmon_ioctl_audio monitor_payload;
 
     if (sleepmon_fd_ == -1) {
         PAL_ERR(LOG_TAG, "ioctl device is not open");
         return -EINVAL;
     }
 
-    monitor_payload.version = ADSPSLEEPMON_IOCTL_AUDIO_VER_1;
     ret = str->getStreamType(&type);
     if (ret != 0) {
         PAL_ERR(LOG_TAG, "getStreamType failed with status : %d", ret);
@@ -1777,59 +1862,28 @@ int32_t ResourceManager::voteSleepMonitor(Stream *str, bool vote, bool force_nlp
                       !IsTransitToNonLPIOnChargingSupported());
     }
 
-    mSleepMonitorMutex.lock();
-    if (vote) {
-        if (lpi_stream) {
-            if (++lpi_counter_ == 1) {
-                monitor_payload.command = ADSPSLEEPMON_AUDIO_ACTIVITY_LPI_START;
-                mSleepMonitorMutex.unlock();
-                ret = ioctl(sleepmon_fd_, ADSPSLEEPMON_IOCTL_AUDIO_ACTIVITY, &monitor_payload);
-                mSleepMonitorMutex.lock();
-            }
-        } else {
-            if (++nlpi_counter_ == 1) {
-                monitor_payload.command = ADSPSLEEPMON_AUDIO_ACTIVITY_START;
-                mSleepMonitorMutex.unlock();
-                ret = ioctl(sleepmon_fd_, ADSPSLEEPMON_IOCTL_AUDIO_ACTIVITY, &monitor_payload);
-                mSleepMonitorMutex.lock();
-            }
-        }
-    } else {
-        if (lpi_stream) {
-            if (--lpi_counter_ == 0) {
-                monitor_payload.command = ADSPSLEEPMON_AUDIO_ACTIVITY_LPI_STOP;
-                mSleepMonitorMutex.unlock();
-                ret = ioctl(sleepmon_fd_, ADSPSLEEPMON_IOCTL_AUDIO_ACTIVITY, &monitor_payload);
-                mSleepMonitorMutex.lock();
-            } else if (lpi_counter_ < 0) {
-                PAL_ERR(LOG_TAG,
-                  "LPI vote count is negative, number of unvotes is more than number of votes");
-                lpi_counter_ = 0;
-            }
-        } else {
-            if (--nlpi_counter_ == 0) {
-                monitor_payload.command = ADSPSLEEPMON_AUDIO_ACTIVITY_STOP;
-                mSleepMonitorMutex.unlock();
-                ret = ioctl(sleepmon_fd_, ADSPSLEEPMON_IOCTL_AUDIO_ACTIVITY, &monitor_payload);
-                mSleepMonitorMutex.lock();
-            } else if(nlpi_counter_ < 0) {
-                PAL_ERR(LOG_TAG,
-                 "NLPI vote count is negative, number of unvotes is more than number of votes");
-                nlpi_counter_ = 0;
-            }
-        }
-    }
+    /* the aggregator pushes only net changes, releases are deferred */
+    ret = mPowerVotes[lpi_stream ? PAL_POWER_VOTE_SLEEPMON_LPI :
+                      PAL_POWER_VOTE_SLEEPMON_NLPI]->vote(vote);
     if (ret) {
         PAL_ERR(LOG_TAG, "Failed to %s for %s use case", vote ? "vote" : "unvote",
                          lpi_stream ? "lpi" : "nlpi");
     } else {
-        PAL_INFO(LOG_TAG, "%s done for %s use case, lpi votes %d, nlpi votes : %d",
-        vote ? "Voting" : "Unvoting", lpi_stream ? "lpi" : "nlpi", lpi_counter_, nlpi_counter_);
+        PAL_INFO(LOG_TAG, "%s done for %s use case", vote ? "Voting" : "Unvoting",
+                 lpi_stream ? "lpi" : "nlpi");
     }
 
-    mSleepMonitorMutex.unlock();
     return ret;
 }
+
+int ResourceManager::pushSleepMonitorVote(uint32_t command)
+{
+    struct adspsleepmon_ioctl_audio monitor_payload;
+
+    monitor_payload.version = ADSPSLEEPMON_IOCTL_AUDIO_VER_1;
+    monitor_payload.command = command;
+    return ioctl(sleepmon_fd_, ADSPSLEEPMON_IOCTL_AUDIO_ACTIVITY, &monitor_payload);
+}
 #else
 int32_t ResourceManager::voteSleepMonitor(Stream *str, bool vote, bool force_nlpi_vote)
 {
@@ -1837,6 +1891,30 @@ int32_t ResourceManager::voteSleepMonitor(Stream *str, bool vote, bool force_nlp
 }
 #endif
 
+int32_t ResourceManager::votePmQos(bool vote)
+{
+    return mPowerVotes[PAL_POWER_VOTE_PM_QOS]->vote(vote);
+}
+
+int ResourceManager::setPmQosMixerCtl(bool enable)
+{
+    struct mixer_ctl *ctl;
+
+    if (!audio_hw_mixer) {
+        PAL_ERR(LOG_TAG,"could not get hwMixer, not setting mixer control for PM_QOS \n");
+        return -ENOENT;
+    }
+
+    ctl = mixer_get_ctl_by_name(audio_hw_mixer, "PM_QOS Vote");
+    if (!ctl) {
+        PAL_ERR(LOG_TAG, "Invalid mixer control: %s\n", "PM_QOS Vote");
+        return -ENOENT;
+    }
+
+    PAL_DBG(LOG_TAG, "mixer control %s for PM_QOS Vote", enable ? "enabled" : "disabled");
+    return mixer_ctl_set_enum_by_string(ctl, enable ? "Enable" : "Disable");
+}
+
 /*
   Playback is going on and charger Insertion occurs, Below
   steps to smooth recovery of FET which avoid its fault.
@@ -2443,7 +2521,6 @@ int32_t ResourceManager::getDeviceConfig(struct pal_device *deviceattr,
     int32_t status = 0;
     struct pal_channel_info dev_ch_info;
     bool is_wfd_in_progress = false;
-    struct pal_stream_attributes tx_attr;
     struct pal_device_info devinfo = {};
 
     if (!deviceattr) {
@@ -2658,14 +2735,7 @@ int32_t ResourceManager::getDeviceConfig(struct pal_device *deviceattr,
                 return -EINVAL;
             }
             // check if wfd session in progress
-            for (auto& tx_str: mActiveStreams) {
-                tx_str->getStreamAttributes(&tx_attr);
-                if (tx_attr.direction == PAL_AUDIO_INPUT &&
-                    tx_attr.info.opt_stream_info.tx_proxy_type == PAL_STREAM_PROXY_TX_WFD) {
-                    is_wfd_in_progress = true;
-                    break;
-                }
-            }
+            is_wfd_in_progress = concState.numWfdTx > 0;
 
             if (is_wfd_in_progress)
             {
@@ -2842,91 +2912,74 @@ bool ResourceManager::isStreamSupported(struct pal_stream_attributes *attributes
         case PAL_STREAM_VOIP:
         case PAL_STREAM_VOIP_RX:
         case PAL_STREAM_VOIP_TX:
-            cur_sessions = active_streams_ll.size();
             max_sessions = MAX_SESSIONS_LOW_LATENCY;
             break;
         case PAL_STREAM_ULTRA_LOW_LATENCY:
-            cur_sessions = active_streams_ull.size();
             max_sessions = MAX_SESSIONS_ULTRA_LOW_LATENCY;
             break;
         case PAL_STREAM_DEEP_BUFFER:
-            cur_sessions = active_streams_db.size();
             max_sessions = MAX_SESSIONS_DEEP_BUFFER;
             break;
         case PAL_STREAM_SPATIAL_AUDIO:
-            cur_sessions = active_streams_sa.size();
             max_sessions = MAX_SESSIONS_SPATIAL_AUDIO;
             break;
         case PAL_STREAM_COMPRESSED:
-            cur_sessions = active_streams_comp.size();
             max_sessions = MAX_SESSIONS_COMPRESSED;
             break;
         case PAL_STREAM_GENERIC:
-            cur_sessions = active_streams_ulla.size();
             max_sessions = MAX_SESSIONS_GENERIC;
             break;
         case PAL_STREAM_RAW:
-            cur_sessions = active_streams_raw.size();
             max_sessions = MAX_SESSIONS_RAW;
             break;
         case PAL_STREAM_VOICE_RECOGNITION:
-            cur_sessions = active_streams_voice_rec.size();
             max_sessions = MAX_SESSIONS_VOICE_RECOGNITION;
             break;
         case PAL_STREAM_LOOPBACK:
         case PAL_STREAM_TRANSCODE:
         case PAL_STREAM_VOICE_UI:
-            cur_sessions = active_streams_st.size();
             max_sessions = MAX_SESSIONS_VOICE_UI;
             break;
         case PAL_STREAM_ACD:
-            cur_sessions = active_streams_acd.size();
             max_sessions = MAX_SESSIONS_ACD;
             break;
         case PAL_STREAM_PCM_OFFLOAD:
-            cur_sessions = active_streams_po.size();
             max_sessions = MAX_SESSIONS_PCM_OFFLOAD;
             break;
         case PAL_STREAM_PROXY:
-            cur_sessions = active_streams_proxy.size();
             max_sessions = MAX_SESSIONS_PROXY;
             break;
          case PAL_STREAM_VOICE_CALL:
             break;
         case PAL_STREAM_VOICE_CALL_MUSIC:
-            cur_sessions = active_streams_incall_music.size();
             max_sessions = MAX_SESSIONS_INCALL_MUSIC;
             break;
         case PAL_STREAM_VOICE_CALL_RECORD:
-            cur_sessions = active_streams_incall_record.size();
             max_sessions = MAX_SESSIONS_INCALL_RECORD;
             break;
         case PAL_STREAM_NON_TUNNEL:
-            cur_sessions = active_streams_non_tunnel.size();
             max_sessions = max_nt_sessions;
             break;
         case PAL_STREAM_HAPTICS:
-            cur_sessions = active_streams_haptics.size();
             max_sessions = MAX_SESSIONS_HAPTICS;
             break;
         case PAL_STREAM_CONTEXT_PROXY:
             return true;
             break;
         case PAL_STREAM_ULTRASOUND:
-            cur_sessions = active_streams_ultrasound.size();
             max_sessions = MAX_SESSIONS_ULTRASOUND;
             break;
         case PAL_STREAM_SENSOR_PCM_DATA:
-            cur_sessions = active_streams_sensor_pcm_data.size();
             max_sessions = MAX_SESSIONS_SENSOR_PCM_DATA;
             break;
         default:
             PAL_ERR(LOG_TAG, "Invalid stream type = %d", type);
         return result;
     }
+    cur_sessions = concState.numSessions(type);
     if (cur_sessions == max_sessions && type != PAL_STREAM_VOICE_CALL) {
         if (type == PAL_STREAM_VOICE_RECOGNITION &&
-            active_streams_db.size() < MAX_SESSIONS_DEEP_BUFFER) {
+            concState.numSessions(PAL_STREAM_DEEP_BUFFER) < MAX_SESSIONS_DEEP_BUFFER) {
                 attributes->type = PAL_STREAM_DEEP_BUFFER;
                 type = PAL_STREAM_DEEP_BUFFER;
         } else {
@@ -3213,6 +3266,7 @@ int ResourceManager::registerStream(Stream *s)
             break;
     }
     mActiveStreams.push_back(s);
+    updateConcurrencyState_l(s, true);
 
 #if 0
     s->getStreamAttributes(&incomingStreamAttr);
@@ -3396,6 +3450,7 @@ int ResourceManager::deregisterStream(Stream *s)
     }
 
     deregisterstream(s, mActiveStreams);
+    updateConcurrencyState_l(s, false);
     mValidStreamMutex.unlock();
     mActiveStreamMutex.unlock();
 exit:
@@ -3403,29 +3458,32 @@ exit:
     return ret;
 }
 
-template <class T>
-bool isStreamActive(T s, std::list<T> &streams)
+int ResourceManager::isActiveStream(pal_stream_handle_t *handle) {
+    return concState.streams.count(reinterpret_cast<Stream *>(handle)) != 0;
+}
+
+// NOTE: this api should be called with mActiveStreamMutex and
+// mValidStreamMutex locked
+void ResourceManager::updateConcurrencyState_l(Stream *s, bool registered)
 {
-    bool ret = false;
+    struct pal_stream_attributes sAttr;
 
-    PAL_DBG(LOG_TAG, "Enter.");
-    typename std::list<T>::iterator iter =
-        std::find(streams.begin(), streams.end(), s);
-    if (iter != streams.end()) {
-        ret = true;
+    if (!registered) {
+        concState.removeStream(s);
+        return;
     }
-
-    PAL_DBG(LOG_TAG, "Exit, ret %d", ret);
-    return ret;
+    if (!concState.streams.count(s) && !s->getStreamAttributes(&sAttr))
+        concState.addStream(s, &sAttr);
 }
 
-int ResourceManager::isActiveStream(pal_stream_handle_t *handle) {
-    for (auto &s : mActiveStreams) {
-        if (handle == reinterpret_cast<uint64_t *>(s)) {
-            return true;
-        }
-    }
-    return false;
+// NOTE: this api should be called with mResourceManagerMutex locked
+void ResourceManager::updateDeviceConcurrencyState_l(std::shared_ptr<Device> d,
+        Stream *s, bool registered)
+{
+    if (registered)
+        concState.addDeviceUser(d.get(), d->getSndDeviceId(), s);
+    else
+        concState.removeDeviceUser(d.get(), d->getSndDeviceId(), s);
 }
 
 int ResourceManager::initStreamUserCounter(Stream *s)
@@ -3607,6 +3665,11 @@ void ResourceManager::disableInternalECRefs(Stream *s)
     std::vector<std::shared_ptr<Device>> associatedDevices;
 
     PAL_DBG(LOG_TAG, "Enter");
+    if (!concState.numTx) {
+        PAL_DBG(LOG_TAG, "Exit, no tx stream");
+        return;
+    }
+
     for (auto str: mActiveStreams) {
         associatedDevices.clear();
         if (!str)
@@ -3653,6 +3716,11 @@ void ResourceManager::restoreInternalECRefs()
     std::vector<std::shared_ptr<Device>> associatedDevices;
 
     PAL_DBG(LOG_TAG, "Enter");
+    if (!concState.numTx) {
+        PAL_DBG(LOG_TAG, "Exit, no tx stream");
+        return;
+    }
+
     for (auto str: mActiveStreams) {
         associatedDevices.clear();
         if (!str)
@@ -3883,7 +3951,7 @@ int ResourceManager::checkandEnableECForRXStream_l(std::shared_ptr<Device> rx_de
     tx_streams_list = getConcurrentTxStream_l(rx_stream, rx_dev);
     for (auto tx_stream: tx_streams_list) {
         tx_devices.clear();
-        if (!tx_stream || !isStreamActive(tx_stream, mActiveStreams)) {
+        if (!tx_stream || !concState.streams.count(tx_stream)) {
             PAL_ERR(LOG_TAG, "TX Stream Empty or is not active\n");
             continue;
         }
@@ -4000,10 +4068,12 @@ int ResourceManager::registerDevice_l(std::shared_ptr<Device> d, Stream *s)
 
     auto iter = std::find(active_devices.begin(),
         active_devices.end(), std::make_pair(d, s));
-    if (iter == active_devices.end())
+    if (iter == active_devices.end()) {
         active_devices.push_back(std::make_pair(d, s));
-    else
+        updateDeviceConcurrencyState_l(d, s, true);
+    } else {
         ret = -EINVAL;
+    }
     PAL_DBG(LOG_TAG, "Exit.");
     return ret;
 }
@@ -4042,9 +4112,10 @@ int ResourceManager::deregisterDevice_l(std::shared_ptr<Device> d, Stream *s)
 
     auto iter = std::find(active_devices.begin(),
         active_devices.end(), std::make_pair(d, s));
-    if (iter != active_devices.end())
+    if (iter != active_devices.end()) {
         active_devices.erase(iter);
-    else {
+        updateDeviceConcurrencyState_l(d, s, false);
+    } else {
         ret = -ENOENT;
         PAL_ERR(LOG_TAG, "no device %d found in active device list ret %d",
                 d->getSndDeviceId(), ret);
@@ -4080,17 +4151,12 @@ int ResourceManager::deregisterDevice(std::shared_ptr<Device> d, Stream *s)
 bool ResourceManager::isDeviceActive(pal_device_id_t deviceId)
 {
     bool is_active = false;
-    int candidateDeviceId;
     PAL_DBG(LOG_TAG, "Enter.");
 
     mResourceManagerMutex.lock();
-    for (int i = 0; i < active_devices.size(); i++) {
-        candidateDeviceId = active_devices[i].first->getSndDeviceId();
-        if (deviceId == candidateDeviceId) {
-            is_active = true;
-            PAL_INFO(LOG_TAG, "deviceid of %d is active", deviceId);
-            break;
-        }
+    if (concState.numByDevice.count(deviceId)) {
+        is_active = true;
+        PAL_INFO(LOG_TAG, "deviceid of %d is active", deviceId);
     }
 
     mResourceManagerMutex.unlock();
@@ -4116,11 +4182,8 @@ bool ResourceManager::isDeviceActive_l(std::shared_ptr<Device> d, Stream *s)
     int deviceId = d->getSndDeviceId();
 
     PAL_DBG(LOG_TAG, "Enter.");
-    auto iter = std::find(active_devices.begin(),
-        active_devices.end(), std::make_pair(d, s));
-    if (iter != active_devices.end()) {
+    if (concState.deviceUsers.count(std::make_pair(d.get(), s)))
         is_active = true;
-    }
 
     PAL_DBG(LOG_TAG, "Exit. device %d is active %d", deviceId, is_active);
     return is_active;
@@ -4679,7 +4742,6 @@ int ResourceManager::registerMixerEventCallback(const std::vector<int> &DevIds,
                                                 uint64_t cookie,
                                                 bool is_register) {
     int status = 0;
-    std::map<int, std::pair<session_callback, uint64_t>>::iterator it;
 
     if (!callback || DevIds.size() <= 0) {
         PAL_ERR(LOG_TAG, "Invalid callback or pcm ids");
@@ -4694,34 +4756,10 @@ int ResourceManager::registerMixerEventCallback(const std::vector<int> &DevIds,
     }
 
     if (is_register) {
-        for (int i = 0; i < DevIds.size(); i++) {
-            it = mixerEventCallbackMap.find(DevIds[i]);
-            if (it != mixerEventCallbackMap.end()) {
-                PAL_DBG(LOG_TAG, "callback exists for pcm id %d, overwrite",
-                    DevIds[i]);
-                mixerEventCallbackMap.erase(it);
-            }
-            mixerEventCallbackMap.insert(std::make_pair(DevIds[i],
-                std::make_pair(callback, cookie)));
-
-        }
+        status = mixerEventDispatcher.registerCallback(DevIds, callback, cookie);
         mixerEventRegisterCount++;
     } else {
-        for (int i = 0; i < DevIds.size(); i++) {
-            it = mixerEventCallbackMap.find(DevIds[i]);
-            if (it != mixerEventCallbackMap.end()) {
-                PAL_DBG(LOG_TAG, "callback found for pcm id %d, remove",
-                    DevIds[i]);
-                if (callback == it->second.first) {
-                    mixerEventCallbackMap.erase(it);
-                } else {
-                    PAL_ERR(LOG_TAG, "No matching callback found for pcm id %d",
-                        DevIds[i]);
-                }
-            } else {
-                PAL_ERR(LOG_TAG, "No callback found for pcm id %d", DevIds[i]);
-            }
-        }
+        status = mixerEventDispatcher.deregisterCallback(DevIds, callback);
         mixerEventRegisterCount--;
     }
 
@@ -4776,8 +4814,6 @@ void ResourceManager::mixerEventWaitThreadLoop(
 int ResourceManager::handleMixerEvent(struct mixer *mixer, char *mixer_str) {
     int status = 0;
     int pcm_id = 0;
-    uint64_t cookie = 0;
-    session_callback session_cb = nullptr;
     std::string event_str(mixer_str);
     // TODO: hard code in common defs
     std::string pcm_prefix = "PCM";
@@ -4790,7 +4826,6 @@ int ResourceManager::handleMixerEvent(struct mixer *mixer, char *mixer_str) {
     char *buf = nullptr;
     unsigned int num_values;
     struct agm_event_cb_params *params = nullptr;
-    std::map<int, std::pair<session_callback, uint64_t>>::iterator it;
 
     PAL_DBG(LOG_TAG, "Enter");
     ctl = mixer_get_ctl_by_name(mixer, mixer_str);
@@ -4851,22 +4886,9 @@ int ResourceManager::handleMixerEvent(struct mixer *mixer, char *mixer_str) {
     length = suffix_idx - prefix_idx;
     pcm_id = std::stoi(event_str.substr(prefix_idx, length));
 
-    // acquire callback/cookie with pcm dev id
-    it = mixerEventCallbackMap.find(pcm_id);
-    if (it != mixerEventCallbackMap.end()) {
-        session_cb = it->second.first;
-        cookie = it->second.second;
-    }
-
-    if (!session_cb) {
-        status = -EINVAL;
-        PAL_ERR(LOG_TAG, "Invalid session callback");
-        goto exit;
-    }
-
-    // callback
-    session_cb(cookie, params->event_id, (void *)params->event_payload,
-                 params->event_payload_size, params->source_module_id);
+    // queue event to the subscriber of this pcm dev id, which owns buf now
+    status = mixerEventDispatcher.dispatch(pcm_id, buf);
+    buf = nullptr;
 
 exit:
     if (buf)
@@ -4880,27 +4902,14 @@ exit:
 int ResourceManager::HandleDetectionStreamAction(pal_stream_type_t type, int32_t action, void *data)
 {
     int status = 0;
-    pal_stream_attributes st_attr;
 
-    if ((type == PAL_STREAM_VOICE_UI &&
-         !active_streams_st.size()) ||
-        (type == PAL_STREAM_ACD &&
-         !active_streams_acd.size()) ||
-        (type == PAL_STREAM_SENSOR_PCM_DATA &&
-         !active_streams_sensor_pcm_data.size())) {
+    if (type >= PAL_STREAM_MAX || !concState.numByType[type]) {
         PAL_VERBOSE(LOG_TAG, "No active stream for type %d, skip action", type);
         return 0;
     }
 
     PAL_DBG(LOG_TAG, "Enter");
-    for (auto& str: mActiveStreams) {
-        if (!isStreamActive(str, mActiveStreams))
-            continue;
-
-        str->getStreamAttributes(&st_attr);
-        if (st_attr.type != type)
-            continue;
-
+    for (auto& str: concState.byType[type]) {
         switch (action) {
             case ST_PAUSE:
                 if (str != (Stream *)data) {
@@ -5278,6 +5287,9 @@ std::shared_ptr<Device> ResourceManager::getActiveEchoReferenceRxDevices_l(
         goto exit;
     }
 
+    if (!concState.numRx)
+        goto exit;
+
     // get associated device list
     status = tx_str->getAssociatedDevices(tx_device_list);
     if (status) {
@@ -5342,7 +5354,7 @@ std::vector<Stream*> ResourceManager::getConcurrentTxStream_l(
     int deviceId = 0;
     int status = 0;
     std::vector<Stream*> tx_stream_list;
-    struct pal_stream_attributes tx_attr;
+    pal_stream_type_t tx_type;
     struct pal_stream_attributes rx_attr;
     std::shared_ptr<Device> tx_device = nullptr;
     std::vector <std::shared_ptr<Device>> tx_device_list;
@@ -5360,34 +5372,32 @@ std::vector<Stream*> ResourceManager::getConcurrentTxStream_l(
         goto exit;
     }
 
-    for (auto& tx_str: mActiveStreams) {
-        tx_device_list.clear();
-        tx_str->getStreamAttributes(&tx_attr);
-        if (tx_attr.type == PAL_STREAM_PROXY ||
-            tx_attr.type == PAL_STREAM_ULTRA_LOW_LATENCY ||
-            tx_attr.type == PAL_STREAM_GENERIC)
+    for (auto& tx_str: concState.txStreams) {
+        tx_type = concState.streams[tx_str].type;
+        if (tx_type == PAL_STREAM_PROXY ||
+            tx_type == PAL_STREAM_ULTRA_LOW_LATENCY ||
+            tx_type == PAL_STREAM_GENERIC)
             continue;
-        if (tx_attr.direction == PAL_AUDIO_INPUT) {
-            if (!getEcRefStatus(tx_attr.type, rx_attr.type)) {
-                PAL_DBG(LOG_TAG, "No need to enable ec ref for rx %d tx %d",
-                        rx_attr.type, tx_attr.type);
+        if (!getEcRefStatus(tx_type, rx_attr.type)) {
+            PAL_DBG(LOG_TAG, "No need to enable ec ref for rx %d tx %d",
+                    rx_attr.type, tx_type);
+            continue;
+        }
+        tx_device_list.clear();
+        tx_str->getAssociatedDevices(tx_device_list);
+        for (int i = 0; i < tx_device_list.size(); i++) {
+            if (!isDeviceActive_l(tx_device_list[i], tx_str))
                 continue;
-            }
-            tx_str->getAssociatedDevices(tx_device_list);
-            for (int i = 0; i < tx_device_list.size(); i++) {
-                if (!isDeviceActive_l(tx_device_list[i], tx_str))
-                    continue;
-                deviceId = tx_device_list[i]->getSndDeviceId();
-                if (deviceId > PAL_DEVICE_IN_MIN &&
-                    deviceId < PAL_DEVICE_IN_MAX)
-                    tx_device = tx_device_list[i];
-                else
-                    tx_device = nullptr;
+            deviceId = tx_device_list[i]->getSndDeviceId();
+            if (deviceId > PAL_DEVICE_IN_MIN &&
+                deviceId < PAL_DEVICE_IN_MAX)
+                tx_device = tx_device_list[i];
+            else
+                tx_device = nullptr;
 
-                if (checkECRef(rx_device, tx_device)) {
-                    tx_stream_list.push_back(tx_str);
-                    break;
-                }
+            if (checkECRef(rx_device, tx_device)) {
+                tx_stream_list.push_back(tx_str);
+                break;
             }
         }
     }
@@ -5617,9 +5627,9 @@ void ResourceManager::getHigherPriorityActiveStreams(const int inComingStreamPri
 
 template <class T>
 void getActiveStreams(std::shared_ptr<Device> d, std::vector<Stream*> &activestreams,
-                      std::list<T> sourcestreams)
+                      const std::list<T> &sourcestreams)
 {
-    for (typename std::list<T>::iterator iter = sourcestreams.begin();
+    for (typename std::list<T>::const_iterator iter = sourcestreams.begin();
                  iter != sourcestreams.end(); iter++) {
         std::vector <std::shared_ptr<Device>> devices;
         (*iter)->getAssociatedDevices(devices);
@@ -5795,7 +5805,7 @@ void ResourceManager::checkHapticsConcurrency(struct pal_device *deviceattr,
         struct pal_device *curDevAttr)
 {
     std::vector <std::tuple<Stream *, uint32_t>> sharedBEStreamDev;
-    std::vector <Stream *> activeHapticsStreams;
+    bool hapticsActive = false;
 
     if (!deviceattr) {
         PAL_ERR(LOG_TAG, "Invalid device attribute");
@@ -5817,8 +5827,18 @@ void ResourceManager::checkHapticsConcurrency(struct pal_device *deviceattr,
             PAL_ERR(LOG_TAG, "Getting Device instance failed");
             return;
         }
-        getActiveStream_l(activeHapticsStreams, hapticsDev);
-        if (activeHapticsStreams.size() != 0) {
+        // only haptics streams are routed to the haptics device
+        for (auto& str: concState.byType[PAL_STREAM_HAPTICS]) {
+            std::vector<std::shared_ptr<Device>> devices;
+
+            str->getAssociatedDevices(devices);
+            if (str->isAlive() &&
+                std::find(devices.begin(), devices.end(), hapticsDev) != devices.end()) {
+                hapticsActive = true;
+                break;
+            }
+        }
+        if (hapticsActive) {
             hapticsDev->getDeviceAttributes(&hapticsDattr);
             if ((deviceattr->config.sample_rate % SAMPLINGRATE_44K == 0) &&
                 (hapticsDattr.config.sample_rate % SAMPLINGRATE_44K != 0)) {
@@ -5833,8 +5853,10 @@ void ResourceManager::checkHapticsConcurrency(struct pal_device *deviceattr,
                hsDev->setSampleRate(0);
         }
     } else if (deviceattr->id == PAL_DEVICE_OUT_HAPTICS_DEVICE) {
-        // if haptics is coming, update headset sample rate if needed
-        getSharedBEActiveStreamDevs(sharedBEStreamDev, PAL_DEVICE_OUT_WIRED_HEADSET);
+        // if haptics is coming, update headset sample rate if needed,
+        // only RX streams can be on the headset backend
+        if (concState.numRx)
+            getSharedBEActiveStreamDevs(sharedBEStreamDev, PAL_DEVICE_OUT_WIRED_HEADSET);
         if (sharedBEStreamDev.size() > 0) {
             for (const auto &elem : sharedBEStreamDev) {
                 bool switchNeeded = false;
@@ -5871,6 +5893,8 @@ bool ResourceManager::isGroupConfigAvailable(group_dev_config_idx_t idx)
 {
     std::map<group_dev_config_idx_t, std::shared_ptr<group_dev_config_t>>::iterator it;
 
+    loadXmlSection("group_device_cfg");
+
     it = groupDevConfigMap.find(idx);
     if (it != groupDevConfigMap.end())
         return true;
@@ -5890,6 +5914,8 @@ int ResourceManager::checkAndUpdateGroupDevConfig(struct pal_device *deviceattr,
     std::vector<Stream*>::iterator sIter;
     group_dev_config_idx_t group_cfg_idx = GRP_DEV_CONFIG_INVALID;
 
+    loadXmlSection("group_device_cfg");
+
     if (!deviceattr) {
         PAL_ERR(LOG_TAG, "Invalid deviceattr");
         return -EINVAL;
@@ -6062,15 +6088,8 @@ int ResourceManager::checkAndUpdateGroupDevConfig(struct pal_device *deviceattr,
                             }
                         // if coming usecase is not voice call but voice call already active
                         // still set group config for speaker as voice speaker
-                        } else {
-                            pal_stream_type_t type;
-                            for (auto& str: mActiveStreams) {
-                                str->getStreamType(&type);
-                                if (type == PAL_STREAM_VOICE_CALL) {
-                                    group_cfg_idx = GRP_SPEAKER_VOICE;
-                                    break;
-                                }
-                            }
+                        } else if (concState.numByType[PAL_STREAM_VOICE_CALL]) {
+                            group_cfg_idx = GRP_SPEAKER_VOICE;
                         }
                     }
                 }
@@ -6112,7 +6131,6 @@ int ResourceManager::checkAndUpdateGroupDevConfig(struct pal_device *deviceattr,
 
 void ResourceManager::checkAndSetDutyCycleParam()
 {
-    pal_stream_attributes StrAttr;
     std::shared_ptr<Device> dev = nullptr;
     struct pal_device DevAttr;
     std::string backEndName;
@@ -6130,10 +6148,8 @@ void ResourceManager::checkAndSetDutyCycleParam()
     }
 
     // check if UPD is already active
-    for (auto& str: mActiveStreams) {
-        str->getStreamAttributes(&StrAttr);
-        if (StrAttr.type == PAL_STREAM_ULTRASOUND &&
-            str->isActive()) {
+    for (auto& str: active_streams_ultrasound) {
+        if (str->isActive()) {
             is_upd_active = true;
             // enable duty by default, this may change based on concurrency.
             // during device switch, upd stream can active, but RX device is
@@ -6296,6 +6312,8 @@ void ResourceManager::deinit()
     card_status_t state = CARD_STATUS_NONE;
 
     mixerClosed = true;
+    StreamGraphPool::getInstance()->deinit();
+    MixerPathPlanner::getInstance()->deinit();
     mixer_close(audio_virt_mixer);
     mixer_close(audio_hw_mixer);
     if (audio_route) {
@@ -6305,6 +6323,7 @@ void ResourceManager::deinit()
         mixerEventTread.join();
     }
     PAL_DBG(LOG_TAG, "Mixer event thread joined");
+    mixerEventDispatcher.stopAll();
     if (sndmon)
         delete sndmon;
 
@@ -7157,7 +7176,7 @@ int32_t ResourceManager::streamDevDisconnect(std::vector <std::tuple<Stream *, u
 
     /* disconnect active list from the current devices they are attached to */
     for (sIter = streamDevDisconnectList.begin(); sIter != streamDevDisconnectList.end(); sIter++) {
-        if ((std::get<0>(*sIter) != NULL) && isStreamActive(std::get<0>(*sIter), mActiveStreams)) {
+        if ((std::get<0>(*sIter) != NULL) && concState.streams.count(std::get<0>(*sIter))) {
             status = (std::get<0>(*sIter))->disconnectStreamDevice(std::get<0>(*sIter), (pal_device_id_t)std::get<1>(*sIter));
             if (status) {
                 PAL_ERR(LOG_TAG, "failed to disconnect stream %pK from device %d",
@@ -7181,7 +7200,7 @@ int32_t ResourceManager::streamDevConnect(std::vector <std::tuple<Stream *, stru
     PAL_DBG(LOG_TAG, "Enter");
     /* connect active list from the current devices they are attached to */
     for (sIter = streamDevConnectList.begin(); sIter != streamDevConnectList.end(); sIter++) {
-        if ((std::get<0>(*sIter) != NULL) && isStreamActive(std::get<0>(*sIter), mActiveStreams)) {
+        if ((std::get<0>(*sIter) != NULL) && concState.streams.count(std::get<0>(*sIter))) {
             status = std::get<0>(*sIter)->connectStreamDevice(std::get<0>(*sIter), std::get<1>(*sIter));
             if (status) {
                 PAL_ERR(LOG_TAG,"failed to connect stream %pK from device %d",
@@ -7206,7 +7225,7 @@ int32_t ResourceManager::streamDevDisconnect_l(std::vector <std::tuple<Stream *,
 
     /* disconnect active list from the current devices they are attached to */
     for (sIter = streamDevDisconnectList.begin(); sIter != streamDevDisconnectList.end(); sIter++) {
-        if ((std::get<0>(*sIter) != NULL) && isStreamActive(std::get<0>(*sIter), mActiveStreams)) {
+        if ((std::get<0>(*sIter) != NULL) && concState.streams.count(std::get<0>(*sIter))) {
             status = (std::get<0>(*sIter))->disconnectStreamDevice_l(std::get<0>(*sIter), (pal_device_id_t)std::get<1>(*sIter));
             if (status) {
                 PAL_ERR(LOG_TAG, "failed to disconnect stream %pK from device %d",
@@ -7230,7 +7249,7 @@ int32_t ResourceManager::streamDevConnect_l(std::vector <std::tuple<Stream *, st
     PAL_DBG(LOG_TAG, "Enter");
     /* connect active list from the current devices they are attached to */
     for (sIter = streamDevConnectList.begin(); sIter != streamDevConnectList.end(); sIter++) {
-        if ((std::get<0>(*sIter) != NULL) && isStreamActive(std::get<0>(*sIter), mActiveStreams)) {
+        if ((std::get<0>(*sIter) != NULL) && concState.streams.count(std::get<0>(*sIter))) {
             status = std::get<0>(*sIter)->connectStreamDevice_l(std::get<0>(*sIter), std::get<1>(*sIter));
             if (status) {
                 PAL_ERR(LOG_TAG,"failed to connect stream %pK from device %d",
@@ -7261,6 +7280,7 @@ void SortAndUnique(std::vector<T> &streams)
 int32_t ResourceManager::streamDevSwitch(std::vector <std::tuple<Stream *, uint32_t>> streamDevDisconnectList,
                                          std::vector <std::tuple<Stream *, struct pal_device *>> streamDevConnectList)
 {
+    PAL_TRACE_SPAN("ResourceManager::streamDevSwitch");
     int status = 0;
     std::vector <Stream*>::iterator sIter;
     std::vector <struct pal_device *>::iterator dIter;
@@ -7288,14 +7308,14 @@ int32_t ResourceManager::streamDevSwitch(std::vector <std::tuple<Stream *, uint3
      * middle of the switch
      */
     for (sIter1 = streamDevDisconnectList.begin(); sIter1 != streamDevDisconnectList.end(); sIter1++) {
-        if ((std::get<0>(*sIter1) != NULL) && isStreamActive(std::get<0>(*sIter1), mActiveStreams)) {
+        if ((std::get<0>(*sIter1) != NULL) && concState.streams.count(std::get<0>(*sIter1))) {
             uniqueStreamsList.push_back(std::get<0>(*sIter1));
             PAL_VERBOSE(LOG_TAG, "streamDevDisconnectList stream %pK", std::get<0>(*sIter1));
         }
     }
 
     for (sIter2 = streamDevConnectList.begin(); sIter2 != streamDevConnectList.end(); sIter2++) {
-        if ((std::get<0>(*sIter2) != NULL) && isStreamActive(std::get<0>(*sIter2), mActiveStreams)) {
+        if ((std::get<0>(*sIter2) != NULL) && concState.streams.count(std::get<0>(*sIter2))) {
             uniqueStreamsList.push_back(std::get<0>(*sIter2));
             PAL_VERBOSE(LOG_TAG, "streamDevConnectList stream %pK", std::get<0>(*sIter2));
             uniqueDevConnectionList.push_back(std::get<1>(*sIter2));
@@ -7354,7 +7374,7 @@ int32_t ResourceManager::streamDevSwitch(std::vector <std::tuple<Stream *, uint3
     }
 
     for (sIter2 = streamDevConnectList.begin(); sIter2 != streamDevConnectList.end(); sIter2++) {
-        if ((std::get<0>(*sIter2) != NULL) && isStreamActive(std::get<0>(*sIter2), mActiveStreams)) {
+        if ((std::get<0>(*sIter2) != NULL) && concState.streams.count(std::get<0>(*sIter2))) {
             for (sIter = uniqueStreamsList.begin(); sIter != uniqueStreamsList.end(); sIter++) {
                 if (*sIter == std::get<0>(*sIter2)) {
                     uniqueStreamsList.erase(sIter);
@@ -7514,7 +7534,7 @@ int32_t ResourceManager::forceDeviceSwitch(std::shared_ptr<Device> inDev,
     if (!status) {
         mActiveStreamMutex.lock();
         for (sIter = activeStreams.begin(); sIter != activeStreams.end(); sIter++) {
-            if (((*sIter) != NULL) && isStreamActive(*sIter, mActiveStreams)) {
+            if (((*sIter) != NULL) && concState.streams.count(*sIter)) {
                 (*sIter)->lockStreamMutex();
                 (*sIter)->clearOutPalDevices(*sIter);
                 (*sIter)->addPalDevice(*sIter, newDevAttr);
@@ -7547,7 +7567,7 @@ int32_t ResourceManager::forceDeviceSwitch(std::shared_ptr<Device> inDev,
     // create dev switch vectors
     mActiveStreamMutex.lock();
     for (sIter = prevActiveStreams.begin(); sIter != prevActiveStreams.end(); sIter++) {
-        if (((*sIter) != NULL) && isStreamActive((*sIter), mActiveStreams)) {
+        if (((*sIter) != NULL) && concState.streams.count((*sIter))) {
             streamDevDisconnect.push_back({(*sIter), inDev->getSndDeviceId()});
             streamDevConnect.push_back({(*sIter), newDevAttr});
         }
@@ -7557,7 +7577,7 @@ int32_t ResourceManager::forceDeviceSwitch(std::shared_ptr<Device> inDev,
     if (!status) {
         mActiveStreamMutex.lock();
         for (sIter = prevActiveStreams.begin(); sIter != prevActiveStreams.end(); sIter++) {
-            if (((*sIter) != NULL) && isStreamActive(*sIter, mActiveStreams)) {
+            if (((*sIter) != NULL) && concState.streams.count(*sIter)) {
                 (*sIter)->lockStreamMutex();
                 (*sIter)->clearOutPalDevices(*sIter);
                 (*sIter)->addPalDevice(*sIter, newDevAttr);
@@ -7629,6 +7649,8 @@ void ResourceManager::updateVirtualBESndName()
     std::shared_ptr<group_dev_config_t> group_device_config = NULL;
     group_dev_config_idx_t grp_dev_cfgs[] = {GRP_UPD_RX_HANDSET, GRP_UPD_RX_SPEAKER};
 
+    loadXmlSection("group_device_cfg");
+
     if (!isVbatEnabled)
         return;
 
@@ -7831,6 +7853,7 @@ int ResourceManager::setConfigParams(struct str_parms *parms)
     ret = setUpdDutyCycleEnableParam(parms, value, len);
     ret = setUpdVirtualPortParam(parms, value, len);
     ret = setSpkrXmaxTmaxLoggingParam(parms, value, len);
+    ret = setWarmGraphPoolParams(parms, value, len);
 
     /* Not checking return value as this is optional */
     setLpiLoggingParams(parms, value, len);
@@ -7992,6 +8015,50 @@ int ResourceManager::setSpkrXmaxTmaxLoggingParam(struct str_parms* parms,
     return ret;
 }
 
+/* comma separated stream types, e.g. PAL_STREAM_LOW_LATENCY,PAL_STREAM_RAW */
+int ResourceManager::setWarmGraphPoolParams(struct str_parms *parms,
+    char *value, int len)
+{
+    int ret = -EINVAL;
+    std::vector<uint32_t> types;
+    char *type = NULL;
+    char *savePtr = NULL;
+
+    if (!value || !parms)
+        return ret;
+
+    ret = str_parms_get_str(parms, AUDIO_PARAMETER_KEY_WARM_GRAPH_POOL_SIZE,
+        value, len);
+    if (ret >= 0) {
+        StreamGraphPool::getInstance()->setBudget(atoi(value));
+        str_parms_del(parms, AUDIO_PARAMETER_KEY_WARM_GRAPH_POOL_SIZE);
+    }
+
+    ret = str_parms_get_str(parms, AUDIO_PARAMETER_KEY_WARM_GRAPH_POOL_TIMEOUT,
+        value, len);
+    if (ret >= 0) {
+        StreamGraphPool::getInstance()->setGracePeriod(atoi(value));
+        str_parms_del(parms, AUDIO_PARAMETER_KEY_WARM_GRAPH_POOL_TIMEOUT);
+    }
+
+    ret = str_parms_get_str(parms, AUDIO_PARAMETER_KEY_WARM_GRAPH_POOL_STREAMS,
+        value, len);
+    if (ret >= 0) {
+        for (type = strtok_r(value, ",", &savePtr); type;
+             type = strtok_r(NULL, ",", &savePtr)) {
+            if (usecaseIdLUT.find(type) == usecaseIdLUT.end()) {
+                PAL_ERR(LOG_TAG, "unknown stream type %s for warm graph pool", type);
+                continue;
+            }
+            types.push_back(usecaseIdLUT.at(type));
+        }
+        StreamGraphPool::getInstance()->setStreamTypes(types);
+        str_parms_del(parms, AUDIO_PARAMETER_KEY_WARM_GRAPH_POOL_STREAMS);
+    }
+
+    return ret;
+}
+
 int ResourceManager::setUpdVirtualPortParam(struct str_parms *parms, char *value, int len)
 {
     int ret = -EINVAL;
@@ -8236,6 +8303,8 @@ int32_t ResourceManager::a2dpSuspend(pal_device_id_t dev_id)
     std::vector <Stream *> activeStreams;
     std::vector <Stream*>::iterator sIter;
     std::vector <std::shared_ptr<Device>> associatedDevices;
+    std::vector <std::tuple<Stream *, uint64_t, uint32_t>> drainStreams;
+    uint64_t writtenUs = 0;
 
     PAL_DBG(LOG_TAG, "enter");
 
@@ -8310,7 +8379,7 @@ int32_t ResourceManager::a2dpSuspend(pal_device_id_t dev_id)
         switchDevDattr.id);
 
     for (sIter = activeA2dpStreams.begin(); sIter != activeA2dpStreams.end(); sIter++) {
-        if (((*sIter) != NULL) && isStreamActive(*sIter, mActiveStreams)) {
+        if (((*sIter) != NULL) && concState.streams.count(*sIter)) {
             associatedDevices.clear();
             status = (*sIter)->getAssociatedDevices(associatedDevices);
             if ((0 != status) ||
@@ -8354,6 +8423,10 @@ int32_t ResourceManager::a2dpSuspend(pal_device_id_t dev_id)
                     latencyMs = (*sIter)->getLatency();
                     if (maxLatencyMs < latencyMs)
                         maxLatencyMs = latencyMs;
+                    // data written up to mute has to be rendered before the switch
+                    if ((*sIter)->getWrittenDuration(&writtenUs))
+                        writtenUs = 0;
+                    drainStreams.push_back(std::make_tuple(*sIter, writtenUs, latencyMs));
                     // Mute
                     if (!(*sIter)->mute_l(true))
                         (*sIter)->a2dpMuted = true;
@@ -8366,18 +8439,14 @@ int32_t ResourceManager::a2dpSuspend(pal_device_id_t dev_id)
     mActiveStreamMutex.unlock();
 
     // wait for stale pcm drained before switching to speaker
-    if (maxLatencyMs > 0) {
-        // multiplication factor applied to latency when calculating a safe mute delay
-        // TODO: It's not needed if latency is accurate.
-        const int latencyMuteFactor = 2;
-        usleep(maxLatencyMs * 1000 * latencyMuteFactor);
-    }
+    if (maxLatencyMs > 0)
+        waitForStalePcmDrained(drainStreams, maxLatencyMs);
 
     forceDeviceSwitch(a2dpDev, &switchDevDattr, activeA2dpStreams);
 
     mActiveStreamMutex.lock();
     for (sIter = activeA2dpStreams.begin(); sIter != activeA2dpStreams.end(); sIter++) {
-        if (((*sIter) != NULL) && isStreamActive(*sIter, mActiveStreams)) {
+        if (((*sIter) != NULL) && concState.streams.count(*sIter)) {
             (*sIter)->lockStreamMutex();
             struct pal_stream_attributes sAttr;
             (*sIter)->getStreamAttributes(&sAttr);
@@ -8402,6 +8471,68 @@ exit:
     return status;
 }
 
+/*
+ * Waits until each muted stream rendered the data written before mute,
+ * as reported by its session time. Streams without position information
+ * fall back to the latency estimate, which also bounds the wait.
+ */
+void ResourceManager::waitForStalePcmDrained(
+        std::vector<std::tuple<Stream *, uint64_t, uint32_t>> &streams,
+        uint32_t maxLatencyMs)
+{
+    // multiplication factor applied to latency when calculating a safe mute delay
+    const int latencyMuteFactor = 2;
+    const uint32_t pollIntervalUs = 5000;
+    struct pal_session_time stime;
+    uint64_t renderedUs = 0;
+    uint32_t elapsedMs = 0;
+    auto begin = std::chrono::steady_clock::now();
+
+    for (;;) {
+        elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - begin).count();
+        if (streams.empty() || elapsedMs >= maxLatencyMs * latencyMuteFactor)
+            break;
+
+        mActiveStreamMutex.lock();
+        for (auto it = streams.begin(); it != streams.end();) {
+            Stream *s = std::get<0>(*it);
+            uint64_t writtenUs = std::get<1>(*it);
+
+            if (!concState.streams.count(s)) {
+                it = streams.erase(it);
+                continue;
+            }
+
+            if (writtenUs) {
+                if (s->getTimestamp(&stime)) {
+                    PAL_DBG(LOG_TAG, "no position for stream %pK, use latency", s);
+                    std::get<1>(*it) = 0;
+                } else {
+                    renderedUs = ((uint64_t)stime.session_time.value_msw << 32) |
+                                 stime.session_time.value_lsw;
+                    if (renderedUs >= writtenUs) {
+                        it = streams.erase(it);
+                        continue;
+                    }
+                }
+            } else if (elapsedMs >= std::get<2>(*it) * latencyMuteFactor) {
+                it = streams.erase(it);
+                continue;
+            }
+            ++it;
+        }
+        mActiveStreamMutex.unlock();
+
+        if (!streams.empty())
+            usleep(pollIntervalUs);
+    }
+
+    PAL_INFO(LOG_TAG, "stale pcm drained in %u ms, %u ms saved over latency estimate",
+             elapsedMs, maxLatencyMs * latencyMuteFactor - std::min(elapsedMs,
+             maxLatencyMs * latencyMuteFactor));
+}
+
 int32_t ResourceManager::a2dpResume(pal_device_id_t dev_id)
 {
     int status = 0;
@@ -8524,7 +8655,7 @@ int32_t ResourceManager::a2dpResume(pal_device_id_t dev_id)
 
     mActiveStreamMutex.lock();
     for (sIter = restoredStreams.begin(); sIter != restoredStreams.end(); sIter++) {
-        if (((*sIter) != NULL) && isStreamActive(*sIter, mActiveStreams)) {
+        if (((*sIter) != NULL) && concState.streams.count(*sIter)) {
             (*sIter)->lockStreamMutex();
             // update PAL devices for the restored streams
             if ((*sIter)->suspendedDevIds.size() == 1 /* non-combo */) {
@@ -8623,7 +8754,7 @@ int32_t ResourceManager::a2dpCaptureSuspend(pal_device_id_t dev_id)
     }
 
     for (sIter = activeA2dpStreams.begin(); sIter != activeA2dpStreams.end(); sIter++) {
-        if (((*sIter) != NULL) && isStreamActive(*sIter, mActiveStreams)) {
+        if (((*sIter) != NULL) && concState.streams.count(*sIter)) {
             if (!((*sIter)->a2dpMuted)) {
                 (*sIter)->mute_l(true);
                 (*sIter)->a2dpMuted = true;
@@ -8637,7 +8768,7 @@ int32_t ResourceManager::a2dpCaptureSuspend(pal_device_id_t dev_id)
 
     mActiveStreamMutex.lock();
     for (sIter = activeA2dpStreams.begin(); sIter != activeA2dpStreams.end(); sIter++) {
-        if (((*sIter) != NULL) && isStreamActive(*sIter, mActiveStreams)) {
+        if (((*sIter) != NULL) && concState.streams.count(*sIter)) {
             (*sIter)->suspendedDevIds.clear();
             (*sIter)->suspendedDevIds.push_back(a2dpDattr.id);
         }
@@ -8732,7 +8863,7 @@ int32_t ResourceManager::a2dpCaptureResume(pal_device_id_t dev_id)
 
     mActiveStreamMutex.lock();
     for (sIter = restoredStreams.begin(); sIter != restoredStreams.end(); sIter++) {
-        if ((*sIter) && isStreamActive(*sIter, mActiveStreams)) {
+        if ((*sIter) && concState.streams.count(*sIter)) {
             (*sIter)->suspendedDevIds.clear();
             (*sIter)->mute_l(false);
             (*sIter)->a2dpMuted = false;
@@ -8840,6 +8971,25 @@ int ResourceManager::getParameter(uint32_t param_id, void **param_payload,
             }
         }
         break;
+        case PAL_PARAM_ID_SP_XMAX_TMAX_STATS:
+        {
+            PAL_VERBOSE(LOG_TAG, "get parameter for Xmax/Tmax telemetry");
+            std::shared_ptr<Device> dev = nullptr;
+            struct pal_device dattr;
+            dattr.id = PAL_DEVICE_OUT_SPEAKER;
+            dev = Device::getInstance(&dattr , rm);
+            if (dev) {
+                status = dev->getParameter(PAL_PARAM_ID_SP_XMAX_TMAX_STATS,
+                                    param_payload);
+                if (status < 0) {
+                    PAL_ERR(LOG_TAG, "Failed to get Xmax/Tmax telemetry %d", status);
+                    goto exit;
+                }
+                *payload_size = status;
+                status = 0;
+            }
+        }
+        break;
         case PAL_PARAM_ID_SNDCARD_STATE:
         {
             PAL_VERBOSE(LOG_TAG, "get parameter for sndcard state");
@@ -8855,6 +9005,29 @@ int ResourceManager::getParameter(uint32_t param_id, void **param_payload,
             **(bool **)param_payload = isHifiFilterEnabled;
         }
         break;
+        case PAL_PARAM_ID_WARM_GRAPH_POOL_STATS:
+        {
+            PAL_VERBOSE(LOG_TAG, "get parameter for warm graph pool stats");
+
+            *payload_size = sizeof(pal_param_warm_graph_pool_stats_t);
+            StreamGraphPool::getInstance()->getStats(
+                *(pal_param_warm_graph_pool_stats_t **)param_payload);
+        }
+        break;
+        case PAL_PARAM_ID_POWER_VOTE_STATS:
+        {
+            pal_param_power_vote_stats_t *voteStats =
+                *(pal_param_power_vote_stats_t **)param_payload;
+
+            PAL_VERBOSE(LOG_TAG, "get parameter for power vote stats");
+            *payload_size = sizeof(pal_param_power_vote_stats_t);
+            memset(voteStats, 0, sizeof(pal_param_power_vote_stats_t));
+            for (int i = 0; i < PAL_POWER_VOTE_MAX; i++) {
+                if (mPowerVotes[i])
+                    mPowerVotes[i]->getStats(&voteStats->vote[i]);
+            }
+        }
+        break;
         default:
             status = -EINVAL;
             PAL_ERR(LOG_TAG, "Unknown ParamID:%d", param_id);
@@ -8929,6 +9102,23 @@ int ResourceManager::setParameter(uint32_t param_id, void *param_payload,
             }
         }
         break;
+        case PAL_PARAM_ID_SPAN_TRACE:
+        {
+            pal_param_span_trace_t *param_trace = (pal_param_span_trace_t *)param_payload;
+            if (payload_size == sizeof(pal_param_span_trace_t)) {
+                PAL_INFO(LOG_TAG, "span trace enable:%d", param_trace->enable);
+                param_trace->path[PAL_SPAN_TRACE_PATH_LEN - 1] = '\0';
+                if (param_trace->enable)
+                    status = PalSpanTracer::start(param_trace->path);
+                else
+                    status = PalSpanTracer::stop();
+            } else {
+                PAL_ERR(LOG_TAG,"Incorrect size : expected (%zu), received(%zu)",
+                        sizeof(pal_param_span_trace_t), payload_size);
+                status = -EINVAL;
+            }
+        }
+        break;
         case PAL_PARAM_ID_SCREEN_STATE:
         {
             pal_param_screen_state_t* param_screen_st = (pal_param_screen_state_t*) param_payload;
@@ -10619,6 +10809,8 @@ std::string ResourceManager::getBtCodecLib(uint32_t codecFormat, std::string cod
 {
     std::map<std::pair<uint32_t, std::string>, std::string>::iterator iter;
 
+    loadXmlSection("bt_codecs");
+
     iter = btCodecMap.find(std::make_pair(codecFormat, codecType));
     if (iter != btCodecMap.end()) {
         return iter->second;
@@ -10636,6 +10828,8 @@ uint32_t ResourceManager::getBtSlimClockSrc(uint32_t codecFormat)
 {
     std::map<uint32_t, std::uint32_t>::iterator iter;
 
+    loadXmlSection("bt_codecs");
+
     iter = btSlimClockSrcMap.find(codecFormat);
     if (iter != btSlimClockSrcMap.end())
         return iter->second;
@@ -10905,6 +11099,8 @@ int ResourceManager::getGainLevelMapping(struct pal_amp_db_and_gain_table *mapTb
 {
     int size = 0;
 
+    loadXmlSection("gain_db_to_level_mapping");
+
     if (gainLvlMap.empty()) {
         PAL_DBG(LOG_TAG, "empty or currupted gain_mapping_table");
         return 0;
@@ -11638,8 +11834,7 @@ void ResourceManager::startTag(void *userdata, const XML_Char *tag_name,
 void ResourceManager::endTag(void *userdata, const XML_Char *tag_name)
 {
     struct xml_userdata *data = (struct xml_userdata *)userdata;
-    std::shared_ptr<SoundTriggerPlatformInfo> st_info =
-        SoundTriggerPlatformInfo::GetInstance();
+    std::shared_ptr<SoundTriggerPlatformInfo> st_info = nullptr;
 
     if (!strcmp(tag_name, "sound_trigger_platform_info")) {
         data->is_parsing_sound_trigger = false;
@@ -11647,6 +11842,7 @@ void ResourceManager::endTag(void *userdata, const XML_Char *tag_name)
     }
 
     if (data->is_parsing_sound_trigger) {
+        st_info = SoundTriggerPlatformInfo::GetInstance();
         st_info->HandleEndTag(data, (const char *)tag_name);
         snd_reset_data_buf(data);
         return;
@@ -11757,6 +11953,232 @@ done:
     return ret;
 }
 
+/*
+ * Records the byte ranges of the children of the root element by tag name,
+ * without building any state, so that each one can be parsed on its own.
+ */
+int ResourceManager::indexXmlSections(const std::string &xml,
+        std::map<std::string, std::vector<std::pair<size_t, size_t>>> &sections)
+{
+    const char *buf = xml.c_str();
+    const char *skipEnd = NULL;
+    size_t size = xml.size();
+    size_t pos = 0;
+    size_t end = 0;
+    size_t nameLen = 0;
+    size_t sectionBegin = 0;
+    int depth = 0;
+    bool closing = false;
+    bool selfClosing = false;
+    char quote = 0;
+
+    xmlRootTag.clear();
+    while ((pos = xml.find('<', pos)) != std::string::npos) {
+        /* comments, CDATA, declarations and processing instructions */
+        if (buf[pos + 1] == '!' || buf[pos + 1] == '?') {
+            if (!strncmp(buf + pos, "<!--", 4))
+                skipEnd = "-->";
+            else if (!strncmp(buf + pos, "<![CDATA[", 9))
+                skipEnd = "]]>";
+            else if (buf[pos + 1] == '?')
+                skipEnd = "?>";
+            else
+                skipEnd = ">";
+            pos = xml.find(skipEnd, pos + 2);
+            if (pos == std::string::npos)
+                return -EINVAL;
+            pos += strlen(skipEnd);
+            continue;
+        }
+
+        /* find the end of the tag, '>' may be part of attribute values */
+        quote = 0;
+        for (end = pos + 1; end < size; end++) {
+            if (quote) {
+                if (buf[end] == quote)
+                    quote = 0;
+            } else if (buf[end] == '"' || buf[end] == '\'') {
+                quote = buf[end];
+            } else if (buf[end] == '>') {
+                break;
+            }
+        }
+        if (end >= size)
+            return -EINVAL;
+
+        closing = (buf[pos + 1] == '/');
+        selfClosing = (buf[end - 1] == '/');
+        nameLen = strcspn(buf + pos + 1 + closing, " \t\r\n/>");
+        if (closing) {
+            if (--depth < 0)
+                return -EINVAL;
+            if (depth == 1)
+                sections[std::string(buf + pos + 2, nameLen)].push_back(
+                        std::make_pair(sectionBegin, end + 1));
+        } else if (depth == 0) {
+            if (!xmlRootTag.empty() || selfClosing)
+                return -EINVAL;
+            xmlRootTag.assign(buf + pos + 1, nameLen);
+            xmlPrologEnd = end + 1;
+            depth++;
+        } else if (selfClosing) {
+            if (depth == 1)
+                sections[std::string(buf + pos + 1, nameLen)].push_back(
+                        std::make_pair(pos, end + 1));
+        } else {
+            if (depth == 1)
+                sectionBegin = pos;
+            depth++;
+        }
+        pos = end + 1;
+    }
+
+    return (depth || xmlRootTag.empty()) ? -EINVAL : 0;
+}
+
+int ResourceManager::parseXmlSections(const std::string &xml,
+        const std::vector<std::pair<size_t, size_t>> &ranges)
+{
+    XML_Parser parser;
+    int ret = 0;
+    std::string rootEnd;
+    struct xml_userdata data;
+    memset(&data, 0, sizeof(data));
+
+    parser = XML_ParserCreate(NULL);
+    if (!parser) {
+        ret = -EINVAL;
+        PAL_ERR(LOG_TAG, "Failed to create XML ret %d", ret);
+        goto done;
+    }
+
+    data.parser = parser;
+    XML_SetUserData(parser, &data);
+    XML_SetElementHandler(parser, startTag, endTag);
+    XML_SetCharacterDataHandler(parser, snd_data_handler);
+
+    /* the sections are fed one after the other inside the original root */
+    if (XML_Parse(parser, xml.data(), xmlPrologEnd, 0) == XML_STATUS_ERROR) {
+        ret = -EINVAL;
+        goto freeParser;
+    }
+    for (auto &range : ranges) {
+        if (XML_Parse(parser, xml.data() + range.first, range.second - range.first,
+                      0) == XML_STATUS_ERROR) {
+            ret = -EINVAL;
+            goto freeParser;
+        }
+    }
+    rootEnd = "</" + xmlRootTag + ">";
+    if (XML_Parse(parser, rootEnd.data(), rootEnd.size(), 1) == XML_STATUS_ERROR)
+        ret = -EINVAL;
+
+freeParser:
+    if (ret)
+        PAL_ERR(LOG_TAG, "XML Parse failed at line %lu: %s",
+                (unsigned long)XML_GetCurrentLineNumber(parser),
+                XML_ErrorString(XML_GetErrorCode(parser)));
+    XML_ParserFree(parser);
+done:
+    return ret;
+}
+
+/*
+ * Parses the sections of the resource manager xml needed for stream opens,
+ * the ones listed in lazyXmlSections are parsed by loadXmlSection() when
+ * first needed. Falls back to XmlParser() if the file can not be indexed.
+ */
+int ResourceManager::XmlSectionParser(std::string xmlFile)
+{
+    std::map<std::string, std::vector<std::pair<size_t, size_t>>> sections;
+    std::vector<std::pair<size_t, size_t>> ranges;
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    std::lock_guard<std::recursive_mutex> lock(xmlSectionMutex);
+    std::shared_ptr<std::string> xml = std::make_shared<std::string>();
+    FILE *file = NULL;
+    long size = 0;
+    int ret = 0;
+
+    PAL_INFO(LOG_TAG, "XML section parsing started - file name %s", xmlFile.c_str());
+    file = fopen(xmlFile.c_str(), "r");
+    if (!file) {
+        ret = -ENOENT;
+        PAL_ERR(LOG_TAG, "Failed to open xml file name %s ret %d", xmlFile.c_str(), ret);
+        return ret;
+    }
+
+    if (fseek(file, 0, SEEK_END) == 0)
+        size = ftell(file);
+    rewind(file);
+    if (size > 0) {
+        xml->resize(size);
+        xml->resize(fread(&(*xml)[0], 1, size, file));
+    }
+    fclose(file);
+
+    xmlLazySections.clear();
+    xmlBuf = nullptr;
+    if (xml->empty() || indexXmlSections(*xml, sections)) {
+        PAL_INFO(LOG_TAG, "could not index %s, parsing it as a whole", xmlFile.c_str());
+        return XmlParser(xmlFile);
+    }
+
+    for (auto &section : sections) {
+        if (std::find_if(std::begin(lazyXmlSections), std::end(lazyXmlSections),
+                [&](const char *name) { return section.first == name; }) !=
+            std::end(lazyXmlSections))
+            xmlLazySections[section.first] = section.second;
+        else
+            ranges.insert(ranges.end(), section.second.begin(), section.second.end());
+    }
+    /* keep the document order of the eagerly parsed sections */
+    std::sort(ranges.begin(), ranges.end());
+
+    ret = parseXmlSections(*xml, ranges);
+    if (ret) {
+        PAL_ERR(LOG_TAG, "XML section parsing failed for %s file ret %d",
+                xmlFile.c_str(), ret);
+        xmlLazySections.clear();
+        return ret;
+    }
+
+    if (!xmlLazySections.empty())
+        xmlBuf = xml;
+    SoundTriggerPlatformInfo::SetSectionLoader(loadXmlSection);
+    PAL_INFO(LOG_TAG, "parsed %zu of %zu sections in %lld us, %zu deferred",
+             sections.size() - xmlLazySections.size(), sections.size(),
+             (long long)std::chrono::duration_cast<std::chrono::microseconds>(
+                 std::chrono::steady_clock::now() - begin).count(),
+             xmlLazySections.size());
+
+    return ret;
+}
+
+void ResourceManager::loadXmlSection(const char *section)
+{
+    std::lock_guard<std::recursive_mutex> lock(xmlSectionMutex);
+    std::vector<std::pair<size_t, size_t>> ranges;
+    std::shared_ptr<const std::string> xml = xmlBuf;
+    std::chrono::steady_clock::time_point begin;
+    auto it = xmlLazySections.find(section);
+
+    /* also returns for nested calls while the section is being parsed */
+    if (it == xmlLazySections.end() || !xml)
+        return;
+
+    ranges.swap(it->second);
+    xmlLazySections.erase(it);
+    if (xmlLazySections.empty())
+        xmlBuf = nullptr;
+
+    begin = std::chrono::steady_clock::now();
+    if (parseXmlSections(*xml, ranges))
+        PAL_ERR(LOG_TAG, "failed to parse section %s", section);
+    PAL_DBG(LOG_TAG, "parsed section %s on first use in %lld us", section,
+            (long long)std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - begin).count());
+}
+
 /* Function to get audio vendor configs path */
 void ResourceManager::getVendorConfigPath (char* config_file_path, int path_size)
 {
@@ -12124,10 +12546,7 @@ int ResourceManager::setUltrasoundGain(pal_ultrasound_gain_t gain, Stream *s)
     }
 
     if (PAL_ULTRASOUND_GAIN_MUTE != gain_2) {
-        /* Currently configured value is 20ms which allows 3 to 4 process call
-         * to handle this value at ADSP side.
-         * Increase or decrease this dealy based on requirements */
-        usleep(20000);
+        /* the stream applies gain_2 itself once mute has ramped down */
         if (PAL_STREAM_ULTRASOUND != sAttr.type)
             status = updStream->setUltraSoundGain(gain_2);
         else
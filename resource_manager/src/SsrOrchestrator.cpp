@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#define LOG_TAG "PAL: SsrOrchestrator"
+
+#include "SsrOrchestrator.h"
+#include "ResourceManager.h"
+#include "Stream.h"
+#include "Device.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <thread>
+
+enum {
+    SSR_CLASS_NONE,
+    SSR_CLASS_VOICE,
+    SSR_CLASS_DETECTION,
+};
+
+static int getRestoreClass(pal_stream_type_t type)
+{
+    switch (type) {
+        case PAL_STREAM_VOICE_CALL:
+        case PAL_STREAM_VOICE_CALL_RECORD:
+        case PAL_STREAM_VOICE_CALL_MUSIC:
+            return SSR_CLASS_VOICE;
+        case PAL_STREAM_VOICE_UI:
+        case PAL_STREAM_ACD:
+        case PAL_STREAM_SENSOR_PCM_DATA:
+        case PAL_STREAM_CONTEXT_PROXY:
+            return SSR_CLASS_DETECTION;
+        default:
+            return SSR_CLASS_NONE;
+    }
+}
+
+static size_t findGroup(std::vector<size_t> &parent, size_t i)
+{
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+static void mergeGroups(std::vector<size_t> &parent, size_t a, size_t b)
+{
+    a = findGroup(parent, a);
+    b = findGroup(parent, b);
+    /* the earlier registered stream stays the root to keep the order */
+    if (a < b)
+        parent[b] = a;
+    else if (b < a)
+        parent[a] = b;
+}
+
+/* whether a TX device takes its echo reference from one of the RX devices */
+static bool usesEcRef(std::shared_ptr<ResourceManager> rm,
+                      const std::vector<std::shared_ptr<Device>> &rxDevices,
+                      const std::vector<std::shared_ptr<Device>> &txDevices)
+{
+    for (auto &rxDev : rxDevices) {
+        int rxId = rxDev->getSndDeviceId();
+        if (rxId <= PAL_DEVICE_OUT_MIN || rxId >= PAL_DEVICE_OUT_MAX)
+            continue;
+        for (auto &txDev : txDevices) {
+            int txId = txDev->getSndDeviceId();
+            if (txId > PAL_DEVICE_IN_MIN && txId < PAL_DEVICE_IN_MAX &&
+                rm->checkECRef(rxDev, txDev))
+                return true;
+        }
+    }
+    return false;
+}
+
+/* emits the EC ref sources of stream i ahead of it, cycles are cut */
+static void emitInOrder(const std::vector<SsrOrchestrator::streamInfo> &streams,
+                        size_t i, std::vector<bool> &seen, std::vector<size_t> &order)
+{
+    if (i >= streams.size() || seen[i])
+        return;
+
+    seen[i] = true;
+    for (auto ref : streams[i].ecRefs)
+        emitInOrder(streams, ref, seen, order);
+    order.push_back(i);
+}
+
+void SsrOrchestrator::planGroups(const std::vector<streamInfo> &streams,
+                                 std::vector<std::vector<size_t>> &groups)
+{
+    std::vector<size_t> parent(streams.size());
+    std::vector<bool> seen(streams.size(), false);
+    std::map<int, size_t> owner;
+    std::map<size_t, size_t> groupIdx;
+    std::vector<std::vector<size_t>> members;
+
+    for (size_t i = 0; i < streams.size(); i++) {
+        parent[i] = i;
+        /* negative keys do not collide with device ids */
+        int cls = streams[i].restoreClass;
+        if (cls != SSR_CLASS_NONE) {
+            if (owner.count(-cls))
+                mergeGroups(parent, owner[-cls], i);
+            else
+                owner[-cls] = i;
+        }
+
+        for (auto id : streams[i].deviceIds) {
+            if (owner.count(id))
+                mergeGroups(parent, owner[id], i);
+            else
+                owner[id] = i;
+        }
+    }
+    for (size_t i = 0; i < streams.size(); i++) {
+        for (auto ref : streams[i].ecRefs)
+            if (ref < streams.size())
+                mergeGroups(parent, ref, i);
+    }
+
+    for (size_t i = 0; i < streams.size(); i++) {
+        size_t root = findGroup(parent, i);
+        if (!groupIdx.count(root)) {
+            groupIdx[root] = members.size();
+            members.emplace_back();
+        }
+        members[groupIdx[root]].push_back(i);
+    }
+
+    groups.clear();
+    groups.resize(members.size());
+    for (size_t g = 0; g < members.size(); g++) {
+        for (auto i : members[g])
+            emitInOrder(streams, i, seen, groups[g]);
+    }
+}
+
+size_t SsrOrchestrator::runGroups(const std::vector<std::vector<size_t>> &groups,
+                                  std::function<void(size_t)> restore)
+{
+    std::vector<std::thread> workers;
+    std::atomic<size_t> next(0);
+    size_t numWorkers = std::min(groups.size(), (size_t)SSR_RESTORE_MAX_WORKERS);
+
+    auto worker = [&]() {
+        size_t i;
+
+        while ((i = next++) < groups.size()) {
+            for (auto idx : groups[i])
+                restore(idx);
+        }
+    };
+
+    for (size_t i = 1; i < numWorkers; i++)
+        workers.emplace_back(worker);
+    worker();
+    for (auto &t : workers)
+        t.join();
+
+    return numWorkers;
+}
+
+void SsrOrchestrator::getStreamInfo(std::shared_ptr<ResourceManager> rm,
+                                    const std::vector<Stream *> &streams,
+                                    std::vector<streamInfo> &infos)
+{
+    std::vector<struct pal_stream_attributes> attrs(streams.size());
+    std::vector<bool> valid(streams.size(), false);
+    std::vector<std::vector<std::shared_ptr<Device>>> devices(streams.size());
+
+    infos.clear();
+    infos.resize(streams.size());
+
+    for (size_t i = 0; i < streams.size(); i++) {
+        infos[i].restoreClass = SSR_CLASS_NONE;
+        if (streams[i]->getStreamAttributes(&attrs[i]) == 0) {
+            valid[i] = true;
+            infos[i].restoreClass = getRestoreClass(attrs[i].type);
+        }
+        streams[i]->getAssociatedDevices(devices[i]);
+        for (auto &dev : devices[i])
+            infos[i].deviceIds.push_back(dev->getSndDeviceId());
+    }
+
+    /* a TX stream restarts after the RX streams it takes its EC ref from */
+    for (size_t i = 0; i < streams.size(); i++) {
+        if (!valid[i] || attrs[i].direction != PAL_AUDIO_INPUT ||
+            attrs[i].type == PAL_STREAM_PROXY ||
+            attrs[i].type == PAL_STREAM_ULTRA_LOW_LATENCY ||
+            attrs[i].type == PAL_STREAM_GENERIC)
+            continue;
+        for (size_t j = 0; j < streams.size(); j++) {
+            if (!valid[j] || attrs[j].direction == PAL_AUDIO_INPUT ||
+                !rm->getEcRefStatus(attrs[i].type, attrs[j].type) ||
+                !usesEcRef(rm, devices[j], devices[i]))
+                continue;
+            infos[i].ecRefs.push_back(j);
+        }
+    }
+}
+
+void SsrOrchestrator::restoreStream(std::shared_ptr<ResourceManager> rm, Stream *str)
+{
+    int32_t ret = 0;
+
+    /* stream ssr handlers expect the active stream lock to be held */
+    rm->lockActiveStream();
+    ret = str->ssrUpHandler();
+    rm->unlockActiveStream();
+    if (0 != ret)
+        PAL_ERR(LOG_TAG, "Ssr up handling failed for %pK ret %d", str, ret);
+
+    rm->lockValidStreamMutex();
+    ret = rm->decreaseStreamUserCounter(str);
+    rm->unlockValidStreamMutex();
+    if (0 != ret)
+        PAL_ERR(LOG_TAG, "Error decrementing the stream counter for the stream handle: %pK", str);
+}
+
+void SsrOrchestrator::restoreStreams(std::shared_ptr<ResourceManager> rm,
+                                     const std::vector<Stream *> &streams)
+{
+    std::vector<streamInfo> infos;
+    std::vector<std::vector<size_t>> groups;
+    size_t numWorkers = 0;
+    auto begin = std::chrono::steady_clock::now();
+
+    if (streams.empty())
+        return;
+
+    getStreamInfo(rm, streams, infos);
+    planGroups(infos, groups);
+    PAL_INFO(LOG_TAG, "restoring %zu streams in %zu groups", streams.size(), groups.size());
+
+    numWorkers = runGroups(groups, [&](size_t i) { restoreStream(rm, streams[i]); });
+
+    PAL_INFO(LOG_TAG, "streams restored in %lld ms on %zu workers",
+             (long long)std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now() - begin).count(), numWorkers);
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#define LOG_TAG "PAL: StreamConcurrencyState"
+
+#include "StreamConcurrencyState.h"
+
+bool StreamConcurrencyState::addStream(Stream *s, const struct pal_stream_attributes *attr)
+{
+    struct streamInfo info;
+
+    if (streams.count(s))
+        return false;
+
+    info.type = attr->type;
+    info.isTx = attr->direction == PAL_AUDIO_INPUT;
+    info.isWfdTx = info.isTx &&
+        attr->info.opt_stream_info.tx_proxy_type == PAL_STREAM_PROXY_TX_WFD;
+    if (info.type < PAL_STREAM_MAX) {
+        info.typePos = byType[info.type].insert(byType[info.type].end(), s);
+        numByType[info.type]++;
+    }
+    if (info.isTx) {
+        info.txPos = txStreams.insert(txStreams.end(), s);
+        numTx++;
+    } else {
+        numRx++;
+    }
+    if (info.isWfdTx)
+        numWfdTx++;
+    streams[s] = info;
+    return true;
+}
+
+bool StreamConcurrencyState::removeStream(Stream *s)
+{
+    auto iter = streams.find(s);
+
+    if (iter == streams.end())
+        return false;
+
+    struct streamInfo &info = iter->second;
+
+    if (info.type < PAL_STREAM_MAX) {
+        byType[info.type].erase(info.typePos);
+        numByType[info.type]--;
+    }
+    if (info.isTx) {
+        txStreams.erase(info.txPos);
+        numTx--;
+    } else {
+        numRx--;
+    }
+    if (info.isWfdTx)
+        numWfdTx--;
+    streams.erase(iter);
+    return true;
+}
+
+void StreamConcurrencyState::addDeviceUser(Device *d, int deviceId, Stream *s)
+{
+    deviceUsers.insert(std::make_pair(d, s));
+    numByDevice[deviceId]++;
+}
+
+void StreamConcurrencyState::removeDeviceUser(Device *d, int deviceId, Stream *s)
+{
+    deviceUsers.erase(std::make_pair(d, s));
+    if (numByDevice.count(deviceId) && --numByDevice[deviceId] == 0)
+        numByDevice.erase(deviceId);
+}
+
+uint32_t StreamConcurrencyState::numSessions(pal_stream_type_t type) const
+{
+    switch (type) {
+        case PAL_STREAM_LOW_LATENCY:
+        case PAL_STREAM_VOIP:
+        case PAL_STREAM_VOIP_RX:
+        case PAL_STREAM_VOIP_TX:
+            return numByType[PAL_STREAM_LOW_LATENCY] + numByType[PAL_STREAM_VOIP_RX] +
+                   numByType[PAL_STREAM_VOIP_TX] + numByType[PAL_STREAM_VOICE_CALL];
+        case PAL_STREAM_PCM_OFFLOAD:
+            return numByType[PAL_STREAM_PCM_OFFLOAD] + numByType[PAL_STREAM_LOOPBACK];
+        case PAL_STREAM_LOOPBACK:
+        case PAL_STREAM_TRANSCODE:
+        case PAL_STREAM_VOICE_UI:
+            return numByType[PAL_STREAM_VOICE_UI];
+        case PAL_STREAM_VOICE_CALL:
+        case PAL_STREAM_VOICE_CALL_TX:
+        case PAL_STREAM_VOICE_CALL_RX_TX:
+            return 0;
+        default:
+            return type < PAL_STREAM_MAX ? numByType[type] : 0;
+    }
+}
@@ -0,0 +1,303 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#define LOG_TAG "PAL: StreamGraphPool"
+
+#include "StreamGraphPool.h"
+#include "PalCommon.h"
+#include "ResourceManager.h"
+#include "SessionAlsaUtils.h"
+#include "Device.h"
+#include <errno.h>
+#include <string.h>
+
+std::shared_ptr<StreamGraphPool> StreamGraphPool::instance = nullptr;
+
+std::shared_ptr<StreamGraphPool> StreamGraphPool::getInstance()
+{
+    static std::mutex instanceLock;
+    std::lock_guard<std::mutex> lck(instanceLock);
+
+    if (!instance)
+        instance = std::make_shared<StreamGraphPool>();
+
+    return instance;
+}
+
+StreamGraphPool::StreamGraphPool()
+{
+    exitReaper = false;
+    budget = WARM_GRAPH_POOL_DEFAULT_SIZE;
+    gracePeriod = std::chrono::milliseconds(WARM_GRAPH_POOL_DEFAULT_TIMEOUT_MS);
+    memset(&stats, 0, sizeof(stats));
+}
+
+StreamGraphPool::~StreamGraphPool()
+{
+    deinit();
+}
+
+void StreamGraphPool::deinit()
+{
+    std::unique_lock<std::mutex> lck(lock);
+
+    exitReaper = true;
+    lck.unlock();
+    cv.notify_all();
+    if (reaper.joinable())
+        reaper.join();
+
+    invalidate("deinit");
+    lck.lock();
+    exitReaper = false;
+}
+
+void StreamGraphPool::setStreamTypes(const std::vector<uint32_t> &types)
+{
+    std::lock_guard<std::mutex> lck(lock);
+
+    streamTypes.clear();
+    for (auto type : types) {
+        PAL_INFO(LOG_TAG, "warm graph pool enabled for stream type %u", type);
+        streamTypes.insert(type);
+    }
+}
+
+void StreamGraphPool::setBudget(uint32_t maxGraphs)
+{
+    std::list<struct warmGraph> evicted;
+
+    lock.lock();
+    budget = maxGraphs;
+    while (graphs.size() > budget) {
+        evicted.splice(evicted.end(), graphs, std::prev(graphs.end()));
+        stats.evictions++;
+    }
+    stats.num_graphs = graphs.size();
+    lock.unlock();
+
+    closeGraphs(evicted);
+}
+
+void StreamGraphPool::setGracePeriod(uint32_t ms)
+{
+    std::lock_guard<std::mutex> lck(lock);
+
+    gracePeriod = std::chrono::milliseconds(ms);
+}
+
+bool StreamGraphPool::isEnabled(pal_stream_type_t type)
+{
+    std::lock_guard<std::mutex> lck(lock);
+
+    return budget && streamTypes.count(type);
+}
+
+bool StreamGraphPool::park(struct warmGraph &graph)
+{
+    std::list<struct warmGraph> evicted;
+
+    lock.lock();
+    if (!budget || !streamTypes.count(graph.sAttr.type) || graph.key.empty() ||
+        exitReaper) {
+        lock.unlock();
+        return false;
+    }
+
+    graph.expiry = std::chrono::steady_clock::now() + gracePeriod;
+    graphs.push_front(graph);
+    while (graphs.size() > budget) {
+        evicted.splice(evicted.end(), graphs, std::prev(graphs.end()));
+        stats.evictions++;
+    }
+    stats.parked++;
+    stats.num_graphs = graphs.size();
+    PAL_DBG(LOG_TAG, "parked graph of stream type %d on front end %d, %zu parked",
+            graph.sAttr.type, graph.pcmDevIds.at(0), graphs.size());
+
+    if (!reaper.joinable())
+        reaper = std::thread(&StreamGraphPool::reaperLoop, this);
+    lock.unlock();
+    cv.notify_all();
+
+    closeGraphs(evicted);
+    return true;
+}
+
+bool StreamGraphPool::take(const std::string &key, struct warmGraph &graph)
+{
+    std::lock_guard<std::mutex> lck(lock);
+
+    for (auto it = graphs.begin(); it != graphs.end(); ++it) {
+        if (it->key != key)
+            continue;
+
+        graph = *it;
+        graphs.erase(it);
+        stats.hits++;
+        stats.num_graphs = graphs.size();
+        if (coldCost.count(graph.sAttr.type))
+            stats.open_us_saved += coldCost[graph.sAttr.type].openUs;
+        PAL_DBG(LOG_TAG, "reuse graph of stream type %d on front end %d",
+                graph.sAttr.type, graph.pcmDevIds.at(0));
+        return true;
+    }
+    stats.misses++;
+
+    return false;
+}
+
+uint32_t StreamGraphPool::invalidate(const char *reason)
+{
+    std::list<struct warmGraph> closed;
+    uint32_t count = 0;
+
+    lock.lock();
+    closed.swap(graphs);
+    count = closed.size();
+    stats.invalidations += count;
+    stats.num_graphs = 0;
+    lock.unlock();
+
+    if (count)
+        PAL_INFO(LOG_TAG, "closing %u parked graphs, %s", count, reason);
+    closeGraphs(closed);
+
+    return count;
+}
+
+/*
+ * A parked graph keeps its front end connected, but not the device, so
+ * the last session on a backend frees its device metadata underneath it.
+ * Such a graph would be taken over without device metadata, close it.
+ */
+uint32_t StreamGraphPool::invalidateBackEnd(const std::string &backEnd,
+                                            const char *reason)
+{
+    std::list<struct warmGraph> closed;
+    uint32_t count = 0;
+
+    lock.lock();
+    for (auto it = graphs.begin(); it != graphs.end();) {
+        auto next = std::next(it);
+
+        for (auto &be : it->backEnds) {
+            if (be.second == backEnd) {
+                closed.splice(closed.end(), graphs, it);
+                break;
+            }
+        }
+        it = next;
+    }
+    count = closed.size();
+    stats.invalidations += count;
+    stats.num_graphs = graphs.size();
+    lock.unlock();
+
+    if (count)
+        PAL_INFO(LOG_TAG, "closing %u graphs parked on %s, %s", count,
+                 backEnd.c_str(), reason);
+    closeGraphs(closed);
+
+    return count;
+}
+
+void StreamGraphPool::recordColdOpen(pal_stream_type_t type, uint64_t us)
+{
+    std::lock_guard<std::mutex> lck(lock);
+    uint64_t &avg = coldCost[type].openUs;
+
+    avg = avg ? (avg * 7 + us) / 8 : us;
+}
+
+void StreamGraphPool::recordColdPrepare(pal_stream_type_t type, uint64_t us)
+{
+    std::lock_guard<std::mutex> lck(lock);
+    uint64_t &avg = coldCost[type].prepareUs;
+
+    avg = avg ? (avg * 7 + us) / 8 : us;
+}
+
+void StreamGraphPool::recordWarmPrepare(pal_stream_type_t type)
+{
+    std::lock_guard<std::mutex> lck(lock);
+
+    if (coldCost.count(type))
+        stats.open_us_saved += coldCost[type].prepareUs;
+}
+
+void StreamGraphPool::getStats(pal_param_warm_graph_pool_stats_t *poolStats)
+{
+    std::lock_guard<std::mutex> lck(lock);
+
+    if (poolStats)
+        *poolStats = stats;
+}
+
+void StreamGraphPool::closeGraph(struct warmGraph &graph)
+{
+    std::shared_ptr<ResourceManager> rm = ResourceManager::getInstance();
+    std::vector<std::pair<std::string, int>> freeDeviceMetadata;
+    std::shared_ptr<Device> dev = nullptr;
+    int status = 0;
+
+    /* the parked graph holds no device reference, free unused backends only */
+    for (auto &be : graph.backEnds) {
+        dev = Device::getObject((pal_device_id_t)be.first);
+        freeDeviceMetadata.push_back(std::make_pair(be.second,
+                (dev && dev->getDeviceCount() > 0) ? 0 : 1));
+    }
+
+    status = SessionAlsaUtils::close(graph.sAttr, rm, graph.pcmDevIds,
+            graph.backEnds, freeDeviceMetadata);
+    if (status)
+        PAL_ERR(LOG_TAG, "session alsa close failed with %d", status);
+
+    if (graph.pcm && pcm_close(graph.pcm))
+        PAL_ERR(LOG_TAG, "pcm_close failed %d", errno);
+    graph.pcm = NULL;
+
+    rm->freeFrontEndIds(graph.pcmDevIds, graph.sAttr, graph.lDirection);
+}
+
+void StreamGraphPool::closeGraphs(std::list<struct warmGraph> &closed)
+{
+    for (auto &graph : closed)
+        closeGraph(graph);
+    closed.clear();
+}
+
+void StreamGraphPool::reaperLoop()
+{
+    std::unique_lock<std::mutex> lck(lock);
+    std::list<struct warmGraph> expired;
+
+    PAL_DBG(LOG_TAG, "Enter");
+    while (!exitReaper) {
+        if (graphs.empty()) {
+            cv.wait(lck);
+            continue;
+        }
+
+        /* graphs are parked in order, the oldest expires first */
+        if (cv.wait_until(lck, graphs.back().expiry) != std::cv_status::timeout)
+            continue;
+
+        while (!graphs.empty() &&
+               graphs.back().expiry <= std::chrono::steady_clock::now()) {
+            expired.splice(expired.end(), graphs, std::prev(graphs.end()));
+            stats.expirations++;
+        }
+        stats.num_graphs = graphs.size();
+        if (expired.empty())
+            continue;
+
+        lck.unlock();
+        PAL_DBG(LOG_TAG, "closing %zu expired graphs", expired.size());
+        closeGraphs(expired);
+        lck.lock();
+    }
+    PAL_DBG(LOG_TAG, "Exit");
+}
@@ -35,6 +35,7 @@
 
 #include "ContextDetectionEngine.h"
 #include "SoundTriggerUtils.h"
+#include "SoundModelStore.h"
 #include "StreamACD.h"
 #include "detection_cmn_api.h"
 
@@ -113,5 +114,7 @@ private:
     bool     model_load_needed_[ACD_SOUND_MODEL_ID_MAX];
     bool     model_unload_needed_[ACD_SOUND_MODEL_ID_MAX];
     bool     is_confidence_value_updated_;
+    /* models registered with the DSP, by UUID */
+    std::map<uint32_t, std::unique_ptr<SoundModelPin>> model_pins_;
 };
 #endif  // ACDENGINE_H
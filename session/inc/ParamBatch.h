@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef PARAM_BATCH_H_
+#define PARAM_BATCH_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "apm_api.h"
+
+#define PARAM_BATCH_MIN_CAPACITY 256
+
+/*
+ * Batch of GSL module params laid out back to back, each one an
+ * apm_module_param_data_t header followed by its data and padded to
+ * 8 bytes, ready to be sent to AGM with a single mixer set.
+ *
+ * The storage is kept across reset() so a session building the same
+ * params on every start/volume change stops allocating once it has
+ * grown to its working size. Storage comes from malloc so release()
+ * can hand it to code that frees payloads with free().
+ */
+class ParamBatch
+{
+public:
+    ParamBatch();
+    ~ParamBatch();
+    ParamBatch(const ParamBatch &) = delete;
+    ParamBatch & operator=(const ParamBatch &) = delete;
+
+    /*
+     * Appends the header of a param and returns its zeroed data area of
+     * paramSize bytes, or nullptr on allocation failure. The pointer is
+     * valid until the next append.
+     */
+    uint8_t *appendParam(uint32_t miid, uint32_t paramId, size_t paramSize);
+    /* typed helper for fixed size params followed by extra bytes */
+    template <typename T>
+    T *appendParam(uint32_t miid, uint32_t paramId, size_t extra = 0)
+    {
+        return (T *)appendParam(miid, paramId, sizeof(T) + extra);
+    }
+    /* copies already formatted module params */
+    int append(const void *payload, size_t size);
+    /* drops the content, keeps the storage */
+    void reset() { used = 0; }
+    /* hands the storage to the caller, who frees it with free() */
+    uint8_t *release(size_t *size);
+
+    uint8_t *data() const { return buf; }
+    size_t size() const { return used; }
+    bool empty() const { return used == 0; }
+    size_t capacity() const { return cap; }
+    uint32_t getAllocCount() const { return allocCount; }
+
+private:
+    int reserve(size_t size);
+
+    uint8_t *buf;
+    size_t used;
+    size_t cap;
+    uint32_t allocCount;
+};
+
+#endif //PARAM_BATCH_H_
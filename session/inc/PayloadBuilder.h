@@ -49,6 +49,7 @@
 #include "Stream.h"
 #include "Device.h"
 #include "ResourceManager.h"
+#include "ParamBatch.h"
 
 #define PAL_ALIGN_8BYTE(x) (((x) + 7) & (~7))
 #define PAL_PADDING_8BYTE_ALIGN(x)  ((((x) + 7) & 7) ^ 7)
@@ -174,6 +175,7 @@ struct user_xml_data{
     bool is_parsing_devicepps;
 };
 class SessionGsl;
+class SoundModelBlob;
 
 class PayloadBuilder
 {
@@ -203,6 +205,21 @@ public:
     void payloadMultichVolumemConfig(uint8_t** payload, size_t* size,
                            uint32_t miid,
                            struct pal_volume_data * data);
+    /* ParamBatch variants, appending in place to a reusable batch */
+    int payloadMFCConfig(ParamBatch &batch, uint32_t miid,
+                           struct sessionToPayloadParam* data);
+    int payloadVolumeConfig(ParamBatch &batch, uint32_t miid,
+                           struct pal_volume_data * data);
+    int payloadMultichVolumemConfig(ParamBatch &batch, uint32_t miid,
+                           struct pal_volume_data * data);
+    int payloadRATConfig(ParamBatch &batch, uint32_t miid,
+                           struct pal_media_config *data);
+    int payloadMSPPConfig(ParamBatch &batch, uint32_t miid, uint32_t gain);
+    int payloadSoftPauseConfig(ParamBatch &batch, uint32_t miid, uint32_t delayMs);
+    int payloadVolumeCtrlRamp(ParamBatch &batch, uint32_t miid,
+                           uint32_t ramp_period_ms);
+    int payloadMFCMixerCoeff(ParamBatch &batch, uint32_t miid, int numCh,
+                           int rotationType);
     int payloadCustomParam(uint8_t **alsaPayload, size_t *size,
                             uint32_t *customayload, uint32_t customPayloadSize,
                             uint32_t moduleInstanceId, uint32_t dspParamId);
@@ -218,6 +235,11 @@ public:
     int payloadSVAConfig(uint8_t **payload, size_t *size,
                         uint8_t *config, size_t config_size,
                         uint32_t miid, uint32_t param_id);
+    int payloadSVAConfig(uint8_t **payload, size_t *size,
+                        SoundModelBlob *model, uint32_t miid, uint32_t param_id);
+    int payloadRegisterSoundModel(uint8_t **payload, size_t *size,
+                        SoundModelBlob *model, uint32_t model_id,
+                        uint32_t miid, uint32_t param_id);
     void payloadDOAInfo(uint8_t **payload, size_t *size, uint32_t moduleId);
     void payloadQuery(uint8_t **payload, size_t *size, uint32_t moduleId,
                             uint32_t paramId, uint32_t querySize);
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef PCM_NON_BLOCKING_IO_H
+#define PCM_NON_BLOCKING_IO_H
+
+#include <condition_variable>
+#include <mutex>
+#include <stddef.h>
+#include <thread>
+
+/* bounds how long stop waits for the readiness thread */
+#define PCM_READY_WAIT_MS 10
+
+struct pcm;
+
+/* pcm calls of the io, the tinyalsa ones outside of tests */
+struct pcm_io_ops {
+    /* 1 if ready, 0 on timeout, negative on error */
+    int (*wait)(struct pcm *pcm, int timeoutMs);
+    int (*read)(struct pcm *pcm, void *data, unsigned int count);
+    int (*write)(struct pcm *pcm, const void *data, unsigned int count);
+};
+
+/*
+ * io of a PAL_STREAM_FLAG_NON_BLOCKING pcm, which stays blocking at the
+ * ALSA level: data is only moved a period at a time while pcm_wait(0)
+ * reports the pcm ready, so no call waits. io returns a short count, or
+ * -EAGAIN if nothing could be moved, and arms the readiness thread, which
+ * waits on the pcm and signals the ready eventfd once it is ready again.
+ * Clients poll the eventfd, see PAL_PARAM_ID_STREAM_READY_FD.
+ */
+class PcmNonBlockingIo
+{
+public:
+    PcmNonBlockingIo(const struct pcm_io_ops *ops);
+    ~PcmNonBlockingIo();
+    PcmNonBlockingIo(const PcmNonBlockingIo &) = delete;
+    PcmNonBlockingIo & operator=(const PcmNonBlockingIo &) = delete;
+
+    /* creates the ready eventfd, once */
+    int init();
+    /* -1 until init */
+    int getReadyFd() const { return readyFd; }
+    /* the pcm stays open until stop returns */
+    void start(struct pcm *pcm);
+    /* also wakes up clients still polling, their next io fails on the state */
+    void stop();
+    /* size receives the bytes moved, periodBytes bounds each pcm call */
+    int read(struct pcm *pcm, void *data, size_t bytes, size_t periodBytes, int *size);
+    int write(struct pcm *pcm, const void *data, size_t bytes, size_t periodBytes,
+              int *size);
+
+private:
+    void arm();
+    void readyLoop();
+
+    const struct pcm_io_ops *ops;
+    struct pcm *readyPcm;
+    int readyFd;
+    bool readyArmed;
+    bool readyExit;
+    std::thread readyThread;
+    std::mutex readyLock;
+    std::condition_variable readyCv;
+};
+
+#endif //PCM_NON_BLOCKING_IO_H
@@ -67,11 +67,6 @@ typedef enum {
     SESSION_STOPPED,
 }sessionState;
 
-typedef enum {
-    PM_QOS_VOTE_DISABLE = 0,
-    PM_QOS_VOTE_ENABLE  = 1
-} pmQosVote;
-
 typedef enum {
    SLOT_MASK1  = 1,
    SLOT_MASK3  = 3,
@@ -110,6 +105,10 @@ protected:
     void *customPayload;
     size_t customPayloadSize;
     int updateCustomPayload(void *payload, size_t size);
+    /* reusable batch of module params for start and set param paths */
+    ParamBatch paramBatch;
+    void beginParamBatch();
+    int sendParamBatch(int device);
     int freeCustomPayload(uint8_t **payload, size_t *payloadSize);
     uint32_t eventId;
     void *eventPayload;
@@ -134,7 +133,9 @@ public:
             struct pal_device &dAttr, const std::vector<int> &pcmDevIds);
     int configureMFC(const std::shared_ptr<ResourceManager>& rm, struct pal_stream_attributes &sAttr,
             struct pal_device &dAttr, const std::vector<int> &pcmDevIds, const char* intf);
-    void setPmQosMixerCtl(pmQosVote vote);
+    int appendMFCConfig(const std::shared_ptr<ResourceManager>& rm,
+            struct pal_stream_attributes &sAttr, struct pal_device &dAttr,
+            const std::vector<int> &pcmDevIds, const char* intf, ParamBatch &batch);
     int getCustomPayload(uint8_t **payload, size_t *payloadSize);
     int freeCustomPayload();
     virtual int open(Stream * s) = 0;
@@ -155,6 +156,9 @@ public:
     virtual int writeBufferInit(Stream *s __unused, size_t noOfBuf __unused, size_t bufSize __unused, int flag __unused) {return 0;};
     virtual int read(Stream *s __unused, int tag __unused, struct pal_buffer *buf __unused, int * size __unused) {return 0;};
     virtual int write(Stream *s __unused, int tag __unused, struct pal_buffer *buf __unused, int * size __unused, int flag __unused) {return 0;};
+    /* writes bufs in order, *done is the number of buffers fully written */
+    virtual int writev(Stream *s, int tag, struct pal_buffer *bufs, uint32_t count,
+                       int *sizes, uint32_t *done, int flag);
     virtual int getParameters(Stream *s __unused, int tagId __unused, uint32_t param_id __unused, void **payload __unused) {return 0;};
     virtual int setParameters(Stream *s __unused, int tagId __unused, uint32_t param_id __unused, void *payload __unused) {return 0;};
     virtual int registerCallBack(session_callback cb __unused, uint64_t cookie __unused) {return 0;};
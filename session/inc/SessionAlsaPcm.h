@@ -69,9 +69,11 @@
 #include "Session.h"
 #include "PalAudioRoute.h"
 #include "PalCommon.h"
+#include "PcmNonBlockingIo.h"
 #include <tinyalsa/asoundlib.h>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
 
 #define PARAM_ID_DETECTION_ENGINE_CONFIG_VOICE_WAKEUP 0x08001049
 #define PARAM_ID_VOICE_WAKEUP_BUFFERING_CONFIG 0x08001044
@@ -102,8 +104,25 @@ private:
     uint64_t cbCookie;
     pal_device_id_t ecRefDevId;
     uint32_t svaMiid;
-    static std::mutex pcmLpmRefCntMtx;
-    static int pcmLpmRefCnt;
+    /* graph taken from or to be parked in the StreamGraphPool */
+    std::string warmGraphKey;
+    bool warmGraphReused;
+    bool graphReconfigured;
+    struct pcm *warmPcm;
+    struct pcm_config warmConfig;
+    /* small buffers of a writev merged into one pcm_write */
+    std::vector<uint8_t> writevBuf;
+    /* PAL_STREAM_FLAG_NON_BLOCKING: io returns -EAGAIN instead of waiting
+     * for a period, see PcmNonBlockingIo */
+    bool nonBlocking;
+    PcmNonBlockingIo nbIo;
+    int readNonBlocking(struct pal_buffer *buf, int *size);
+    int writeNonBlocking(struct pal_buffer *buf, int *size);
+    void setCaptureTimestamp(struct pal_buffer *buf, uint32_t sampleRate, int bytesRead);
+    int getWarmGraphKey(Stream *s, struct pal_stream_attributes &sAttr, std::string &key);
+    bool takeWarmGraph(Stream *s, struct pal_stream_attributes &sAttr);
+    bool parkWarmGraph(struct pal_stream_attributes &sAttr);
+    struct pcm *adoptWarmPcm(struct pal_stream_attributes &sAttr, struct pcm_config *config);
 public:
 
     SessionAlsaPcm(std::shared_ptr<ResourceManager> Rm);
@@ -122,6 +141,8 @@ public:
     int writeBufferInit(Stream *s, size_t noOfBuf, size_t bufSize, int flag) override;
     int read(Stream *s, int tag, struct pal_buffer *buf, int * size) override;
     int write(Stream *s, int tag, struct pal_buffer *buf, int * size, int flag) override;
+    int writev(Stream *s, int tag, struct pal_buffer *bufs, uint32_t count,
+               int *sizes, uint32_t *done, int flag) override;
     int setParameters(Stream *s, int tagId, uint32_t param_id, void *payload) override;
     int getParameters(Stream *s, int tagId, uint32_t param_id, void **payload) override;
     int setECRef(Stream *s, std::shared_ptr<Device> rx_dev, bool is_enable) override;
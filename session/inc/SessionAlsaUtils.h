@@ -102,6 +102,10 @@ public:
                     pal_device_id_t deviceId, void *payload, bool isParamWrite, uint32_t instanceId);
     static int close(Stream * s, std::shared_ptr<ResourceManager> rm, const std::vector<int> &DevIds,
             const std::vector<std::pair<int32_t, std::string>> &BackEnds, std::vector<std::pair<std::string, int>> &freedevicemetadata);
+    /* for graphs that outlive their stream, e.g. parked in the warm graph pool */
+    static int close(const struct pal_stream_attributes &sAttr, std::shared_ptr<ResourceManager> rm,
+            const std::vector<int> &DevIds, const std::vector<std::pair<int32_t, std::string>> &BackEnds,
+            std::vector<std::pair<std::string, int>> &freedevicemetadata);
     static int close(Stream * s, std::shared_ptr<ResourceManager> rm,
                     const std::vector<int> &RxDevIds, const std::vector<int> &TxDevIds,
                     const std::vector<std::pair<int32_t, std::string>> &rxBackEnds,
@@ -61,6 +61,34 @@ using ChronoSteadyClock_t = std::chrono::time_point<std::chrono::steady_clock>;
 class Stream;
 class VoiceUIInterface;
 
+/*
+ * Scratch memory owned by an engine and reused across detections.
+ * It is reserved when the sound model is loaded and only grows when
+ * a detection needs more than what was reserved.
+ */
+class StEngineArena
+{
+public:
+    StEngineArena() : buf_(nullptr), size_(0) {
+        memset(&stats_, 0, sizeof(stats_));
+    }
+    ~StEngineArena() { Release(); }
+    StEngineArena(const StEngineArena &) = delete;
+    StEngineArena & operator=(const StEngineArena &) = delete;
+
+    int32_t Reserve(size_t size);
+    uint8_t *Get(size_t size);
+    void Release();
+    size_t GetSize() const { return size_; }
+    /* adds this arena's counters to the ones already in stats */
+    void GetStats(struct pal_param_st_arena_stats *stats) const;
+
+private:
+    uint8_t *buf_;
+    size_t size_;
+    struct pal_param_st_arena_stats stats_;
+};
+
 struct model_stats
 {
     uint32_t detected_model_id;
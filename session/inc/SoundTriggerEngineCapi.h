@@ -64,9 +64,7 @@ public:
         uint32_t num_conf_levels) override;
     void SetDetected(bool detected) override;
 
-    int32_t GetParameters(uint32_t param_id __unused, void **payload __unused) {
-        return 0;
-    }
+    int32_t GetParameters(uint32_t param_id, void **payload) override;
     int32_t ConnectSessionDevice(
         Stream* stream_handle __unused,
         pal_stream_type_t stream_type __unused,
@@ -101,6 +99,7 @@ private:
     int32_t StopSoundEngine();
     int32_t StartKeywordDetection();
     int32_t StartUserVerification();
+    int32_t ReserveProcessBuffers();
     static void BufferThreadLoop(SoundTriggerEngineCapi *capi_engine);
 
     std::string lib_name_;
@@ -133,6 +132,14 @@ private:
     int32_t detection_state_;
     stage2_uv_wrapper_scratch_param_t in_model_buffer_param_;
     stage2_uv_wrapper_scratch_param_t scratch_param_;
+
+    /* reused across detections instead of being allocated per run */
+    StEngineArena process_arena_;
+    capi_v2_stream_data_t stream_input_;
+    capi_v2_buf_t stream_buf_;
+    sva_result_t kw_result_;
+    stage2_uv_wrapper_result uv_result_;
+    stage2_uv_wrapper_stage1_uv_score_t uv_score_;
 };
 #endif  // SOUNDTRIGGERENGINECAPI_H
 
@@ -169,6 +169,8 @@ class SoundTriggerEngineGsl : public SoundTriggerEngine {
              listen_model_type *out_model);
     int32_t DeleteFromMergedModel(char **keyphrases, uint32_t num_keyphrases,
              listen_model_type *in_model, listen_model_type *out_model);
+    std::vector<uint64_t> GetModelSetKey(Stream *exclude, Stream *include = nullptr);
+    bool LookupMergedModel(std::vector<uint64_t> &key);
     int32_t ProcessStartRecognition(Stream *s);
     int32_t ProcessStopRecognition(Stream *s);
     int32_t UpdateMergeConfLevelsWithActiveStreams();
@@ -184,6 +186,10 @@ class SoundTriggerEngineGsl : public SoundTriggerEngine {
     Session *session_;
     PayloadBuilder *builder_;
     std::map<uint32_t, Stream*> mid_stream_map_;
+    uint32_t pdk_model_id_;
+    /* PDK model being loaded, and the models registered with the DSP */
+    std::shared_ptr<SoundModelBlob> pdk_model_;
+    std::map<uint32_t, std::unique_ptr<SoundModelPin>> pdk_pins_;
     std::map<uint32_t, std::pair<uint32_t, uint32_t>> mid_buff_cfg_;
     st_module_type_t module_type_;
     static std::map<st_module_type_t,std::vector<std::shared_ptr<SoundTriggerEngineGsl>>>
@@ -194,6 +200,8 @@ class SoundTriggerEngineGsl : public SoundTriggerEngine {
     std::vector<uint32_t> updated_cfg_;
     SoundModelInfo *eng_sm_info_;
     bool sm_merged_;
+    MergedModelCache merged_model_cache_;
+    std::map<Stream *, uint64_t> sm_hashes_;
     int32_t dev_disconnect_count_;
     eng_state_t eng_state_;
     struct detection_engine_config_voice_wakeup wakeup_config_;
@@ -219,6 +227,7 @@ class SoundTriggerEngineGsl : public SoundTriggerEngine {
     size_t mmap_buffer_size_;
     uint32_t mmap_write_position_;
     uint64_t kw_transfer_latency_;
+    StEngineArena lab_arena_;
     int32_t ec_ref_count_;
     ChronoSteadyClock_t detection_time_;
     std::mutex state_mutex_;
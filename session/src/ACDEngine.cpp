@@ -73,6 +73,7 @@
 #include "ResourceManager.h"
 #include "kvh2xml.h"
 #include "acd_api.h"
+#include "SoundModelStore.h"
 
 #define FILENAME_LEN 128
 std::shared_ptr<ACDEngine> ACDEngine::eng_;
@@ -441,67 +442,51 @@ int32_t ACDEngine::RegDeregSoundModel(uint32_t sess_param_id, uint8_t *payload,
     if (status != 0)
         PAL_ERR(LOG_TAG, "Error:%d Failed to send sound model payload", status);
 
+    free(session_payload);
     return status;
 }
 
 int32_t ACDEngine::PopulateSoundModel(std::string model_file_name, uint32_t model_uuid)
 {
-    FILE *fp;
-    size_t size = 0, bytes_read = 0;
     int32_t status = 0;
-    void *payload = NULL;
+    uint32_t miid = 0;
+    uint32_t tag_id = CONTEXT_DETECTION_ENGINE;
+    uint8_t *session_payload = nullptr;
+    size_t len = 0;
     char filename[FILENAME_LEN];
-    struct param_id_detection_engine_register_multi_sound_model_t *sm_data =
-           nullptr;
+    std::shared_ptr<SoundModelBlob> blob = nullptr;
 
     snprintf(filename, FILENAME_LEN, "%s%s", ACD_SM_FILEPATH, model_file_name.c_str());
-    fp = fopen(filename, "rb");
-    if (!fp) {
-        PAL_ERR(LOG_TAG, "Error:%d Unable to open soundmodel file '%s'", -EIO,
+    blob = SoundModelStore::GetInstance()->MapFile(filename);
+    if (!blob) {
+        PAL_ERR(LOG_TAG, "Error:%d Unable to map soundmodel file '%s'", -EIO,
             model_file_name.c_str());
         return -EIO;
     }
-    fseek(fp, 0, SEEK_END);
-    size = ftell(fp);
-    rewind(fp);
-    payload = calloc(1, size);
-    if (!payload) {
-        status = -ENOMEM;
-        goto close_fp;
-    }
 
-    bytes_read = fread((char*)payload, 1, size , fp);
-    if (bytes_read != size) {
-        status = -EIO;
-        PAL_ERR(LOG_TAG, "Error:%d failed to read data from soundmodel file' %s'\n",
-            status, model_file_name.c_str());
-        goto free_payload;
+    status = session_->getMIID(nullptr, tag_id, &miid);
+    if (status != 0) {
+        PAL_ERR(LOG_TAG, "Error:%d Failed to get miid for tag %x", status, tag_id);
+        return status;
     }
 
-    sm_data = (struct param_id_detection_engine_register_multi_sound_model_t *)
-         calloc(1, sizeof(
-         struct param_id_detection_engine_register_multi_sound_model_t) +
-         size);
-
-    if (sm_data == nullptr) {
-        status =  -ENOMEM;
-        PAL_ERR(LOG_TAG, "Error:%d Failed to allocate memory for sm_data", status);
-        goto free_smdata;
+    /* the payload is laid out around the mapped model, nothing is copied */
+    std::lock_guard<std::mutex> payload_lck(blob->GetPayloadLock());
+    status = builder_->payloadRegisterSoundModel(&session_payload, &len,
+                         blob.get(), model_uuid, miid,
+                         PARAM_ID_DETECTION_ENGINE_REGISTER_MULTI_SOUND_MODEL);
+    if (status || !session_payload) {
+        PAL_ERR(LOG_TAG, "Error:%d Failed to construct ACD soundmodel payload", status);
+        return -ENOMEM;
     }
 
-    sm_data->model_id = model_uuid;
-    sm_data->model_size = size;
-    ar_mem_cpy(sm_data->model, size, payload, size);
-    size += (sizeof(param_id_detection_engine_register_multi_sound_model_t));
-
-    status = RegDeregSoundModel(PAL_PARAM_ID_LOAD_SOUND_MODEL, (uint8_t *)sm_data, size);
+    status = session_->setParameters(stream_handle_, tag_id,
+                         PAL_PARAM_ID_LOAD_SOUND_MODEL, session_payload);
+    if (status != 0)
+        PAL_ERR(LOG_TAG, "Error:%d Failed to send sound model payload", status);
+    else
+        model_pins_[model_uuid] = std::make_unique<SoundModelPin>(model_uuid, blob);
 
-free_smdata:
-    free(sm_data);
-free_payload:
-    free(payload);
-close_fp:
-    fclose(fp);
     return status;
 }
 
@@ -907,9 +892,11 @@ int32_t ACDEngine::UnloadSoundModel()
                 return status;
             }
             deregister_config.model_id = modelInfo->GetModelUUID();
-            if (deregister_config.model_id)
+            if (deregister_config.model_id) {
                 status = RegDeregSoundModel(PAL_PARAM_ID_UNLOAD_SOUND_MODEL, (uint8_t *)&deregister_config,
                                      sizeof(deregister_config));
+                model_pins_.erase(deregister_config.model_id);
+            }
         }
     }
     return status;
@@ -1175,6 +1162,7 @@ int32_t ACDEngine::TeardownEngine(Stream *st, void *config)
     status = session_->close(s);
     if (status)
         PAL_ERR(LOG_TAG, "Error:%d Failed to close session", status);
+    model_pins_.clear();
 
     eng_state_ = ENG_IDLE;
 exit:
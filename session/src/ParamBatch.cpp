@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#define LOG_TAG "PAL: ParamBatch"
+
+#include "ParamBatch.h"
+#include "PalCommon.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PARAM_BATCH_ALIGN_8BYTE(x) (((x) + 7) & (~7))
+
+ParamBatch::ParamBatch()
+{
+    buf = NULL;
+    used = 0;
+    cap = 0;
+    allocCount = 0;
+}
+
+ParamBatch::~ParamBatch()
+{
+    if (buf)
+        free(buf);
+}
+
+int ParamBatch::reserve(size_t size)
+{
+    uint8_t *newBuf = NULL;
+    size_t newCap = cap ? cap : PARAM_BATCH_MIN_CAPACITY;
+
+    if (size <= cap)
+        return 0;
+
+    while (newCap < size)
+        newCap *= 2;
+
+    newBuf = (uint8_t *)realloc(buf, newCap);
+    if (!newBuf) {
+        PAL_ERR(LOG_TAG, "failed to grow param batch to %zu bytes", newCap);
+        return -ENOMEM;
+    }
+    buf = newBuf;
+    cap = newCap;
+    allocCount++;
+
+    return 0;
+}
+
+uint8_t *ParamBatch::appendParam(uint32_t miid, uint32_t paramId,
+                                 size_t paramSize)
+{
+    struct apm_module_param_data_t *header = NULL;
+    size_t size = PARAM_BATCH_ALIGN_8BYTE(sizeof(struct apm_module_param_data_t) +
+                                          paramSize);
+    uint8_t *param = NULL;
+
+    if (reserve(used + size))
+        return NULL;
+
+    param = buf + used;
+    memset(param, 0, size);
+    header = (struct apm_module_param_data_t *)param;
+    header->module_instance_id = miid;
+    header->param_id = paramId;
+    header->error_code = 0x0;
+    header->param_size = paramSize;
+    used += size;
+
+    return param + sizeof(struct apm_module_param_data_t);
+}
+
+int ParamBatch::append(const void *payload, size_t size)
+{
+    if (!payload || !size)
+        return 0;
+
+    if (reserve(used + size))
+        return -ENOMEM;
+
+    memcpy(buf + used, payload, size);
+    used += size;
+    return 0;
+}
+
+uint8_t *ParamBatch::release(size_t *size)
+{
+    uint8_t *payload = used ? buf : NULL;
+
+    *size = used;
+    if (!used && buf)
+        free(buf);
+
+    buf = NULL;
+    used = 0;
+    cap = 0;
+    return payload;
+}
@@ -68,8 +68,10 @@
 #define LOG_TAG "PAL: PayloadBuilder"
 #include "ResourceManager.h"
 #include "PayloadBuilder.h"
+#include "SoundModelStore.h"
 #include "SessionGsl.h"
 #include "StreamSoundTrigger.h"
+#include "PalSpanTracer.h"
 #include "spr_api.h"
 #include "pop_suppressor_api.h"
 #include <agm/agm_api.h>
@@ -434,12 +436,20 @@ void PayloadBuilder::payloadDpAudioConfig(uint8_t** payload, size_t* size,
 void PayloadBuilder::payloadVolumeConfig(uint8_t** payload, size_t* size,
         uint32_t miid, struct pal_volume_data* voldata)
 {
-    struct apm_module_param_data_t* header = nullptr;
+    ParamBatch batch;
+
+    if (payloadVolumeConfig(batch, miid, voldata))
+        return;
+    *payload = batch.release(size);
+    PAL_DBG(LOG_TAG, "payload %pK size %zu", *payload, *size);
+}
+
+int PayloadBuilder::payloadVolumeConfig(ParamBatch &batch, uint32_t miid,
+        struct pal_volume_data* voldata)
+{
     volume_ctrl_master_gain_t *volConf = nullptr;
     float voldB = 0.0f;
     long vol = 0;
-    uint8_t* payloadInfo = NULL;
-    size_t payloadSize = 0, padBytes = 0;
 
     if (voldata->no_of_volpair == 1) {
         voldB = (voldata->volume_pair[0].vol);
@@ -450,55 +460,44 @@ void PayloadBuilder::payloadVolumeConfig(uint8_t** payload, size_t* size,
     }
     PAL_VERBOSE(LOG_TAG,"volume sent:%f \n",voldB);
     vol = (long)(voldB * (PLAYBACK_VOLUME_MAX*1.0));
-    payloadSize = sizeof(struct apm_module_param_data_t) +
-                  sizeof(struct volume_ctrl_master_gain_t);
-    padBytes = PAL_PADDING_8BYTE_ALIGN(payloadSize);
-    payloadInfo = new uint8_t[payloadSize + padBytes]();
-    if (!payloadInfo) {
+    volConf = batch.appendParam<volume_ctrl_master_gain_t>(miid,
+                                        PARAM_ID_VOL_CTRL_MASTER_GAIN);
+    if (!volConf) {
         PAL_ERR(LOG_TAG, "payloadInfo malloc failed %s", strerror(errno));
-        return;
+        return -ENOMEM;
     }
-    header = (struct apm_module_param_data_t*)payloadInfo;
-    header->module_instance_id = miid;
-    header->param_id = PARAM_ID_VOL_CTRL_MASTER_GAIN;
-    header->error_code = 0x0;
-    header->param_size = payloadSize -  sizeof(struct apm_module_param_data_t);
-    volConf = (volume_ctrl_master_gain_t *) (payloadInfo + sizeof(struct apm_module_param_data_t));
     volConf->master_gain = vol;
-    PAL_VERBOSE(LOG_TAG, "header params IID:%x param_id:%x error_code:%d param_size:%d",
-                  header->module_instance_id, header->param_id,
-                  header->error_code, header->param_size);
-    *size = payloadSize + padBytes;;
-    *payload = payloadInfo;
-    PAL_DBG(LOG_TAG, "payload %pK size %zu", *payload, *size);
+    PAL_VERBOSE(LOG_TAG, "IID:%x param_id:%x param_size:%zu", miid,
+                  PARAM_ID_VOL_CTRL_MASTER_GAIN, sizeof(volume_ctrl_master_gain_t));
+    return 0;
 }
 
 void PayloadBuilder::payloadMultichVolumemConfig(uint8_t** payload, size_t* size,
         uint32_t miid, struct pal_volume_data* voldata)
+{
+    ParamBatch batch;
+
+    if (payloadMultichVolumemConfig(batch, miid, voldata))
+        return;
+    *payload = batch.release(size);
+    PAL_DBG(LOG_TAG, "payload %pK size %zu", *payload, *size);
+}
+
+int PayloadBuilder::payloadMultichVolumemConfig(ParamBatch &batch, uint32_t miid,
+        struct pal_volume_data* voldata)
 {
      const uint32_t PLAYBACK_MULTI_VOLUME_GAIN = 1 << 28;
-     struct apm_module_param_data_t* header = nullptr;
      volume_ctrl_multichannel_gain_t *volConf = nullptr;
      int numChannels;
-     uint8_t* payloadInfo = NULL;
-     size_t payloadSize = 0, padBytes = 0;
 
      numChannels = voldata->no_of_volpair;
-     payloadSize = sizeof(struct apm_module_param_data_t) +
-                   sizeof(struct volume_ctrl_multichannel_gain_t) +
-                   numChannels * sizeof(volume_ctrl_channels_gain_config_t);
-     padBytes = PAL_PADDING_8BYTE_ALIGN(payloadSize);
-     payloadInfo = (uint8_t*) calloc(1, payloadSize + padBytes);
-     if (!payloadInfo) {
+     volConf = batch.appendParam<volume_ctrl_multichannel_gain_t>(miid,
+                     PARAM_ID_VOL_CTRL_MULTICHANNEL_GAIN,
+                     numChannels * sizeof(volume_ctrl_channels_gain_config_t));
+     if (!volConf) {
          PAL_ERR(LOG_TAG, "payloadInfo malloc failed %s", strerror(errno));
-         return;
+         return -ENOMEM;
      }
-     header = (struct apm_module_param_data_t*)payloadInfo;
-     header->module_instance_id = miid;
-     header->param_id = PARAM_ID_VOL_CTRL_MULTICHANNEL_GAIN;
-     header->error_code = 0x0;
-     header->param_size = payloadSize -  sizeof(struct apm_module_param_data_t);
-     volConf = (volume_ctrl_multichannel_gain_t *) (payloadInfo + sizeof(struct apm_module_param_data_t));
      volConf->num_config = numChannels;
      PAL_DBG(LOG_TAG, "num_config %d", numChannels);
      /*
@@ -510,161 +509,134 @@ void PayloadBuilder::payloadMultichVolumemConfig(uint8_t** payload, size_t* size
           volConf->gain_data[i].channel_mask_msb = 0;
           volConf->gain_data[i].gain = (uint32_t)((voldata->volume_pair[i].vol) * (PLAYBACK_MULTI_VOLUME_GAIN * 1.0));
      }
-     PAL_DBG(LOG_TAG, "header params IID:%x param_id:%x error_code:%d param_size:%d",
-                   header->module_instance_id, header->param_id,
-                   header->error_code, header->param_size);
-     *size = payloadSize + padBytes;
-     *payload = payloadInfo;
-     PAL_DBG(LOG_TAG, "payload %pK size %zu", *payload, *size);
+     PAL_DBG(LOG_TAG, "IID:%x param_id:%x", miid, PARAM_ID_VOL_CTRL_MULTICHANNEL_GAIN);
+     return 0;
 }
 
 void PayloadBuilder::payloadVolumeCtrlRamp(uint8_t** payload, size_t* size,
         uint32_t miid, uint32_t ramp_period_ms)
 {
-    struct apm_module_param_data_t* header = NULL;
+    ParamBatch batch;
+
+    if (payloadVolumeCtrlRamp(batch, miid, ramp_period_ms))
+        return;
+    *payload = batch.release(size);
+    PAL_DBG(LOG_TAG, "payload %pK size %zu", *payload, *size);
+}
+
+int PayloadBuilder::payloadVolumeCtrlRamp(ParamBatch &batch, uint32_t miid,
+        uint32_t ramp_period_ms)
+{
     struct volume_ctrl_gain_ramp_params_t *rampParams;
-    uint8_t* payloadInfo = NULL;
-    size_t payloadSize = 0, padBytes = 0;
 
-    payloadSize = sizeof(struct apm_module_param_data_t) +
-                  sizeof(struct volume_ctrl_gain_ramp_params_t);
-    padBytes = PAL_PADDING_8BYTE_ALIGN(payloadSize);
-    payloadInfo = new uint8_t[payloadSize + padBytes]();
-    if (!payloadInfo) {
+    rampParams = batch.appendParam<struct volume_ctrl_gain_ramp_params_t>(miid,
+                    PARAM_ID_VOL_CTRL_GAIN_RAMP_PARAMETERS);
+    if (!rampParams) {
         PAL_ERR(LOG_TAG, "payloadInfo malloc failed %s", strerror(errno));
-        return;
+        return -ENOMEM;
     }
-    header = (struct apm_module_param_data_t*)payloadInfo;
-    header->module_instance_id = miid;
-    header->param_id = PARAM_ID_VOL_CTRL_GAIN_RAMP_PARAMETERS;
-    header->error_code = 0x0;
-    header->param_size = payloadSize -  sizeof(struct apm_module_param_data_t);
-    rampParams = (struct volume_ctrl_gain_ramp_params_t*) (payloadInfo + sizeof(struct apm_module_param_data_t));
     rampParams->period_ms = ramp_period_ms;
     rampParams->step_us = 0;
     rampParams->ramping_curve = PARAM_VOL_CTRL_RAMPINGCURVE_LINEAR;
-    PAL_VERBOSE(LOG_TAG, "header params IID:%x param_id:%x error_code:%d param_size:%d",
-                  header->module_instance_id, header->param_id,
-                  header->error_code, header->param_size);
-    *size = payloadSize + padBytes;;
-    *payload = payloadInfo;
-    PAL_DBG(LOG_TAG, "payload %pK size %zu", *payload, *size);
+    PAL_VERBOSE(LOG_TAG, "IID:%x param_id:%x param_size:%zu", miid,
+                  PARAM_ID_VOL_CTRL_GAIN_RAMP_PARAMETERS,
+                  sizeof(struct volume_ctrl_gain_ramp_params_t));
+    return 0;
 }
 
 void PayloadBuilder::payloadMFCMixerCoeff(uint8_t** payload, size_t* size,
         uint32_t miid, int numCh, int rotationType)
 {
-    struct apm_module_param_data_t* header = NULL;
+    ParamBatch batch;
+
+    if (payloadMFCMixerCoeff(batch, miid, numCh, rotationType) || batch.empty())
+        return;
+    *payload = batch.release(size);
+}
+
+int PayloadBuilder::payloadMFCMixerCoeff(ParamBatch &batch, uint32_t miid,
+        int numCh, int rotationType)
+{
     param_id_chmixer_coeff_t *mfcMixerCoeff = NULL;
     chmixer_coeff_t *chMixerCoeff = NULL;
-    size_t payloadSize = 0, padBytes = 0;
-    uint8_t* payloadInfo = NULL;
     uint16_t* pcmChannel = NULL;
     int numChannels = numCh;
 
     // Only Stereo Speaker swap is supported
     if (numChannels != 2)
-        return;
+        return 0;
 
     PAL_DBG(LOG_TAG, "Enter");
-    payloadSize = sizeof(struct apm_module_param_data_t) +
-                  sizeof(param_id_chmixer_coeff_t) +
-                  sizeof(chmixer_coeff_t) // Only 1 table is being send currently
-                  + sizeof(uint16_t) * (numChannels)
-                  + sizeof(uint16_t) * (numChannels)
-                  + sizeof(uint16_t) * (numChannels*2);
-    padBytes = PAL_PADDING_8BYTE_ALIGN(payloadSize);
-    payloadInfo = (uint8_t*) calloc(1, payloadSize + padBytes);
-    if (!payloadInfo) {
+    // Only 1 table is being send currently
+    mfcMixerCoeff = batch.appendParam<param_id_chmixer_coeff_t>(miid,
+                    PARAM_ID_CHMIXER_COEFF,
+                    sizeof(chmixer_coeff_t)
+                    + sizeof(uint16_t) * (numChannels)
+                    + sizeof(uint16_t) * (numChannels)
+                    + sizeof(uint16_t) * (numChannels*2));
+    if (!mfcMixerCoeff) {
         PAL_ERR(LOG_TAG, "payloadInfo malloc failed %s", strerror(errno));
-        return;
+        return -ENOMEM;
     }
-    header = (struct apm_module_param_data_t*)payloadInfo;
-    mfcMixerCoeff = (param_id_chmixer_coeff_t *)(payloadInfo +
-                    sizeof(struct apm_module_param_data_t));
     // Set number of tables
     mfcMixerCoeff->num_coeff_tbls = 1;
 
-    chMixerCoeff = (chmixer_coeff_t *) (payloadInfo +
-                    sizeof(struct apm_module_param_data_t) +
+    chMixerCoeff = (chmixer_coeff_t *)((uint8_t *)mfcMixerCoeff +
                     sizeof(param_id_chmixer_coeff_t));
     // Set Number of channels for input and output channels
     chMixerCoeff->num_output_channels = numChannels;
     chMixerCoeff->num_input_channels = numChannels;
-    pcmChannel = (uint16_t *) (payloadInfo +
-                    sizeof(struct apm_module_param_data_t)+
-                    sizeof(param_id_chmixer_coeff_t) +
-                    sizeof(chmixer_coeff_t));
+    pcmChannel = (uint16_t *)((uint8_t *)chMixerCoeff + sizeof(chmixer_coeff_t));
     // Populate output channel map
     populateChannelMap(pcmChannel, numChannels);
 
-    pcmChannel = (uint16_t *) (payloadInfo +
-                    sizeof(struct apm_module_param_data_t)+
-                    sizeof(param_id_chmixer_coeff_t) +
-                    sizeof(chmixer_coeff_t) +
-                    sizeof(uint16_t) * numChannels);
+    pcmChannel += numChannels;
     // Populate input channel map
     populateChannelMap(pcmChannel, numChannels);
 
-
-    pcmChannel = (uint16_t *) (payloadInfo +
-                    sizeof(struct apm_module_param_data_t)+
-                    sizeof(param_id_chmixer_coeff_t) +
-                    sizeof(chmixer_coeff_t) +
-                    sizeof(uint16_t) * numChannels +
-                    sizeof(uint16_t) * numChannels);
-
+    pcmChannel += numChannels;
     populateChannelMixerCoeff(pcmChannel, numChannels, rotationType);
 
-    header->module_instance_id = miid;
-    header->error_code = 0x0;
-    header->param_id = PARAM_ID_CHMIXER_COEFF;
-    header->param_size = payloadSize - sizeof(struct apm_module_param_data_t);
-
-    *size = payloadSize + padBytes;
-    *payload = payloadInfo;
-
     PAL_DBG(LOG_TAG, "Exit");
+    return 0;
 }
 
 void PayloadBuilder::payloadMFCConfig(uint8_t** payload, size_t* size,
         uint32_t miid, struct sessionToPayloadParam* data)
 {
-    struct apm_module_param_data_t* header = NULL;
+    ParamBatch batch;
+
+    if (payloadMFCConfig(batch, miid, data))
+        return;
+    *payload = batch.release(size);
+    PAL_DBG(LOG_TAG, "customPayload address %pK and size %zu", *payload,
+                *size);
+}
+
+int PayloadBuilder::payloadMFCConfig(ParamBatch &batch, uint32_t miid,
+        struct sessionToPayloadParam* data)
+{
     struct param_id_mfc_output_media_fmt_t *mfcConf;
     int numChannels;
     uint16_t* pcmChannel = NULL;
-    uint8_t* payloadInfo = NULL;
-    size_t payloadSize = 0, padBytes = 0;
 
     if (!data) {
         PAL_ERR(LOG_TAG, "Invalid input parameters");
-        return;
+        return -EINVAL;
     }
     numChannels = data->numChannel;
-    payloadSize = sizeof(struct apm_module_param_data_t) +
-                  sizeof(struct param_id_mfc_output_media_fmt_t) +
-                  sizeof(uint16_t)*numChannels;
-    padBytes = PAL_PADDING_8BYTE_ALIGN(payloadSize);
-
-    payloadInfo = (uint8_t*) calloc(1, payloadSize + padBytes);
-    if (!payloadInfo) {
+    mfcConf = batch.appendParam<struct param_id_mfc_output_media_fmt_t>(miid,
+                    PARAM_ID_MFC_OUTPUT_MEDIA_FORMAT, sizeof(uint16_t)*numChannels);
+    if (!mfcConf) {
         PAL_ERR(LOG_TAG, "payloadInfo malloc failed %s", strerror(errno));
-        return;
+        return -ENOMEM;
     }
-    header = (struct apm_module_param_data_t*)payloadInfo;
-    mfcConf = (struct param_id_mfc_output_media_fmt_t*)(payloadInfo +
-               sizeof(struct apm_module_param_data_t));
-    pcmChannel = (uint16_t*)(payloadInfo + sizeof(struct apm_module_param_data_t) +
-                                       sizeof(struct param_id_mfc_output_media_fmt_t));
-
-    header->module_instance_id = miid;
-    header->param_id = PARAM_ID_MFC_OUTPUT_MEDIA_FORMAT;
-    header->error_code = 0x0;
-    header->param_size = payloadSize - sizeof(struct apm_module_param_data_t);
-    PAL_DBG(LOG_TAG, "header params \n IID:%x param_id:%x error_code:%d param_size:%d",
-                      header->module_instance_id, header->param_id,
-                      header->error_code, header->param_size);
+    pcmChannel = (uint16_t*)((uint8_t*)mfcConf +
+                             sizeof(struct param_id_mfc_output_media_fmt_t));
+    PAL_DBG(LOG_TAG, "header params \n IID:%x param_id:%x param_size:%zu",
+                      miid, PARAM_ID_MFC_OUTPUT_MEDIA_FORMAT,
+                      sizeof(struct param_id_mfc_output_media_fmt_t) +
+                      sizeof(uint16_t)*numChannels);
 
     mfcConf->sampling_rate = data->sampleRate;
     mfcConf->bit_width = data->bitWidth;
@@ -677,13 +649,10 @@ void PayloadBuilder::payloadMFCConfig(uint8_t** payload, size_t* size,
         populateChannelMap(pcmChannel, data->numChannel);
     }
 
-    *size = payloadSize + padBytes;
-    *payload = payloadInfo;
     PAL_DBG(LOG_TAG, "sample_rate:%d bit_width:%d num_channels:%d Miid:%d",
                       mfcConf->sampling_rate, mfcConf->bit_width,
-                      mfcConf->num_channels, header->module_instance_id);
-    PAL_DBG(LOG_TAG, "customPayload address %pK and size %zu", payloadInfo,
-                *size);
+                      mfcConf->num_channels, miid);
+    return 0;
 }
 
 int PayloadBuilder::payloadPopSuppressorConfig(uint8_t** payload, size_t* size,
@@ -1678,6 +1647,85 @@ int PayloadBuilder::payloadSVAConfig(uint8_t **payload, size_t *size,
     return 0;
 }
 
+/*
+ * Lays out a model param around a model from the SoundModelStore: the
+ * header goes into the headroom in front of the model, so the model is not
+ * copied. The payload points into the blob; the caller holds the blob's
+ * payload lock until it has been sent and does not free it.
+ */
+int PayloadBuilder::payloadSVAConfig(uint8_t **payload, size_t *size,
+            SoundModelBlob *model, uint32_t miid, uint32_t param_id) {
+    struct apm_module_param_data_t* header = nullptr;
+
+    if (!model || !model->GetSize()) {
+        PAL_ERR(LOG_TAG, "Invalid sound model");
+        return -EINVAL;
+    }
+
+    header = (struct apm_module_param_data_t *)
+        model->GetHeadroom(sizeof(struct apm_module_param_data_t));
+    if (!header) {
+        PAL_ERR(LOG_TAG, "No room for the param header");
+        return -EINVAL;
+    }
+    header->module_instance_id = miid;
+    header->param_id = param_id;
+    header->error_code = 0x0;
+    header->param_size = model->GetSize();
+
+    *size = PAL_ALIGN_8BYTE(sizeof(struct apm_module_param_data_t) +
+                            model->GetSize());
+    *payload = (uint8_t *)header;
+
+    PAL_INFO(LOG_TAG, "PID 0x%x, payload %pK size %zu", param_id, *payload, *size);
+
+    return 0;
+}
+
+/*
+ * Builds PARAM_ID_DETECTION_ENGINE_REGISTER_MULTI_SOUND_MODEL in place
+ * around a model from the SoundModelStore, same as the model param above.
+ */
+int PayloadBuilder::payloadRegisterSoundModel(uint8_t **payload, size_t *size,
+            SoundModelBlob *model, uint32_t model_id, uint32_t miid,
+            uint32_t param_id) {
+    struct apm_module_param_data_t* header = nullptr;
+    struct param_id_detection_engine_register_multi_sound_model_t *reg = nullptr;
+    size_t regSize =
+        offsetof(struct param_id_detection_engine_register_multi_sound_model_t, model);
+    size_t headerSize = sizeof(struct apm_module_param_data_t) + regSize;
+    size_t paramSize = 0;
+
+    if (!model || !model->GetSize()) {
+        PAL_ERR(LOG_TAG, "Invalid sound model");
+        return -EINVAL;
+    }
+
+    header = (struct apm_module_param_data_t *)model->GetHeadroom(headerSize);
+    if (!header) {
+        PAL_ERR(LOG_TAG, "No room for the register header");
+        return -EINVAL;
+    }
+    paramSize = regSize + model->GetSize();
+    header->module_instance_id = miid;
+    header->param_id = param_id;
+    header->error_code = 0x0;
+    header->param_size = paramSize;
+
+    reg = (struct param_id_detection_engine_register_multi_sound_model_t *)
+        ((uint8_t *)header + sizeof(struct apm_module_param_data_t));
+    reg->model_id = model_id;
+    reg->model_size = model->GetSize();
+
+    *size = PAL_ALIGN_8BYTE(sizeof(struct apm_module_param_data_t) + paramSize);
+    *payload = (uint8_t *)header;
+
+    PAL_INFO(LOG_TAG, "model id 0x%x, PID 0x%x, payload %pK size %zu",
+        model_id, param_id, *payload, *size);
+
+    return 0;
+}
+
 void PayloadBuilder::payloadQuery(uint8_t **payload, size_t *size,
                     uint32_t moduleId, uint32_t paramId, uint32_t querySize)
 {
@@ -1919,44 +1967,40 @@ void PayloadBuilder::payloadLC3Config(uint8_t** payload, size_t* size,
 void PayloadBuilder::payloadRATConfig(uint8_t** payload, size_t* size,
         uint32_t miid, struct pal_media_config *data)
 {
-    struct apm_module_param_data_t* header = NULL;
+    ParamBatch batch;
+
+    if (payloadRATConfig(batch, miid, data))
+        return;
+    *payload = batch.release(size);
+    PAL_DBG(LOG_TAG, "customPayload address %pK and size %zu", *payload,
+                *size);
+}
+
+int PayloadBuilder::payloadRATConfig(ParamBatch &batch, uint32_t miid,
+        struct pal_media_config *data)
+{
     struct param_id_rat_mf_t *ratConf;
     int numChannel;
     uint32_t bitWidth;
     uint16_t* pcmChannel = NULL;
-    uint8_t* payloadInfo = NULL;
-    size_t payloadSize = 0, padBytes = 0;
 
     if (!data) {
         PAL_ERR(LOG_TAG, "Invalid input parameters");
-        return;
+        return -EINVAL;
     }
 
     numChannel = data->ch_info.channels;
     bitWidth = data->bit_width;
-    payloadSize = sizeof(struct apm_module_param_data_t) +
-                  sizeof(struct param_id_rat_mf_t) +
-                  sizeof(uint16_t)*numChannel;
-    padBytes = PAL_PADDING_8BYTE_ALIGN(payloadSize);
-
-    payloadInfo = (uint8_t*) calloc(1, payloadSize + padBytes);
-    if (!payloadInfo) {
+    ratConf = batch.appendParam<struct param_id_rat_mf_t>(miid,
+                    PARAM_ID_RAT_MEDIA_FORMAT, sizeof(uint16_t)*numChannel);
+    if (!ratConf) {
         PAL_ERR(LOG_TAG, "payloadInfo malloc failed %s", strerror(errno));
-        return;
+        return -ENOMEM;
     }
-    header = (struct apm_module_param_data_t*)payloadInfo;
-    ratConf = (struct param_id_rat_mf_t*)(payloadInfo +
-               sizeof(struct apm_module_param_data_t));
-    pcmChannel = (uint16_t*)(payloadInfo + sizeof(struct apm_module_param_data_t) +
-                                       sizeof(struct param_id_rat_mf_t));
-
-    header->module_instance_id = miid;
-    header->param_id = PARAM_ID_RAT_MEDIA_FORMAT;
-    header->error_code = 0x0;
-    header->param_size = payloadSize - sizeof(struct apm_module_param_data_t);
-    PAL_DBG(LOG_TAG, "header params \n IID:%x param_id:%x error_code:%d param_size:%d",
-                      header->module_instance_id, header->param_id,
-                      header->error_code, header->param_size);
+    pcmChannel = (uint16_t*)((uint8_t*)ratConf + sizeof(struct param_id_rat_mf_t));
+    PAL_DBG(LOG_TAG, "header params \n IID:%x param_id:%x param_size:%zu",
+                      miid, PARAM_ID_RAT_MEDIA_FORMAT,
+                      sizeof(struct param_id_rat_mf_t) + sizeof(uint16_t)*numChannel);
 
     ratConf->sample_rate = data->sample_rate;
     if ((bitWidth == BITWIDTH_16) || (bitWidth == BITWIDTH_32)) {
@@ -1969,13 +2013,10 @@ void PayloadBuilder::payloadRATConfig(uint8_t** payload, size_t* size,
     ratConf->data_format = DATA_FORMAT_FIXED_POINT;
     ratConf->num_channels = numChannel;
     populateChannelMap(pcmChannel, numChannel);
-    *size = payloadSize + padBytes;
-    *payload = payloadInfo;
     PAL_DBG(LOG_TAG, "sample_rate:%d bits_per_sample:%d q_factor:%d data_format:%d num_channels:%d",
                       ratConf->sample_rate, ratConf->bits_per_sample, ratConf->q_factor,
                       ratConf->data_format, ratConf->num_channels);
-    PAL_DBG(LOG_TAG, "customPayload address %pK and size %zu", payloadInfo,
-                *size);
+    return 0;
 }
 
 void PayloadBuilder::payloadPcmCnvConfig(uint8_t** payload, size_t* size,
@@ -2331,6 +2372,7 @@ int PayloadBuilder::getBtDeviceKV(int dev_id, std::vector<std::pair<int,int>>& d
 int PayloadBuilder::populateStreamKV(Stream* s, std::vector<std::pair<int,int>> &keyVectorRx,
         std::vector<std::pair<int,int>> &keyVectorTx, struct vsid_info vsidinfo)
 {
+    PAL_TRACE_SPAN("PayloadBuilder::populateStreamKV");
     int status = 0;
     struct pal_stream_attributes *sattr = NULL;
     std::vector<std::string> selector_names;
@@ -2397,6 +2439,7 @@ exit:
 int PayloadBuilder::populateStreamPPKV(Stream* s, std::vector <std::pair<int,int>> &keyVectorRx,
         std::vector <std::pair<int,int>> &keyVectorTx __unused)
 {
+    PAL_TRACE_SPAN("PayloadBuilder::populateStreamPPKV");
     int status = 0;
     struct pal_stream_attributes *sattr = NULL;
     std::vector <std::string> selectors;
@@ -2759,6 +2802,7 @@ std::vector<std::string> PayloadBuilder::retrieveSelectors(int32_t type, std::ve
 int PayloadBuilder::populateStreamKV(Stream* s,
         std::vector <std::pair<int,int>> &keyVector)
 {
+    PAL_TRACE_SPAN("PayloadBuilder::populateStreamKV");
     int status = -EINVAL;
     struct pal_stream_attributes *sattr = NULL;
     std::vector <std::string> selectors;
@@ -2794,6 +2838,7 @@ exit:
 int PayloadBuilder::populateStreamKVTunnel(Stream* s,
         std::vector <std::pair<int,int>> &keyVector, uint32_t instanceId)
 {
+    PAL_TRACE_SPAN("PayloadBuilder::populateStreamKVTunnel");
     int status = -EINVAL;
     struct pal_stream_attributes *sattr = NULL;
     std::vector <std::string> selectors;
@@ -2854,6 +2899,7 @@ int PayloadBuilder::populateStreamDeviceKV(Stream* s, int32_t rxBeDevId,
         std::vector <std::pair<int,int>> &keyVectorTx, struct vsid_info vsidinfo,
                                            sidetone_mode_t sidetoneMode)
 {
+    PAL_TRACE_SPAN("PayloadBuilder::populateStreamDeviceKV");
     int status = 0;
     std::vector <std::pair<int, int>> emptyKV;
     std::shared_ptr<ResourceManager> rm = ResourceManager::getInstance();
@@ -2881,6 +2927,7 @@ exit:
 int PayloadBuilder::populateDeviceKV(Stream* s, int32_t beDevId,
         std::vector <std::pair<int,int>> &keyVector)
 {
+    PAL_TRACE_SPAN("PayloadBuilder::populateDeviceKV");
     int status = 0;
     std::vector <std::string> selectors;
     std::vector <std::pair<selector_type_t, std::string>> filled_selector_pairs;
@@ -2928,6 +2975,7 @@ int PayloadBuilder::populateDeviceKV(Stream* s, int32_t rxBeDevId,
         std::vector <std::pair<int,int>> &keyVectorRx, int32_t txBeDevId,
         std::vector <std::pair<int,int>> &keyVectorTx, sidetone_mode_t sidetoneMode)
 {
+    PAL_TRACE_SPAN("PayloadBuilder::populateDeviceKV");
     int status = 0;
     struct pal_stream_attributes sAttr;
     std::vector <std::pair<selector_type_t, std::string>> filled_selector_pairs;
@@ -2962,6 +3010,7 @@ int PayloadBuilder::populateDeviceKV(Stream* s, int32_t rxBeDevId,
 int PayloadBuilder::populateDeviceKVTunnel(Stream* s, int32_t beDevId,
         std::vector <std::pair<int,int>> &keyVector)
 {
+    PAL_TRACE_SPAN("PayloadBuilder::populateDeviceKVTunnel");
     int status = 0;
     std::vector <std::string> selectors;
     std::vector <std::pair<selector_type_t, std::string>> filled_selector_pairs;
@@ -2995,6 +3044,7 @@ int PayloadBuilder::populateDeviceKVTunnel(Stream* s, int32_t beDevId,
 int PayloadBuilder::populateDevicePPKVTunnel(Stream* s, int32_t rxBeDevId,
         std::vector <std::pair<int,int>> &keyVectorRx)
 {
+    PAL_TRACE_SPAN("PayloadBuilder::populateDevicePPKVTunnel");
     int status = 0;
     struct pal_device dAttr;
     std::shared_ptr<ResourceManager> rm = ResourceManager::getInstance();
@@ -3023,6 +3073,7 @@ int PayloadBuilder::populateDevicePPKV(Stream* s, int32_t rxBeDevId,
         std::vector <std::pair<int,int>> &keyVectorRx, int32_t txBeDevId,
         std::vector <std::pair<int,int>> &keyVectorTx)
 {
+    PAL_TRACE_SPAN("PayloadBuilder::populateDevicePPKV");
     int status = 0;
     struct pal_device dAttr;
     std::shared_ptr<Device> dev = nullptr;
@@ -4044,77 +4095,49 @@ void PayloadBuilder::payloadSPConfig(uint8_t** payload, size_t* size, uint32_t m
 void PayloadBuilder::payloadMSPPConfig(uint8_t** payload, size_t* size,
         uint32_t miid, uint32_t gain)
 {
-    struct apm_module_param_data_t* header = NULL;
-    uint8_t* payloadInfo = NULL;
-    uint32_t param_id = 0;
-    size_t payloadSize = 0, customPayloadSize = 0;
-    mspp_volume_ctrl_gain_t *mspp_payload;
-
-    param_id = PARAM_ID_MSPP_VOLUME;
-    customPayloadSize = sizeof(mspp_volume_ctrl_gain_t);
+    ParamBatch batch;
 
-    payloadSize = PAL_ALIGN_8BYTE(sizeof(struct apm_module_param_data_t)
-                                        + customPayloadSize);
-    payloadInfo = (uint8_t *)calloc(1, (size_t)payloadSize);
-    if (!payloadInfo) {
-        PAL_ERR(LOG_TAG, "failed to allocate memory.");
+    if (payloadMSPPConfig(batch, miid, gain))
         return;
-    }
+    *payload = batch.release(size);
+}
 
-    header = (struct apm_module_param_data_t*)payloadInfo;
-    header->module_instance_id = miid;
-    header->param_id = param_id;
-    header->error_code = 0x0;
-    header->param_size = customPayloadSize;
+int PayloadBuilder::payloadMSPPConfig(ParamBatch &batch, uint32_t miid,
+        uint32_t gain)
+{
+    mspp_volume_ctrl_gain_t *mspp_payload;
 
-    mspp_payload =
-        (mspp_volume_ctrl_gain_t *)(payloadInfo +
-         sizeof(struct apm_module_param_data_t));
+    mspp_payload = batch.appendParam<mspp_volume_ctrl_gain_t>(miid,
+                                        PARAM_ID_MSPP_VOLUME);
+    if (!mspp_payload) {
+        PAL_ERR(LOG_TAG, "failed to allocate memory.");
+        return -ENOMEM;
+    }
     mspp_payload->vol_lin_gain = gain;
-    ar_mem_cpy(payloadInfo + sizeof(struct apm_module_param_data_t),
-                     customPayloadSize,
-                     mspp_payload,
-                     customPayloadSize);
-
-    *size = payloadSize;
-    *payload = payloadInfo;
+    return 0;
 }
 
 void PayloadBuilder::payloadSoftPauseConfig(uint8_t** payload, size_t* size,
         uint32_t miid, uint32_t delayMs)
 {
-    struct apm_module_param_data_t* header = NULL;
-    uint8_t* payloadInfo = NULL;
-    uint32_t param_id = 0;
-    size_t payloadSize = 0, customPayloadSize = 0;
-    pause_downstream_delay_t *pause_payload;
+    ParamBatch batch;
 
-    param_id = PARAM_ID_SOFT_PAUSE_DOWNSTREAM_DELAY;
-    customPayloadSize = sizeof(pause_downstream_delay_t);
-
-    payloadSize = PAL_ALIGN_8BYTE(sizeof(struct apm_module_param_data_t)
-                                        + customPayloadSize);
-    payloadInfo = (uint8_t *)calloc(1, (size_t)payloadSize);
-    if (!payloadInfo) {
-        PAL_ERR(LOG_TAG, "failed to allocate memory.");
+    if (payloadSoftPauseConfig(batch, miid, delayMs))
         return;
-    }
+    *payload = batch.release(size);
+}
 
-    header = (struct apm_module_param_data_t*)payloadInfo;
-    header->module_instance_id = miid;
-    header->param_id = param_id;
-    header->error_code = 0x0;
-    header->param_size = customPayloadSize;
+int PayloadBuilder::payloadSoftPauseConfig(ParamBatch &batch, uint32_t miid,
+        uint32_t delayMs)
+{
+    pause_downstream_delay_t *pause_payload;
 
-    pause_payload =
-        (pause_downstream_delay_t *)(payloadInfo +
-         sizeof(struct apm_module_param_data_t));
+    pause_payload = batch.appendParam<pause_downstream_delay_t>(miid,
+                                        PARAM_ID_SOFT_PAUSE_DOWNSTREAM_DELAY);
+    if (!pause_payload) {
+        PAL_ERR(LOG_TAG, "failed to allocate memory.");
+        return -ENOMEM;
+    }
     pause_payload->delay_ms = delayMs;
-    ar_mem_cpy(payloadInfo + sizeof(struct apm_module_param_data_t),
-                     customPayloadSize,
-                     pause_payload,
-                     customPayloadSize);
-
-    *size = payloadSize;
-    *payload = payloadInfo;
+    return 0;
 }
@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#define LOG_TAG "PAL: PcmNonBlockingIo"
+
+#include "PcmNonBlockingIo.h"
+#include "PalCommon.h"
+#include <algorithm>
+#include <errno.h>
+#include <stdint.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+PcmNonBlockingIo::PcmNonBlockingIo(const struct pcm_io_ops *ops)
+{
+    this->ops = ops;
+    readyPcm = NULL;
+    readyFd = -1;
+    readyArmed = false;
+    readyExit = false;
+}
+
+PcmNonBlockingIo::~PcmNonBlockingIo()
+{
+    stop();
+    if (readyFd >= 0)
+        ::close(readyFd);
+}
+
+int PcmNonBlockingIo::init()
+{
+    int status = 0;
+
+    if (readyFd >= 0)
+        return 0;
+
+    readyFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (readyFd < 0) {
+        status = -errno;
+        PAL_ERR(LOG_TAG, "ready eventfd creation failed %d", status);
+    }
+
+    return status;
+}
+
+void PcmNonBlockingIo::start(struct pcm *pcm)
+{
+    std::lock_guard<std::mutex> lck(readyLock);
+
+    if (readyThread.joinable())
+        return;
+
+    readyPcm = pcm;
+    readyExit = false;
+    readyArmed = false;
+    readyThread = std::thread(&PcmNonBlockingIo::readyLoop, this);
+}
+
+void PcmNonBlockingIo::stop()
+{
+    std::unique_lock<std::mutex> lck(readyLock);
+
+    if (!readyThread.joinable())
+        return;
+
+    readyExit = true;
+    lck.unlock();
+    readyCv.notify_one();
+    readyThread.join();
+
+    eventfd_write(readyFd, 1);
+}
+
+int PcmNonBlockingIo::read(struct pcm *pcm, void *data, size_t bytes,
+                           size_t periodBytes, int *size)
+{
+    int status = 0;
+    size_t bytesRead = 0, pcmReadSize = 0;
+
+    if (!pcm) {
+        PAL_ERR(LOG_TAG, "pcm is NULL");
+        return -EINVAL;
+    }
+
+    while (bytesRead < bytes) {
+        /* errors are left to pcm_read to report or recover */
+        if (ops->wait(pcm, 0) == 0)
+            break;
+        pcmReadSize = std::min(bytes - bytesRead, periodBytes);
+        status = ops->read(pcm, (uint8_t *)data + bytesRead, pcmReadSize);
+        if (status != 0) {
+            PAL_ERR(LOG_TAG, "Failed to read data %d bytes read %zu", status,
+                    bytesRead);
+            break;
+        }
+        bytesRead += pcmReadSize;
+    }
+
+    if (bytesRead < bytes && !status)
+        arm();
+    if (!bytesRead && bytes)
+        return status ? status : -EAGAIN;
+
+    *size = bytesRead;
+    return 0;
+}
+
+int PcmNonBlockingIo::write(struct pcm *pcm, const void *data, size_t bytes,
+                            size_t periodBytes, int *size)
+{
+    int status = 0;
+    size_t bytesWritten = 0, sizeWritten = 0;
+
+    if (!pcm) {
+        PAL_ERR(LOG_TAG, "pcm is NULL");
+        return -EINVAL;
+    }
+
+    while (bytesWritten < bytes) {
+        if (ops->wait(pcm, 0) == 0)
+            break;
+        sizeWritten = std::min(bytes - bytesWritten, periodBytes);
+        status = ops->write(pcm, (const uint8_t *)data + bytesWritten, sizeWritten);
+        if (status != 0) {
+            PAL_ERR(LOG_TAG, "Error! pcm_write failed");
+            break;
+        }
+        bytesWritten += sizeWritten;
+    }
+
+    if (bytesWritten < bytes && !status)
+        arm();
+    if (!bytesWritten && bytes)
+        return status ? status : -EAGAIN;
+
+    *size = bytesWritten;
+    return 0;
+}
+
+void PcmNonBlockingIo::arm()
+{
+    std::lock_guard<std::mutex> lck(readyLock);
+
+    if (!readyArmed) {
+        readyArmed = true;
+        readyCv.notify_one();
+    }
+}
+
+void PcmNonBlockingIo::readyLoop()
+{
+    std::unique_lock<std::mutex> lck(readyLock);
+    int ret = 0;
+
+    PAL_DBG(LOG_TAG, "Enter");
+    while (true) {
+        readyCv.wait(lck, [&] { return readyExit || readyArmed; });
+        if (readyExit)
+            break;
+
+        lck.unlock();
+        ret = ops->wait(readyPcm, PCM_READY_WAIT_MS);
+        lck.lock();
+        if (ret == 0)
+            continue;
+
+        /* errors as well, so the client's next io reports or recovers them */
+        readyArmed = false;
+        eventfd_write(readyFd, 1);
+    }
+    PAL_DBG(LOG_TAG, "Exit");
+}
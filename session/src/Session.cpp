@@ -97,30 +97,6 @@ Session::~Session()
 
 }
 
-void Session::setPmQosMixerCtl(pmQosVote vote)
-{
-    struct mixer *hwMixer;
-    struct mixer_ctl *ctl;
-
-    if (0 == rm->getHwAudioMixer(&hwMixer)) {
-        ctl = mixer_get_ctl_by_name(hwMixer, "PM_QOS Vote");
-        if (!ctl) {
-            PAL_ERR(LOG_TAG, "Invalid mixer control: %s\n",
-                                               "PM_QOS Vote");
-        } else {
-            if (vote == PM_QOS_VOTE_DISABLE) {
-                mixer_ctl_set_enum_by_string(ctl, "Disable");
-                PAL_DBG(LOG_TAG,"mixer control disabled for PM_QOS Vote \n");
-            } else if (vote == PM_QOS_VOTE_ENABLE) {
-                mixer_ctl_set_enum_by_string(ctl, "Enable");
-                PAL_DBG(LOG_TAG,"mixer control enabled for PM_QOS Vote \n");
-            }
-        }
-    }
-    else
-        PAL_ERR(LOG_TAG,"could not get hwMixer, not setting mixer control for PM_QOS \n");
-}
-
 Session* Session::makeSession(const std::shared_ptr<ResourceManager>& rm, const struct pal_stream_attributes *sAttr)
 {
     if (!rm || !sAttr) {
@@ -294,6 +270,20 @@ exit:
     return status;
 }
 
+int Session::writev(Stream *s, int tag, struct pal_buffer *bufs, uint32_t count,
+                    int *sizes, uint32_t *done, int flag)
+{
+    int status = 0;
+
+    for (*done = 0; *done < count; (*done)++) {
+        status = write(s, tag, &bufs[*done], &sizes[*done], flag);
+        if (status)
+            break;
+    }
+
+    return status;
+}
+
 int Session::getEffectParameters(Stream *s __unused, effect_pal_payload_t *effectPayload)
 {
     int status = 0;
@@ -620,6 +610,33 @@ int Session::updateCustomPayload(void *payload, size_t size)
     return 0;
 }
 
+/*
+ * Starts a batch of params to be sent with one sendParamBatch(). Batches
+ * are only started where no params should be queued in customPayload;
+ * anything left there is stale and is dropped rather than merged.
+ */
+void Session::beginParamBatch()
+{
+    paramBatch.reset();
+    if (customPayload) {
+        PAL_DBG(LOG_TAG, "drop %zu bytes of stale custom payload", customPayloadSize);
+        freeCustomPayload();
+    }
+}
+
+/* sends the params appended since beginParamBatch() with a single mixer set */
+int Session::sendParamBatch(int device)
+{
+    int status = 0;
+
+    if (!paramBatch.empty())
+        status = SessionAlsaUtils::setMixerParameter(mixer, device,
+                                                     paramBatch.data(),
+                                                     paramBatch.size());
+    paramBatch.reset();
+    return status;
+}
+
 int Session::getCustomPayload(uint8_t **payload, size_t *payloadSize)
 {
     if (customPayloadSize) {
@@ -667,8 +684,6 @@ int Session::handleDeviceRotation(Stream *s, pal_speaker_rotation_type rotation_
     struct pal_stream_attributes sAttr;
     struct pal_device dAttr;
     uint32_t miid = 0;
-    uint8_t* alsaParamData = NULL;
-    size_t alsaPayloadSize = 0;
     int mfc_tag = TAG_MFC_SPEAKER_SWAP;
     std::vector<std::shared_ptr<Device>> associatedDevices;
     status = s->getStreamAttributes(&sAttr);
@@ -714,24 +729,15 @@ int Session::handleDeviceRotation(Stream *s, pal_speaker_rotation_type rotation_
                     if (rm->activeGroupDevConfig->devpp_mfc_cfg.channels)
                         dAttr.config.ch_info.channels =rm->activeGroupDevConfig->devpp_mfc_cfg.channels;
                 }
-                builder->payloadMFCMixerCoeff((uint8_t **)&alsaParamData,
-                                            &alsaPayloadSize, miid,
+                /* goes out with the params a start in progress has batched */
+                status = builder->payloadMFCMixerCoeff(paramBatch, miid,
                                             dAttr.config.ch_info.channels,
                                             rotation_type);
-
-                if (alsaPayloadSize) {
-                    status = updateCustomPayload(alsaParamData, alsaPayloadSize);
-                    freeCustomPayload(&alsaParamData, &alsaPayloadSize);
-                    if (0 != status) {
-                        PAL_ERR(LOG_TAG, "updateCustomPayload Failed\n");
-                        return status;
-                    }
+                if (0 != status) {
+                    PAL_ERR(LOG_TAG, "payloadMFCMixerCoeff Failed\n");
+                    return status;
                 }
-                status = SessionAlsaUtils::setMixerParameter(mixer,
-                                                             device,
-                                                             customPayload,
-                                                             customPayloadSize);
-                freeCustomPayload();
+                status = sendParamBatch(device);
                 if (status != 0) {
                     PAL_ERR(LOG_TAG, "setMixerParameter failed");
                     return status;
@@ -830,22 +836,37 @@ exit:
 }
 
 /* This is to set devicePP MFC(if exists) and PSPD MFC and stream MFC*/
+/* Leaves the devicePP, stream and PSPD MFC params of the device in customPayload */
 int Session::configureMFC(const std::shared_ptr<ResourceManager>& rm, struct pal_stream_attributes &sAttr,
             struct pal_device &dAttr, const std::vector<int> &pcmDevIds, const char* intf)
 {
     int status = 0;
+
+    // clear any cached custom payload
+    freeCustomPayload();
+    paramBatch.reset();
+
+    status = appendMFCConfig(rm, sAttr, dAttr, pcmDevIds, intf, paramBatch);
+    if (0 == status && !paramBatch.empty())
+        customPayload = paramBatch.release(&customPayloadSize);
+    paramBatch.reset();
+
+    return status;
+}
+
+/* Appends the devicePP, stream and PSPD MFC params of the device to batch */
+int Session::appendMFCConfig(const std::shared_ptr<ResourceManager>& rm,
+            struct pal_stream_attributes &sAttr, struct pal_device &dAttr,
+            const std::vector<int> &pcmDevIds, const char* intf, ParamBatch &batch)
+{
+    int status = 0;
     std::shared_ptr<Device> dev = nullptr;
-    uint8_t* payload = NULL;
-    size_t payloadSize = 0;
     struct pal_media_config codecConfig;
     struct sessionToPayloadParam mfcData;
     PayloadBuilder* builder = new PayloadBuilder();
     uint32_t miid = 0;
     bool devicePPMFCSet =  true;
 
-    // clear any cached custom payload
-    freeCustomPayload();
-
     /* Prepare devicePP MFC payload */
     /* Try to set devicePP MFC for virtual port enabled device to match to DMA config */
     if (rm->activeGroupDevConfig &&
@@ -872,16 +893,9 @@ int Session::configureMFC(const std::shared_ptr<ResourceManager>& rm, struct pal
                 mfcData.numChannel = dAttr.config.ch_info.channels;
             mfcData.ch_info = nullptr;
 
-            builder->payloadMFCConfig((uint8_t**)&payload, &payloadSize, miid, &mfcData);
-            if (!payloadSize) {
-                PAL_ERR(LOG_TAG, "payloadMFCConfig failed\n");
-                status = -EINVAL;
-                goto exit;
-            }
-            status = updateCustomPayload(payload, payloadSize);
-            freeCustomPayload(&payload, &payloadSize);
+            status = builder->payloadMFCConfig(batch, miid, &mfcData);
             if (0 != status) {
-                PAL_ERR(LOG_TAG, "updateCustomPayload Failed\n");
+                PAL_ERR(LOG_TAG, "payloadMFCConfig failed\n");
                 goto exit;
             }
         } else {
@@ -911,14 +925,10 @@ int Session::configureMFC(const std::shared_ptr<ResourceManager>& rm, struct pal
             mfcData.sampleRate = sAttr.in_media_config.sample_rate;
             mfcData.numChannel = sAttr.in_media_config.ch_info.channels;
             mfcData.ch_info = nullptr;
-            builder->payloadMFCConfig((uint8_t **)&payload, &payloadSize, miid, &mfcData);
-            if (payloadSize && payload) {
-                status = updateCustomPayload(payload, payloadSize);
-                freeCustomPayload(&payload, &payloadSize);
-                if (0 != status) {
-                    PAL_ERR(LOG_TAG, "updateCustomPayload failed\n");
-                    goto exit;
-                }
+            status = builder->payloadMFCConfig(batch, miid, &mfcData);
+            if (0 != status) {
+                PAL_ERR(LOG_TAG, "payloadMFCConfig failed\n");
+                goto exit;
             }
         }
     }
@@ -968,17 +978,9 @@ int Session::configureMFC(const std::shared_ptr<ResourceManager>& rm, struct pal
             dAttr.id == PAL_DEVICE_OUT_HDMI)
             mfcData.ch_info = &dAttr.config.ch_info;
 
-        builder->payloadMFCConfig((uint8_t **)&payload, &payloadSize, miid, &mfcData);
-        if (!payloadSize) {
-            PAL_ERR(LOG_TAG, "payloadMFCConfig failed\n");
-            status = -EINVAL;
-            goto exit;
-        }
-
-        status = updateCustomPayload(payload, payloadSize);
-        freeCustomPayload(&payload, &payloadSize);
+        status = builder->payloadMFCConfig(batch, miid, &mfcData);
         if (0 != status) {
-            PAL_ERR(LOG_TAG, "updateCustomPayload Failed\n");
+            PAL_ERR(LOG_TAG, "payloadMFCConfig failed\n");
             goto exit;
         }
     } else {
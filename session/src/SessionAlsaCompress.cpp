@@ -1458,8 +1458,6 @@ int SessionAlsaCompress::start(Stream * s)
 
                 if (PAL_DEVICE_OUT_SPEAKER == dAttr.id && !strcmp(dAttr.custom_config.custom_key, "mspp")) {
 
-                    uint8_t* payload = NULL;
-                    size_t payloadSize = 0;
                     uint32_t miid;
                     int32_t volStatus;
                     volStatus = SessionAlsaUtils::getModuleInstanceId(mixer, compressDevIds.at(0),
@@ -1469,24 +1467,12 @@ int SessionAlsaCompress::start(Stream * s)
                         break;
                     }
 
-                    builder->payloadMSPPConfig(&payload, &payloadSize, miid, rm->linear_gain.gain);
-                    if (payloadSize && payload) {
-                        volStatus = updateCustomPayload(payload, payloadSize);
-                        free(payload);
-                        if (0 != volStatus) {
-                            PAL_ERR(LOG_TAG,"updateCustomPayload Failed\n");
-                            break;
-                        }
-                    }
-                    volStatus = SessionAlsaUtils::setMixerParameter(mixer, compressDevIds.at(0),
-                                                                 customPayload, customPayloadSize);
-                    if (customPayload) {
-                        free(customPayload);
-                        customPayload = NULL;
-                        customPayloadSize = 0;
-                    }
-                    if (volStatus != 0) {
-                        PAL_ERR(LOG_TAG,"setMixerParameter failed for MSPP module");
+                    /* MSPP gain and soft pause delay go with one set */
+                    beginParamBatch();
+                    volStatus = builder->payloadMSPPConfig(paramBatch, miid,
+                                                           rm->linear_gain.gain);
+                    if (0 != volStatus) {
+                        PAL_ERR(LOG_TAG,"payloadMSPPConfig Failed\n");
                         break;
                     }
 
@@ -1495,27 +1481,17 @@ int SessionAlsaCompress::start(Stream * s)
                                                                     rxAifBackEnds[0].second.data(), TAG_PAUSE, &miid);
                     if (status != 0) {
                         PAL_ERR(LOG_TAG,"get Soft Pause ModuleInstanceId failed");
+                        sendParamBatch(compressDevIds.at(0));
                         break;
                     }
 
-                    builder->payloadSoftPauseConfig(&payload, &payloadSize, miid, MSPP_SOFT_PAUSE_DELAY);
-                    if (payloadSize && payload) {
-                        status = updateCustomPayload(payload, payloadSize);
-                        free(payload);
-                        if (0 != status) {
-                            PAL_ERR(LOG_TAG,"updateCustomPayload Failed\n");
-                            break;
-                        }
-                    }
-                    status = SessionAlsaUtils::setMixerParameter(mixer, compressDevIds.at(0),
-                                                                 customPayload, customPayloadSize);
-                    if (customPayload) {
-                        free(customPayload);
-                        customPayload = NULL;
-                        customPayloadSize = 0;
-                    }
+                    status = builder->payloadSoftPauseConfig(paramBatch, miid,
+                                                             MSPP_SOFT_PAUSE_DELAY);
+                    if (0 != status)
+                        PAL_ERR(LOG_TAG,"payloadSoftPauseConfig Failed\n");
+                    status = sendParamBatch(compressDevIds.at(0));
                     if (status != 0) {
-                        PAL_ERR(LOG_TAG,"setMixerParameter failed for soft Pause module");
+                        PAL_ERR(LOG_TAG,"setMixerParameter failed for MSPP module");
                         break;
                     }
                 }
@@ -2182,19 +2158,19 @@ int SessionAlsaCompress::setParameters(Stream *s __unused, int tagId, uint32_t p
                 goto exit;
             }
 
+            paramBatch.reset();
             if (vdata->no_of_volpair == 2 && sAttr.out_media_config.ch_info.channels == 2) {
-                builder->payloadMultichVolumemConfig(&alsaParamData, &alsaPayloadSize, miid, vdata);
+                status = builder->payloadMultichVolumemConfig(paramBatch, miid, vdata);
             } else {
-                builder->payloadVolumeConfig(&alsaParamData, &alsaPayloadSize, miid, vdata);
+                status = builder->payloadVolumeConfig(paramBatch, miid, vdata);
             }
 
-            if (alsaPayloadSize) {
+            if (0 == status) {
                 status = SessionAlsaUtils::setMixerParameter(mixer, device,
-                                               alsaParamData, alsaPayloadSize);
+                                               paramBatch.data(), paramBatch.size());
                 PAL_INFO(LOG_TAG, "mixer set volume config status=%d\n", status);
-                freeCustomPayload(&alsaParamData, &alsaPayloadSize);
-                alsaPayloadSize = 0;
             }
+            paramBatch.reset();
         }
         break;
         case PAL_PARAM_ID_MSPP_LINEAR_GAIN:
@@ -2216,12 +2192,10 @@ int SessionAlsaCompress::setParameters(Stream *s __unused, int tagId, uint32_t p
                 return status;
             }
 
-            builder->payloadMSPPConfig(&alsaParamData, &alsaPayloadSize, miid, linear_gain->gain);
-            if (alsaPayloadSize) {
-                status = SessionAlsaUtils::setMixerParameter(mixer, device,
-                                               alsaParamData, alsaPayloadSize);
+            beginParamBatch();
+            if (0 == builder->payloadMSPPConfig(paramBatch, miid, linear_gain->gain)) {
+                status = sendParamBatch(device);
                 PAL_INFO(LOG_TAG, "mixer set MSPP config status=%d\n", status);
-                free(alsaParamData);
             }
             return 0;
         }
@@ -2238,13 +2212,11 @@ int SessionAlsaCompress::setParameters(Stream *s __unused, int tagId, uint32_t p
             struct pal_vol_ctrl_ramp_param *rampParam = (struct pal_vol_ctrl_ramp_param *)payload;
             status = SessionAlsaUtils::getModuleInstanceId(mixer, device,
                                rxAifBackEnds[0].second.data(), tagId, &miid);
-            builder->payloadVolumeCtrlRamp(&alsaParamData, &alsaPayloadSize,
-                 miid, rampParam->ramp_period_ms);
-            if (alsaPayloadSize) {
-                status = SessionAlsaUtils::setMixerParameter(mixer, device,
-                                               alsaParamData, alsaPayloadSize);
+            beginParamBatch();
+            if (0 == builder->payloadVolumeCtrlRamp(paramBatch, miid,
+                                                    rampParam->ramp_period_ms)) {
+                status = sendParamBatch(device);
                 PAL_INFO(LOG_TAG, "mixer set vol ctrl ramp status=%d\n", status);
-                freeCustomPayload(&alsaParamData, &alsaPayloadSize);
             }
             break;
         }
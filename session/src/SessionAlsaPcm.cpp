@@ -67,11 +67,14 @@
 #include "SessionAlsaPcm.h"
 #include "SessionAlsaUtils.h"
 #include "Stream.h"
+#include "StreamUltraSound.h"
 #include "ResourceManager.h"
+#include "StreamGraphPool.h"
 #include "detection_cmn_api.h"
 #include "acd_api.h"
 #include <agm/agm_api.h>
 #include <asps/asps_acm_api.h>
+#include <chrono>
 #include <sstream>
 #include <string>
 #include "audio_dam_buffer_api.h"
@@ -80,9 +83,7 @@
 #include "us_detect_api.h"
 #include "us_gen_api.h"
 #include <sys/ioctl.h>
-
-std::mutex SessionAlsaPcm::pcmLpmRefCntMtx;
-int SessionAlsaPcm::pcmLpmRefCnt = 0;
+#include <unistd.h>
 
 #define SESSION_ALSA_MMAP_DEFAULT_OUTPUT_SAMPLING_RATE (48000)
 #define SESSION_ALSA_MMAP_PERIOD_SIZE (SESSION_ALSA_MMAP_DEFAULT_OUTPUT_SAMPLING_RATE/1000)
@@ -90,7 +91,18 @@ int SessionAlsaPcm::pcmLpmRefCnt = 0;
 #define SESSION_ALSA_MMAP_PERIOD_COUNT_MAX 2048
 #define SESSION_ALSA_MMAP_PERIOD_COUNT_DEFAULT (SESSION_ALSA_MMAP_PERIOD_COUNT_MAX)
 
+static const struct pcm_io_ops alsaIoOps = {
+    [](struct pcm *pcm, int timeoutMs) { return pcm_wait(pcm, timeoutMs); },
+    [](struct pcm *pcm, void *data, unsigned int count) {
+        return pcm_read(pcm, data, count);
+    },
+    [](struct pcm *pcm, const void *data, unsigned int count) {
+        return pcm_write(pcm, data, count);
+    },
+};
+
 SessionAlsaPcm::SessionAlsaPcm(std::shared_ptr<ResourceManager> Rm)
+    : nbIo(&alsaIoOps)
 {
    rm = Rm;
    builder = new PayloadBuilder();
@@ -104,11 +116,17 @@ SessionAlsaPcm::SessionAlsaPcm(std::shared_ptr<ResourceManager> Rm)
    mState = SESSION_IDLE;
    ecRefDevId = PAL_DEVICE_OUT_MIN;
    streamHandle = NULL;
+   warmGraphReused = false;
+   graphReconfigured = false;
+   warmPcm = NULL;
+   memset(&warmConfig, 0, sizeof(warmConfig));
+   nonBlocking = false;
 }
 
 SessionAlsaPcm::~SessionAlsaPcm()
 {
    delete builder;
+   nbIo.stop();
 
 }
 
@@ -125,6 +143,7 @@ int SessionAlsaPcm::open(Stream * s)
     std::vector<std::shared_ptr<Device>> associatedDevices;
     int ldir = 0;
     std::vector<int> pcmId;
+    std::chrono::steady_clock::time_point openBegin;
 
     PAL_DBG(LOG_TAG, "Enter");
     status = s->getStreamAttributes(&sAttr);
@@ -133,6 +152,15 @@ int SessionAlsaPcm::open(Stream * s)
         PAL_ERR(LOG_TAG, "getStreamAttributes Failed \n");
         goto exit;
     }
+    nonBlocking = (sAttr.flags & PAL_STREAM_FLAG_NON_BLOCKING_MASK) &&
+                  !SessionAlsaUtils::isMmapUsecase(sAttr) &&
+                  (sAttr.direction == PAL_AUDIO_INPUT ||
+                   sAttr.direction == PAL_AUDIO_OUTPUT);
+    if (nonBlocking) {
+        status = nbIo.init();
+        if (status)
+            goto exit;
+    }
     if (sAttr.type != PAL_STREAM_VOICE_CALL_RECORD &&
         sAttr.type != PAL_STREAM_VOICE_CALL_MUSIC  &&
         sAttr.type != PAL_STREAM_CONTEXT_PROXY) {
@@ -155,12 +183,20 @@ int SessionAlsaPcm::open(Stream * s)
         PAL_ERR(LOG_TAG, "mixer error");
         goto exit;
     }
-    if (sAttr.direction == PAL_AUDIO_INPUT) {
+
+    warmGraphReused = takeWarmGraph(s, sAttr);
+    openBegin = std::chrono::steady_clock::now();
+    if (warmGraphReused) {
+        /* front end comes with the graph taken from the pool */
+    } else if (sAttr.direction == PAL_AUDIO_INPUT) {
         if (sAttr.type == PAL_STREAM_ACD ||
             sAttr.type == PAL_STREAM_SENSOR_PCM_DATA)
             ldir = TX_HOSTLESS;
 
         pcmDevIds = rm->allocateFrontEndIds(sAttr, ldir);
+        if (pcmDevIds.size() == 0 &&
+            StreamGraphPool::getInstance()->invalidate("front end shortage"))
+            pcmDevIds = rm->allocateFrontEndIds(sAttr, ldir);
         if (pcmDevIds.size() == 0) {
             PAL_ERR(LOG_TAG, "allocateFrontEndIds failed");
             status = -EINVAL;
@@ -168,6 +204,9 @@ int SessionAlsaPcm::open(Stream * s)
         }
     } else if (sAttr.direction == PAL_AUDIO_OUTPUT) {
         pcmDevIds = rm->allocateFrontEndIds(sAttr, 0);
+        if (pcmDevIds.size() == 0 &&
+            StreamGraphPool::getInstance()->invalidate("front end shortage"))
+            pcmDevIds = rm->allocateFrontEndIds(sAttr, 0);
         if (pcmDevIds.size() == 0) {
             PAL_ERR(LOG_TAG, "allocateFrontEndIds failed");
             status = -EINVAL;
@@ -209,7 +248,8 @@ int SessionAlsaPcm::open(Stream * s)
     frontEndIdAllocated = true;
     switch (sAttr.direction) {
         case PAL_AUDIO_INPUT:
-            status = SessionAlsaUtils::open(s, rm, pcmDevIds, txAifBackEnds);
+            if (!warmGraphReused)
+                status = SessionAlsaUtils::open(s, rm, pcmDevIds, txAifBackEnds);
             if (status) {
                 PAL_ERR(LOG_TAG, "session alsa open failed with %d", status);
                 rm->freeFrontEndIds(pcmDevIds, sAttr, ldir);
@@ -217,7 +257,8 @@ int SessionAlsaPcm::open(Stream * s)
             }
             break;
         case PAL_AUDIO_OUTPUT:
-            status = SessionAlsaUtils::open(s, rm, pcmDevIds, rxAifBackEnds);
+            if (!warmGraphReused)
+                status = SessionAlsaUtils::open(s, rm, pcmDevIds, rxAifBackEnds);
             if (status) {
                 PAL_ERR(LOG_TAG, "session alsa open failed with %d", status);
                 rm->freeFrontEndIds(pcmDevIds, sAttr, 0);
@@ -280,6 +321,11 @@ int SessionAlsaPcm::open(Stream * s)
     if (status)
         goto exit;
 
+    if (!warmGraphReused && !warmGraphKey.empty())
+        StreamGraphPool::getInstance()->recordColdOpen(sAttr.type,
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - openBegin).count());
+
     if (sAttr.type == PAL_STREAM_VOICE_UI ||
         sAttr.type == PAL_STREAM_ACD ||
         sAttr.type == PAL_STREAM_CONTEXT_PROXY ||
@@ -319,6 +365,9 @@ int SessionAlsaPcm::setConfig(Stream * s, configType type, uint32_t tag1,
     struct mixer_ctl *ctl = nullptr;
     uint32_t tkv_size = 0;
     PAL_DBG(LOG_TAG, "Enter tags: %d %d %d", tag1, tag2, tag3);
+
+    graphReconfigured = true;
+
     switch (type) {
         case MODULE:
             tkv.clear();
@@ -519,6 +568,8 @@ int SessionAlsaPcm::setConfig(Stream * s, configType type, int tag)
     int tag_config_size = 0;
     int cal_config_size = 0;
 
+    graphReconfigured = true;
+
     status = s->getStreamAttributes(&sAttr);
     if (status != 0) {
         PAL_ERR(LOG_TAG, "stream get attributes failed");
@@ -700,6 +751,8 @@ int SessionAlsaPcm::setTKV(Stream * s, configType type, effect_pal_payload_t *ef
     int tkv_size = 0;
     pal_stream_attributes sAttr;
 
+    graphReconfigured = true;
+
     status = s->getStreamAttributes(&sAttr);
     if (status != 0) {
         PAL_ERR(LOG_TAG, "stream get attributes failed");
@@ -786,6 +839,7 @@ exit:
 
 void SessionAlsaPcm::deRegisterAdmStream(Stream *s)
 {
+    rm->loadAdmLib();
     if (rm->admDeregisterStreamFn)
         rm->admDeregisterStreamFn(rm->admData, static_cast<void *>(s));
 }
@@ -793,6 +847,8 @@ void SessionAlsaPcm::deRegisterAdmStream(Stream *s)
 void SessionAlsaPcm::registerAdmStream(Stream *s, pal_stream_direction_t dir,
         pal_stream_flags_t flags, struct pcm *pcm, struct pcm_config *cfg)
 {
+    /* ADM is optional, its library is loaded by the first stream */
+    rm->loadAdmLib();
     switch (dir) {
     case PAL_AUDIO_INPUT:
         if (rm->admRegisterInputStreamFn) {
@@ -823,6 +879,7 @@ void SessionAlsaPcm::registerAdmStream(Stream *s, pal_stream_direction_t dir,
 
 void SessionAlsaPcm::requestAdmFocus(Stream *s,  long ns)
 {
+    rm->loadAdmLib();
     if (rm->admRequestFocusV2Fn)
         rm->admRequestFocusV2Fn(rm->admData, static_cast<void *>(s),
                 ns);
@@ -832,12 +889,14 @@ void SessionAlsaPcm::requestAdmFocus(Stream *s,  long ns)
 
 void SessionAlsaPcm::AdmRoutingChange(Stream *s)
 {
+    rm->loadAdmLib();
     if (rm->admOnRoutingChangeFn)
         rm->admOnRoutingChangeFn(rm->admData, static_cast<void *>(s));
 }
 
 void SessionAlsaPcm::releaseAdmFocus(Stream *s)
 {
+    rm->loadAdmLib();
     if (rm->admAbandonFocusFn)
         rm->admAbandonFocusFn(rm->admData, static_cast<void *>(s));
 }
@@ -851,8 +910,6 @@ int SessionAlsaPcm::start(Stream * s)
     struct pal_device dAttr = {};
     struct pal_media_config codecConfig = {};
     struct sessionToPayloadParam streamData = {};
-    uint8_t* payload = NULL;
-    size_t payloadSize = 0;
     uint32_t miid;
     int payload_size = 0;
     struct agm_event_reg_cfg event_cfg = {};
@@ -864,6 +921,8 @@ int SessionAlsaPcm::start(Stream * s)
     struct volume_set_param_info vol_set_param_info = {};
     uint16_t volSize = 0;
     uint8_t *volPayload = nullptr;
+    std::chrono::steady_clock::time_point prepareBegin;
+    bool pcmReused = false;
 
     PAL_DBG(LOG_TAG, "Enter");
 
@@ -899,6 +958,13 @@ int SessionAlsaPcm::start(Stream * s)
         config.start_threshold = 0;
         config.stop_threshold = 0;
         config.silence_threshold = 0;
+        /* poll only reports a non-blocking pcm ready for a whole period */
+        if (nonBlocking)
+            config.avail_min = config.period_size;
+        prepareBegin = std::chrono::steady_clock::now();
+        if (warmPcm)
+            pcm = adoptWarmPcm(sAttr, &config);
+        pcmReused = (pcm != NULL);
         switch(sAttr.direction) {
             case PAL_AUDIO_INPUT:
                 if (pcmDevIds.size() == 0) {
@@ -906,7 +972,9 @@ int SessionAlsaPcm::start(Stream * s)
                     status = -EINVAL;
                     goto exit;
                 }
-                if(SessionAlsaUtils::isMmapUsecase(sAttr)) {
+                if (pcm) {
+                    PAL_DBG(LOG_TAG, "reuse prepared pcm of warm graph");
+                } else if(SessionAlsaUtils::isMmapUsecase(sAttr)) {
                     config.start_threshold = 0;
                     config.stop_threshold = INT32_MAX;
                     config.silence_threshold = 0;
@@ -936,7 +1004,9 @@ int SessionAlsaPcm::start(Stream * s)
                     status = -EINVAL;
                     goto exit;
                 }
-                if(SessionAlsaUtils::isMmapUsecase(sAttr)) {
+                if (pcm) {
+                    PAL_DBG(LOG_TAG, "reuse prepared pcm of warm graph");
+                } else if(SessionAlsaUtils::isMmapUsecase(sAttr)) {
                     config.start_threshold = config.period_size * 8;
                     config.stop_threshold = INT32_MAX;
                     config.silence_threshold = 0;
@@ -996,6 +1066,14 @@ int SessionAlsaPcm::start(Stream * s)
                 goto exit;
         }
         mState = SESSION_OPENED;
+        if (!warmGraphKey.empty()) {
+            if (!pcmReused)
+                StreamGraphPool::getInstance()->recordColdPrepare(sAttr.type,
+                    std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - prepareBegin).count());
+            /* parked along with the pcm on close */
+            warmConfig = config;
+        }
 
         if (SessionAlsaUtils::isMmapUsecase(sAttr) &&
                 !(sAttr.flags & PAL_STREAM_FLAG_MMAP_NO_IRQ_MASK))
@@ -1089,14 +1167,11 @@ int SessionAlsaPcm::start(Stream * s)
                 streamData.sampleRate = sAttr.in_media_config.sample_rate;
                 streamData.numChannel = sAttr.in_media_config.ch_info.channels;
                 streamData.ch_info = nullptr;
-                builder->payloadMFCConfig(&payload, &payloadSize, miid, &streamData);
-                if (payloadSize && payload) {
-                    status = updateCustomPayload(payload, payloadSize);
-                    freeCustomPayload(&payload, &payloadSize);
-                    if (0 != status) {
-                        PAL_ERR(LOG_TAG, "updateCustomPayload Failed\n");
-                        goto exit;
-                    }
+                beginParamBatch();
+                status = builder->payloadMFCConfig(paramBatch, miid, &streamData);
+                if (0 != status) {
+                    PAL_ERR(LOG_TAG, "payloadMFCConfig Failed\n");
+                    goto exit;
                 }
 
                 if (sAttr.type == PAL_STREAM_VOIP_TX) {
@@ -1143,26 +1218,14 @@ int SessionAlsaPcm::start(Stream * s)
                             streamData.bitWidth   = AUDIO_BIT_WIDTH_DEFAULT_16;
                             streamData.numChannel = 0xFFFF;
                         }
-                        builder->payloadMFCConfig(&payload, &payloadSize, miid, &streamData);
-                        if (payloadSize && payload) {
-                            status = updateCustomPayload(payload, payloadSize);
-                            freeCustomPayload(&payload, &payloadSize);
-                            if (0 != status) {
-                                PAL_ERR(LOG_TAG,"updateCustomPayload Failed\n");
-                                goto set_mixer;
-                            }
+                        status = builder->payloadMFCConfig(paramBatch, miid, &streamData);
+                        if (0 != status) {
+                            PAL_ERR(LOG_TAG,"payloadMFCConfig Failed\n");
+                            goto set_mixer;
                         }
                     }
                 }
 
-set_mixer:
-                status = SessionAlsaUtils::setMixerParameter(mixer, pcmDevIds.at(0),
-                                                             customPayload, customPayloadSize);
-                freeCustomPayload();
-                if (status != 0) {
-                    PAL_ERR(LOG_TAG, "setMixerParameter failed");
-                    goto exit;
-                }
                 if (sAttr.type == PAL_STREAM_VOICE_CALL_RECORD) {
                     status = SessionAlsaUtils::getModuleInstanceId(mixer, pcmDevIds.at(0),
                                                                 "ZERO", RAT_RENDER, &miid);
@@ -1187,22 +1250,21 @@ set_mixer:
                          */
                         codecConfig.ch_info.channels = 1;
                     }
-                    builder->payloadRATConfig(&payload, &payloadSize, miid, &codecConfig);
-                    if (payloadSize && payload) {
-                        status = updateCustomPayload(payload, payloadSize);
-                        freeCustomPayload(&payload, &payloadSize);
-                        if (0 != status) {
-                            PAL_ERR(LOG_TAG, "updateCustomPayload Failed\n");
-                            goto exit;
-                        }
-                    }
-                    status = SessionAlsaUtils::setMixerParameter(mixer, pcmDevIds.at(0),
-                                                                 customPayload, customPayloadSize);
-                    freeCustomPayload();
-                    if (status != 0) {
-                        PAL_ERR(LOG_TAG, "setMixerParameter failed for RAT render");
+                    status = builder->payloadRATConfig(paramBatch, miid, &codecConfig);
+                    if (0 != status) {
+                        PAL_ERR(LOG_TAG, "payloadRATConfig Failed\n");
                         goto exit;
                     }
+                }
+
+set_mixer:
+                /* stream MFC, EC MFC and RAT render params in one set */
+                status = sendParamBatch(pcmDevIds.at(0));
+                if (status != 0) {
+                    PAL_ERR(LOG_TAG, "setMixerParameter failed");
+                    goto exit;
+                }
+                if (sAttr.type == PAL_STREAM_VOICE_CALL_RECORD) {
                     switch (sAttr.info.voice_rec_info.record_direction) {
                         case INCALL_RECORD_VOICE_UPLINK:
                             tagId = INCALL_RECORD_UPLINK;
@@ -1266,18 +1328,13 @@ set_mixer:
                 streamData.sampleRate = sAttr.in_media_config.sample_rate;
                 streamData.numChannel = sAttr.in_media_config.ch_info.channels;
                 streamData.ch_info = nullptr;
-                builder->payloadMFCConfig(&payload, &payloadSize, miid, &streamData);
-                if (payloadSize && payload) {
-                    status = updateCustomPayload(payload, payloadSize);
-                    freeCustomPayload(&payload, &payloadSize);
-                    if (0 != status) {
-                        PAL_ERR(LOG_TAG, "updateCustomPayload Failed\n");
-                        goto exit;
-                    }
+                beginParamBatch();
+                status = builder->payloadMFCConfig(paramBatch, miid, &streamData);
+                if (0 != status) {
+                    PAL_ERR(LOG_TAG, "payloadMFCConfig Failed\n");
+                    goto exit;
                 }
-                status = SessionAlsaUtils::setMixerParameter(mixer, pcmDevIds.at(0),
-                                                         customPayload, customPayloadSize);
-                freeCustomPayload();
+                status = sendParamBatch(pcmDevIds.at(0));
                 if (status != 0) {
                     PAL_ERR(LOG_TAG, "setMixerParameter failed");
                     goto exit;
@@ -1288,7 +1345,7 @@ set_mixer:
 
                 status = rm->getAudioRoute(&audioRoute);
                 if (!status)
-                    audio_route_apply_and_update_path(audioRoute, "lpi-pcm-logging");
+                    enableDevice(audioRoute, "lpi-pcm-logging");
                 PAL_INFO(LOG_TAG, "LPI data logging Param ON");
                 /* No error check as TAG/TKV may not required for non LPI usecases */
                 setConfig(s, MODULE, LPI_LOGGING_ON);
@@ -1303,6 +1360,8 @@ set_mixer:
             }
             break;
         case PAL_AUDIO_OUTPUT:
+            /* params of all modules below are sent with one set at pcm_start */
+            beginParamBatch();
             if (sAttr.type == PAL_STREAM_VOICE_CALL_MUSIC) {
                 if (pcmDevIds.size() == 0) {
                     PAL_ERR(LOG_TAG, "frontendIDs is not available.");
@@ -1328,26 +1387,12 @@ set_mixer:
                     goto exit;
                 }
 
-                status = configureMFC(rm, sAttr, dAttr, pcmDevIds,
-                            rxAifBackEnds[i].second.data());
+                status = appendMFCConfig(rm, sAttr, dAttr, pcmDevIds,
+                            rxAifBackEnds[i].second.data(), paramBatch);
                 if (status != 0) {
                     PAL_ERR(LOG_TAG, "configure MFC failed");
                     goto exit;
                 }
-                if (customPayload) {
-                    if (pcmDevIds.size() == 0) {
-                        PAL_ERR(LOG_TAG, "frontendIDs is not available.");
-                        status = -EINVAL;
-                        goto exit;
-                    }
-                    status = SessionAlsaUtils::setMixerParameter(mixer, pcmDevIds.at(0),
-                                                     customPayload, customPayloadSize);
-                    freeCustomPayload();
-                    if (status != 0) {
-                        PAL_ERR(LOG_TAG, "setMixerParameter failed");
-                        goto exit;
-                    }
-                }
                 if ((ResourceManager::isChargeConcurrencyEnabled) &&
                     (dAttr.id == PAL_DEVICE_OUT_SPEAKER)) {
                     status = Session::NotifyChargerConcurrency(rm, true);
@@ -1381,24 +1426,10 @@ set_mixer:
                     }
                     PAL_INFO(LOG_TAG, "miid : %x id = %d\n", miid, pcmDevIds.at(0));
 
-                    builder->payloadMSPPConfig(&payload, &payloadSize, miid, rm->linear_gain.gain);
-                    if (payloadSize && payload) {
-                        status = updateCustomPayload(payload, payloadSize);
-                        free(payload);
-                        if (0 != status) {
-                            PAL_ERR(LOG_TAG,"updateCustomPayload Failed\n");
-                            goto pcm_start;
-                        }
-                    }
-                    status = SessionAlsaUtils::setMixerParameter(mixer, pcmDevIds.at(0),
-                                                                 customPayload, customPayloadSize);
-                    if (customPayload) {
-                        free(customPayload);
-                        customPayload = NULL;
-                        customPayloadSize = 0;
-                    }
-                    if (status != 0) {
-                        PAL_ERR(LOG_TAG,"setMixerParameter failed for MSPP module");
+                    status = builder->payloadMSPPConfig(paramBatch, miid,
+                                                        rm->linear_gain.gain);
+                    if (0 != status) {
+                        PAL_ERR(LOG_TAG,"payloadMSPPConfig Failed\n");
                         goto pcm_start;
                     }
 
@@ -1410,25 +1441,10 @@ set_mixer:
                     }
                     PAL_INFO(LOG_TAG, "miid : %x id = %d\n", miid, pcmDevIds.at(0));
 
-                    builder->payloadSoftPauseConfig(&payload, &payloadSize, miid,
-                                                            MSPP_SOFT_PAUSE_DELAY);
-                    if (payloadSize && payload) {
-                        status = updateCustomPayload(payload, payloadSize);
-                        free(payload);
-                        if (0 != status) {
-                            PAL_ERR(LOG_TAG,"updateCustomPayload Failed\n");
-                            goto pcm_start;
-                        }
-                    }
-                    status = SessionAlsaUtils::setMixerParameter(mixer, pcmDevIds.at(0),
-                                                                 customPayload, customPayloadSize);
-                    if (customPayload) {
-                        free(customPayload);
-                        customPayload = NULL;
-                        customPayloadSize = 0;
-                    }
-                    if (status != 0) {
-                        PAL_ERR(LOG_TAG,"setMixerParameter failed for soft Pause module");
+                    status = builder->payloadSoftPauseConfig(paramBatch, miid,
+                                                             MSPP_SOFT_PAUSE_DELAY);
+                    if (0 != status) {
+                        PAL_ERR(LOG_TAG,"payloadSoftPauseConfig Failed\n");
                         goto pcm_start;
                     }
 
@@ -1495,42 +1511,36 @@ set_mixer:
                         streamData.bitWidth   = AUDIO_BIT_WIDTH_DEFAULT_16;
                         streamData.numChannel = 0xFFFF;
                     }
-                    builder->payloadMFCConfig(&payload, &payloadSize, miid, &streamData);
-                    if (payloadSize && payload) {
-                        status = updateCustomPayload(payload, payloadSize);
-                        freeCustomPayload(&payload, &payloadSize);
-                        if (0 != status) {
-                            PAL_ERR(LOG_TAG,"updateCustomPayload Failed\n");
-                            status = 0;
-                            goto pcm_start;
-                        }
+                    status = builder->payloadMFCConfig(paramBatch, miid, &streamData);
+                    if (0 != status) {
+                        PAL_ERR(LOG_TAG,"payloadMFCConfig Failed\n");
+                        status = 0;
+                        goto pcm_start;
                     }
                 }
-                status = SessionAlsaUtils::setMixerParameter(mixer, pcmDevIds.at(0),
-                                                             customPayload, customPayloadSize);
-                freeCustomPayload();
+            }
+
+pcm_start:
+            /* device MFC, MSPP, soft pause and EC MFC params in one set */
+            if (!paramBatch.empty()) {
+                if (pcmDevIds.size() == 0) {
+                    PAL_ERR(LOG_TAG, "frontendIDs is not available.");
+                    status = -EINVAL;
+                    goto exit;
+                }
+                status = sendParamBatch(pcmDevIds.at(0));
                 if (status != 0) {
                     PAL_ERR(LOG_TAG, "setMixerParameter failed");
-                    status = 0;
-                    goto pcm_start;
+                    goto exit;
                 }
             }
-
-pcm_start:
             memset(&lpm_info, 0, sizeof(struct disable_lpm_info));
             rm->getDisableLpmInfo(&lpm_info);
             isStreamAvail = (find(lpm_info.streams_.begin(),
                             lpm_info.streams_.end(), sAttr.type) !=
                             lpm_info.streams_.end());
-            if (isStreamAvail && lpm_info.isDisableLpm) {
-                std::lock_guard<std::mutex> lock(pcmLpmRefCntMtx);
-                PAL_DBG(LOG_TAG,"pcmLpmRefCnt %d\n", pcmLpmRefCnt);
-                pcmLpmRefCnt++;
-                if (1 == pcmLpmRefCnt)
-                    setPmQosMixerCtl(PM_QOS_VOTE_ENABLE);
-                else
-                    PAL_DBG(LOG_TAG,"pcmLpmRefCnt %d\n", pcmLpmRefCnt);
-            }
+            if (isStreamAvail && lpm_info.isDisableLpm)
+                rm->votePmQos(true);
 
             if (pcm) {
                 status = pcm_start(pcm);
@@ -1580,6 +1590,7 @@ pcm_start:
                 PAL_ERR(LOG_TAG, "getAssociatedDevices Failed");
                 goto exit;
             }
+            beginParamBatch();
             for (int i = 0; i < associatedDevices.size(); i++) {
                 if (!SessionAlsaUtils::isRxDevice(
                             associatedDevices[i]->getSndDeviceId()))
@@ -1590,26 +1601,12 @@ pcm_start:
                     PAL_ERR(LOG_TAG, "get Device Attributes Failed");
                     goto exit;
                 }
-                status = configureMFC(rm, sAttr, dAttr, pcmDevRxIds,
-                            rxAifBackEnds[0].second.data());
+                status = appendMFCConfig(rm, sAttr, dAttr, pcmDevRxIds,
+                            rxAifBackEnds[0].second.data(), paramBatch);
                 if (status != 0) {
                     PAL_ERR(LOG_TAG, "configure MFC failed");
                     goto exit;
                 }
-                if (customPayload) {
-                    if (!pcmDevRxIds.size()) {
-                        PAL_ERR(LOG_TAG, "pcmDevRxIds not found.");
-                        status = -EINVAL;
-                        goto exit;
-                    }
-                    status = SessionAlsaUtils::setMixerParameter(mixer, pcmDevRxIds.at(0),
-                                                             customPayload, customPayloadSize);
-                    freeCustomPayload();
-                    if (status != 0) {
-                        PAL_ERR(LOG_TAG, "setMixerParameter failed");
-                        goto exit;
-                    }
-                }
                 if ((ResourceManager::isChargeConcurrencyEnabled) &&
                     (dAttr.id == PAL_DEVICE_OUT_SPEAKER)) {
                     status = Session::NotifyChargerConcurrency(rm, true);
@@ -1624,6 +1621,19 @@ pcm_start:
                     status = 0;
                 }
             }
+            /* MFC params of all rx devices in one set */
+            if (!paramBatch.empty()) {
+                if (!pcmDevRxIds.size()) {
+                    PAL_ERR(LOG_TAG, "pcmDevRxIds not found.");
+                    status = -EINVAL;
+                    goto exit;
+                }
+                status = sendParamBatch(pcmDevRxIds.at(0));
+                if (status != 0) {
+                    PAL_ERR(LOG_TAG, "setMixerParameter failed");
+                    goto exit;
+                }
+            }
 
             if (pcmRx) {
                 status = pcm_start(pcmRx);
@@ -1690,6 +1700,8 @@ pcm_start:
         }
     }
     mState = SESSION_STARTED;
+    if (nonBlocking)
+        nbIo.start(pcm);
 
 exit:
     if (status != 0)
@@ -1713,6 +1725,7 @@ int SessionAlsaPcm::stop(Stream * s)
         PAL_ERR(LOG_TAG, "stream get attributes failed");
         return status;
     }
+    nbIo.stop();
     switch (sAttr.direction) {
         case PAL_AUDIO_INPUT:
             if (pcm && isActive()) {
@@ -1727,7 +1740,7 @@ int SessionAlsaPcm::stop(Stream * s)
 
                 status = rm->getAudioRoute(&audioRoute);
                 if (!status)
-                    audio_route_reset_and_update_path(audioRoute, "lpi-pcm-logging");
+                    disableDevice(audioRoute, "lpi-pcm-logging");
             }
         break;
         case PAL_AUDIO_OUTPUT:
@@ -1872,6 +1885,7 @@ int SessionAlsaPcm::close(Stream * s)
     std::vector<int> pcmId;
     struct disable_lpm_info lpm_info;
     bool isStreamAvail = false;
+    bool parked = false;
 
     PAL_DBG(LOG_TAG, "Enter");
     if (!frontEndIdAllocated) {
@@ -1895,6 +1909,11 @@ int SessionAlsaPcm::close(Stream * s)
     }
     freeDeviceMetadata.clear();
 
+    parked = parkWarmGraph(sAttr);
+    if (!parked && warmPcm)
+        pcm_close(warmPcm);
+    warmPcm = NULL;
+
     switch (sAttr.direction) {
         case PAL_AUDIO_INPUT:
             for (auto &dev: associatedDevices) {
@@ -1909,14 +1928,15 @@ int SessionAlsaPcm::close(Stream * s)
                     PAL_DBG(LOG_TAG, "Tx dev not active");
                 }
             }
-            status = SessionAlsaUtils::close(s, rm, pcmDevIds, txAifBackEnds, freeDeviceMetadata);
+            if (!parked)
+                status = SessionAlsaUtils::close(s, rm, pcmDevIds, txAifBackEnds, freeDeviceMetadata);
             if (status) {
                 PAL_ERR(LOG_TAG, "session alsa close failed with %d", status);
             }
             if (SessionAlsaUtils::isMmapUsecase(sAttr) &&
                 !(sAttr.flags & PAL_STREAM_FLAG_MMAP_NO_IRQ_MASK))
                 deRegisterAdmStream(s);
-            if (pcm)
+            if (pcm && !parked)
                 status = pcm_close(pcm);
             if (status) {
                 status = errno;
@@ -1926,7 +1946,8 @@ int SessionAlsaPcm::close(Stream * s)
                 sAttr.type == PAL_STREAM_SENSOR_PCM_DATA)
                 ldir = TX_HOSTLESS;
 
-            rm->freeFrontEndIds(pcmDevIds, sAttr, ldir);
+            if (!parked)
+                rm->freeFrontEndIds(pcmDevIds, sAttr, ldir);
             pcm = NULL;
             break;
         case PAL_AUDIO_OUTPUT:
@@ -1942,7 +1963,8 @@ int SessionAlsaPcm::close(Stream * s)
                     freeDeviceMetadata.push_back(std::make_pair(backendname, 1));
                 }
             }
-            status = SessionAlsaUtils::close(s, rm, pcmDevIds, rxAifBackEnds, freeDeviceMetadata);
+            if (!parked)
+                status = SessionAlsaUtils::close(s, rm, pcmDevIds, rxAifBackEnds, freeDeviceMetadata);
             if (status) {
                 PAL_ERR(LOG_TAG, "session alsa close failed with %d", status);
             }
@@ -1955,20 +1977,10 @@ int SessionAlsaPcm::close(Stream * s)
             isStreamAvail = (find(lpm_info.streams_.begin(),
                             lpm_info.streams_.end(), sAttr.type) !=
                             lpm_info.streams_.end());
-            if (isStreamAvail && lpm_info.isDisableLpm) {
-                std::lock_guard<std::mutex> lock(pcmLpmRefCntMtx);
-                PAL_DBG(LOG_TAG, "pcm_close pcmLpmRefCnt %d", pcmLpmRefCnt);
-                pcmLpmRefCnt--;
-                if (pcmLpmRefCnt < 0) { //May not happen, to catch the error, if it happens to be
-                    PAL_ERR(LOG_TAG, "pcm_close Unacceptable pcmLpmRefCnt %d, resetting to 0", pcmLpmRefCnt);
-                    pcmLpmRefCnt = 0;
-                }
-                if (0 == pcmLpmRefCnt)
-                    setPmQosMixerCtl(PM_QOS_VOTE_DISABLE);
-                PAL_DBG(LOG_TAG, "pcm_close pcmLpmRefCnt %d", pcmLpmRefCnt);
-            }
+            if (isStreamAvail && lpm_info.isDisableLpm)
+                rm->votePmQos(false);
 
-            if (pcm)
+            if (pcm && !parked)
                 status = pcm_close(pcm);
             if (status) {
                 status = errno;
@@ -1986,7 +1998,8 @@ int SessionAlsaPcm::close(Stream * s)
                     status = 0;
                 }
             }
-            rm->freeFrontEndIds(pcmDevIds, sAttr, 0);
+            if (!parked)
+                rm->freeFrontEndIds(pcmDevIds, sAttr, 0);
             pcm = NULL;
             break;
         case PAL_AUDIO_INPUT | PAL_AUDIO_OUTPUT:
@@ -2030,6 +2043,9 @@ int SessionAlsaPcm::close(Stream * s)
     }
     frontEndIdAllocated = false;
     mState = SESSION_IDLE;
+    warmGraphKey.clear();
+    warmGraphReused = false;
+    graphReconfigured = false;
 
     if (sAttr.type == PAL_STREAM_VOICE_UI ||
         sAttr.type == PAL_STREAM_ACD ||
@@ -2077,6 +2093,8 @@ int SessionAlsaPcm::disconnectSessionDevice(Stream *streamHandle,
     std::vector<std::pair<int32_t, std::string>> txAifBackEndsToDisconnect;
     int32_t status = 0;
 
+    graphReconfigured = true;
+
     deviceList.push_back(deviceToDisconnect);
     rm->getBackEndNames(deviceList, rxAifBackEndsToDisconnect,
             txAifBackEndsToDisconnect);
@@ -2095,8 +2113,11 @@ int SessionAlsaPcm::disconnectSessionDevice(Stream *streamHandle,
                 if (0 != status) {
                     PAL_ERR(LOG_TAG, "SetParameters failed for Rampdown, status = %d", status);
                 }
-                /* TODO: Need to adjust the delay based on requirement */
-                usleep(20000);
+                /* a muted generator has nothing left to ramp down */
+                if (!static_cast<StreamUltraSound *>(streamHandle)->isGainMuted_l()) {
+                    /* TODO: Need to adjust the delay based on requirement */
+                    usleep(20000);
+                }
             }
             status = SessionAlsaUtils::disconnectSessionDevice(streamHandle, streamType, rm,
                      dAttr, pcmDevTxIds, pcmDevRxIds, rxAifBackEndsToDisconnect);
@@ -2147,6 +2168,8 @@ int SessionAlsaPcm::setupSessionDevice(Stream* streamHandle, pal_stream_type_t s
     int32_t status = 0;
     struct pal_device dAttr1;
 
+    graphReconfigured = true;
+
     deviceList.push_back(deviceToConnect);
     rm->getBackEndNames(deviceList, rxAifBackEndsToConnect,
             txAifBackEndsToConnect);
@@ -2172,6 +2195,8 @@ int SessionAlsaPcm::connectSessionDevice(Stream* streamHandle, pal_stream_type_t
     std::vector<std::pair<int32_t, std::string>> txAifBackEndsToConnect;
     int32_t status = 0;
 
+    graphReconfigured = true;
+
     deviceList.push_back(deviceToConnect);
     rm->getBackEndNames(deviceList, rxAifBackEndsToConnect,
             txAifBackEndsToConnect);
@@ -2226,6 +2251,12 @@ int SessionAlsaPcm::read(Stream *s, int tag __unused, struct pal_buffer *buf, in
         PAL_ERR(LOG_TAG, "stream get attributes failed");
         return status;
     }
+    if (nonBlocking) {
+        status = readNonBlocking(buf, size);
+        if (!status && buf->ts && (sAttr.flags & PAL_STREAM_FLAG_TIMESTAMP))
+            setCaptureTimestamp(buf, sAttr.in_media_config.sample_rate, *size);
+        return status;
+    }
     while (1) {
         offset = bytesRead + buf->offset;
         bytesToRead = buf->size - offset;
@@ -2259,11 +2290,37 @@ int SessionAlsaPcm::read(Stream *s, int tag __unused, struct pal_buffer *buf, in
         bytesRead += pcmReadSize;
     }
 
+    if (!status && buf->ts && (sAttr.flags & PAL_STREAM_FLAG_TIMESTAMP))
+        setCaptureTimestamp(buf, sAttr.in_media_config.sample_rate, bytesRead);
     *size = bytesRead;
     PAL_VERBOSE(LOG_TAG, "exit bytesRead:%d status:%d ", bytesRead, status);
     return status;
 }
 
+/*
+ * Sets buf->ts to the capture time of the first frame just read, from the
+ * last hw pointer update: the frames still available and the frames read
+ * were captured before it. Left untouched if the driver has no timestamp.
+ */
+void SessionAlsaPcm::setCaptureTimestamp(struct pal_buffer *buf, uint32_t sampleRate,
+                                         int bytesRead)
+{
+    struct timespec tstamp;
+    unsigned int avail = 0;
+    uint64_t frames = 0, ns = 0, behindNs = 0;
+
+    if (!pcm || !sampleRate || bytesRead <= 0 ||
+        pcm_get_htimestamp(pcm, &avail, &tstamp) != 0)
+        return;
+
+    frames = (uint64_t)avail + pcm_bytes_to_frames(pcm, bytesRead);
+    behindNs = frames * 1000000000ULL / sampleRate;
+    ns = (uint64_t)tstamp.tv_sec * 1000000000ULL + tstamp.tv_nsec;
+    ns = ns > behindNs ? ns - behindNs : 0;
+    buf->ts->tv_sec = ns / 1000000000ULL;
+    buf->ts->tv_nsec = ns % 1000000000ULL;
+}
+
 int SessionAlsaPcm::write(Stream *s, int tag, struct pal_buffer *buf, int * size,
                           int flag)
 {
@@ -2284,6 +2341,9 @@ int SessionAlsaPcm::write(Stream *s, int tag, struct pal_buffer *buf, int * size
         return -EINVAL;
     }
 
+    if (nonBlocking)
+        return writeNonBlocking(buf, size);
+
     void *data = nullptr;
 
     bytesRemaining = buf->size;
@@ -2360,6 +2420,100 @@ exit:
     return status;
 }
 
+int SessionAlsaPcm::readNonBlocking(struct pal_buffer *buf, int *size)
+{
+    size_t bytesToRead = buf->size > buf->offset ? buf->size - buf->offset : 0;
+
+    return nbIo.read(pcm, buf->buffer + buf->offset, bytesToRead, in_buf_size, size);
+}
+
+int SessionAlsaPcm::writeNonBlocking(struct pal_buffer *buf, int *size)
+{
+    return nbIo.write(pcm, buf->buffer + buf->offset, buf->size, out_buf_size, size);
+}
+
+int SessionAlsaPcm::writev(Stream *s, int tag, struct pal_buffer *bufs, uint32_t count,
+                           int *sizes, uint32_t *done, int flag)
+{
+    int status = 0;
+    size_t frameBytes = 0, staged = 0;
+    uint32_t i = 0, first = 0;
+    bool merge = false;
+    struct pal_stream_attributes sAttr;
+
+    *done = 0;
+    status = s->getStreamAttributes(&sAttr);
+    if (status != 0) {
+        PAL_ERR(LOG_TAG, "stream get attributes failed");
+        return status;
+    }
+
+    if (pcm == NULL) {
+        PAL_ERR(LOG_TAG, "PCM is NULL");
+        return -EINVAL;
+    }
+
+    /* mmap writes request ADM focus per buffer */
+    if (SessionAlsaUtils::isMmapUsecase(sAttr))
+        return Session::writev(s, tag, bufs, count, sizes, done, flag);
+
+    /* the batch ends at the first buffer not taken whole */
+    if (nonBlocking) {
+        while (*done < count) {
+            status = writeNonBlocking(&bufs[*done], &sizes[*done]);
+            if (status != 0)
+                break;
+            (*done)++;
+            if ((size_t)sizes[*done - 1] < bufs[*done - 1].size)
+                break;
+        }
+        return *done ? 0 : status;
+    }
+
+    frameBytes = pcm_frames_to_bytes(pcm, 1);
+    auto mergeable = [&](uint32_t idx) {
+        return idx < count && bufs[idx].size && frameBytes &&
+               !(bufs[idx].size % frameBytes) &&
+               staged + bufs[idx].size <= out_buf_size;
+    };
+
+    while (i < count) {
+        /* a run of small frame aligned buffers is written as one period */
+        staged = 0;
+        merge = mergeable(i);
+        staged = bufs[i].size;
+        if (merge && mergeable(i + 1)) {
+            if (writevBuf.size() < out_buf_size)
+                writevBuf.resize(out_buf_size);
+            first = i;
+            staged = 0;
+            while (mergeable(i)) {
+                memcpy(writevBuf.data() + staged, bufs[i].buffer + bufs[i].offset,
+                       bufs[i].size);
+                staged += bufs[i].size;
+                i++;
+            }
+            PAL_VERBOSE(LOG_TAG, "merged %u buffers, %zu bytes", i - first, staged);
+            status = pcm_write(pcm, writevBuf.data(), staged);
+            if (status != 0) {
+                PAL_ERR(LOG_TAG, "Error! pcm_write failed");
+                break;
+            }
+            for (; first < i; first++)
+                sizes[first] = bufs[first].size;
+            *done = i;
+            continue;
+        }
+
+        status = write(s, tag, &bufs[i], &sizes[i], flag);
+        if (status != 0)
+            break;
+        *done = ++i;
+    }
+
+    return status;
+}
+
 int SessionAlsaPcm::readBufferInit(Stream * /*streamHandle*/, size_t /*noOfBuf*/, size_t /*bufSize*/,
                                    int /*flag*/)
 {
@@ -2399,6 +2553,10 @@ int SessionAlsaPcm::setParameters(Stream *streamHandle, int tagId, uint32_t para
     PAL_DBG(LOG_TAG, "Enter. param id: %d", param_id);
     if (pcmDevIds.size() > 0)
         device = pcmDevIds.at(0);
+    /* volume is reapplied on every start, anything else stays in the graph */
+    if (param_id != PAL_PARAM_ID_VOLUME_USING_SET_PARAM &&
+        param_id != PAL_PARAM_ID_VOLUME_CTRL_RAMP)
+        graphReconfigured = true;
     switch (param_id) {
         case PAL_PARAM_ID_DEVICE_ROTATION:
         {
@@ -2550,19 +2708,19 @@ int SessionAlsaPcm::setParameters(Stream *streamHandle, int tagId, uint32_t para
                 goto exit;
             }
 
+            paramBatch.reset();
             if (vdata->no_of_volpair == 2 && sAttr.out_media_config.ch_info.channels == 2) {
-                builder->payloadMultichVolumemConfig(&paramData, &paramSize, miid, vdata);
+                status = builder->payloadMultichVolumemConfig(paramBatch, miid, vdata);
             } else {
-                builder->payloadVolumeConfig(&paramData, &paramSize, miid, vdata);
+                status = builder->payloadVolumeConfig(paramBatch, miid, vdata);
             }
 
-            if (paramSize) {
+            if (0 == status) {
                 status = SessionAlsaUtils::setMixerParameter(mixer, device,
-                                               paramData, paramSize);
+                                               paramBatch.data(), paramBatch.size());
                 PAL_INFO(LOG_TAG, "mixer set volume config status=%d\n", status);
-                freeCustomPayload(&paramData, &paramSize);
-                paramSize = 0;
             }
+            paramBatch.reset();
             return 0;
         }
         case PAL_PARAM_ID_MSPP_LINEAR_GAIN:
@@ -2578,12 +2736,10 @@ int SessionAlsaPcm::setParameters(Stream *streamHandle, int tagId, uint32_t para
                 return status;
             }
 
-            builder->payloadMSPPConfig(&paramData, &paramSize, miid, linear_gain->gain);
-            if (paramSize) {
-                status = SessionAlsaUtils::setMixerParameter(mixer, device,
-                                               paramData, paramSize);
+            beginParamBatch();
+            if (0 == builder->payloadMSPPConfig(paramBatch, miid, linear_gain->gain)) {
+                status = sendParamBatch(device);
                 PAL_INFO(LOG_TAG, "mixer set MSPP config status=%d\n", status);
-                free(paramData);
             }
             return 0;
         }
@@ -2688,13 +2844,11 @@ int SessionAlsaPcm::setParameters(Stream *streamHandle, int tagId, uint32_t para
                 PAL_ERR(LOG_TAG, "Failed to get tag info %x, status = %d", tagId, status);
                 return status;
             }
-            builder->payloadVolumeCtrlRamp(&paramData, &paramSize,
-                 miid, rampParam->ramp_period_ms);
-            if (paramSize) {
-                status = SessionAlsaUtils::setMixerParameter(mixer, device,
-                                               paramData, paramSize);
+            beginParamBatch();
+            if (0 == builder->payloadVolumeCtrlRamp(paramBatch, miid,
+                                                    rampParam->ramp_period_ms)) {
+                status = sendParamBatch(device);
                 PAL_INFO(LOG_TAG, "mixer set vol ctrl ramp status=%d\n", status);
-                freeCustomPayload(&paramData, &paramSize);
             }
             return 0;
         }
@@ -2863,6 +3017,8 @@ int SessionAlsaPcm::setECRef(Stream *s, std::shared_ptr<Device> rx_dev, bool is_
         goto exit;
     }
 
+    graphReconfigured = true;
+
     status = s->getStreamAttributes(&sAttr);
     if (status != 0) {
         PAL_ERR(LOG_TAG, "stream get attributes failed");
@@ -3030,8 +3186,24 @@ int SessionAlsaPcm::getParameters(Stream *s __unused, int tagId, uint32_t param_
     const char *stream = "PCM";
     struct mixer_ctl *ctl;
     std::ostringstream CntrlName;
+    pal_param_payload *palPayload = NULL;
     PAL_DBG(LOG_TAG, "Enter.");
 
+    if (param_id == PAL_PARAM_ID_STREAM_READY_FD) {
+        palPayload = (pal_param_payload *)(*payload);
+        if (!palPayload ||
+            palPayload->payload_size != sizeof(struct pal_param_stream_ready_fd)) {
+            PAL_ERR(LOG_TAG, "Invalid payload for ready fd");
+            return -EINVAL;
+        }
+        if (nbIo.getReadyFd() < 0) {
+            PAL_ERR(LOG_TAG, "stream is not opened non-blocking");
+            return -ENOSYS;
+        }
+        ((struct pal_param_stream_ready_fd *)palPayload->payload)->fd = nbIo.getReadyFd();
+        return 0;
+    }
+
     if (pcmDevIds.size() > 0) {
         device = pcmDevIds.at(0);
         CntrlName << stream << pcmDevIds.at(0) << " " << control;
@@ -3596,3 +3768,143 @@ exit:
     PAL_DBG(LOG_TAG, "Exit status: %d", status);
     return status;
 }
+
+int SessionAlsaPcm::getWarmGraphKey(Stream *s, struct pal_stream_attributes &sAttr,
+                                    std::string &key)
+{
+    int status = 0;
+    std::vector<std::pair<int32_t, std::string>> &backEnds =
+        (sAttr.direction == PAL_AUDIO_OUTPUT) ? rxAifBackEnds : txAifBackEnds;
+    std::vector<std::pair<int, int>> kv;
+    std::vector<std::pair<int, int>> emptyKV;
+    std::vector<std::shared_ptr<Device>> associatedDevices;
+    struct pal_device dAttr;
+    std::ostringstream keyStream;
+
+    keyStream << sAttr.type << ":" << sAttr.direction << ":" << sAttr.flags << ":";
+    if (sAttr.direction == PAL_AUDIO_OUTPUT)
+        keyStream << sAttr.out_media_config.sample_rate << ":"
+                  << sAttr.out_media_config.bit_width << ":"
+                  << sAttr.out_media_config.aud_fmt_id << ":"
+                  << sAttr.out_media_config.ch_info.channels;
+    else
+        keyStream << sAttr.in_media_config.sample_rate << ":"
+                  << sAttr.in_media_config.bit_width << ":"
+                  << sAttr.in_media_config.aud_fmt_id << ":"
+                  << sAttr.in_media_config.ch_info.channels;
+
+    /* the graph is identified by everything SessionAlsaUtils::open sets up */
+    status = builder->populateStreamKV(s, kv);
+    if (status)
+        goto exit;
+    builder->populateStreamCkv(s, kv, 0, (struct pal_volume_data **)nullptr);
+    builder->populateDevicePPCkv(s, kv);
+    for (auto &be : backEnds) {
+        keyStream << "|" << be.second;
+        if ((status = builder->populateDeviceKV(s, be.first, kv)) != 0)
+            goto exit;
+        if (sAttr.direction == PAL_AUDIO_OUTPUT)
+            builder->populateDevicePPKV(s, be.first, kv, 0, emptyKV);
+        else
+            builder->populateDevicePPKV(s, 0, emptyKV, be.first, kv);
+        builder->populateStreamDeviceKV(s, be.first, kv);
+    }
+    /* backends keep running at the config of the devices */
+    status = s->getAssociatedDevices(associatedDevices);
+    if (status)
+        goto exit;
+    for (auto &dev : associatedDevices) {
+        if (dev->getDeviceAttributes(&dAttr, s))
+            continue;
+        keyStream << "|" << dAttr.id << "@" << dAttr.config.sample_rate << ":"
+                  << dAttr.config.bit_width << ":" << dAttr.config.aud_fmt_id << ":"
+                  << dAttr.config.ch_info.channels;
+    }
+    for (auto &k : kv)
+        keyStream << "," << std::hex << k.first << "=" << k.second << std::dec;
+    key = keyStream.str();
+
+exit:
+    if (status)
+        PAL_DBG(LOG_TAG, "no warm graph key, status %d", status);
+    return status;
+}
+
+bool SessionAlsaPcm::takeWarmGraph(Stream *s, struct pal_stream_attributes &sAttr)
+{
+    std::shared_ptr<StreamGraphPool> pool = StreamGraphPool::getInstance();
+    struct warmGraph graph;
+
+    warmGraphKey.clear();
+    graphReconfigured = false;
+    if ((sAttr.direction != PAL_AUDIO_INPUT && sAttr.direction != PAL_AUDIO_OUTPUT) ||
+        SessionAlsaUtils::isMmapUsecase(sAttr) ||
+        sAttr.type == PAL_STREAM_VOICE_UI ||
+        sAttr.type == PAL_STREAM_ACD ||
+        sAttr.type == PAL_STREAM_CONTEXT_PROXY ||
+        sAttr.type == PAL_STREAM_ULTRASOUND ||
+        sAttr.type == PAL_STREAM_SENSOR_PCM_DATA ||
+        sAttr.type == PAL_STREAM_VOICE_CALL_RECORD ||
+        sAttr.type == PAL_STREAM_VOICE_CALL_MUSIC ||
+        !pool->isEnabled(sAttr.type))
+        return false;
+
+    if (getWarmGraphKey(s, sAttr, warmGraphKey)) {
+        warmGraphKey.clear();
+        return false;
+    }
+
+    if (!pool->take(warmGraphKey, graph))
+        return false;
+
+    pcmDevIds = graph.pcmDevIds;
+    warmPcm = graph.pcm;
+    warmConfig = graph.config;
+
+    return true;
+}
+
+bool SessionAlsaPcm::parkWarmGraph(struct pal_stream_attributes &sAttr)
+{
+    struct warmGraph graph;
+
+    if (warmGraphKey.empty() || graphReconfigured || mState == SESSION_STARTED ||
+        rm->cardState != CARD_STATUS_ONLINE || pcmDevIds.empty())
+        return false;
+
+    graph.key = warmGraphKey;
+    graph.sAttr = sAttr;
+    graph.lDirection = 0;
+    graph.pcmDevIds = pcmDevIds;
+    graph.backEnds = (sAttr.direction == PAL_AUDIO_OUTPUT) ?
+        rxAifBackEnds : txAifBackEnds;
+    graph.pcm = pcm ? pcm : warmPcm;
+    graph.config = warmConfig;
+
+    return StreamGraphPool::getInstance()->park(graph);
+}
+
+struct pcm *SessionAlsaPcm::adoptWarmPcm(struct pal_stream_attributes &sAttr,
+                                         struct pcm_config *config)
+{
+    struct pcm *warm = warmPcm;
+
+    warmPcm = NULL;
+    if (config->rate == warmConfig.rate &&
+        config->format == warmConfig.format &&
+        config->channels == warmConfig.channels &&
+        config->period_size == warmConfig.period_size &&
+        config->period_count == warmConfig.period_count &&
+        config->start_threshold == warmConfig.start_threshold &&
+        config->stop_threshold == warmConfig.stop_threshold &&
+        config->silence_threshold == warmConfig.silence_threshold &&
+        config->avail_min == warmConfig.avail_min) {
+        StreamGraphPool::getInstance()->recordWarmPrepare(sAttr.type);
+        return warm;
+    }
+
+    PAL_DBG(LOG_TAG, "pcm config changed, reopen pcm of warm graph");
+    pcm_close(warm);
+
+    return NULL;
+}
@@ -73,7 +73,9 @@
 //#include "SessionAlsaCompress.h"
 #include "SessionAlsaVoice.h"
 #include "ResourceManager.h"
+#include "StreamGraphPool.h"
 #include "StreamSoundTrigger.h"
+#include "PalSpanTracer.h"
 #include <agm/agm_api.h>
 #include "spr_api.h"
 #include "apm_api.h"
@@ -190,6 +192,7 @@ pcm_format SessionAlsaUtils::palToAlsaFormat(uint32_t fmt_id)
 
 int SessionAlsaUtils::setMixerCtlData(struct mixer_ctl *ctl, MixerCtlType id, void *data, int size)
 {
+    PAL_TRACE_SPAN("mixer write");
 
     int rc = -EINVAL;
 
@@ -363,6 +366,7 @@ struct mixer_ctl *SessionAlsaUtils::getBeMixerControl(struct mixer *am, std::str
 int SessionAlsaUtils::open(Stream * streamHandle, std::shared_ptr<ResourceManager> rmHandle,
     const std::vector<int> &DevIds, const std::vector<std::pair<int32_t, std::string>> &BackEnds)
 {
+    PAL_TRACE_SPAN("SessionAlsaUtils::open");
     std::vector <std::pair<int, int>> streamKV;
     std::vector <std::pair<int, int>> streamCKV;
     std::vector <std::pair<int, int>> streamDeviceKV;
@@ -613,11 +617,27 @@ exit:
 int SessionAlsaUtils::close(Stream * streamHandle, std::shared_ptr<ResourceManager> rmHandle,
     const std::vector<int> &DevIds, const std::vector<std::pair<int32_t, std::string>> &BackEnds,
     std::vector<std::pair<std::string, int>> &freedevicemetadata)
+{
+    int status = 0;
+    struct pal_stream_attributes sAttr;
+
+    status = streamHandle->getStreamAttributes(&sAttr);
+    if(0 != status) {
+        PAL_ERR(LOG_TAG, "getStreamAttributes Failed \n");
+        return status;
+    }
+
+    return close(sAttr, rmHandle, DevIds, BackEnds, freedevicemetadata);
+}
+
+int SessionAlsaUtils::close(const struct pal_stream_attributes &sAttr,
+    std::shared_ptr<ResourceManager> rmHandle, const std::vector<int> &DevIds,
+    const std::vector<std::pair<int32_t, std::string>> &BackEnds,
+    std::vector<std::pair<std::string, int>> &freedevicemetadata)
 {
     int status = 0;
     uint32_t i;
     std::vector <std::pair<int, int>> emptyKV;
-    struct pal_stream_attributes sAttr;
     struct agmMetaData streamMetaData(nullptr, 0);
     struct agmMetaData deviceMetaData(nullptr, 0);
     struct agmMetaData streamDeviceMetaData(nullptr, 0);
@@ -629,12 +649,6 @@ int SessionAlsaUtils::close(Stream * streamHandle, std::shared_ptr<ResourceManag
     struct mixer_ctl *beMetaDataMixerCtrl = nullptr;
     struct mixer *mixerHandle = nullptr;
 
-    status = streamHandle->getStreamAttributes(&sAttr);
-    if(0 != status) {
-        PAL_ERR(LOG_TAG, "getStreamAttributes Failed \n");
-        goto exit;
-    }
-
     if (DevIds.size() <= 0) {
         PAL_ERR(LOG_TAG, "DevIds size is invalid \n");
         goto exit;
@@ -690,6 +704,8 @@ int SessionAlsaUtils::close(Stream * streamHandle, std::shared_ptr<ResourceManag
                 if (freeDevmeta->second == 0) {
                     PAL_INFO(LOG_TAG, "No need to free device metadata as device is still active");
                 } else {
+                    StreamGraphPool::getInstance()->invalidateBackEnd(be->second,
+                            "device metadata freed");
                     mixer_ctl_set_array(beMetaDataMixerCtrl, (void *)deviceMetaData.buf,
                                     deviceMetaData.size);
                 }
@@ -932,6 +948,7 @@ int SessionAlsaUtils::setDeviceMetadata(std::shared_ptr<ResourceManager> rmHandl
                                            std::string backEndName,
                                            std::vector <std::pair<int, int>> &deviceKV)
 {
+    PAL_TRACE_SPAN("SessionAlsaUtils::setDeviceMetadata");
     std::vector <std::pair<int, int>> emptyKV;
     int status = 0;
     struct agmMetaData deviceMetaData(nullptr, 0);
@@ -975,6 +992,7 @@ int SessionAlsaUtils::setDeviceMetadata(std::shared_ptr<ResourceManager> rmHandl
 int SessionAlsaUtils::setDeviceMediaConfig(std::shared_ptr<ResourceManager> rmHandle,
                                            std::string backEndName, struct pal_device *dAttr)
 {
+    PAL_TRACE_SPAN("SessionAlsaUtils::setDeviceMediaConfig");
     struct mixer_ctl *ctl = NULL;
     long aif_media_config[4];
     long aif_group_atrr_config[5];
@@ -1263,6 +1281,7 @@ int SessionAlsaUtils::getTagsWithModuleInfo(struct mixer *mixer, int device, con
 int SessionAlsaUtils::setMixerParameter(struct mixer *mixer, int device,
                                         void *payload, int size)
 {
+    PAL_TRACE_SPAN("SessionAlsaUtils::setMixerParameter");
     char *pcmDeviceName = NULL;
     char const *control = "setParam";
     char *mixer_str;
@@ -1300,6 +1319,7 @@ int SessionAlsaUtils::setMixerParameter(struct mixer *mixer, int device,
 
 int SessionAlsaUtils::setStreamMetadataType(struct mixer *mixer, int device, const char *val)
 {
+    PAL_TRACE_SPAN("SessionAlsaUtils::setStreamMetadataType");
     char *pcmDeviceName = NULL;
     char const *control = "control";
     char *mixer_str;
@@ -1470,6 +1490,7 @@ int SessionAlsaUtils::open(Stream * streamHandle, std::shared_ptr<ResourceManage
     const std::vector<std::pair<int32_t, std::string>> &rxBackEnds,
     const std::vector<std::pair<int32_t, std::string>> &txBackEnds)
 {
+    PAL_TRACE_SPAN("SessionAlsaUtils::open");
     std::vector <std::pair<int, int>> streamRxKV, streamTxKV;
     std::vector <std::pair<int, int>> streamRxCKV, streamTxCKV;
     std::vector <std::pair<int, int>> streamDeviceRxKV, streamDeviceTxKV;
@@ -2032,6 +2053,8 @@ int SessionAlsaUtils::close(Stream * streamHandle, std::shared_ptr<ResourceManag
             if (freeDevMeta->second == 0) {
                 PAL_INFO(LOG_TAG, "No need to free TX device metadata as device is still active");
             } else {
+                StreamGraphPool::getInstance()->invalidateBackEnd(txBackEnds[0].second,
+                        "device metadata freed");
                 mixer_ctl_set_array(txBeMixerCtrl, (void *)deviceTxMetaData.buf,
                                     deviceTxMetaData.size);
             }
@@ -2040,6 +2063,8 @@ int SessionAlsaUtils::close(Stream * streamHandle, std::shared_ptr<ResourceManag
             if (freeDevMeta->second == 0) {
                 PAL_INFO(LOG_TAG, "No need to free RX device metadata as device is still active");
             } else {
+                StreamGraphPool::getInstance()->invalidateBackEnd(rxBackEnds[0].second,
+                        "device metadata freed");
                 mixer_ctl_set_array(rxBeMixerCtrl, (void *)deviceRxMetaData.buf,
                                     deviceRxMetaData.size);
             }
@@ -2184,6 +2209,8 @@ int SessionAlsaUtils::disconnectSessionDevice(Stream* streamHandle, pal_stream_t
     if (devCount > 1) {
         PAL_INFO(LOG_TAG, "No need to free device metadata since active streams present on device");
     } else {
+        StreamGraphPool::getInstance()->invalidateBackEnd(
+            aifBackEndsToDisconnect[0].second, "device metadata freed");
         mixer_ctl_set_array(beMetaDataMixerCtrl, (void*)deviceMetaData.buf,
             deviceMetaData.size);
     }
@@ -2254,6 +2281,7 @@ int SessionAlsaUtils::connectSessionDevice(Session* sess, Stream* streamHandle,
         const std::vector<int> &pcmDevIds,
         const std::vector<std::pair<int32_t, std::string>> &aifBackEndsToConnect)
 {
+    PAL_TRACE_SPAN("SessionAlsaUtils::connectSessionDevice");
     struct mixer_ctl *connectCtrl;
     struct mixer *mixerHandle = nullptr;
     bool is_compress = false;
@@ -2390,6 +2418,7 @@ int SessionAlsaUtils::connectSessionDevice(Session* sess, Stream* streamHandle,
         const std::vector<int> &pcmTxDevIds,const std::vector<int> &pcmRxDevIds,
         const std::vector<std::pair<int32_t, std::string>> &aifBackEndsToConnect)
 {
+    PAL_TRACE_SPAN("SessionAlsaUtils::connectSessionDevice");
     std::ostringstream connectCtrlName;
     int status = 0;
     struct mixer *mixerHandle = nullptr;
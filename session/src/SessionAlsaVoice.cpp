@@ -1672,25 +1672,25 @@ int SessionAlsaVoice::setHWSidetone(Stream * s, bool enable){
             case PAL_DEVICE_IN_HANDSET_MIC:
                 if(enable) {
                     if (rxDevice->getSndDeviceId() == PAL_DEVICE_OUT_WIRED_HEADPHONE)
-                        audio_route_apply_and_update_path(audioRoute, "sidetone-heaphone-handset-mic");
+                        enableDevice(audioRoute, "sidetone-heaphone-handset-mic");
                     else
-                        audio_route_apply_and_update_path(audioRoute, "sidetone-handset");
+                        enableDevice(audioRoute, "sidetone-handset");
                     sideTone_cnt++;
                 } else {
                     if (rxDevice->getSndDeviceId() == PAL_DEVICE_OUT_WIRED_HEADPHONE)
-                        audio_route_reset_and_update_path(audioRoute, "sidetone-heaphone-handset-mic");
+                        disableDevice(audioRoute, "sidetone-heaphone-handset-mic");
                     else
-                        audio_route_reset_and_update_path(audioRoute, "sidetone-handset");
+                        disableDevice(audioRoute, "sidetone-handset");
                     sideTone_cnt--;
                 }
                 set = true;
                 break;
             case PAL_DEVICE_IN_WIRED_HEADSET:
                 if(enable) {
-                    audio_route_apply_and_update_path(audioRoute, "sidetone-headphones");
+                    enableDevice(audioRoute, "sidetone-headphones");
                     sideTone_cnt++;
                 } else {
-                    audio_route_reset_and_update_path(audioRoute, "sidetone-headphones");
+                    disableDevice(audioRoute, "sidetone-headphones");
                     sideTone_cnt--;
                 }
                 set = true;
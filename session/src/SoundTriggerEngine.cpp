@@ -235,3 +235,59 @@ uint32_t SoundTriggerEngine::FrameToBytes(uint32_t frames) {
 uint32_t SoundTriggerEngine::BytesToFrames(uint32_t bytes) {
     return (bytes * BITS_PER_BYTE) / (bit_width_ * channels_);
 }
+
+int32_t StEngineArena::Reserve(size_t size)
+{
+    uint8_t *buf = nullptr;
+
+    if (size <= size_)
+        return 0;
+
+    buf = (uint8_t *)calloc(1, size);
+    if (!buf) {
+        PAL_ERR(LOG_TAG, "Failed to reserve %zu bytes for engine arena", size);
+        return -ENOMEM;
+    }
+
+    if (buf_)
+        free(buf_);
+    buf_ = buf;
+    size_ = size;
+    stats_.alloc_count++;
+    PAL_DBG(LOG_TAG, "engine arena reserved %zu bytes", size_);
+
+    return 0;
+}
+
+uint8_t *StEngineArena::Get(size_t size)
+{
+    if (size <= size_ && buf_) {
+        stats_.reuse_count++;
+        return buf_;
+    }
+
+    PAL_INFO(LOG_TAG, "engine arena grows from %zu to %zu bytes", size_, size);
+    if (Reserve(size))
+        return nullptr;
+
+    return buf_;
+}
+
+void StEngineArena::Release()
+{
+    if (buf_) {
+        free(buf_);
+        buf_ = nullptr;
+    }
+    size_ = 0;
+}
+
+void StEngineArena::GetStats(struct pal_param_st_arena_stats *stats) const
+{
+    if (!stats)
+        return;
+
+    stats->alloc_count += stats_.alloc_count;
+    stats->reuse_count += stats_.reuse_count;
+    stats->reserved_size += size_;
+}
@@ -37,6 +37,7 @@
 
 #include "SoundTriggerEngineCapi.h"
 
+#include <algorithm>
 #include <cutils/trace.h>
 #include <dlfcn.h>
 
@@ -141,8 +142,8 @@ int32_t SoundTriggerEngineCapi::StartKeywordDetection()
     int32_t status = 0;
     char *process_input_buff = nullptr;
     capi_v2_err_t rc = CAPI_V2_EOK;
-    capi_v2_stream_data_t *stream_input = nullptr;
-    sva_result_t *result_cfg_ptr = nullptr;
+    capi_v2_stream_data_t *stream_input = &stream_input_;
+    sva_result_t *result_cfg_ptr = &kw_result_;
     int32_t read_size = 0;
     size_t start_idx = 0;
     size_t end_idx = 0;
@@ -200,36 +201,23 @@ int32_t SoundTriggerEngineCapi::StartKeywordDetection()
     }
 
     memset(&capi_result, 0, sizeof(capi_result));
-    process_input_buff = (char*)calloc(1, buffer_size_);
+    /*
+     * Later reads use the LAB buffer size, which may exceed the
+     * keyword window used for the first read.
+     */
+    process_input_buff = (char *)process_arena_.Get(
+        std::max(buffer_size_, (uint32_t)lab_buffer_size));
     if (!process_input_buff) {
         status = -ENOMEM;
-        PAL_ERR(LOG_TAG, "failed to allocate process input buff, status %d",
-                status);
-        goto exit;
-    }
-
-    stream_input = (capi_v2_stream_data_t *)
-                   calloc(1, sizeof(capi_v2_stream_data_t));
-    if (!stream_input) {
-        status = -ENOMEM;
-        PAL_ERR(LOG_TAG, "failed to allocate stream input, status %d", status);
-        goto exit;
-    }
-
-    stream_input->buf_ptr = (capi_v2_buf_t*)calloc(1, sizeof(capi_v2_buf_t));
-    if (!stream_input->buf_ptr) {
-        status = -ENOMEM;
-        PAL_ERR(LOG_TAG, "failed to allocate stream_input->buf_ptr, status %d",
+        PAL_ERR(LOG_TAG, "failed to get process input buff, status %d",
                 status);
         goto exit;
     }
 
-    result_cfg_ptr = (sva_result_t*)calloc(1, sizeof(sva_result_t));
-    if (!result_cfg_ptr) {
-        status = -ENOMEM;
-        PAL_ERR(LOG_TAG, "failed to allocate result cfg ptr status %d", status);
-        goto exit;
-    }
+    memset(&stream_input_, 0, sizeof(stream_input_));
+    memset(&stream_buf_, 0, sizeof(stream_buf_));
+    memset(&kw_result_, 0, sizeof(kw_result_));
+    stream_input->buf_ptr = &stream_buf_;
 
     process_start = std::chrono::steady_clock::now();
     while (!exit_buffering_ &&
@@ -364,16 +352,6 @@ exit:
     if (reader_)
         reader_->updateState(READER_DISABLED);
 
-    if (process_input_buff)
-        free(process_input_buff);
-    if (stream_input) {
-        if (stream_input->buf_ptr)
-            free(stream_input->buf_ptr);
-        free(stream_input);
-    }
-    if (result_cfg_ptr)
-        free(result_cfg_ptr);
-
     PAL_DBG(LOG_TAG, "Exit, status %d", status);
 
     return status;
@@ -384,10 +362,10 @@ int32_t SoundTriggerEngineCapi::StartUserVerification()
     int32_t status = 0;
     char *process_input_buff = nullptr;
     capi_v2_err_t rc = CAPI_V2_EOK;
-    capi_v2_stream_data_t *stream_input = nullptr;
+    capi_v2_stream_data_t *stream_input = &stream_input_;
     capi_v2_buf_t capi_uv_ptr;
-    stage2_uv_wrapper_result *result_cfg_ptr = nullptr;
-    stage2_uv_wrapper_stage1_uv_score_t *uv_cfg_ptr = nullptr;
+    stage2_uv_wrapper_result *result_cfg_ptr = &uv_result_;
+    stage2_uv_wrapper_stage1_uv_score_t *uv_cfg_ptr = &uv_score_;
     int32_t read_size = 0;
     capi_v2_buf_t capi_result;
     bool buffer_advanced = false;
@@ -437,43 +415,18 @@ int32_t SoundTriggerEngineCapi::StartUserVerification()
     memset(&capi_uv_ptr, 0, sizeof(capi_uv_ptr));
     memset(&capi_result, 0, sizeof(capi_result));
 
-    process_input_buff = (char*)calloc(1, buffer_size_);
+    process_input_buff = (char *)process_arena_.Get(buffer_size_);
     if (!process_input_buff) {
-        PAL_ERR(LOG_TAG, "failed to allocate process input buff");
-        status = -ENOMEM;
-        goto exit;
-    }
-
-    stream_input = (capi_v2_stream_data_t *)
-                   calloc(1, sizeof(capi_v2_stream_data_t));
-    if (!stream_input) {
-        PAL_ERR(LOG_TAG, "failed to allocate stream input");
-        status = -ENOMEM;
-        goto exit;
-    }
-
-    stream_input->buf_ptr = (capi_v2_buf_t*)calloc(1, sizeof(capi_v2_buf_t));
-    if (!stream_input->buf_ptr) {
-        PAL_ERR(LOG_TAG, "failed to allocate buf ptr");
-        status = -ENOMEM;
-        goto exit;
-    }
-
-    result_cfg_ptr = (stage2_uv_wrapper_result*)
-                     calloc(1, sizeof(stage2_uv_wrapper_result));
-    if (!result_cfg_ptr) {
-        PAL_ERR(LOG_TAG, "failed to allocate result cfg ptr");
+        PAL_ERR(LOG_TAG, "failed to get process input buff");
         status = -ENOMEM;
         goto exit;
     }
 
-    uv_cfg_ptr = (stage2_uv_wrapper_stage1_uv_score_t *)
-                 calloc(1, sizeof(stage2_uv_wrapper_stage1_uv_score_t));
-    if (!uv_cfg_ptr) {
-        PAL_ERR(LOG_TAG, "failed to allocate uv cfg ptr");
-        status = -ENOMEM;
-        goto exit;
-    }
+    memset(&stream_input_, 0, sizeof(stream_input_));
+    memset(&stream_buf_, 0, sizeof(stream_buf_));
+    memset(&uv_result_, 0, sizeof(uv_result_));
+    memset(&uv_score_, 0, sizeof(uv_score_));
+    stream_input->buf_ptr = &stream_buf_;
 
     str = dynamic_cast<StreamSoundTrigger *>(stream_handle_);
     if (vui_intf_->GetModuleType(stream_handle_) == ST_MODULE_TYPE_GMM) {
@@ -631,18 +584,6 @@ exit:
     if (reader_)
         reader_->updateState(READER_DISABLED);
 
-    if (process_input_buff)
-        free(process_input_buff);
-    if (stream_input) {
-        if (stream_input->buf_ptr)
-            free(stream_input->buf_ptr);
-        free(stream_input);
-    }
-    if (result_cfg_ptr)
-        free(result_cfg_ptr);
-    if (uv_cfg_ptr)
-        free(uv_cfg_ptr);
-
     PAL_DBG(LOG_TAG, "Exit, status %d", status);
 
     return status;
@@ -681,6 +622,11 @@ SoundTriggerEngineCapi::SoundTriggerEngineCapi(
     det_conf_score_ = 0;
     memset(&in_model_buffer_param_, 0, sizeof(in_model_buffer_param_));
     memset(&scratch_param_, 0, sizeof(scratch_param_));
+    memset(&stream_input_, 0, sizeof(stream_input_));
+    memset(&stream_buf_, 0, sizeof(stream_buf_));
+    memset(&kw_result_, 0, sizeof(kw_result_));
+    memset(&uv_result_, 0, sizeof(uv_result_));
+    memset(&uv_score_, 0, sizeof(uv_score_));
 
     vui_ptfm_info_ = VoiceUIPlatformInfo::GetInstance();
     if (!vui_ptfm_info_) {
@@ -903,6 +849,47 @@ int32_t SoundTriggerEngineCapi::StopSoundEngine()
     return status;
 }
 
+/*
+ * Size the process buffer for the largest window a detection can read:
+ * the configured keyword duration plus the tolerances applied around it,
+ * or one LAB buffer if that is larger.
+ */
+int32_t SoundTriggerEngineCapi::ReserveProcessBuffers()
+{
+    uint64_t window_us = 0;
+    size_t size = 0;
+
+    window_us = (uint64_t)sm_cfg_->GetKwDuration() * 1000;
+    if (detection_type_ == ST_SM_TYPE_KEYWORD_DETECTION)
+        window_us += kw_start_tolerance_;
+    else
+        window_us += data_before_kw_start_;
+    window_us += kw_end_tolerance_;
+
+    size = std::max(UsToBytes(window_us), buffer_size_);
+    PAL_DBG(LOG_TAG, "reserving %zu bytes for %llu us window", size,
+            (unsigned long long)window_us);
+
+    return process_arena_.Reserve(size);
+}
+
+int32_t SoundTriggerEngineCapi::GetParameters(uint32_t param_id,
+    void **payload)
+{
+    int32_t status = 0;
+
+    switch (param_id) {
+        case PAL_PARAM_ID_ST_ENGINE_ARENA_STATS:
+            process_arena_.GetStats(
+                (struct pal_param_st_arena_stats *)*payload);
+            break;
+        default:
+            break;
+    }
+
+    return status;
+}
+
 int32_t SoundTriggerEngineCapi::LoadSoundModel(Stream *s __unused,
     uint8_t *data, uint32_t data_size)
 {
@@ -957,6 +944,13 @@ int32_t SoundTriggerEngineCapi::LoadSoundModel(Stream *s __unused,
         goto exit;
     }
 
+    status = ReserveProcessBuffers();
+    if (status) {
+        PAL_ERR(LOG_TAG, "Failed to reserve process buffers, status %d",
+                status);
+        goto exit;
+    }
+
     buffer_thread_handler_ =
         std::thread(SoundTriggerEngineCapi::BufferThreadLoop, this);
 
@@ -1057,6 +1051,7 @@ exit:
         free(scratch_param_.scratch_ptr);
         scratch_param_.scratch_ptr = NULL;
     }
+    process_arena_.Release();
     PAL_DBG(LOG_TAG, "Exit, status %d", status);
     return status;
 }
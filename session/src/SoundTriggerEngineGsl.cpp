@@ -103,6 +103,7 @@ void SoundTriggerEngineGsl::EventProcessingThread(
         det_str = dynamic_cast<StreamSoundTrigger *>(
             gsl_engine->vui_intf_->GetDetectedStream());
         if (det_str) {
+            det_str->GetLatencyTracer()->Mark(PAL_ST_TRACE_EVENT_THREAD);
             if (gsl_engine->capture_requested_) {
                 status = gsl_engine->StartBuffering(det_str);
                 if (status < 0) {
@@ -162,7 +163,7 @@ int32_t SoundTriggerEngineGsl::StartBuffering(Stream *s) {
 
     std::memset(&buf, 0, sizeof(struct pal_buffer));
     buf.size = input_buf_size * input_buf_num;
-    buf.buffer = (uint8_t *)calloc(1, buf.size);
+    buf.buffer = lab_arena_.Get(buf.size);
     if (!buf.buffer) {
         PAL_ERR(LOG_TAG, "buf.buffer allocation failed");
         status = -ENOMEM;
@@ -258,7 +259,7 @@ int32_t SoundTriggerEngineGsl::StartBuffering(Stream *s) {
             }
 
             if (size_to_read != buf.size) {
-                buf.buffer = (uint8_t *)realloc(buf.buffer, size_to_read);
+                buf.buffer = lab_arena_.Get(size_to_read);
                 if (!buf.buffer) {
                     PAL_ERR(LOG_TAG, "buf.buffer allocation failed");
                     status = -ENOMEM;
@@ -360,9 +361,6 @@ int32_t SoundTriggerEngineGsl::StartBuffering(Stream *s) {
     }
 
 exit:
-    if (buf.buffer) {
-        free(buf.buffer);
-    }
     if (buf.ts) {
         free(buf.ts);
     }
@@ -390,6 +388,9 @@ SoundTriggerEngineGsl::SoundTriggerEngineGsl(
     capture_requested_ = false;
     stream_handle_ = s;
     sm_data_ = nullptr;
+    sm_data_size_ = 0;
+    pdk_model_id_ = 0;
+    pdk_model_ = nullptr;
     reader_ = nullptr;
     buffer_ = nullptr;
     rx_ec_dev_ = nullptr;
@@ -661,6 +662,61 @@ cleanup:
     return status;
 }
 
+/*
+ * Key of the model set made of the engine streams without exclude, plus the
+ * model of include which is not added to eng_streams_ until load completes.
+ */
+std::vector<uint64_t> SoundTriggerEngineGsl::GetModelSetKey(Stream *exclude,
+                                                            Stream *include) {
+
+    std::vector<uint64_t> key;
+    bool included = false;
+
+    for (int i = 0; i < eng_streams_.size(); i++) {
+        StreamSoundTrigger *sst = dynamic_cast<StreamSoundTrigger *>(eng_streams_[i]);
+        SoundModelInfo *info = nullptr;
+
+        if (eng_streams_[i] == exclude || !sst)
+            continue;
+        if (eng_streams_[i] == include)
+            included = true;
+        info = vui_intf_->GetSoundModelInfo(sst);
+        if (!info || !info->GetModelData())
+            continue;
+
+        auto it = sm_hashes_.find(eng_streams_[i]);
+        if (it == sm_hashes_.end())
+            it = sm_hashes_.insert(std::make_pair(eng_streams_[i],
+                info->GetModelBlob()->GetHash())).first;
+        key.push_back(it->second);
+    }
+    if (include && !included) {
+        auto it = sm_hashes_.find(include);
+        if (it != sm_hashes_.end())
+            key.push_back(it->second);
+    }
+    return key;
+}
+
+bool SoundTriggerEngineGsl::LookupMergedModel(std::vector<uint64_t> &key) {
+
+    SoundModelInfo *sm_info = new SoundModelInfo();
+    bool hit = false;
+
+    /* copy into a scratch info first so a failed copy leaves engine model intact */
+    hit = merged_model_cache_.Lookup(key, sm_info);
+    if (hit) {
+        PAL_INFO(LOG_TAG, "Reuse cached merged model: current size %d, new size %d",
+            eng_sm_info_->GetModelSize(), sm_info->GetModelSize());
+        *eng_sm_info_ = *sm_info;
+        vui_intf_->SetSoundModelInfo(eng_sm_info_);
+        sm_merged_ = true;
+    }
+    delete sm_info;
+
+    return hit;
+}
+
 int32_t SoundTriggerEngineGsl::AddSoundModel(Stream *s, uint8_t *data,
                                               uint32_t data_size){
 
@@ -670,6 +726,8 @@ int32_t SoundTriggerEngineGsl::AddSoundModel(Stream *s, uint8_t *data,
     listen_model_type **in_models = nullptr;
     listen_model_type out_model = {};
     SoundModelInfo *sm_info;
+    std::vector<uint64_t> key;
+    ChronoSteadyClock_t merge_begin;
 
     PAL_VERBOSE(LOG_TAG, "Enter");
     if (vui_intf_->GetSoundModelInfo(st)->GetModelData()) {
@@ -693,6 +751,12 @@ int32_t SoundTriggerEngineGsl::AddSoundModel(Stream *s, uint8_t *data,
     }
 
     vui_intf_->GetSoundModelInfo(st)->SetModelData(data, data_size);
+    if (!vui_intf_->GetSoundModelInfo(st)->GetModelData()) {
+        PAL_ERR(LOG_TAG, "Failed to store stream model");
+        return -ENOMEM;
+    }
+    /* hashed once, the store keeps it with the model */
+    sm_hashes_[s] = vui_intf_->GetSoundModelInfo(st)->GetModelBlob()->GetHash();
 
     /* Check for remaining stream sound models to merge */
     for (int i = 0; i < eng_streams_.size(); i++) {
@@ -737,6 +801,11 @@ int32_t SoundTriggerEngineGsl::AddSoundModel(Stream *s, uint8_t *data,
         }
     }
 
+    /* Same set of models merged recently, skip SML merge */
+    key = GetModelSetKey(nullptr, s);
+    if (LookupMergedModel(key))
+        return 0;
+
     /* Merge this stream model with remaining streams models */
     num_models = 2;
     SoundModelInfo::AllocArrayPtrs((char***)&in_models, num_models,
@@ -753,11 +822,15 @@ int32_t SoundTriggerEngineGsl::AddSoundModel(Stream *s, uint8_t *data,
     in_models[1]->data = data;
     in_models[1]->size = data_size;
 
+    merge_begin = std::chrono::steady_clock::now();
     status = MergeSoundModels(num_models, in_models, &out_model);
     if (status) {
         PAL_ERR(LOG_TAG, "merge models failed");
         goto cleanup;
     }
+    merged_model_cache_.RecordMerge(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - merge_begin).count());
     sm_info = new SoundModelInfo();
     sm_info->SetModelData(out_model.data, out_model.size);
 
@@ -784,8 +857,10 @@ int32_t SoundTriggerEngineGsl::AddSoundModel(Stream *s, uint8_t *data,
     *eng_sm_info_ = *sm_info;
     vui_intf_->SetSoundModelInfo(eng_sm_info_);
     sm_merged_ = true;
+    merged_model_cache_.Insert(key, sm_info);
 
     delete sm_info;
+    free(out_model.data);
     PAL_DBG(LOG_TAG, "Exit: status %d", status);
     return 0;
 cleanup:
@@ -890,8 +965,11 @@ int32_t SoundTriggerEngineGsl::DeleteSoundModel(Stream *s) {
     listen_model_type in_model = {};
     listen_model_type out_model = {};
     SoundModelInfo *sm_info = nullptr;
+    std::vector<uint64_t> key;
+    ChronoSteadyClock_t merge_begin;
 
     PAL_VERBOSE(LOG_TAG, "Enter");
+    sm_hashes_.erase(s);
     if (!vui_intf_->GetSoundModelInfo(st)->GetModelData()) {
         PAL_DBG(LOG_TAG, "Stream model data already deleted");
         return 0;
@@ -947,24 +1025,35 @@ int32_t SoundTriggerEngineGsl::DeleteSoundModel(Stream *s) {
         goto cleanup;
     }
 
+    /* Remaining models were merged recently, skip SML delete */
+    key = GetModelSetKey(s);
+    if (LookupMergedModel(key))
+        return 0;
+
     /* Existing merged model from which the current stream model to be deleted */
     in_model.data = eng_sm_info_->GetModelData();
     in_model.size = eng_sm_info_->GetModelSize();
 
+    merge_begin = std::chrono::steady_clock::now();
     status = DeleteFromMergedModel(vui_intf_->GetSoundModelInfo(st)->GetKeyPhrases(),
         vui_intf_->GetSoundModelInfo(st)->GetNumKeyPhrases(),
         &in_model, &out_model);
 
     if (status)
         goto cleanup;
+    merged_model_cache_.RecordMerge(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - merge_begin).count());
     sm_info = new SoundModelInfo();
     sm_info->SetModelData(out_model.data, out_model.size);
 
     /* Update existing merged model info with new merged model */
     status = QuerySoundModel(sm_info, out_model.data,
                                out_model.size);
-    if (status)
+    if (status) {
+        delete sm_info;
         goto cleanup;
+    }
 
     if (out_model.size > eng_sm_info_->GetModelSize()) {
         PAL_ERR(LOG_TAG, "Unexpected, merged model sz %d > current sz %d",
@@ -980,7 +1069,10 @@ int32_t SoundTriggerEngineGsl::DeleteSoundModel(Stream *s) {
     *eng_sm_info_ = *sm_info;
     vui_intf_->SetSoundModelInfo(eng_sm_info_);
     sm_merged_ = true;
+    merged_model_cache_.Insert(key, sm_info);
 
+    delete sm_info;
+    free(out_model.data);
     return 0;
 
 cleanup:
@@ -1203,6 +1295,7 @@ int32_t SoundTriggerEngineGsl::HandleMultiStreamUnloadPDK(Stream *s) {
         return -EINVAL;
     }
 
+    pdk_pins_.erase(model_id);
     deleted_entries = mid_stream_map_.erase(model_id);
     if (deleted_entries == 0) {
         PAL_ERR(LOG_TAG, "Sound model not deleted");
@@ -1324,9 +1417,9 @@ int32_t SoundTriggerEngineGsl::LoadSoundModel(Stream *s, uint8_t *data,
                                               uint32_t data_size) {
     int32_t status = 0;
     uint32_t model_id = 0;
+    size_t in_buf_size = 0;
+    size_t in_buf_count = 0;
     StreamSoundTrigger *st = dynamic_cast<StreamSoundTrigger *>(s);
-    struct param_id_detection_engine_register_multi_sound_model_t *pdk_data =
-           nullptr;
     std::shared_ptr<ResourceManager> rm = ResourceManager::getInstance();
 
     PAL_DBG(LOG_TAG, "Enter");
@@ -1340,24 +1433,18 @@ int32_t SoundTriggerEngineGsl::LoadSoundModel(Stream *s, uint8_t *data,
         model_id = st->GetModelId();
         mid_stream_map_[model_id] = s;
 
-        pdk_data = (struct param_id_detection_engine_register_multi_sound_model_t *)
-             malloc(sizeof(
-             struct param_id_detection_engine_register_multi_sound_model_t) +
-             data_size);
-
-        if (pdk_data == nullptr) {
-            PAL_ERR(LOG_TAG, "Failed to allocate memory for pdk_data");
-            return -EINVAL;
+        /*
+         * The register payload is laid out around the model in the store,
+         * a model reloaded under the same id is not copied again.
+         */
+        pdk_model_id_ = model_id;
+        pdk_model_ = SoundModelStore::GetInstance()->ShareModel(model_id,
+                                                                data, data_size);
+        if (!pdk_model_) {
+            PAL_ERR(LOG_TAG, "Failed to store model %x", model_id);
+            return -ENOMEM;
         }
-
-        pdk_data->model_id = model_id;
-        pdk_data->model_size = data_size;
-        ar_mem_cpy(pdk_data->model, data_size, data, data_size);
-        sm_data_ = (uint8_t *)pdk_data;
-        data_size += (sizeof(param_id_detection_engine_register_multi_sound_model_t));
-        sm_data_size_ = data_size;
-        PAL_DBG(LOG_TAG, "model id : %x, model size : %u", pdk_data->model_id,
-                pdk_data->model_size);
+        PAL_DBG(LOG_TAG, "model id : %x, model size : %u", model_id, data_size);
     }
 
     exit_buffering_ = true;
@@ -1394,6 +1481,11 @@ int32_t SoundTriggerEngineGsl::LoadSoundModel(Stream *s, uint8_t *data,
         goto exit;
     }
 
+    /* reserve LAB read buffer up front so detections don't allocate */
+    s->getBufInfo(&in_buf_size, &in_buf_count, nullptr, nullptr);
+    if (lab_arena_.Reserve(in_buf_size * in_buf_count))
+        PAL_ERR(LOG_TAG, "Failed to reserve LAB buffer, allocate on detection");
+
     UpdateState(ENG_LOADED);
 exit:
     if (!status)
@@ -1404,8 +1496,11 @@ exit:
         status = 0;
     }
 
-    if (pdk_data)
-        free(pdk_data);
+    /* pinned while registered with the DSP, dropped on unload/teardown */
+    if (!status && pdk_model_)
+        pdk_pins_[pdk_model_id_] = std::make_unique<SoundModelPin>(pdk_model_id_,
+                                                                   pdk_model_);
+    pdk_model_ = nullptr;
 
     PAL_DBG(LOG_TAG, "Exit, status = %d", status);
     return status;
@@ -1433,6 +1528,7 @@ int32_t SoundTriggerEngineGsl::UnloadSoundModel(Stream *s) {
     status = session_->close(s);
     if (status)
         PAL_ERR(LOG_TAG, "Failed to close session, status = %d", status);
+    pdk_pins_.clear();
 
     /* Delete the sound model in engine */
     status = UpdateEngineModel(s, nullptr, 0, false);
@@ -2096,6 +2192,7 @@ void SoundTriggerEngineGsl::HandleSessionEvent(uint32_t event_id __unused,
     int32_t status = 0;
     uint32_t start_index = 0;
     uint32_t end_index = 0;
+    StreamSoundTrigger *det_str = nullptr;
     std::shared_ptr<ResourceManager> rm = ResourceManager::getInstance();
 
     /*
@@ -2111,6 +2208,14 @@ void SoundTriggerEngineGsl::HandleSessionEvent(uint32_t event_id __unused,
         return;
     }
 
+    det_str = dynamic_cast<StreamSoundTrigger *>(vui_intf_->GetDetectedStream());
+    if (det_str) {
+        det_str->GetLatencyTracer()->Begin(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                detection_time_.time_since_epoch()).count());
+        det_str->GetLatencyTracer()->Mark(PAL_ST_TRACE_EVENT_PARSED);
+    }
+
     // update keyword index to ring buffer
     vui_intf_->GetKeywordIndex(&start_index, &end_index);
     buffer_->updateIndices(start_index, end_index);
@@ -2222,6 +2327,13 @@ int32_t SoundTriggerEngineGsl::GetParameters(uint32_t param_id,
         case PAL_PARAM_ID_KW_TRANSFER_LATENCY:
             *(uint64_t **)payload = &kw_transfer_latency_;
             break;
+        case PAL_PARAM_ID_ST_ENGINE_ARENA_STATS:
+            lab_arena_.GetStats((struct pal_param_st_arena_stats *)*payload);
+            break;
+        case PAL_PARAM_ID_ST_MERGE_CACHE_STATS:
+            merged_model_cache_.GetStats(
+                (struct pal_param_st_merge_cache_stats *)*payload);
+            break;
         default:
             status = -EINVAL;
             PAL_ERR(LOG_TAG, "Unsupported param id %u status %d",
@@ -2385,6 +2497,9 @@ int32_t SoundTriggerEngineGsl::UpdateSessionPayload(st_param_id_type_t param) {
     size_t payload_size = 0;
     uint32_t ses_param_id = 0;
     uint32_t detection_miid = 0;
+    /* set for payloads laid out in place around a stored model */
+    std::shared_ptr<SoundModelBlob> model = nullptr;
+    std::unique_lock<std::mutex> payload_lck;
 
     PAL_DBG(LOG_TAG, "Enter, param : %u", param);
 
@@ -2421,14 +2536,22 @@ int32_t SoundTriggerEngineGsl::UpdateSessionPayload(st_param_id_type_t param) {
         {
             ses_param_id = PAL_PARAM_ID_LOAD_SOUND_MODEL;
             if (!IS_MODULE_TYPE_PDK(module_type_)) {
-                /* Set payload data and size from engine's sound model info */
-                status = builder_->payloadSVAConfig(&payload, &payload_size,
-                    eng_sm_info_->GetModelData(), eng_sm_info_->GetModelSize(),
-                    detection_miid, param_id);
+                /* Lay out the payload around the engine's sound model */
+                model = eng_sm_info_->GetModelBlob();
+                if (model) {
+                    payload_lck = std::unique_lock<std::mutex>(model->GetPayloadLock());
+                    status = builder_->payloadSVAConfig(&payload, &payload_size,
+                        model.get(), detection_miid, param_id);
+                }
 
             } else {
-                status = builder_->payloadSVAConfig(&payload, &payload_size,
-                         sm_data_, sm_data_size_, detection_miid, param_id);
+                model = pdk_model_;
+                if (model) {
+                    payload_lck = std::unique_lock<std::mutex>(model->GetPayloadLock());
+                    status = builder_->payloadRegisterSoundModel(&payload,
+                             &payload_size, model.get(), pdk_model_id_,
+                             detection_miid, param_id);
+                }
             }
             break;
         }
@@ -2548,6 +2671,9 @@ int32_t SoundTriggerEngineGsl::UpdateSessionPayload(st_param_id_type_t param) {
         PAL_ERR(LOG_TAG, "Failed to set payload for param id %x, status = %d",
             ses_param_id, status);
     }
+    /* the session keeps its own copy */
+    if (!model)
+        free(payload);
 
     return status;
 }
@@ -2592,6 +2718,7 @@ void SoundTriggerEngineGsl::DetachStream(Stream *s, bool erase_engine) {
         auto iter = std::find(eng_streams_.begin(), eng_streams_.end(), s);
         if (iter != eng_streams_.end())
             eng_streams_.erase(iter);
+        sm_hashes_.erase(s);
     }
     if (!eng_streams_.size() && erase_engine) {
         key = this->module_type_;
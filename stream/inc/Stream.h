@@ -79,6 +79,7 @@
 #include <condition_variable>
 #endif
 #include "PalCommon.h"
+#include "PalOfflineClock.h"
 
 typedef enum {
     DATA_MODE_SHMEM = 0,
@@ -204,6 +205,8 @@ protected:
     bool mutexLockedbyRm = false;
     bool mDutyCycleEnable = false;
     sem_t mInUse;
+    /* paces io and keeps the position while the sound card is offline */
+    PalOfflineClock mOfflineClock;
     int connectToDefaultDevice(Stream* streamHandle, uint32_t dir);
 public:
     virtual ~Stream() {};
@@ -233,10 +236,14 @@ public:
     virtual int32_t flush() {return 0;}
     virtual int32_t suspend() {return 0;}
     virtual int32_t read(struct pal_buffer *buf) = 0;
+    /* sizes[i] is set for each buffer processed, returns the number of
+     * buffers processed or an error if none was */
+    virtual int32_t readv(struct pal_buffer *bufs, uint32_t count, ssize_t *sizes);
 
     virtual int32_t addRemoveEffect(pal_audio_effect_t effect, bool enable) = 0; //TBD: make this non virtual and prrovide implementation as StreamPCM and StreamCompressed are doing the same things
     virtual int32_t setParameters(uint32_t param_id, void *payload) = 0;
     virtual int32_t write(struct pal_buffer *buf) = 0; //TBD: make this non virtual and prrovide implementation as StreamPCM and StreamCompressed are doing the same things
+    virtual int32_t writev(struct pal_buffer *bufs, uint32_t count, ssize_t *sizes);
     virtual int32_t registerCallBack(pal_stream_callback cb, uint64_t cookie) = 0;
     virtual int32_t getCallBack(pal_stream_callback *cb) = 0;
     virtual int32_t getParameters(uint32_t param_id, void **payload) = 0;
@@ -247,6 +254,9 @@ public:
     virtual int32_t createMmapBuffer(int32_t min_size_frames __unused,
                                    struct pal_mmap_buffer *info __unused) {return -EINVAL;}
     virtual int32_t GetMmapPosition(struct pal_mmap_position *position __unused) {return -EINVAL;}
+    /* duration of the data written, on the epoch of getTimestamp; caller holds
+     * the stream mutex */
+    virtual int32_t getWrittenDuration(uint64_t *us __unused) {return -EINVAL;}
     virtual int32_t getTagsWithModuleInfo(size_t *size __unused, uint8_t *payload __unused) {return -EINVAL;};
     virtual bool ConfigSupportLPI() {return true;}; //Only LPI streams can update their vote to NLPI
     int32_t getStreamAttributes(struct pal_stream_attributes *sattr);
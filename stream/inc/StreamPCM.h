@@ -61,6 +61,8 @@ public:
    int32_t addRemoveEffect(pal_audio_effect_t effect, bool enable) override;
    int32_t read(struct pal_buffer *buf) override;
    int32_t write(struct pal_buffer *buf) override;
+   int32_t readv(struct pal_buffer *bufs, uint32_t count, ssize_t *sizes) override;
+   int32_t writev(struct pal_buffer *bufs, uint32_t count, ssize_t *sizes) override;
    int32_t registerCallBack(pal_stream_callback cb, uint64_t cookie) override;
    int32_t getCallBack(pal_stream_callback *cb) override;
    int32_t getParameters(uint32_t param_id, void **payload) override;
@@ -72,13 +74,17 @@ public:
    int32_t createMmapBuffer(int32_t min_size_frames,
                                    struct pal_mmap_buffer *info) override;
    int32_t GetMmapPosition(struct pal_mmap_position *position) override;
+   int32_t getWrittenDuration(uint64_t *us) override;
 
    static int32_t isSampleRateSupported(uint32_t sampleRate);
    static int32_t isChannelSupported(uint32_t numChannels);
    static int32_t isBitWidthSupported(uint32_t bitWidth);
 
 private:
+    /* re-registers the devices when written to after pause */
+    void restartOnWrite();
     uint32_t volRampPeriodms;
+    uint64_t mWrittenFrames;
 };
 
 #endif//STREAMPCM_H_
@@ -42,6 +42,7 @@
 #include "PalRingBuffer.h"
 #include "SoundTriggerEngine.h"
 #include "VoiceUIPlatformInfo.h"
+#include "VUILatencyTracer.h"
 
 enum {
     ENGINE_IDLE  = 0x0,
@@ -174,6 +175,7 @@ public:
     uint32_t GetHistBufDuration() { return hist_buf_duration_; }
     uint32_t GetPreRollDuration() { return pre_roll_duration_; }
     uint32_t GetModelId(){ return model_id_; }
+    VUILatencyTracer *GetLatencyTracer() { return &latency_tracer_; }
     void SetModelId(uint32_t model_id) { model_id_ = model_id; }
     bool GetLPIEnabled() { return use_lpi_; }
     uint32_t GetInstanceId();
@@ -515,16 +517,13 @@ private:
 
     int32_t notifyClient(bool detection);
 
-    static void TimerThread(StreamSoundTrigger& st_stream);
     void PostDelayedStop();
     void CancelDelayedStop();
     void InternalStopRecognition();
-    std::thread timer_thread_;
     std::mutex timer_mutex_;
-    std::condition_variable timer_start_cond_;
-    std::condition_variable timer_wait_cond_;
-    bool timer_stop_waiting_;
-    bool exit_timer_thread_;
+    /* deferred stop armed on the blocking PalExecutor, 0 if none */
+    uint64_t stop_timer_id_;
+    uint32_t stop_timer_seq_;
     bool pending_stop_;
     bool paused_;
     bool device_opened_;
@@ -586,5 +585,6 @@ private:
     // flag to indicate whether we should update common capture profile in RM
     bool common_cp_update_disable_;
     bool second_stage_processing_;
+    VUILatencyTracer latency_tracer_;
 };
 #endif // STREAMSOUNDTRIGGER_H_
@@ -38,6 +38,18 @@
 #include "ResourceManager.h"
 #include "Device.h"
 #include "Session.h"
+#include <chrono>
+#include <condition_variable>
+
+/* ramp down to mute takes 3 to 4 process calls at ADSP side */
+#define US_GAIN_RAMP_MS 20
+/* stop gives up waiting for the ramp down after this */
+#define US_GAIN_RAMP_TIMEOUT_MS 200
+
+typedef enum {
+    US_GAIN_SETTLED,
+    US_GAIN_RAMPING,   /* mute sent, target gain applied once ramped down */
+} us_gain_state_t;
 
 class StreamUltraSound : public StreamCommon
 {
@@ -52,8 +64,16 @@ public:
    int32_t stop();
    int32_t setUltraSoundGain_l(pal_ultrasound_gain_t new_gain);
    int32_t setUltraSoundGain(pal_ultrasound_gain_t new_gain);
+   /* true if gain is muted and no ramp is in flight */
+   bool isGainMuted_l();
 private:
+    void onGainRampDone(uint32_t seq);
     pal_ultrasound_gain_t gain;
+    us_gain_state_t gainState;
+    pal_ultrasound_gain_t pendingGain;
+    uint32_t gainRampSeq;
+    std::condition_variable gainRampCv;
+    uint64_t gainSeqStartUs;
     static void HandleCallBack(uint64_t hdl, uint32_t event_id,
                                void *data, uint32_t event_size, uint32_t miid);
     void HandleEvent(uint32_t event_id, void *data, uint32_t event_size);
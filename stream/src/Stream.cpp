@@ -77,6 +77,7 @@
 #include "ResourceManager.h"
 #include "Device.h"
 #include "USBAudio.h"
+#include "PalSpanTracer.h"
 
 std::shared_ptr<ResourceManager> Stream::rm = nullptr;
 std::mutex Stream::mBaseStreamMutex;
@@ -354,6 +355,36 @@ exit:
     return status;
 }
 
+int32_t Stream::readv(struct pal_buffer *bufs, uint32_t count, ssize_t *sizes)
+{
+    int32_t ret = 0;
+    uint32_t i = 0;
+
+    for (i = 0; i < count; i++) {
+        ret = read(&bufs[i]);
+        if (ret < 0)
+            break;
+        sizes[i] = ret;
+    }
+
+    return i ? (int32_t)i : ret;
+}
+
+int32_t Stream::writev(struct pal_buffer *bufs, uint32_t count, ssize_t *sizes)
+{
+    int32_t ret = 0;
+    uint32_t i = 0;
+
+    for (i = 0; i < count; i++) {
+        ret = write(&bufs[i]);
+        if (ret < 0)
+            break;
+        sizes[i] = ret;
+    }
+
+    return i ? (int32_t)i : ret;
+}
+
 int32_t Stream::getEffectParameters(void *effect_query)
 {
     int32_t status = 0;
@@ -826,12 +857,21 @@ bool Stream::isStreamAudioOutFmtSupported(pal_audio_fmt_t format)
 int32_t Stream::getTimestamp(struct pal_session_time *stime)
 {
     int32_t status = 0;
+    uint64_t us = 0;
+
     if (!stime) {
         status = -EINVAL;
         PAL_ERR(LOG_TAG, "Invalid session time pointer, status %d", status);
         goto exit;
     }
-    if (rm->cardState == CARD_STATUS_OFFLINE) {
+    if (rm->cardState == CARD_STATUS_OFFLINE || cachedState != STREAM_IDLE) {
+        /* streams paced while offline report their virtual position */
+        if (mOfflineClock.getPosition(&us)) {
+            memset(stime, 0, sizeof(*stime));
+            stime->session_time.value_lsw = (uint32_t)us;
+            stime->session_time.value_msw = (uint32_t)(us >> 32);
+            goto exit;
+        }
         status = -EINVAL;
         PAL_ERR(LOG_TAG, "Sound card offline, status %d", status);
         goto exit;
@@ -839,7 +879,13 @@ int32_t Stream::getTimestamp(struct pal_session_time *stime)
     rm->lockResourceManagerMutex();
     status = session->getTimestamp(stime);
     rm->unlockResourceManagerMutex();
-    if (0 != status) {
+    if (0 == status) {
+        us = ((uint64_t)stime->session_time.value_msw << 32) |
+             stime->session_time.value_lsw;
+        us = mOfflineClock.adjust(us);
+        stime->session_time.value_lsw = (uint32_t)us;
+        stime->session_time.value_msw = (uint32_t)(us >> 32);
+    } else {
         PAL_ERR(LOG_TAG, "Failed to get session timestamp status %d", status);
         if (errno == -ENETRESET &&
             rm->cardState != CARD_STATUS_OFFLINE) {
@@ -1395,6 +1441,7 @@ case 7
 */
 int32_t Stream::switchDevice(Stream* streamHandle, uint32_t numDev, struct pal_device *newDevices)
 {
+    PAL_TRACE_SPAN("Stream::switchDevice");
     int32_t status = 0;
     int32_t connectCount = 0, disconnectCount = 0;
     bool isNewDeviceA2dp = false;
@@ -39,6 +39,7 @@
 #include "ResourceManager.h"
 #include "Device.h"
 #include "kvh2xml.h"
+#include "PalExecutor.h"
 
 StreamACD::StreamACD(struct pal_stream_attributes *sattr,
                                        struct pal_device *dattr,
@@ -55,7 +56,6 @@ StreamACD::StreamACD(struct pal_stream_attributes *sattr,
     paused_ = false;
     device_opened_ = false;
     currentState = STREAM_IDLE;
-    exit_thread_ = false;
     acd_idle_ = nullptr;
     acd_loaded_ = nullptr;
     acd_active = nullptr;
@@ -116,12 +116,6 @@ StreamACD::StreamACD(struct pal_stream_attributes *sattr,
         throw std::runtime_error("ACD not enabled, exiting");
     }
 
-    notification_thread_handler_ = std::thread(EventNotificationThread, this);
-    if (!notification_thread_handler_.joinable()) {
-        PAL_ERR(LOG_TAG, "Error:%d failed to create notification thread",
-                -EINVAL);
-        throw std::runtime_error("failed to create notification thread");
-    }
     rm->registerStream(this);
 
     // Create internal states
@@ -168,14 +162,7 @@ exit:
 StreamACD::~StreamACD()
 {
     acd_states_.clear();
-    exit_thread_ = true;
-    if (notification_thread_handler_.joinable()) {
-        std::unique_lock<std::mutex> lck(mutex_);
-        cv_.notify_one();
-        lck.unlock();
-        notification_thread_handler_.join();
-        PAL_INFO(LOG_TAG, "Thread joined");
-    }
+    PalExecutor::getBlockingInstance()->cancel(this);
 
     rm->deregisterStream(this);
     if (mStreamAttr) {
@@ -558,8 +545,8 @@ notify:
         ev_payload = NULL;
         mutex_.lock();
         notificationInProgress = false;
-        /* If mutex_ lock is acquired by other thread handling detection event before
-         * this thread, then cv_.notify_one will not be handled. Handle it here and
+        /* If a detection event is cached while the client callback is running,
+         * no notification is posted for it. Handle it here and
          * notify client if there is pending notification to be sent to client.
          */
         if (deferredNotification == true && cached_event_data_ != NULL) {
@@ -987,24 +974,15 @@ exit:
     return status;
 }
 
-void StreamACD::EventNotificationThread(StreamACD *stream)
+void StreamACD::PostEventNotification()
 {
-    PAL_DBG(LOG_TAG, "Enter. start thread loop");
-
-    std::unique_lock<std::mutex> lck(stream->mutex_);
-    while (!stream->exit_thread_) {
-        PAL_DBG(LOG_TAG, "waiting on cond");
-        stream->cv_.wait(lck);
-        PAL_INFO(LOG_TAG, "Received start recognition");
-
-        if (stream->exit_thread_) {
-            PAL_DBG(LOG_TAG, "Exit thread");
-            break;
-        }
-
-        stream->SendCachedEventData();
-    }
-    PAL_DBG(LOG_TAG, "Exit");
+    PAL_DBG(LOG_TAG, "post cached event notification");
+    PalExecutor::getBlockingInstance()->post(this, [this]() {
+        std::unique_lock<std::mutex> lck(mutex_);
+        /* the event may have been sent already by a deferred notification */
+        if (cached_event_data_)
+            SendCachedEventData();
+    });
 }
 
 int32_t StreamACD::ACDIdle::ProcessEvent(
@@ -1217,7 +1195,7 @@ int32_t StreamACD::ACDLoaded::ProcessEvent(
                 acd_stream_.state_for_restore_ = ACD_STATE_NONE;
             } else if (acd_stream_.cached_event_data_) {
                 std::unique_lock<std::mutex> lck(acd_stream_.mutex_);
-                acd_stream_.cv_.notify_one();
+                acd_stream_.PostEventNotification();
                 TransitTo(ACD_STATE_DETECTED);
             }
             break;
@@ -1445,7 +1423,7 @@ int32_t StreamACD::ACDActive::ProcessEvent(
                 if (acd_stream_.notificationInProgress == true)
                     acd_stream_.deferredNotification = true;
                 else
-                    acd_stream_.cv_.notify_one();
+                    acd_stream_.PostEventNotification();
                 TransitTo(ACD_STATE_DETECTED);
             }
             break;
@@ -1728,7 +1706,7 @@ int32_t StreamACD::ACDDetected::ProcessEvent(
                 if (acd_stream_.notificationInProgress == true)
                     acd_stream_.deferredNotification = true;
                 else
-                    acd_stream_.cv_.notify_one();
+                    acd_stream_.PostEventNotification();
             } else {
                 TransitTo(ACD_STATE_ACTIVE);
             }
@@ -1898,7 +1876,7 @@ int32_t StreamACD::ACDSSR::ProcessEvent(std::shared_ptr<ACDEventConfig> ev_cfg)
                 if ((acd_stream_.state_for_restore_ == ACD_STATE_DETECTED) &&
                     (acd_stream_.cached_event_data_ != NULL)) {
                     std::unique_lock<std::mutex> lck(acd_stream_.mutex_);
-                    acd_stream_.cv_.notify_one();
+                    acd_stream_.PostEventNotification();
                 } else {
                     acd_stream_.state_for_restore_ = ACD_STATE_ACTIVE;
                 }
@@ -50,7 +50,7 @@ StreamCommon::StreamCommon(const struct pal_stream_attributes *sattr, struct pal
 
     if (rm->cardState == CARD_STATUS_OFFLINE) {
         PAL_ERR(LOG_TAG, "Error:Sound card offline, can not create stream");
-        usleep(SSR_RECOVERY);
+        rm->waitForCardOnline(SSR_RECOVERY);
         mStreamMutex.unlock();
         throw std::runtime_error("Sound card offline");
     }
@@ -211,7 +211,7 @@ int32_t  StreamCommon::open()
     mStreamMutex.lock();
     if (rm->cardState == CARD_STATUS_OFFLINE) {
         PAL_ERR(LOG_TAG, "Error:Sound card offline, can not open stream");
-        usleep(SSR_RECOVERY);
+        rm->waitForCardOnline(SSR_RECOVERY);
         status = -EIO;
         goto exit;
     }
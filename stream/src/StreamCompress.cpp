@@ -73,7 +73,7 @@ StreamCompress::StreamCompress(const struct pal_stream_attributes *sattr, struct
 
     if (rm->cardState == CARD_STATUS_OFFLINE) {
         PAL_ERR(LOG_TAG, "Sound card offline, can not create stream");
-        usleep(SSR_RECOVERY);
+        rm->waitForCardOnline(SSR_RECOVERY);
         mStreamMutex.unlock();
         throw std::runtime_error("Sound card offline");
     }
@@ -164,7 +164,7 @@ int32_t StreamCompress::open()
     if (rm->cardState == CARD_STATUS_OFFLINE) {
         status = -EIO;
         PAL_ERR(LOG_TAG, "Sound card offline, can not open stream");
-        usleep(SSR_RECOVERY);
+        rm->waitForCardOnline(SSR_RECOVERY);
         goto exit;
     }
 
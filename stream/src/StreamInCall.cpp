@@ -49,7 +49,7 @@ StreamInCall::StreamInCall(const struct pal_stream_attributes *sattr, struct pal
 
     if (rm->cardState == CARD_STATUS_OFFLINE) {
         PAL_ERR(LOG_TAG, "Sound card offline, can not create stream");
-        usleep(SSR_RECOVERY);
+        rm->waitForCardOnline(SSR_RECOVERY);
         mStreamMutex.unlock();
         throw std::runtime_error("Sound card offline");
     }
@@ -133,7 +133,7 @@ int32_t  StreamInCall::open()
     mStreamMutex.lock();
     if (rm->cardState == CARD_STATUS_OFFLINE) {
         PAL_ERR(LOG_TAG, "Sound card offline, can not open stream");
-        usleep(SSR_RECOVERY);
+        rm->waitForCardOnline(SSR_RECOVERY);
         status = -EIO;
         goto exit;
     }
@@ -323,6 +323,10 @@ int32_t StreamInCall::stop()
     PAL_DBG(LOG_TAG, "Enter. session handle - %pK mStreamAttr->direction - %d state %d",
                 session, mStreamAttr->direction, currentState);
 
+    /* a stop by the client restarts the position, a stop for SSR keeps it */
+    if (rm->cardState != CARD_STATUS_OFFLINE && cachedState == STREAM_IDLE)
+        mOfflineClock.reset();
+
     if (currentState == STREAM_STARTED || currentState == STREAM_PAUSED) {
         switch (mStreamAttr->direction) {
         case PAL_AUDIO_OUTPUT:
@@ -477,6 +481,7 @@ int32_t  StreamInCall::read(struct pal_buffer* buf)
 {
     int32_t status = 0;
     int32_t size;
+    uint64_t deadlineNs = 0;
     PAL_VERBOSE(LOG_TAG, "Enter. session handle - %pK, state %d",
             session, currentState);
 
@@ -497,15 +502,21 @@ int32_t  StreamInCall::read(struct pal_buffer* buf)
         }
         size = buf->size;
         memset(buf->buffer, 0, size);
-        usleep((uint64_t)size * 1000000 / streamSize / sampleRate);
+        deadlineNs = mOfflineClock.advance(size / streamSize, sampleRate);
+        mStreamMutex.unlock();
+        /* paced without the stream lock so control calls are not held up */
+        PalOfflineClock::sleepUntil(deadlineNs);
         PAL_DBG(LOG_TAG, "Sound card offline, dropped buffer size - %d", size);
-        status = size;
-        goto exit;
+        return size;
     }
 
+    mOfflineClock.online();
     if (currentState == STREAM_STARTED) {
         status = session->read(this, SHMEM_ENDPOINT, buf, &size);
         if (0 != status) {
+            /* non-blocking stream without a captured period */
+            if (status == -EAGAIN)
+                goto exit;
             PAL_ERR(LOG_TAG, "session read is failed with status %d", status);
             if (errno == -ENETRESET &&
                 rm->cardState != CARD_STATUS_OFFLINE) {
@@ -547,6 +558,7 @@ int32_t  StreamInCall::write(struct pal_buffer* buf)
     uint32_t byteWidth = 0;
     uint32_t sampleRate = 0;
     uint32_t channelCount = 0;
+    uint64_t deadlineNs = 0;
 
     PAL_VERBOSE(LOG_TAG, "Enter. session handle - %pK, state %d",
             session, currentState);
@@ -566,16 +578,23 @@ int32_t  StreamInCall::write(struct pal_buffer* buf)
             return -EINVAL;
         }
         size = buf->size;
-        usleep((uint64_t)size * 1000000 / frameSize / sampleRate);
-        PAL_DBG(LOG_TAG, "dropped buffer size - %d", size);
+        deadlineNs = mOfflineClock.advance(size / frameSize, sampleRate);
         mStreamMutex.unlock();
+        /* paced without the stream lock so control calls are not held up */
+        PalOfflineClock::sleepUntil(deadlineNs);
+        PAL_DBG(LOG_TAG, "dropped buffer size - %d", size);
         PAL_VERBOSE(LOG_TAG, "Exit size: %d", size);
         return size;
     }
 
+    mOfflineClock.online();
     if (currentState == STREAM_STARTED) {
         status = session->write(this, SHMEM_ENDPOINT, buf, &size, 0);
         mStreamMutex.unlock();
+        if (status == -EAGAIN) {
+            PAL_VERBOSE(LOG_TAG, "Exit. non-blocking write, no period free");
+            return status;
+        }
         if (0 != status) {
             PAL_ERR(LOG_TAG, "session write is failed with status %d", status);
 
@@ -626,9 +645,16 @@ int32_t  StreamInCall::getCallBack(pal_stream_callback * /*cb*/)
     return 0;
 }
 
-int32_t StreamInCall::getParameters(uint32_t /*param_id*/, void ** /*payload*/)
+int32_t StreamInCall::getParameters(uint32_t param_id, void **payload)
 {
-    return 0;
+    int32_t status = 0;
+
+    if (param_id == PAL_PARAM_ID_STREAM_READY_FD) {
+        std::lock_guard<std::mutex> lck(mStreamMutex);
+        status = session->getParameters(this, 0, param_id, payload);
+    }
+
+    return status;
 }
 
 int32_t  StreamInCall::setParameters(uint32_t param_id, void *payload)
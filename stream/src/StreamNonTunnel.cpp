@@ -65,7 +65,7 @@ StreamNonTunnel::StreamNonTunnel(const struct pal_stream_attributes *sattr, stru
 
     if (rm->cardState == CARD_STATUS_OFFLINE) {
         PAL_ERR(LOG_TAG, "Sound card offline, can not create stream");
-        usleep(SSR_RECOVERY);
+        rm->waitForCardOnline(SSR_RECOVERY);
         mStreamMutex.unlock();
         throw std::runtime_error("Sound card offline");
     }
@@ -144,7 +144,7 @@ int32_t  StreamNonTunnel::open()
     mStreamMutex.lock();
     if (rm->cardState == CARD_STATUS_OFFLINE || ssrInNTMode == true) {
         PAL_ERR(LOG_TAG, "Sound card offline, can not open stream");
-        usleep(SSR_RECOVERY);
+        rm->waitForCardOnline(SSR_RECOVERY);
         status = -ENETRESET;
         goto exit;
     }
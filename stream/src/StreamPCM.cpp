@@ -52,7 +52,7 @@ StreamPCM::StreamPCM(const struct pal_stream_attributes *sattr, struct pal_devic
 
     if (rm->cardState == CARD_STATUS_OFFLINE) {
         PAL_ERR(LOG_TAG, "Sound card offline, can not create stream");
-        usleep(SSR_RECOVERY);
+        rm->waitForCardOnline(SSR_RECOVERY);
         mStreamMutex.unlock();
         throw std::runtime_error("Sound card offline");
     }
@@ -65,6 +65,7 @@ StreamPCM::StreamPCM(const struct pal_stream_attributes *sattr, struct pal_devic
     currentState = STREAM_IDLE;
     //Modify cached values only at time of SSR down.
     cachedState = STREAM_IDLE;
+    mWrittenFrames = 0;
     bool isDeviceConfigUpdated = false;
 
     PAL_DBG(LOG_TAG, "Enter");
@@ -179,7 +180,7 @@ int32_t  StreamPCM::open()
     mStreamMutex.lock();
     if (rm->cardState == CARD_STATUS_OFFLINE) {
         PAL_ERR(LOG_TAG, "Sound card offline, can not open stream");
-        usleep(SSR_RECOVERY);
+        rm->waitForCardOnline(SSR_RECOVERY);
         status = -EIO;
         goto exit;
     }
@@ -386,6 +387,7 @@ int32_t StreamPCM::start()
     }
 
     if (currentState == STREAM_INIT || currentState == STREAM_STOPPED) {
+        mWrittenFrames = 0;
         switch (mStreamAttr->direction) {
         case PAL_AUDIO_OUTPUT:
             PAL_VERBOSE(LOG_TAG, "Inside PAL_AUDIO_OUTPUT device count - %zu",
@@ -658,6 +660,10 @@ int32_t StreamPCM::stop()
     PAL_DBG(LOG_TAG, "Enter. session handle - %pK mStreamAttr->direction - %d state %d",
                 session, mStreamAttr->direction, currentState);
 
+    /* a stop by the client restarts the position, a stop for SSR keeps it */
+    if (rm->cardState != CARD_STATUS_OFFLINE && cachedState == STREAM_IDLE)
+        mOfflineClock.reset();
+
     if (currentState == STREAM_STARTED || currentState == STREAM_PAUSED) {
         mStreamMutex.unlock();
         rm->lockActiveStream();
@@ -902,6 +908,7 @@ int32_t  StreamPCM::read(struct pal_buffer* buf)
 {
     int32_t status = 0;
     int32_t size;
+    uint64_t deadlineNs = 0;
     PAL_VERBOSE(LOG_TAG, "Enter. session handle - %pK, state %d",
             session, currentState);
 
@@ -922,15 +929,21 @@ int32_t  StreamPCM::read(struct pal_buffer* buf)
         }
         size = buf->size;
         memset(buf->buffer, 0, size);
-        usleep((uint64_t)size * 1000000 / streamSize / sampleRate);
+        deadlineNs = mOfflineClock.advance(size / streamSize, sampleRate);
+        mStreamMutex.unlock();
+        /* paced without the stream lock so control calls are not held up */
+        PalOfflineClock::sleepUntil(deadlineNs);
         PAL_DBG(LOG_TAG, "Sound card offline, dropped buffer size - %d", size);
-        status = size;
-        goto exit;
+        return size;
     }
 
+    mOfflineClock.online();
     if (currentState == STREAM_STARTED) {
         status = session->read(this, SHMEM_ENDPOINT, buf, &size);
         if (0 != status) {
+            /* non-blocking stream without a captured period */
+            if (status == -EAGAIN)
+                goto exit;
             PAL_ERR(LOG_TAG, "session read is failed with status %d", status);
             if (errno == -ENETRESET &&
                 rm->cardState != CARD_STATUS_OFFLINE) {
@@ -971,6 +984,7 @@ int32_t StreamPCM::write(struct pal_buffer* buf)
     uint32_t byteWidth = 0;
     uint32_t sampleRate = 0;
     uint32_t channelCount = 0;
+    uint64_t deadlineNs = 0;
 
     PAL_VERBOSE(LOG_TAG, "Enter. session handle - %pK, state %d",
             session, currentState);
@@ -991,18 +1005,29 @@ int32_t StreamPCM::write(struct pal_buffer* buf)
             goto exit;
         }
         size = buf->size;
-        usleep((uint64_t)size * 1000000 / frameSize / sampleRate);
-        PAL_DBG(LOG_TAG, "dropped buffer size - %d", size);
+        deadlineNs = mOfflineClock.advance(size / frameSize, sampleRate);
         mStreamMutex.unlock();
+        /* paced without the stream lock so control calls are not held up */
+        PalOfflineClock::sleepUntil(deadlineNs);
+        PAL_DBG(LOG_TAG, "dropped buffer size - %d", size);
         PAL_VERBOSE(LOG_TAG, "Exit size: %d", size);
         return size;
     }
 
+    mOfflineClock.online();
     // we should allow writes to go through in Start/Pause state as well.
     if ((currentState == STREAM_STARTED) ||
         (currentState == STREAM_PAUSED) ) {
         status = session->write(this, SHMEM_ENDPOINT, buf, &size, 0);
+        frameSize = (mStreamAttr->out_media_config.bit_width / 8) *
+                    mStreamAttr->out_media_config.ch_info.channels;
+        if (0 == status && frameSize)
+            mWrittenFrames += size / frameSize;
         mStreamMutex.unlock();
+        if (status == -EAGAIN) {
+            PAL_VERBOSE(LOG_TAG, "Exit. non-blocking write, no period free");
+            return status;
+        }
         if (0 != status) {
             PAL_ERR(LOG_TAG, "session write is failed with status %d", status);
 
@@ -1024,14 +1049,7 @@ int32_t StreamPCM::write(struct pal_buffer* buf)
                 goto exit;
             }
         } else if (currentState == STREAM_PAUSED && !isPaused) {
-            rm->lockActiveStream();
-            mStreamMutex.lock();
-            for (int i = 0; i < mDevices.size(); i++) {
-                rm->registerDevice(mDevices[i], this);
-            }
-            mStreamMutex.unlock();
-            rm->unlockActiveStream();
-            currentState = STREAM_STARTED;
+            restartOnWrite();
         }
         PAL_VERBOSE(LOG_TAG, "Exit. session write successful size - %d", size);
         return size;
@@ -1051,6 +1069,118 @@ exit:
     return status;
 }
 
+void StreamPCM::restartOnWrite()
+{
+    rm->lockActiveStream();
+    mStreamMutex.lock();
+    for (int i = 0; i < mDevices.size(); i++) {
+        rm->registerDevice(mDevices[i], this);
+    }
+    mStreamMutex.unlock();
+    rm->unlockActiveStream();
+    currentState = STREAM_STARTED;
+}
+
+int32_t StreamPCM::readv(struct pal_buffer *bufs, uint32_t count, ssize_t *sizes)
+{
+    int32_t status = 0;
+    int32_t size = 0;
+    uint32_t i = 0;
+
+    PAL_VERBOSE(LOG_TAG, "Enter. session handle - %pK, state %d, %u buffers",
+            session, currentState, count);
+
+    mStreamMutex.lock();
+    if ((rm->cardState == CARD_STATUS_OFFLINE) || cachedState != STREAM_IDLE ||
+        currentState != STREAM_STARTED) {
+        mStreamMutex.unlock();
+        /* dropped and paced or failed per buffer as by read() */
+        return Stream::readv(bufs, count, sizes);
+    }
+
+    for (i = 0; i < count; i++) {
+        status = session->read(this, SHMEM_ENDPOINT, &bufs[i], &size);
+        if (0 != status)
+            break;
+        sizes[i] = size;
+        /* a non-blocking read ends the batch at a short buffer */
+        if ((size_t)size + bufs[i].offset < bufs[i].size) {
+            i++;
+            break;
+        }
+    }
+    mStreamMutex.unlock();
+
+    if (0 != status && -EAGAIN != status) {
+        PAL_ERR(LOG_TAG, "session read is failed with status %d", status);
+        if (errno == -ENETRESET &&
+            rm->cardState != CARD_STATUS_OFFLINE) {
+            PAL_ERR(LOG_TAG, "Sound card offline, informing RM");
+            rm->ssrHandler(CARD_STATUS_OFFLINE);
+        }
+        if (rm->cardState == CARD_STATUS_OFFLINE) {
+            for (; i < count; i++)
+                sizes[i] = bufs[i].size;
+            PAL_DBG(LOG_TAG, "dropped buffers from the failed one");
+        }
+    }
+
+    PAL_VERBOSE(LOG_TAG, "Exit. %u buffers read", i);
+    return i ? (int32_t)i : status;
+}
+
+int32_t StreamPCM::writev(struct pal_buffer *bufs, uint32_t count, ssize_t *sizes)
+{
+    int32_t status = 0;
+    uint32_t frameSize = 0;
+    uint32_t done = 0;
+    std::vector<int> written(count, 0);
+
+    PAL_VERBOSE(LOG_TAG, "Enter. session handle - %pK, state %d, %u buffers",
+            session, currentState, count);
+
+    mStreamMutex.lock();
+    if (rm->cardState == CARD_STATUS_OFFLINE || cachedState != STREAM_IDLE ||
+        (currentState != STREAM_STARTED && currentState != STREAM_PAUSED)) {
+        mStreamMutex.unlock();
+        /* dropped and paced or failed per buffer as by write() */
+        return Stream::writev(bufs, count, sizes);
+    }
+
+    status = session->writev(this, SHMEM_ENDPOINT, bufs, count, written.data(),
+                             &done, 0);
+    frameSize = (mStreamAttr->out_media_config.bit_width / 8) *
+                mStreamAttr->out_media_config.ch_info.channels;
+    for (uint32_t i = 0; i < done; i++) {
+        sizes[i] = written[i];
+        if (frameSize)
+            mWrittenFrames += written[i] / frameSize;
+    }
+    mStreamMutex.unlock();
+
+    if (0 != status && -EAGAIN != status) {
+        PAL_ERR(LOG_TAG, "session write is failed with status %d", status);
+
+        /* ENETRESET is the error code returned by AGM during SSR */
+        if (errno == -ENETRESET &&
+            rm->cardState != CARD_STATUS_OFFLINE) {
+            PAL_ERR(LOG_TAG, "Sound card offline, informing RM");
+            rm->ssrHandler(CARD_STATUS_OFFLINE);
+        }
+        if (rm->cardState == CARD_STATUS_OFFLINE) {
+            for (; done < count; done++)
+                sizes[done] = bufs[done].size;
+            PAL_DBG(LOG_TAG, "dropped buffers from the failed one");
+        }
+    }
+
+    if (done && currentState == STREAM_PAUSED && !isPaused)
+        restartOnWrite();
+
+    PAL_VERBOSE(LOG_TAG, "Exit. %u buffers written", done);
+    return done ? (int32_t)done : status;
+}
+
 int32_t  StreamPCM::registerCallBack(pal_stream_callback /*cb*/, uint64_t /*cookie*/)
 {
     return 0;
@@ -1061,9 +1191,16 @@ int32_t  StreamPCM::getCallBack(pal_stream_callback * /*cb*/)
     return 0;
 }
 
-int32_t StreamPCM::getParameters(uint32_t /*param_id*/, void ** /*payload*/)
+int32_t StreamPCM::getParameters(uint32_t param_id, void **payload)
 {
-    return 0;
+    int32_t status = 0;
+
+    if (param_id == PAL_PARAM_ID_STREAM_READY_FD) {
+        std::lock_guard<std::mutex> lck(mStreamMutex);
+        status = session->getParameters(this, 0, param_id, payload);
+    }
+
+    return status;
 }
 
 int32_t  StreamPCM::setParameters(uint32_t param_id, void *payload)
@@ -1695,6 +1832,22 @@ exit:
     return status;
 }
 
+int32_t StreamPCM::getWrittenDuration(uint64_t *us)
+{
+    uint32_t sampleRate = mStreamAttr->out_media_config.sample_rate;
+
+    if (!us || !sampleRate || mStreamAttr->direction != PAL_AUDIO_OUTPUT)
+        return -EINVAL;
+
+    /*
+     * mWrittenFrames restarts with the session after SSR, as the session
+     * time does; getTimestamp adds the offline position to the latter, so
+     * add it here too to compare both on the same epoch.
+     */
+    *us = mOfflineClock.getOffset() + mWrittenFrames * 1000000 / sampleRate;
+    return 0;
+}
+
 int32_t StreamPCM::GetMmapPosition(struct pal_mmap_position *position)
 {
     int32_t status = 0;
@@ -108,7 +108,7 @@ int32_t StreamSensorPCMData::open()
     std::lock_guard<std::mutex> lck(mStreamMutex);
     if (rm->cardState == CARD_STATUS_OFFLINE) {
         PAL_ERR(LOG_TAG, "Error:Sound card offline, can not open stream");
-        usleep(SSR_RECOVERY);
+        rm->waitForCardOnline(SSR_RECOVERY);
         status = -EIO;
         goto exit;
     }
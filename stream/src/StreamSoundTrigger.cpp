@@ -73,6 +73,7 @@
 #include "Device.h"
 #include "kvh2xml.h"
 #include "VoiceUIInterface.h"
+#include "PalExecutor.h"
 
 // TODO: find another way to print debug logs by default
 #define ST_DBG_LOGS
@@ -106,6 +107,8 @@ StreamSoundTrigger::StreamSoundTrigger(struct pal_stream_attributes *sattr,
     paused_ = false;
     device_opened_ = false;
     pending_stop_ = false;
+    stop_timer_id_ = 0;
+    stop_timer_seq_ = 0;
     currentState = STREAM_IDLE;
     capture_requested_ = false;
     hist_buf_duration_ = 0;
@@ -227,27 +230,13 @@ StreamSoundTrigger::StreamSoundTrigger(struct pal_stream_attributes *sattr,
         paused_ = true;
     }
 
-    timer_thread_ = std::thread(TimerThread, std::ref(*this));
-    timer_stop_waiting_ = false;
-    exit_timer_thread_ = false;
-
     PAL_DBG(LOG_TAG, "Exit");
 }
 
 StreamSoundTrigger::~StreamSoundTrigger() {
+    /* the deferred stop takes mStreamMutex, cancel it before locking */
+    PalExecutor::getBlockingInstance()->cancel(this);
     mStreamMutex.lock();
-    {
-        std::lock_guard<std::mutex> lck(timer_mutex_);
-        exit_timer_thread_ = true;
-        timer_stop_waiting_ = true;
-        timer_wait_cond_.notify_one();
-        timer_start_cond_.notify_one();
-    }
-    if (timer_thread_.joinable()) {
-        PAL_DBG(LOG_TAG, "Join timer thread");
-        timer_thread_.join();
-    }
-
     st_states_.clear();
     engines_.clear();
     mStreamMutex.unlock();
@@ -415,6 +404,10 @@ int32_t StreamSoundTrigger::read(struct pal_buffer* buf) {
     std::shared_ptr<StEventConfig> ev_cfg(
         new StReadBufferEventConfig((void *)buf));
     size = cur_state_->ProcessEvent(ev_cfg);
+    if (size > 0 && latency_tracer_.IsOpen()) {
+        latency_tracer_.Mark(PAL_ST_TRACE_LAB_FIRST_READ);
+        latency_tracer_.End();
+    }
 
     vui_intf_->ProcessLab(buf->buffer, size);
 
@@ -527,6 +520,50 @@ release:
                 status = ret;
             }
         }
+    } else if (param_id == PAL_PARAM_ID_ST_DETECTION_LATENCY) {
+        pal_payload = (pal_param_payload *)(*payload);
+        if (!pal_payload ||
+            pal_payload->payload_size != sizeof(struct pal_param_st_latency_stats)) {
+            PAL_ERR(LOG_TAG, "Invalid payload for detection latency");
+            return -EINVAL;
+        }
+        latency_tracer_.GetStats(
+            (struct pal_param_st_latency_stats *)pal_payload->payload);
+    } else if (param_id == PAL_PARAM_ID_ST_ENGINE_ARENA_STATS) {
+        pal_payload = (pal_param_payload *)(*payload);
+        if (!pal_payload ||
+            pal_payload->payload_size != sizeof(struct pal_param_st_arena_stats)) {
+            PAL_ERR(LOG_TAG, "Invalid payload for arena stats");
+            return -EINVAL;
+        }
+        void *stats = (void *)pal_payload->payload;
+
+        memset(stats, 0, sizeof(struct pal_param_st_arena_stats));
+        std::lock_guard<std::mutex> lck(mStreamMutex);
+        for (auto &eng : engines_) {
+            ret = eng->GetEngine()->GetParameters(param_id, &stats);
+            if (ret)
+                PAL_ERR(LOG_TAG, "Failed to get arena stats from engine %d",
+                        eng->GetEngineId());
+        }
+    } else if (param_id == PAL_PARAM_ID_ST_MERGE_CACHE_STATS) {
+        pal_payload = (pal_param_payload *)(*payload);
+        if (!pal_payload ||
+            pal_payload->payload_size != sizeof(struct pal_param_st_merge_cache_stats)) {
+            PAL_ERR(LOG_TAG, "Invalid payload for merge cache stats");
+            return -EINVAL;
+        }
+        void *stats = (void *)pal_payload->payload;
+
+        memset(stats, 0, sizeof(struct pal_param_st_merge_cache_stats));
+        std::lock_guard<std::mutex> lck(mStreamMutex);
+        if (!gsl_engine_) {
+            PAL_ERR(LOG_TAG, "No gsl engine present");
+            return -EINVAL;
+        }
+        status = gsl_engine_->GetParameters(param_id, &stats);
+        if (status)
+            PAL_ERR(LOG_TAG, "Failed to get merge cache stats, status %d", status);
     } else if (gsl_engine_) {
         status = gsl_engine_->GetParameters(param_id, payload);
         if (status)
@@ -878,6 +915,9 @@ int32_t StreamSoundTrigger::SetEngineDetectionState(int32_t det_type) {
     if (det_type == GMM_DETECTED) {
         rm->acquireWakeLock();
         reader_->updateState(READER_ENABLED);
+        latency_tracer_.Mark(PAL_ST_TRACE_FIRST_STAGE_DONE);
+    } else if (det_type & DETECTION_TYPE_SS) {
+        latency_tracer_.Mark(PAL_ST_TRACE_SECOND_STAGE_DONE);
     }
 
     std::shared_ptr<StEventConfig> ev_cfg(
@@ -917,41 +957,34 @@ void StreamSoundTrigger::InternalStopRecognition() {
     PAL_DBG(LOG_TAG, "Exit, status %d", status);
 }
 
-void StreamSoundTrigger::TimerThread(StreamSoundTrigger& st_stream) {
-    PAL_DBG(LOG_TAG, "Enter");
-
-    std::unique_lock<std::mutex> lck(st_stream.timer_mutex_);
-    while (!st_stream.exit_timer_thread_) {
-        st_stream.timer_start_cond_.wait(lck);
-        if (st_stream.exit_timer_thread_)
-            break;
-
-        st_stream.timer_wait_cond_.wait_for(lck,
-            std::chrono::milliseconds(ST_DEFERRED_STOP_DEALY_MS));
-
-        if (!st_stream.timer_stop_waiting_ && !st_stream.exit_timer_thread_) {
-            st_stream.timer_mutex_.unlock();
-            st_stream.InternalStopRecognition();
-            st_stream.timer_mutex_.lock();
-        }
-    }
-    PAL_DBG(LOG_TAG, "Exit");
-}
-
 void StreamSoundTrigger::PostDelayedStop() {
+    uint32_t seq = 0;
+
     PAL_VERBOSE(LOG_TAG, "Post Delayed Stop for %p", this);
     pending_stop_ = true;
     std::lock_guard<std::mutex> lck(timer_mutex_);
-    timer_stop_waiting_ = false;
-    timer_start_cond_.notify_one();
+    if (stop_timer_id_)
+        return;
+
+    seq = ++stop_timer_seq_;
+    stop_timer_id_ = PalExecutor::getBlockingInstance()->postDelayed(this,
+        ST_DEFERRED_STOP_DEALY_MS, [this, seq]() {
+            {
+                std::lock_guard<std::mutex> lck(timer_mutex_);
+                if (seq == stop_timer_seq_)
+                    stop_timer_id_ = 0;
+            }
+            InternalStopRecognition();
+        });
 }
 
 void StreamSoundTrigger::CancelDelayedStop() {
     PAL_VERBOSE(LOG_TAG, "Cancel Delayed stop for %p", this);
     pending_stop_ = false;
     std::lock_guard<std::mutex> lck(timer_mutex_);
-    timer_stop_waiting_ = true;
-    timer_wait_cond_.notify_one();
+    if (stop_timer_id_)
+        PalExecutor::getBlockingInstance()->cancelTimer(stop_timer_id_);
+    stop_timer_id_ = 0;
 }
 
 std::shared_ptr<SoundTriggerEngine> StreamSoundTrigger::HandleEngineLoad(
@@ -1565,6 +1598,10 @@ int32_t StreamSoundTrigger::notifyClient(bool detection) {
         PAL_INFO(LOG_TAG, "Notify detection event to client,"
             " total processing time: %llums",
             (long long)total_process_duration);
+        latency_tracer_.Mark(PAL_ST_TRACE_CLIENT_NOTIFIED);
+        /* keep the record open until the first LAB read if one follows */
+        if (!detection || !rec_config_->capture_requested)
+            latency_tracer_.End();
         mStreamMutex.unlock();
         callback_((pal_stream_handle_t *)this, 0, (uint32_t *)rec_event,
                   event_size, (uint64_t)rec_config_->cookie);
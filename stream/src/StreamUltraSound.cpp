@@ -38,8 +38,9 @@
 #include "SessionAlsaPcm.h"
 #include "ResourceManager.h"
 #include "Device.h"
+#include "PalExecutor.h"
+#include "PalSpanTracer.h"
 #include "us_detect_api.h"
-#include <unistd.h>
 
 StreamUltraSound::StreamUltraSound(const struct pal_stream_attributes *sattr __unused, struct pal_device *dattr __unused,
                     const uint32_t no_of_devices __unused, const struct modifier_kv *modifiers __unused,
@@ -47,12 +48,17 @@ StreamUltraSound::StreamUltraSound(const struct pal_stream_attributes *sattr __u
                   StreamCommon(sattr,dattr,no_of_devices,modifiers,no_of_modifiers,rm)
 {
     gain = PAL_ULTRASOUND_GAIN_MUTE;
+    gainState = US_GAIN_SETTLED;
+    pendingGain = PAL_ULTRASOUND_GAIN_MUTE;
+    gainRampSeq = 0;
+    gainSeqStartUs = 0;
     session->registerCallBack((session_callback)HandleCallBack,((uint64_t) this));
     rm->registerStream(this);
 }
 
 StreamUltraSound::~StreamUltraSound()
 {
+    PalExecutor::getInstance()->cancel(this);
     rm->resetStreamInstanceID(this);
     rm->deregisterStream(this);
 }
@@ -118,19 +124,18 @@ int32_t StreamUltraSound::stop()
     PAL_DBG(LOG_TAG, "Enter");
 
     if (rm->IsCustomGainEnabledForUPD()) {
-        mStreamMutex.lock();
+        std::unique_lock<std::mutex> lck(mStreamMutex);
         if (currentState == STREAM_STARTED || currentState == STREAM_PAUSED) {
 
             status = setUltraSoundGain_l(PAL_ULTRASOUND_GAIN_MUTE);
             if (0 != status) {
                 PAL_ERR(LOG_TAG, "Ultrasound set gain failed, status = %d", status);
             }
-            /* Currently configured value is 20ms which allows 3 to 4 process call
-             * to handle this value at ADSP side.
-             * Increase or decrease this dealy based on requirements */
-            usleep(20000);
+            /* wait for the ramp down with the stream lock released */
+            if (!gainRampCv.wait_for(lck, std::chrono::milliseconds(US_GAIN_RAMP_TIMEOUT_MS),
+                    [this] { return gainState == US_GAIN_SETTLED; }))
+                PAL_ERR(LOG_TAG, "Ultrasound gain ramp down timed out");
         }
-        mStreamMutex.unlock();
     }
 
     status = StreamCommon::stop();
@@ -232,6 +237,7 @@ int32_t StreamUltraSound::setUltraSoundGain_l(pal_ultrasound_gain_t new_gain)
 {
     int32_t status = 0;
     pal_ultrasound_gain_t mute = PAL_ULTRASOUND_GAIN_MUTE;
+    uint32_t seq = 0;
 
     if (!rm->IsCustomGainEnabledForUPD()) {
         PAL_ERR(LOG_TAG,"Custom Gain not enabled for UPD, returning");
@@ -240,37 +246,82 @@ int32_t StreamUltraSound::setUltraSoundGain_l(pal_ultrasound_gain_t new_gain)
 
     PAL_DBG(LOG_TAG, "Received request to set Ultrasound gain(%d)", new_gain);
 
-    if (gain != new_gain) {
-
-        if ((gain != PAL_ULTRASOUND_GAIN_MUTE) && (new_gain != PAL_ULTRASOUND_GAIN_MUTE)) {
-            /* For scanarios cases like, UPD followed by Music/Audio Playback,
-             * in order to avoid sending gain LOW follwed by HIGH directly,
-             * here we will send MUTE followed by some delay so module can rampdown
-             * previous gain first before applying new gain */
-            status = session->setParameters(this, TAG_ULTRASOUND_GAIN,
-                            PAL_PARAM_ID_ULTRASOUND_SET_GAIN, &mute);
-            if (status) {
-                PAL_ERR(LOG_TAG, "Error:%d, Failed to setParam for Ultrasound set gain",
-                        status);
-            }
-            gain = mute;
-            PAL_DBG(LOG_TAG, "Ultrasound gain(%d), configured successfully", gain);
+    if (US_GAIN_RAMPING == gainState) {
+        /* mute is still ramping down, only the latest target gets applied */
+        PAL_DBG(LOG_TAG, "Ultrasound gain ramping, target %d replaces %d",
+                new_gain, pendingGain);
+        pendingGain = new_gain;
+        return status;
+    }
 
-            /* Currently configured value is 20ms which allows 3 to 4 process call
-             * to handle this value at ADSP side.
-             * Increase or decrease this dealy based on requirements */
-            usleep(20000);
-        }
+    if (gain == new_gain) {
+        PAL_DBG(LOG_TAG, "Ultrasound gain(%d), already configured", gain);
+        return status;
+    }
 
-        status = session->setParameters(this, TAG_ULTRASOUND_GAIN, PAL_PARAM_ID_ULTRASOUND_SET_GAIN, &new_gain);
+    if (gain != PAL_ULTRASOUND_GAIN_MUTE) {
+        /* For scanarios cases like, UPD followed by Music/Audio Playback,
+         * in order to avoid sending gain LOW follwed by HIGH directly,
+         * here we will send MUTE first and apply the new gain from the
+         * executor once the module has ramped down the previous gain */
+        status = session->setParameters(this, TAG_ULTRASOUND_GAIN,
+                        PAL_PARAM_ID_ULTRASOUND_SET_GAIN, &mute);
         if (status) {
             PAL_ERR(LOG_TAG, "Error:%d, Failed to setParam for Ultrasound set gain",
                     status);
         }
-        gain = new_gain;
+        gain = mute;
         PAL_DBG(LOG_TAG, "Ultrasound gain(%d), configured successfully", gain);
-    } else {
-        PAL_DBG(LOG_TAG, "Ultrasound gain(%d), already configured", gain);
+
+        gainState = US_GAIN_RAMPING;
+        pendingGain = new_gain;
+        gainSeqStartUs = PalSpanTracer::nowUs();
+        seq = ++gainRampSeq;
+        PalExecutor::getInstance()->postDelayed(this, US_GAIN_RAMP_MS,
+                [this, seq] { onGainRampDone(seq); });
+        return status;
+    }
+
+    status = session->setParameters(this, TAG_ULTRASOUND_GAIN, PAL_PARAM_ID_ULTRASOUND_SET_GAIN, &new_gain);
+    if (status) {
+        PAL_ERR(LOG_TAG, "Error:%d, Failed to setParam for Ultrasound set gain",
+                status);
     }
+    gain = new_gain;
+    PAL_DBG(LOG_TAG, "Ultrasound gain(%d), configured successfully", gain);
     return status;
 }
+
+void StreamUltraSound::onGainRampDone(uint32_t seq)
+{
+    std::lock_guard<std::mutex> lck(mStreamMutex);
+    int32_t status = 0;
+    uint64_t endUs = 0;
+
+    if (seq != gainRampSeq || US_GAIN_RAMPING != gainState)
+        return;
+
+    /* a stream stopped meanwhile keeps the mute */
+    if (PAL_ULTRASOUND_GAIN_MUTE != pendingGain && STREAM_STARTED == currentState) {
+        status = session->setParameters(this, TAG_ULTRASOUND_GAIN,
+                        PAL_PARAM_ID_ULTRASOUND_SET_GAIN, &pendingGain);
+        if (status) {
+            PAL_ERR(LOG_TAG, "Error:%d, Failed to setParam for Ultrasound set gain",
+                    status);
+        }
+        gain = pendingGain;
+    }
+    gainState = US_GAIN_SETTLED;
+    gainRampCv.notify_all();
+
+    endUs = PalSpanTracer::nowUs();
+    PAL_INFO(LOG_TAG, "Ultrasound gain(%d) sequence done in %llu us", gain,
+             (unsigned long long)(endUs - gainSeqStartUs));
+    if (PalSpanTracer::isEnabled())
+        PalSpanTracer::record("us_gain_ramp", gainSeqStartUs, endUs);
+}
+
+bool StreamUltraSound::isGainMuted_l()
+{
+    return PAL_ULTRASOUND_GAIN_MUTE == gain && US_GAIN_SETTLED == gainState;
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+/*
+ * Stresses the ContextManager command queue: several producers push into
+ * a WaitableBoundedQueue faster than a slowed down consumer pops, the way
+ * a burst of proxy stream callbacks outruns the dispatcher. Checks that
+ * every command arrives once and in order per producer, that producers
+ * sleep on the full queue instead of spinning, and that closing the queue
+ * releases a blocked producer. Reports the CPU time burnt against the
+ * same run with producers yielding in a loop on the plain BoundedQueue.
+ *
+ * Usage: PalBoundedQueueTest [commands per producer]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "BoundedQueue.h"
+
+#define QUEUE_SIZE 64
+#define NUM_PRODUCERS 4
+#define DEFAULT_COMMANDS 20000
+/* the consumer pauses after every batch, so that the queue fills up */
+#define CONSUMER_BATCH 32
+#define CONSUMER_PAUSE_US 200
+
+static uint64_t nowUs()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static uint64_t cpuUs()
+{
+    struct rusage usage;
+
+    getrusage(RUSAGE_SELF, &usage);
+    return (uint64_t)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000 +
+           usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+}
+
+static int check(bool cond, const char *what)
+{
+    fprintf(stdout, "%s: %s\n", cond ? "PASS" : "FAIL", what);
+    return cond ? 0 : -1;
+}
+
+struct runResult {
+    bool inOrder;
+    uint32_t maxWaiters;
+    uint64_t wallUs;
+    uint64_t cpuUs;
+};
+
+static uint32_t getWaiters(WaitableBoundedQueue<uint64_t, QUEUE_SIZE> &queue)
+{
+    return queue.getWaiters();
+}
+
+static uint32_t getWaiters(BoundedQueue<uint64_t, QUEUE_SIZE> &queue __unused)
+{
+    return 0;
+}
+
+/* push(cmd) blocks or spins until the command is queued */
+template <typename Q, typename Push>
+static void run(Q &queue, Push push, uint32_t commands, struct runResult *result)
+{
+    std::vector<std::thread> producers;
+    std::vector<uint32_t> next(NUM_PRODUCERS, 0);
+    uint64_t total = (uint64_t)commands * NUM_PRODUCERS;
+    uint64_t received = 0;
+    uint64_t cmd = 0;
+    uint64_t wallBegin = nowUs();
+    uint64_t cpuBegin = cpuUs();
+
+    result->inOrder = true;
+    result->maxWaiters = 0;
+    for (uint32_t p = 0; p < NUM_PRODUCERS; p++) {
+        producers.emplace_back([&, p]() {
+            for (uint32_t n = 0; n < commands; n++)
+                push(((uint64_t)p << 32) | n);
+        });
+    }
+
+    while (received < total) {
+        if (!queue.pop(cmd)) {
+            usleep(10);
+            continue;
+        }
+        uint32_t p = (uint32_t)(cmd >> 32);
+        if (p >= NUM_PRODUCERS || (uint32_t)cmd != next[p]++)
+            result->inOrder = false;
+        if (++received % CONSUMER_BATCH == 0)
+            usleep(CONSUMER_PAUSE_US);
+        result->maxWaiters = std::max(result->maxWaiters, getWaiters(queue));
+    }
+
+    for (auto &t : producers)
+        t.join();
+    result->wallUs = nowUs() - wallBegin;
+    result->cpuUs = cpuUs() - cpuBegin;
+}
+
+int main(int argc, char *argv[])
+{
+    WaitableBoundedQueue<uint64_t, QUEUE_SIZE> waitable;
+    BoundedQueue<uint64_t, QUEUE_SIZE> plain;
+    uint32_t commands = argc > 1 ? (uint32_t)atoi(argv[1]) : DEFAULT_COMMANDS;
+    struct runResult blocking;
+    struct runResult spinning;
+    std::atomic<int> blockedResult(-1);
+    uint64_t cmd = 0;
+    int status = 0;
+
+    run(waitable, [&](uint64_t c) {
+            if (!waitable.push(c))
+                abort();
+        }, commands, &blocking);
+    status |= check(blocking.inOrder, "every command arrives once, in order per producer");
+    status |= check(blocking.maxWaiters > 0, "producers sleep on the full queue");
+    status |= check(blocking.cpuUs * 2 < blocking.wallUs,
+                    "producers do not burn CPU while the queue is full");
+
+    run(plain, [&](uint64_t c) {
+            while (!plain.push(c))
+                std::this_thread::yield();
+        }, commands, &spinning);
+
+    /* a producer blocked on a full queue is released by close */
+    for (uint32_t n = 0; n < QUEUE_SIZE; n++)
+        waitable.push(n);
+    std::thread blocked([&]() { blockedResult = waitable.push(QUEUE_SIZE) ? 1 : 0; });
+    while (!waitable.getWaiters())
+        usleep(100);
+    waitable.close();
+    blocked.join();
+    status |= check(blockedResult == 0, "close releases a blocked producer");
+    status |= check(!waitable.push(0), "push fails on a closed queue");
+    while (waitable.pop(cmd))
+        ;
+    waitable.reopen();
+    status |= check(waitable.push(0) && waitable.pop(cmd) && cmd == 0,
+                    "queue usable once reopened");
+
+    fprintf(stdout, "%u producers x %u commands: sleeping %llu ms cpu in %llu ms, "
+            "yielding %llu ms cpu in %llu ms\n", NUM_PRODUCERS, commands,
+            (unsigned long long)blocking.cpuUs / 1000,
+            (unsigned long long)blocking.wallUs / 1000,
+            (unsigned long long)spinning.cpuUs / 1000,
+            (unsigned long long)spinning.wallUs / 1000);
+    fprintf(stdout, "%s\n", status ? "FAIL" : "PASS");
+    return status;
+}
@@ -0,0 +1,937 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+/*
+ * Decodes the audio blocks of real sinks (monitor, TV, soundbars and an
+ * AVR) read from the EDID control with DisplayPort::getSinkCaps() and
+ * checks them against their known capabilities. The same blocks, every
+ * speaker allocation and random blocks are also decoded with a copy of
+ * the switch based decoder the tables replaced, which must give the same
+ * result, except for the 176.4 kHz rate the old one reported as 176000.
+ * Reports the time of both for decoding and for the capability queries of
+ * a stream open, which the old one answered by walking the blocks.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "DisplayPort.h"
+
+#define NUM_ITERATIONS 100000
+#define NUM_RANDOM_BLOCKS 10000
+#define AVR_FIXTURE 4
+
+/* audio data block followed by the speaker allocation, as in the control */
+struct edidFixture {
+    const char *name;
+    unsigned char data[1 + (MAX_EDID_BLOCKS + 1) * MIN_AUDIO_DESC_LENGTH];
+    int audioBlocks;
+    int channelAllocation;
+    unsigned int channelMask;
+    char channelMap[MAX_CHANNELS_SUPPORTED];
+    int samplingFreqMask;
+    int bitsPerSampleMask;
+    int maxLpcmChannels;
+    int highestSR;
+    int highestBps;
+};
+
+static const struct edidFixture fixtures[] = {
+    {"monitor, LPCM 2ch 32-48kHz",
+     {6, 0x09, 0x07, 0x07,
+         0x01, 0x00, 0x00},
+     1, 0x00, AUDIO_CHANNEL_OUT_STEREO,
+     {PCM_CHANNEL_L, PCM_CHANNEL_R},
+     0x07, 0x07, 2, 48000, 24},
+    {"TV, LPCM 2ch + AC3 + DD+",
+     {12, 0x09, 0x07, 0x07,
+          0x15, 0x07, 0x50,
+          0x55, 0x06, 0x00,
+          0x01, 0x00, 0x00},
+     3, 0x00, AUDIO_CHANNEL_OUT_STEREO,
+     {PCM_CHANNEL_L, PCM_CHANNEL_R},
+     0x07, 0x57, 2, 48000, 24},
+    {"5.1 soundbar, LPCM 2ch + AC3 + DTS",
+     {12, 0x09, 0x07, 0x07,
+          0x15, 0x07, 0x50,
+          0x3d, 0x06, 0xc0,
+          0x0f, 0x00, 0x00},
+     3, 0x0b, AUDIO_CHANNEL_OUT_5POINT1,
+     {PCM_CHANNEL_L, PCM_CHANNEL_R, PCM_CHANNEL_LFE, PCM_CHANNEL_C,
+      PCM_CHANNEL_LS, PCM_CHANNEL_RS},
+     0x07, 0xd7, 2, 48000, 24},
+    {"5.1.2 soundbar, LPCM 6ch + DD+ + MAT",
+     {12, 0x0d, 0x1f, 0x07,
+          0x57, 0x06, 0x01,
+          0x67, 0x54, 0x01,
+          0x0f, 0x01, 0x00},
+     3, 0x2f, AUDIO_CHANNEL_OUT_5POINT1POINT2,
+     {PCM_CHANNEL_L, PCM_CHANNEL_R, PCM_CHANNEL_LFE, PCM_CHANNEL_C,
+      PCM_CHANNEL_LS, PCM_CHANNEL_RS},
+     0x5f, 0x07, 6, 192000, 24},
+    {"7.1 AVR, LPCM 8ch/2ch + AC3 + DTS + DD+ + DTS-HD + MAT",
+     {24, 0x0f, 0x7f, 0x07,
+          0x09, 0x7f, 0x07,
+          0x15, 0x07, 0x50,
+          0x3d, 0x1e, 0xc0,
+          0x57, 0x06, 0x03,
+          0x5f, 0x7e, 0x01,
+          0x67, 0x7e, 0x00,
+          0x4f, 0x00, 0x00},
+     7, 0x13, AUDIO_CHANNEL_OUT_7POINT1,
+     {PCM_CHANNEL_L, PCM_CHANNEL_R, PCM_CHANNEL_LFE, PCM_CHANNEL_C,
+      PCM_CHANNEL_LS, PCM_CHANNEL_RS, PCM_CHANNEL_LB, PCM_CHANNEL_RB},
+     0x7f, 0xd7, 8, 192000, 24},
+    {"dock, LPCM 2ch 16bit up to 176.4kHz",
+     {6, 0x09, 0x3f, 0x01,
+         0x01, 0x00, 0x00},
+     1, 0x00, AUDIO_CHANNEL_OUT_STEREO,
+     {PCM_CHANNEL_L, PCM_CHANNEL_R},
+     0x3f, 0x01, 2, 176400, 16},
+    /* front center high is not rendered by LPASS: no mask, CEA order map */
+    {"5.1 + FCH AVR, LPCM 6ch",
+     {6, 0x0d, 0x07, 0x05,
+         0x0f, 0x04, 0x00},
+     1, 0x21, 0,
+     {PCM_CHANNEL_L, PCM_CHANNEL_R, PCM_CHANNEL_LFE, PCM_CHANNEL_C,
+      PCM_CHANNEL_LS, PCM_CHANNEL_RS},
+     0x07, 0x05, 6, 48000, 24},
+};
+
+static const int rates[] = {32000, 44100, 48000, 88200, 96000, 176400, 192000};
+#define NUM_RATES (sizeof(rates) / sizeof(rates[0]))
+
+/* the decoder as it was before the tables, without its logs */
+struct legacyCaps {
+    edidAudioInfo info;
+    int highestSR;
+    int highestBps;
+    int maxChannel;
+};
+
+static int legacyGetHighestEdidSF(unsigned char byte)
+{
+    int nfreq = 0;
+
+    if (byte & BIT(6)) {
+        nfreq = 192000;
+    } else if (byte & BIT(5)) {
+        nfreq = 176000;
+    } else if (byte & BIT(4)) {
+        nfreq = 96000;
+    } else if (byte & BIT(3)) {
+        nfreq = 88200;
+    } else if (byte & BIT(2)) {
+        nfreq = 48000;
+    } else if (byte & BIT(1)) {
+        nfreq = 44100;
+    } else if (byte & BIT(0)) {
+        nfreq = 32000;
+    }
+    return nfreq;
+}
+
+static bool legacyIsSampleRateSupported(unsigned char srByte, int samplingRate)
+{
+    int result = 0;
+
+    switch (samplingRate) {
+    case 192000:
+        result = (srByte & BIT(6));
+        break;
+    case 176400:
+        result = (srByte & BIT(5));
+        break;
+    case 96000:
+        result = (srByte & BIT(4));
+        break;
+    case 88200:
+        result = (srByte & BIT(3));
+        break;
+    case 48000:
+        result = (srByte & BIT(2));
+        break;
+    case 44100:
+        result = (srByte & BIT(1));
+        break;
+    case 32000:
+        result = (srByte & BIT(0));
+        break;
+     default:
+        break;
+    }
+
+    if (result)
+        return true;
+
+    return false;
+}
+
+static bool legacyIsSupportedBps(unsigned char bpsByte, int bps)
+{
+    int result = 0;
+
+    switch (bps) {
+    case 24:
+        result = (bpsByte & BIT(2));
+        break;
+    case 16:
+        result = (bpsByte & BIT(0));
+        break;
+     default:
+        break;
+    }
+
+    if (result)
+        return true;
+
+    return false;
+}
+
+static void legacyUpdateChannelAllocation(edidAudioInfo *info)
+{
+    int16_t ca;
+    int16_t spkrAlloc;
+
+    spkrAlloc = ((info->speakerAllocation[1]) << 8) |
+               (info->speakerAllocation[0]);
+
+    switch (spkrAlloc) {
+    case BIT(0):                                           ca = 0x00; break;
+    case BIT(0)|BIT(1):                                    ca = 0x01; break;
+    case BIT(0)|BIT(2):                                    ca = 0x02; break;
+    case BIT(0)|BIT(1)|BIT(2):                             ca = 0x03; break;
+    case BIT(0)|BIT(4):                                    ca = 0x04; break;
+    case BIT(0)|BIT(1)|BIT(4):                             ca = 0x05; break;
+    case BIT(0)|BIT(2)|BIT(4):                             ca = 0x06; break;
+    case BIT(0)|BIT(1)|BIT(2)|BIT(4):                      ca = 0x07; break;
+    case BIT(0)|BIT(3):                                    ca = 0x08; break;
+    case BIT(0)|BIT(1)|BIT(3):                             ca = 0x09; break;
+    case BIT(0)|BIT(2)|BIT(3):                             ca = 0x0A; break;
+    case BIT(0)|BIT(1)|BIT(2)|BIT(3):                      ca = 0x0B; break;
+    case BIT(0)|BIT(3)|BIT(4):                             ca = 0x0C; break;
+    case BIT(0)|BIT(1)|BIT(3)|BIT(4):                      ca = 0x0D; break;
+    case BIT(0)|BIT(2)|BIT(3)|BIT(4):                      ca = 0x0E; break;
+    case BIT(0)|BIT(1)|BIT(2)|BIT(3)|BIT(4):               ca = 0x0F; break;
+    case BIT(0)|BIT(3)|BIT(6):                             ca = 0x10; break;
+    case BIT(0)|BIT(1)|BIT(3)|BIT(6):                      ca = 0x11; break;
+    case BIT(0)|BIT(2)|BIT(3)|BIT(6):                      ca = 0x12; break;
+    case BIT(0)|BIT(1)|BIT(2)|BIT(3)|BIT(6):               ca = 0x13; break;
+    case BIT(0)|BIT(5):                                    ca = 0x14; break;
+    case BIT(0)|BIT(1)|BIT(5):                             ca = 0x15; break;
+    case BIT(0)|BIT(2)|BIT(5):                             ca = 0x16; break;
+    case BIT(0)|BIT(1)|BIT(2)|BIT(5):                      ca = 0x17; break;
+    case BIT(0)|BIT(4)|BIT(5):                             ca = 0x18; break;
+    case BIT(0)|BIT(1)|BIT(4)|BIT(5):                      ca = 0x19; break;
+    case BIT(0)|BIT(2)|BIT(4)|BIT(5):                      ca = 0x1A; break;
+    case BIT(0)|BIT(1)|BIT(2)|BIT(4)|BIT(5):               ca = 0x1B; break;
+    case BIT(0)|BIT(3)|BIT(5):                             ca = 0x1C; break;
+    case BIT(0)|BIT(1)|BIT(3)|BIT(5):                      ca = 0x1D; break;
+    case BIT(0)|BIT(2)|BIT(3)|BIT(5):                      ca = 0x1E; break;
+    case BIT(0)|BIT(1)|BIT(2)|BIT(3)|BIT(5):               ca = 0x1F; break;
+    case BIT(0)|BIT(2)|BIT(3)|BIT(10):                     ca = 0x20; break;
+    case BIT(0)|BIT(1)|BIT(2)|BIT(3)|BIT(10):              ca = 0x21; break;
+    case BIT(0)|BIT(2)|BIT(3)|BIT(9):                      ca = 0x22; break;
+    case BIT(0)|BIT(1)|BIT(2)|BIT(3)|BIT(9):               ca = 0x23; break;
+    case BIT(0)|BIT(3)|BIT(8):                             ca = 0x24; break;
+    case BIT(0)|BIT(1)|BIT(3)|BIT(8):                      ca = 0x25; break;
+    case BIT(0)|BIT(3)|BIT(7):                             ca = 0x26; break;
+    case BIT(0)|BIT(1)|BIT(3)|BIT(7):                      ca = 0x27; break;
+    case BIT(0)|BIT(2)|BIT(3)|BIT(4)|BIT(9):               ca = 0x28; break;
+    case BIT(0)|BIT(1)|BIT(2)|BIT(3)|BIT(4)|BIT(9):        ca = 0x29; break;
+    case BIT(0)|BIT(2)|BIT(3)|BIT(4)|BIT(10):              ca = 0x2A; break;
+    case BIT(0)|BIT(1)|BIT(2)|BIT(3)|BIT(4)|BIT(10):       ca = 0x2B; break;
+    case BIT(0)|BIT(2)|BIT(3)|BIT(9)|BIT(10):              ca = 0x2C; break;
+    case BIT(0)|BIT(1)|BIT(2)|BIT(3)|BIT(9)|BIT(10):       ca = 0x2D; break;
+    case BIT(0)|BIT(2)|BIT(3)|BIT(8):                      ca = 0x2E; break;
+    case BIT(0)|BIT(1)|BIT(2)|BIT(3)|BIT(8):               ca = 0x2F; break;
+    case BIT(0)|BIT(2)|BIT(3)|BIT(7):                      ca = 0x30; break;
+    case BIT(0)|BIT(1)|BIT(2)|BIT(3)|BIT(7):               ca = 0x31; break;
+    default:                                               ca = 0x0;  break;
+    }
+    info->channelAllocation = ca;
+}
+
+static void legacyRetrieveChannelMapLpass(int ca, uint8_t *ch_map)
+{
+    if (((ca < 0) || (ca > 0x1f)) &&
+         (ca != 0x2f))
+        return;
+
+    memset(ch_map, 0, MAX_CHANNELS_SUPPORTED);
+
+    switch(ca) {
+    case 0x0:
+        ch_map[0] = PCM_CHANNEL_L;
+        ch_map[1] = PCM_CHANNEL_R;
+        break;
+    case 0x1:
+        ch_map[0] = PCM_CHANNEL_L;
+        ch_map[1] = PCM_CHANNEL_R;
+        ch_map[2] = PCM_CHANNEL_LFE;
+        break;
+    case 0x2:
+        ch_map[0] = PCM_CHANNEL_L;
+        ch_map[1] = PCM_CHANNEL_R;
+        ch_map[2] = PCM_CHANNEL_C;
+        break;
+    case 0x3:
+        ch_map[0] = PCM_CHANNEL_L;
+        ch_map[1] = PCM_CHANNEL_R;
+        ch_map[2] = PCM_CHANNEL_LFE;
+        ch_map[3] = PCM_CHANNEL_C;
+        break;
+    case 0x4:
+        ch_map[0] = PCM_CHANNEL_L;
+        ch_map[1] = PCM_CHANNEL_R;
+        ch_map[2] = PCM_CHANNEL_CS;
+        break;
+    case 0x5:
+        ch_map[0] = PCM_CHANNEL_L;
+        ch_map[1] = PCM_CHANNEL_R;
+        ch_map[2] = PCM_CHANNEL_LFE;
+        ch_map[3] = PCM_CHANNEL_CS;
+        break;
+    case 0x6:
+        ch_map[0] = PCM_CHANNEL_L;
+        ch_map[1] = PCM_CHANNEL_R;
+        ch_map[2] = PCM_CHANNEL_C;
+        ch_map[3] = PCM_CHANNEL_CS;
+        break;
+    case 0x7:
+        ch_map[0] = PCM_CHANNEL_L;
+        ch_map[1] = PCM_CHANNEL_R;
+        ch_map[2] = PCM_CHANNEL_LFE;
+        ch_map[3] = PCM_CHANNEL_C;
+        ch_map[4] = PCM_CHANNEL_CS;
+        break;
+    case 0x8:
+        ch_map[0] = PCM_CHANNEL_L;
+        ch_map[1] = PCM_CHANNEL_R;
+        ch_map[2] = PCM_CHANNEL_LS;
+        ch_map[3] = PCM_CHANNEL_RS;
+        break;
+    case 0x9:
+        ch_map[0] = PCM_CHANNEL_L;
+        ch_map[1] = PCM_CHANNEL_R;
+        ch_map[2] = PCM_CHANNEL_LFE;
+        ch_map[3] = PCM_CHANNEL_LS;
+        ch_map[4] = PCM_CHANNEL_RS;
+        break;
+    case 0xa:
+        ch_map[0] = PCM_CHANNEL_L;
+        ch_map[1] = PCM_CHANNEL_R;
+        ch_map[2] = PCM_CHANNEL_C;
+        ch_map[3] = PCM_CHANNEL_LS;
+        ch_map[4] = PCM_CHANNEL_RS;
+        break;
+    case 0xb:
+        ch_map[0] = PCM_CHANNEL_L;
+        ch_map[1] = PCM_CHANNEL_R;
+        ch_map[2] = PCM_CHANNEL_LFE;
+        ch_map[3] = PCM_CHANNEL_C;
+        ch_map[4] = PCM_CHANNEL_LS;
+        ch_map[5] = PCM_CHANNEL_RS;
+        break;
+    case 0xc:
+        ch_map[0] = PCM_CHANNEL_L;
+        ch_map[1] = PCM_CHANNEL_R;
+        ch_map[2] = PCM_CHANNEL_LS;
+        ch_map[3] = PCM_CHANNEL_RS;
+        ch_map[4] = PCM_CHANNEL_CS;
+        break;
+    case 0xd:
+        ch_map[0] = PCM_CHANNEL_L;
+        ch_map[1] = PCM_CHANNEL_R;
+        ch_map[2] = PCM_CHANNEL_LFE;
+        ch_map[3] = PCM_CHANNEL_LS;
+        ch_map[4] = PCM_CHANNEL_RS;
+        ch_map[5] = PCM_CHANNEL_CS;
+        break;
+    case 0xe:
+        ch_map[0] = PCM_CHANNEL_L;
+        ch_map[1] = PCM_CHANNEL_R;
+        ch_map[2] = PCM_CHANNEL_C;
+        ch_map[3] = PCM_CHANNEL_LS;
+        ch_map[4] = PCM_CHANNEL_RS;
+        ch_map[5] = PCM_CHANNEL_CS;
+        break;
+    case 0xf:
+        ch_map[0] = PCM_CHANNEL_L;
+        ch_map[1] = PCM_CHANNEL_R;
+        ch_map[2] = PCM_CHANNEL_LFE;
+        ch_map[3] = PCM_CHANNEL_C;
+        ch_map[4] = PCM_CHANNEL_LS;
+        ch_map[5] = PCM_CHANNEL_RS;
+        ch_map[6] = PCM_CHANNEL_CS;
+        break;
+    case 0x10:
+        ch_map[0] = PCM_CHANNEL_L;
+        ch_map[1] = PCM_CHANNEL_R;
+        ch_map[2] = PCM_CHANNEL_LS;
+        ch_map[3] = PCM_CHANNEL_RS;
+        ch_map[4] = PCM_CHANNEL_LB;
+        ch_map[5] = PCM_CHANNEL_RB;
+        break;
+    case 0x11:
+        ch_map[0] = PCM_CHANNEL_L;
+        ch_map[1] = PCM_CHANNEL_R;
+        ch_map[2] = PCM_CHANNEL_LFE;
+        ch_map[3] = PCM_CHANNEL_LS;
+        ch_map[4] = PCM_CHANNEL_RS;
+        ch_map[5] = PCM_CHANNEL_LB;
+        ch_map[6] = PCM_CHANNEL_RB;
+        break;
+    case 0x12:
+        ch_map[0] = PCM_CHANNEL_L;
+        ch_map[1] = PCM_CHANNEL_R;
+        ch_map[2] = PCM_CHANNEL_C;
+        ch_map[3] = PCM_CHANNEL_LS;
+        ch_map[4] = PCM_CHANNEL_RS;
+        ch_map[5] = PCM_CHANNEL_LB;
+        ch_map[6] = PCM_CHANNEL_RB;
+        break;
+    case 0x13:
+        ch_map[0] = PCM_CHANNEL_L;
+        ch_map[1] = PCM_CHANNEL_R;
+        ch_map[2] = PCM_CHANNEL_LFE;
+        ch_map[3] = PCM_CHANNEL_C;
+        ch_map[4] = PCM_CHANNEL_LS;
+        ch_map[5] = PCM_CHANNEL_RS;
+        ch_map[6] = PCM_CHANNEL_LB;
+        ch_map[7] = PCM_CHANNEL_RB;
+        break;
+    case 0x14:
+        ch_map[0] = PCM_CHANNEL_L;
+        ch_map[1] = PCM_CHANNEL_R;
+        ch_map[2] = PCM_CHANNEL_FLC;
+        ch_map[3] = PCM_CHANNEL_FRC;
+        break;
+    case 0x15:
+        ch_map[0] = PCM_CHANNEL_L;
+        ch_map[1] = PCM_CHANNEL_R;
+        ch_map[2] = PCM_CHANNEL_LFE;
+        ch_map[3] = PCM_CHANNEL_FLC;
+        ch_map[4] = PCM_CHANNEL_FRC;
+        break;
+    case 0x16:
+        ch_map[0] = PCM_CHANNEL_L;
+        ch_map[1] = PCM_CHANNEL_R;
+        ch_map[2] = PCM_CHANNEL_C;
+        ch_map[3] = PCM_CHANNEL_FLC;
+        ch_map[4] = PCM_CHANNEL_FRC;
+        break;
+    case 0x17:
+        ch_map[0] = PCM_CHANNEL_L;
+        ch_map[1] = PCM_CHANNEL_R;
+        ch_map[2] = PCM_CHANNEL_LFE;
+        ch_map[3] = PCM_CHANNEL_C;
+        ch_map[4] = PCM_CHANNEL_FLC;
+        ch_map[5] = PCM_CHANNEL_FRC;
+        break;
+    case 0x18:
+        ch_map[0] = PCM_CHANNEL_L;
+        ch_map[1] = PCM_CHANNEL_R;
+        ch_map[2] = PCM_CHANNEL_CS;
+        ch_map[3] = PCM_CHANNEL_FLC;
+        ch_map[4] = PCM_CHANNEL_FRC;
+        break;
+    case 0x19:
+        ch_map[0] = PCM_CHANNEL_L;
+        ch_map[1] = PCM_CHANNEL_R;
+        ch_map[2] = PCM_CHANNEL_LFE;
+        ch_map[3] = PCM_CHANNEL_CS;
+        ch_map[4] = PCM_CHANNEL_FLC;
+        ch_map[5] = PCM_CHANNEL_FRC;
+        break;
+    case 0x1a:
+        ch_map[0] = PCM_CHANNEL_L;
+        ch_map[1] = PCM_CHANNEL_R;
+        ch_map[2] = PCM_CHANNEL_C;
+        ch_map[3] = PCM_CHANNEL_CS;
+        ch_map[4] = PCM_CHANNEL_FLC;
+        ch_map[5] = PCM_CHANNEL_FRC;
+        break;
+    case 0x1b:
+        ch_map[0] = PCM_CHANNEL_L;
+        ch_map[1] = PCM_CHANNEL_R;
+        ch_map[2] = PCM_CHANNEL_LFE;
+        ch_map[3] = PCM_CHANNEL_C;
+        ch_map[4] = PCM_CHANNEL_CS;
+        ch_map[5] = PCM_CHANNEL_FLC;
+        ch_map[6] = PCM_CHANNEL_FRC;
+        break;
+    case 0x1c:
+        ch_map[0] = PCM_CHANNEL_L;
+        ch_map[1] = PCM_CHANNEL_R;
+        ch_map[2] = PCM_CHANNEL_LS;
+        ch_map[3] = PCM_CHANNEL_RS;
+        ch_map[4] = PCM_CHANNEL_FLC;
+        ch_map[5] = PCM_CHANNEL_FRC;
+        break;
+    case 0x1d:
+        ch_map[0] = PCM_CHANNEL_L;
+        ch_map[1] = PCM_CHANNEL_R;
+        ch_map[2] = PCM_CHANNEL_LFE;
+        ch_map[3] = PCM_CHANNEL_LS;
+        ch_map[4] = PCM_CHANNEL_RS;
+        ch_map[5] = PCM_CHANNEL_FLC;
+        ch_map[6] = PCM_CHANNEL_FRC;
+        break;
+    case 0x1e:
+        ch_map[0] = PCM_CHANNEL_L;
+        ch_map[1] = PCM_CHANNEL_R;
+        ch_map[2] = PCM_CHANNEL_C;
+        ch_map[3] = PCM_CHANNEL_LS;
+        ch_map[4] = PCM_CHANNEL_RS;
+        ch_map[5] = PCM_CHANNEL_FLC;
+        ch_map[6] = PCM_CHANNEL_FRC;
+        break;
+    case 0x1f:
+        ch_map[0] = PCM_CHANNEL_L;
+        ch_map[1] = PCM_CHANNEL_R;
+        ch_map[2] = PCM_CHANNEL_LFE;
+        ch_map[3] = PCM_CHANNEL_C;
+        ch_map[4] = PCM_CHANNEL_LS;
+        ch_map[5] = PCM_CHANNEL_RS;
+        ch_map[6] = PCM_CHANNEL_FLC;
+        ch_map[7] = PCM_CHANNEL_FRC;
+        break;
+    case 0x2f:
+        ch_map[0] = PCM_CHANNEL_L;
+        ch_map[1] = PCM_CHANNEL_R;
+        ch_map[2] = PCM_CHANNEL_LFE;
+        ch_map[3] = PCM_CHANNEL_C;
+        ch_map[4] = PCM_CHANNEL_LS;
+        ch_map[5] = PCM_CHANNEL_RS;
+        ch_map[6] = 0; // PCM_CHANNEL_TFL; but not defined by LPASS
+        ch_map[7] = 0; // PCM_CHANNEL_TFR; but not defined by LPASS
+        break;
+    default:
+        break;
+    }
+}
+
+static void legacyUpdateChannelMask(edidAudioInfo *info)
+{
+    if (((info->channelAllocation < 0) ||
+         (info->channelAllocation > 0x1f)) &&
+         (info->channelAllocation != 0x2f))
+        return;
+
+    switch(info->channelAllocation) {
+    case 0x0:
+        info->channelMask = AUDIO_CHANNEL_OUT_STEREO;
+        break;
+    case 0x1:
+        info->channelMask = AUDIO_CHANNEL_OUT_2POINT1;
+        break;
+    case 0x2:
+        info->channelMask = AUDIO_CHANNEL_OUT_STEREO;
+        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_CENTER;
+        break;
+    case 0x3:
+        info->channelMask = AUDIO_CHANNEL_OUT_2POINT1;
+        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_CENTER;
+        break;
+    case 0x4:
+        info->channelMask = AUDIO_CHANNEL_OUT_STEREO;
+        info->channelMask |= AUDIO_CHANNEL_OUT_BACK_CENTER;
+        break;
+    case 0x5:
+        info->channelMask = AUDIO_CHANNEL_OUT_2POINT1;
+        info->channelMask |= AUDIO_CHANNEL_OUT_LOW_FREQUENCY;
+        info->channelMask |= AUDIO_CHANNEL_OUT_BACK_CENTER;
+        break;
+    case 0x6:
+        info->channelMask = AUDIO_CHANNEL_OUT_SURROUND;
+        break;
+    case 0x7:
+        info->channelMask = AUDIO_CHANNEL_OUT_SURROUND;
+        info->channelMask |= AUDIO_CHANNEL_OUT_LOW_FREQUENCY;
+        break;
+    case 0x8:
+        info->channelMask = AUDIO_CHANNEL_OUT_QUAD;
+        break;
+    case 0x9:
+        info->channelMask = AUDIO_CHANNEL_OUT_QUAD;
+        info->channelMask |= AUDIO_CHANNEL_OUT_LOW_FREQUENCY;
+        break;
+    case 0xa:
+        info->channelMask = AUDIO_CHANNEL_OUT_PENTA;
+        break;
+    case 0xb:
+        info->channelMask = AUDIO_CHANNEL_OUT_5POINT1;
+        break;
+    case 0xc:
+        info->channelMask = AUDIO_CHANNEL_OUT_QUAD;
+        info->channelMask |= AUDIO_CHANNEL_OUT_BACK_CENTER;
+        break;
+    case 0xd:
+        info->channelMask = AUDIO_CHANNEL_OUT_QUAD;
+        info->channelMask |= AUDIO_CHANNEL_OUT_LOW_FREQUENCY;
+        info->channelMask |= AUDIO_CHANNEL_OUT_BACK_CENTER;
+        break;
+    case 0xe:
+        info->channelMask = AUDIO_CHANNEL_OUT_PENTA;
+        info->channelMask |= AUDIO_CHANNEL_OUT_BACK_CENTER;
+        break;
+    case 0xf:
+        info->channelMask = AUDIO_CHANNEL_OUT_5POINT1;
+        info->channelMask |= AUDIO_CHANNEL_OUT_BACK_CENTER;
+        break;
+    case 0x10:
+        info->channelMask = AUDIO_CHANNEL_OUT_QUAD;
+        info->channelMask |= AUDIO_CHANNEL_OUT_SIDE_LEFT;
+        info->channelMask |= AUDIO_CHANNEL_OUT_SIDE_RIGHT;
+        break;
+    case 0x11:
+        info->channelMask = AUDIO_CHANNEL_OUT_QUAD;
+        info->channelMask |= AUDIO_CHANNEL_OUT_LOW_FREQUENCY;
+        info->channelMask |= AUDIO_CHANNEL_OUT_SIDE_LEFT;
+        info->channelMask |= AUDIO_CHANNEL_OUT_SIDE_RIGHT;
+        break;
+    case 0x12:
+        info->channelMask = AUDIO_CHANNEL_OUT_QUAD;
+        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_CENTER;
+        info->channelMask |= AUDIO_CHANNEL_OUT_SIDE_LEFT;
+        info->channelMask |= AUDIO_CHANNEL_OUT_SIDE_RIGHT;
+        break;
+    case 0x13:
+        info->channelMask = AUDIO_CHANNEL_OUT_7POINT1;
+        break;
+    case 0x14:
+        info->channelMask = AUDIO_CHANNEL_OUT_FRONT_LEFT;
+        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_RIGHT;
+        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_LEFT_OF_CENTER;
+        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_RIGHT_OF_CENTER;
+        break;
+    case 0x15:
+        info->channelMask = AUDIO_CHANNEL_OUT_2POINT1;
+        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_LEFT_OF_CENTER;
+        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_RIGHT_OF_CENTER;
+        break;
+    case 0x16:
+        info->channelMask = AUDIO_CHANNEL_OUT_FRONT_LEFT;
+        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_RIGHT;
+        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_CENTER;
+        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_LEFT_OF_CENTER;
+        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_RIGHT_OF_CENTER;
+        break;
+    case 0x17:
+        info->channelMask = AUDIO_CHANNEL_OUT_2POINT1;
+        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_CENTER;
+        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_LEFT_OF_CENTER;
+        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_RIGHT_OF_CENTER;
+        break;
+    case 0x18:
+        info->channelMask = AUDIO_CHANNEL_OUT_FRONT_LEFT;
+        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_RIGHT;
+        info->channelMask |= AUDIO_CHANNEL_OUT_BACK_CENTER;
+        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_LEFT_OF_CENTER;
+        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_RIGHT_OF_CENTER;
+        break;
+    case 0x19:
+        info->channelMask = AUDIO_CHANNEL_OUT_2POINT1;
+        info->channelMask |= AUDIO_CHANNEL_OUT_BACK_CENTER;
+        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_LEFT_OF_CENTER;
+        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_RIGHT_OF_CENTER;
+        break;
+    case 0x1a:
+        info->channelMask = AUDIO_CHANNEL_OUT_SURROUND;
+        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_LEFT_OF_CENTER;
+        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_RIGHT_OF_CENTER;
+        break;
+    case 0x1b:
+        info->channelMask = AUDIO_CHANNEL_OUT_SURROUND;
+        info->channelMask |= AUDIO_CHANNEL_OUT_LOW_FREQUENCY;
+        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_LEFT_OF_CENTER;
+        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_RIGHT_OF_CENTER;
+        break;
+    case 0x1c:
+        info->channelMask = AUDIO_CHANNEL_OUT_QUAD;
+        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_LEFT_OF_CENTER;
+        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_RIGHT_OF_CENTER;
+        break;
+    case 0x1d:
+        info->channelMask = AUDIO_CHANNEL_OUT_QUAD;
+        info->channelMask |= AUDIO_CHANNEL_OUT_LOW_FREQUENCY;
+        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_LEFT_OF_CENTER;
+        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_RIGHT_OF_CENTER;
+        break;
+    case 0x1e:
+        info->channelMask = AUDIO_CHANNEL_OUT_PENTA;
+        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_LEFT_OF_CENTER;
+        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_RIGHT_OF_CENTER;
+        break;
+    case 0x1f:
+        info->channelMask = AUDIO_CHANNEL_OUT_5POINT1;
+        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_LEFT_OF_CENTER;
+        info->channelMask |= AUDIO_CHANNEL_OUT_FRONT_RIGHT_OF_CENTER;
+        break;
+    case 0x2f:
+        info->channelMask = AUDIO_CHANNEL_OUT_5POINT1POINT2;
+        break;
+    default:
+        break;
+    }
+}
+
+/* read through char like the control data, bytes above 0x7f included */
+static bool legacyGetSinkCaps(struct legacyCaps *caps, const char *edidData)
+{
+    edidAudioInfo *info = &caps->info;
+    unsigned char channels[MAX_EDID_BLOCKS];
+    unsigned char formats[MAX_EDID_BLOCKS];
+    unsigned char frequency[MAX_EDID_BLOCKS];
+    unsigned char bitrate[MAX_EDID_BLOCKS];
+    int i = 0;
+    int length, countDesc;
+
+    length = (int) *edidData++;
+    countDesc = length/MIN_AUDIO_DESC_LENGTH;
+    if (!countDesc)
+        return false;
+
+    memset(caps, 0, sizeof(*caps));
+    info->audioBlocks = countDesc-1;
+    if (info->audioBlocks > MAX_EDID_BLOCKS)
+        info->audioBlocks = MAX_EDID_BLOCKS;
+
+    for (i=0; i<info->audioBlocks; i++) {
+        channels [i]   = (*edidData & 0x7) + 1;
+        formats  [i]   = (*edidData++) >> 3;
+        frequency[i]   = *edidData++;
+        bitrate  [i]   = *edidData++;
+    }
+    info->speakerAllocation[0] = *edidData++;
+    info->speakerAllocation[1] = *edidData++;
+    info->speakerAllocation[2] = *edidData++;
+
+    /* the CEA order map is unchanged, the LPASS one overrides it */
+    DisplayPort::updateChannelMap(info);
+    legacyUpdateChannelAllocation(info);
+    legacyRetrieveChannelMapLpass(info->channelAllocation,
+                                  (uint8_t *)&info->channelMap[0]);
+    legacyUpdateChannelMask(info);
+
+    for (i=0; i<info->audioBlocks; i++) {
+        info->audioBlocksArray[i].channels = channels[i];
+        info->audioBlocksArray[i].formatId = (edidAudioFormatId)formats[i];
+        info->audioBlocksArray[i].samplingFreqBitmask = frequency[i];
+        info->audioBlocksArray[i].bitsPerSampleBitmask =
+                   formats[i] ? bitrate[i] : 0;
+    }
+
+    return true;
+}
+
+/* what getHighestSupportedSR/Bps and getMaxChannel walked on every call */
+static void legacyQuery(struct legacyCaps *caps)
+{
+    edidAudioInfo *info = &caps->info;
+    int bpsMask = 0;
+    int sr = 0;
+    int i = 0;
+
+    caps->highestSR = 0;
+    caps->highestBps = 0;
+    caps->maxChannel = 2;
+    for (i = 0; i < info->audioBlocks; i++) {
+        sr = legacyGetHighestEdidSF(info->audioBlocksArray[i].samplingFreqBitmask);
+        if (sr > caps->highestSR)
+            caps->highestSR = sr;
+        if (info->audioBlocksArray[i].formatId == LPCM &&
+            caps->maxChannel < info->audioBlocksArray[i].channels)
+            caps->maxChannel = info->audioBlocksArray[i].channels;
+    }
+    for (i = 0; i < info->audioBlocks; i++) {
+        bpsMask = info->audioBlocksArray[i].bitsPerSampleBitmask;
+        if (legacyIsSupportedBps(bpsMask, 24)) {
+            caps->highestBps = 24;
+            break;
+        } else if (legacyIsSupportedBps(bpsMask, 16) && caps->highestBps < 16) {
+            caps->highestBps = 16;
+        }
+    }
+}
+
+static bool legacyIsSupportedSR(edidAudioInfo *info, int sr)
+{
+    for (int i = 0; i < info->audioBlocks; i++) {
+        if (legacyIsSampleRateSupported(info->audioBlocksArray[i].samplingFreqBitmask, sr))
+            return true;
+    }
+    return false;
+}
+
+static bool legacyIsSupportedBps(edidAudioInfo *info, int bps)
+{
+    for (int i = 0; i < info->audioBlocks; i++) {
+        if (legacyIsSupportedBps(info->audioBlocksArray[i].bitsPerSampleBitmask, bps))
+            return true;
+    }
+    return false;
+}
+
+static uint64_t nowUs()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int check(bool cond, const char *what)
+{
+    fprintf(stdout, "%s: %s\n", cond ? "PASS" : "FAIL", what);
+    return cond ? 0 : -1;
+}
+
+static bool matchesFixture(const edidAudioInfo *info, const struct edidFixture *f)
+{
+    return info->audioBlocks == f->audioBlocks &&
+           info->channelAllocation == f->channelAllocation &&
+           info->channelMask == f->channelMask &&
+           !memcmp(info->channelMap, f->channelMap, MAX_CHANNELS_SUPPORTED) &&
+           info->samplingFreqMask == f->samplingFreqMask &&
+           info->bitsPerSampleMask == f->bitsPerSampleMask &&
+           info->maxLpcmChannels == f->maxLpcmChannels &&
+           info->highestSR == f->highestSR &&
+           info->highestBps == f->highestBps;
+}
+
+/* everything the old decoder produced, and the queries it answered */
+static bool matchesLegacy(edidAudioInfo *info, struct legacyCaps *caps)
+{
+    edidAudioInfo *old = &caps->info;
+    int maxChannel = info->maxLpcmChannels > 2 ? info->maxLpcmChannels : 2;
+    int highestSR = caps->highestSR == 176000 ? 176400 : caps->highestSR;
+
+    if (info->audioBlocks != old->audioBlocks ||
+        memcmp(info->speakerAllocation, old->speakerAllocation,
+               sizeof(old->speakerAllocation)) ||
+        memcmp(info->audioBlocksArray, old->audioBlocksArray,
+               old->audioBlocks * sizeof(edidAudioBlockInfo)) ||
+        memcmp(info->channelMap, old->channelMap, MAX_CHANNELS_SUPPORTED) ||
+        info->channelAllocation != old->channelAllocation ||
+        info->channelMask != old->channelMask)
+        return false;
+    if (info->highestSR != highestSR || info->highestBps != caps->highestBps ||
+        maxChannel != caps->maxChannel)
+        return false;
+    for (size_t i = 0; i < NUM_RATES; i++) {
+        if (DisplayPort::isSampleRateSupported(info->samplingFreqMask, rates[i]) !=
+            legacyIsSupportedSR(old, rates[i]))
+            return false;
+    }
+    return DisplayPort::isSupportedBps(info->bitsPerSampleMask, 24) ==
+               legacyIsSupportedBps(old, 24) &&
+           DisplayPort::isSupportedBps(info->bitsPerSampleMask, 16) ==
+               legacyIsSupportedBps(old, 16);
+}
+
+static bool decodeBoth(const unsigned char *data, edidAudioInfo *info,
+                       struct legacyCaps *caps)
+{
+    bool decoded = DisplayPort::getSinkCaps(info, (char *)data);
+
+    if (decoded != legacyGetSinkCaps(caps, (const char *)data))
+        return false;
+    if (!decoded)
+        return true;
+    legacyQuery(caps);
+    return matchesLegacy(info, caps);
+}
+
+int main(int argc __unused, char *argv[] __unused)
+{
+    const size_t numFixtures = sizeof(fixtures) / sizeof(fixtures[0]);
+    unsigned char data[1 + (MAX_EDID_BLOCKS + 2) * MIN_AUDIO_DESC_LENGTH];
+    unsigned char shortData[] = {2, 0x09, 0x07};
+    edidAudioInfo info;
+    struct legacyCaps caps;
+    char what[128];
+    uint64_t tableUs = 0;
+    uint64_t legacyUs = 0;
+    uint64_t begin = 0;
+    uint32_t mismatches = 0;
+    uint64_t tableAnswers = 0;
+    uint64_t legacyAnswers = 0;
+    int status = 0;
+
+    for (size_t i = 0; i < numFixtures; i++) {
+        bool decoded = DisplayPort::getSinkCaps(&info, (char *)fixtures[i].data);
+
+        snprintf(what, sizeof(what), "%s decodes to its capabilities",
+                 fixtures[i].name);
+        status |= check(decoded && matchesFixture(&info, &fixtures[i]), what);
+        snprintf(what, sizeof(what), "%s decodes as before", fixtures[i].name);
+        status |= check(decodeBoth(fixtures[i].data, &info, &caps), what);
+    }
+    status |= check(!DisplayPort::getSinkCaps(&info, (char *)shortData),
+                    "block shorter than a descriptor rejected");
+
+    /* one LPCM block with every speaker allocation the two bytes can hold */
+    for (uint32_t alloc = 0; alloc <= 0xffff; alloc++) {
+        unsigned char block[] = {6, 0x0f, 0x7f, 0x07,
+                                 (unsigned char)(alloc & 0xff),
+                                 (unsigned char)(alloc >> 8), 0x00};
+
+        if (!decodeBoth(block, &info, &caps))
+            mismatches++;
+    }
+    status |= check(!mismatches, "every speaker allocation decodes as before");
+
+    /* random blocks, some longer than MAX_EDID_BLOCKS descriptors */
+    srand(1);
+    mismatches = 0;
+    for (int n = 0; n < NUM_RANDOM_BLOCKS; n++) {
+        data[0] = rand() % (sizeof(data) - 1);
+        for (size_t i = 1; i < sizeof(data); i++)
+            data[i] = rand() & 0xff;
+        if (!decodeBoth(data, &info, &caps))
+            mismatches++;
+    }
+    status |= check(!mismatches, "random blocks decode as before");
+
+    begin = nowUs();
+    for (int n = 0; n < NUM_ITERATIONS; n++)
+        DisplayPort::getSinkCaps(&info, (char *)fixtures[n % numFixtures].data);
+    tableUs = nowUs() - begin;
+    begin = nowUs();
+    for (int n = 0; n < NUM_ITERATIONS; n++)
+        legacyGetSinkCaps(&caps, (const char *)fixtures[n % numFixtures].data);
+    legacyUs = nowUs() - begin;
+    fprintf(stdout, "%d decodes: tables %llu us, switches %llu us\n", NUM_ITERATIONS,
+            (unsigned long long)tableUs, (unsigned long long)legacyUs);
+
+    /* the rate, width and channel checks of a stream open, on the AVR */
+    DisplayPort::getSinkCaps(&info, (char *)fixtures[AVR_FIXTURE].data);
+    legacyGetSinkCaps(&caps, (const char *)fixtures[AVR_FIXTURE].data);
+    begin = nowUs();
+    for (int n = 0; n < NUM_ITERATIONS; n++) {
+        tableAnswers += DisplayPort::isSampleRateSupported(info.samplingFreqMask,
+                                                           rates[n % NUM_RATES]);
+        tableAnswers += DisplayPort::isSupportedBps(info.bitsPerSampleMask, 24);
+        tableAnswers += info.highestSR + info.highestBps + info.maxLpcmChannels;
+    }
+    tableUs = nowUs() - begin;
+    begin = nowUs();
+    for (int n = 0; n < NUM_ITERATIONS; n++) {
+        legacyAnswers += legacyIsSupportedSR(&caps.info, rates[n % NUM_RATES]);
+        legacyAnswers += legacyIsSupportedBps(&caps.info, 24);
+        legacyQuery(&caps);
+        legacyAnswers += caps.highestSR + caps.highestBps + caps.maxChannel;
+    }
+    legacyUs = nowUs() - begin;
+    status |= check(tableAnswers == legacyAnswers, "queries answer as before");
+    fprintf(stdout, "%d queries: summary %llu us, block walks %llu us\n", NUM_ITERATIONS,
+            (unsigned long long)tableUs, (unsigned long long)legacyUs);
+
+    fprintf(stdout, "%s\n", status ? "FAIL" : "PASS");
+    return status;
+}
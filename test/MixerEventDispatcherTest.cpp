@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+/*
+ * Feeds fake mixer events through MixerEventDispatcher and reports the
+ * queueing latency per subscriber, with one subscriber whose handler is
+ * slow. Also checks that no handler starts once deregisterCallback
+ * returns, that deregistering with a lock held that the running handler
+ * waits for doesn't block, and that events beyond the queue depth are
+ * counted as dropped.
+ */
+
+#include <agm/agm_api.h>
+#include <atomic>
+#include <mutex>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <time.h>
+#include <unistd.h>
+#include "MixerEventDispatcher.h"
+
+#define FAST_PCM_ID 10
+#define SLOW_PCM_ID 20
+#define NUM_EVENTS 20
+#define LOCKED_PCM_ID 30
+#define SLOW_HANDLER_US 20000
+
+struct test_client {
+    std::atomic<uint32_t> events;
+    std::atomic<uint32_t> entered;
+    std::atomic<bool> deregistered;
+    std::atomic<bool> late_callback;
+    uint32_t handler_us;
+    std::mutex *lock;
+};
+
+static void initClient(struct test_client *client, uint32_t handler_us,
+                       std::mutex *lock)
+{
+    client->events = 0;
+    client->entered = 0;
+    client->deregistered = false;
+    client->late_callback = false;
+    client->handler_us = handler_us;
+    client->lock = lock;
+}
+
+static void testCallback(uint64_t hdl, uint32_t event_id __unused, void *data __unused,
+                         uint32_t event_size __unused, uint32_t miid __unused)
+{
+    struct test_client *client = (struct test_client *)hdl;
+
+    /* set after deregisterCallback returned, no handler may start */
+    if (client->deregistered.load())
+        client->late_callback.store(true);
+    client->entered++;
+    if (client->lock) {
+        /* like a session handler taking the engine lock */
+        std::lock_guard<std::mutex> lck(*client->lock);
+    }
+    if (client->handler_us)
+        usleep(client->handler_us);
+    client->events++;
+}
+
+static void *makeEvent(uint32_t event_id)
+{
+    struct agm_event_cb_params *params = NULL;
+
+    params = (struct agm_event_cb_params *)calloc(1, sizeof(*params) + sizeof(uint32_t));
+    if (params) {
+        params->event_id = event_id;
+        params->event_payload_size = sizeof(uint32_t);
+    }
+    return params;
+}
+
+static void printStats(const char *name, struct mixer_event_dispatch_stats *stats)
+{
+    fprintf(stdout, "%s: dispatched %llu dropped %llu avg latency %llu us max %llu us\n",
+            name, (unsigned long long)stats->dispatched,
+            (unsigned long long)stats->dropped,
+            stats->dispatched ?
+                (unsigned long long)(stats->total_latency_us / stats->dispatched) : 0ULL,
+            (unsigned long long)stats->max_latency_us);
+}
+
+static uint64_t nowUs()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+int main(int argc __unused, char *argv[] __unused)
+{
+    MixerEventDispatcher dispatcher;
+    struct test_client fast;
+    struct test_client slow;
+    struct test_client locked;
+    struct mixer_event_dispatch_stats stats;
+    std::vector<int> fastIds = {FAST_PCM_ID};
+    std::vector<int> slowIds = {SLOW_PCM_ID};
+    std::vector<int> lockedIds = {LOCKED_PCM_ID};
+    std::mutex engineLock;
+    uint64_t deregisterUs = 0;
+    uint64_t dropped = 0;
+    int status = 0;
+
+    initClient(&fast, 0, NULL);
+    initClient(&slow, SLOW_HANDLER_US, NULL);
+    initClient(&locked, 0, &engineLock);
+
+    dispatcher.registerCallback(slowIds, testCallback, (uint64_t)&slow);
+    dispatcher.registerCallback(fastIds, testCallback, (uint64_t)&fast);
+
+    for (int i = 0; i < NUM_EVENTS; i++) {
+        dispatcher.dispatch(SLOW_PCM_ID, makeEvent(i));
+        dispatcher.dispatch(FAST_PCM_ID, makeEvent(i));
+        usleep(1000);
+    }
+    while (fast.events.load() < NUM_EVENTS)
+        usleep(1000);
+
+    /* only the slow subscriber waits behind its own handler */
+    dispatcher.getStats(&stats);
+    printStats("all subscribers", &stats);
+    dispatcher.deregisterCallback(fastIds, testCallback);
+    fast.deregistered.store(true);
+
+    /* deregister while the slow handler is still draining its queue */
+    dispatcher.deregisterCallback(slowIds, testCallback);
+    slow.deregistered.store(true);
+    usleep(2 * SLOW_HANDLER_US);
+
+    fprintf(stdout, "fast events %u, slow events %u before deregister\n",
+            fast.events.load(), slow.events.load());
+    if (fast.late_callback.load() || slow.late_callback.load()) {
+        fprintf(stdout, "FAIL: handler started after deregisterCallback returned\n");
+        status = -1;
+    }
+
+    /* deregister holding the lock a running handler is blocked on */
+    dispatcher.registerCallback(lockedIds, testCallback, (uint64_t)&locked);
+    engineLock.lock();
+    dispatcher.dispatch(LOCKED_PCM_ID, makeEvent(0));
+    while (locked.entered.load() == 0)
+        usleep(1000);
+    deregisterUs = nowUs();
+    dispatcher.deregisterCallback(lockedIds, testCallback);
+    deregisterUs = nowUs() - deregisterUs;
+    locked.deregistered.store(true);
+    dispatcher.dispatch(LOCKED_PCM_ID, makeEvent(1));
+    engineLock.unlock();
+    while (locked.events.load() == 0)
+        usleep(1000);
+    fprintf(stdout, "deregister with a blocked handler took %llu us\n",
+            (unsigned long long)deregisterUs);
+    if (locked.late_callback.load()) {
+        fprintf(stdout, "FAIL: blocked subscriber got an event after deregister\n");
+        status = -1;
+    }
+
+    /* events beyond the queue depth are dropped and counted */
+    initClient(&slow, SLOW_HANDLER_US, NULL);
+    dispatcher.getStats(&stats);
+    dropped = stats.dropped;
+    dispatcher.registerCallback(slowIds, testCallback, (uint64_t)&slow);
+    for (int i = 0; i < 2 * MIXER_EVENT_QUEUE_DEPTH; i++)
+        dispatcher.dispatch(SLOW_PCM_ID, makeEvent(i));
+    dispatcher.deregisterCallback(slowIds, testCallback);
+    dispatcher.getStats(&stats);
+    printStats("after overflow", &stats);
+    if (stats.dropped - dropped < MIXER_EVENT_QUEUE_DEPTH - 1) {
+        fprintf(stdout, "FAIL: %llu drops counted for %d events over the queue depth\n",
+                (unsigned long long)(stats.dropped - dropped), MIXER_EVENT_QUEUE_DEPTH);
+        status = -1;
+    }
+
+    dispatcher.stopAll();
+    if (!status)
+        fprintf(stdout, "PASS\n");
+
+    return status;
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+/*
+ * Applies and resets the given mixer paths through audio_route and through
+ * MixerPathPlanner on the same sound card, and reports the time per
+ * transition of both along with the control writes the planner skipped.
+ *
+ * Usage: PalMixerPathBench <card> <mixer paths xml> <iterations> <path>...
+ * The paths should be ones not in use by a running stream.
+ */
+
+#include "audio_route/audio_route.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <tinyalsa/asoundlib.h>
+#include "MixerPathPlanner.h"
+
+static uint64_t nowUs()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static uint64_t runAudioRoute(struct audio_route *ar, int iterations,
+                              int numPaths, char *paths[])
+{
+    uint64_t begin = nowUs();
+
+    for (int n = 0; n < iterations; n++) {
+        for (int i = 0; i < numPaths; i++)
+            audio_route_apply_and_update_path(ar, paths[i]);
+        for (int i = numPaths - 1; i >= 0; i--)
+            audio_route_reset_and_update_path(ar, paths[i]);
+    }
+    return nowUs() - begin;
+}
+
+static uint64_t runPlanner(MixerPathPlanner *planner, int iterations,
+                           int numPaths, char *paths[])
+{
+    uint64_t begin = nowUs();
+
+    for (int n = 0; n < iterations; n++) {
+        for (int i = 0; i < numPaths; i++)
+            planner->applyPath(paths[i]);
+        for (int i = numPaths - 1; i >= 0; i--)
+            planner->resetPath(paths[i]);
+    }
+    return nowUs() - begin;
+}
+
+int main(int argc, char *argv[])
+{
+    struct audio_route *ar = NULL;
+    struct mixer *mixer = NULL;
+    MixerPathPlanner planner;
+    uint64_t arUs = 0;
+    uint64_t plannerUs = 0;
+    uint32_t numTransitions = 0;
+    uint32_t numWrites = 0;
+    uint32_t numSkipped = 0;
+    int card = 0;
+    int iterations = 0;
+    int numPaths = 0;
+    int status = 0;
+
+    if (argc < 5) {
+        fprintf(stderr, "usage: %s <card> <mixer paths xml> <iterations> <path>...\n",
+                argv[0]);
+        return -1;
+    }
+    card = atoi(argv[1]);
+    iterations = atoi(argv[3]);
+    numPaths = argc - 4;
+
+    /* audio_route applies the initial state the planner reads back */
+    ar = audio_route_init(card, argv[2]);
+    if (!ar) {
+        fprintf(stderr, "audio_route_init failed for card %d\n", card);
+        return -1;
+    }
+    mixer = mixer_open(card);
+    if (!mixer) {
+        fprintf(stderr, "mixer_open failed for card %d\n", card);
+        status = -1;
+        goto exit;
+    }
+    status = planner.init(mixer, argv[2]);
+    if (status) {
+        fprintf(stderr, "planner init failed %d\n", status);
+        goto exit;
+    }
+
+    /* both leave every path reset, so each run starts from the same state */
+    arUs = runAudioRoute(ar, iterations, numPaths, &argv[4]);
+    plannerUs = runPlanner(&planner, iterations, numPaths, &argv[4]);
+    planner.getStats(&numTransitions, &numWrites, &numSkipped);
+
+    fprintf(stdout, "%d paths x %d iterations, %u transitions\n", numPaths,
+            iterations, numTransitions);
+    fprintf(stdout, "audio_route: %llu us, %llu us per transition\n",
+            (unsigned long long)arUs,
+            (unsigned long long)(arUs / (numTransitions ? numTransitions : 1)));
+    fprintf(stdout, "planner: %llu us, %llu us per transition, %u writes, %u skipped\n",
+            (unsigned long long)plannerUs,
+            (unsigned long long)(plannerUs / (numTransitions ? numTransitions : 1)),
+            numWrites, numSkipped);
+    planner.deinit();
+
+exit:
+    if (mixer)
+        mixer_close(mixer);
+    audio_route_free(ar);
+    return status;
+}
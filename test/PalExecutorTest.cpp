@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+/*
+ * Measures how late short timers of the shared PalExecutor fire while
+ * detection streams stop on the DSP and ACD clients sit in their event
+ * callbacks, simulated by tasks sleeping for a stop's duration. With the
+ * blocking work on the blocking instance the timers fire on time; the same
+ * work on the shared instance, as it used to run, holds both of its
+ * workers and delays every timer behind it. Also checks that the blocking
+ * instance still runs the tasks of one key in posting order.
+ *
+ * Usage: PalExecutorTest [rounds]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+#include "PalExecutor.h"
+
+#define DEFAULT_ROUNDS 10
+/* a stop of a detection stream or a slow client callback */
+#define BLOCKING_TASK_MS 100
+#define NUM_BLOCKING_STREAMS 4
+#define TIMER_DELAY_MS 5
+#define NUM_TIMERS 8
+/* a timer of the shared instance is late past this */
+#define MAX_TIMER_LATENESS_MS 20
+
+static uint64_t nowUs()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int check(bool cond, const char *what)
+{
+    fprintf(stdout, "%s: %s\n", cond ? "PASS" : "FAIL", what);
+    return cond ? 0 : -1;
+}
+
+/*
+ * Posts the blocking tasks on blocking, then arms short timers on shared
+ * and returns the worst lateness of the timers in us.
+ */
+static uint64_t runRound(std::shared_ptr<PalExecutor> blocking,
+                         std::shared_ptr<PalExecutor> shared)
+{
+    static int streams[NUM_BLOCKING_STREAMS];
+    static int timerKeys[NUM_TIMERS];
+    std::mutex lock;
+    std::condition_variable cv;
+    uint32_t done = 0;
+    uint64_t worst = 0;
+
+    for (auto &key : streams) {
+        blocking->post(&key, [&]() {
+            usleep(BLOCKING_TASK_MS * 1000);
+            std::lock_guard<std::mutex> lck(lock);
+            done++;
+            cv.notify_all();
+        });
+    }
+    /* let the workers pick the blocking tasks up */
+    usleep(2000);
+
+    for (auto &key : timerKeys) {
+        uint64_t armed = nowUs();
+        shared->postDelayed(&key, TIMER_DELAY_MS, [&, armed]() {
+            uint64_t late = nowUs() - armed;
+            late = late > TIMER_DELAY_MS * 1000 ? late - TIMER_DELAY_MS * 1000 : 0;
+            std::lock_guard<std::mutex> lck(lock);
+            worst = std::max(worst, late);
+            done++;
+            cv.notify_all();
+        });
+    }
+
+    std::unique_lock<std::mutex> lck(lock);
+    cv.wait(lck, [&] { return done == NUM_BLOCKING_STREAMS + NUM_TIMERS; });
+    return worst;
+}
+
+int main(int argc, char *argv[])
+{
+    std::shared_ptr<PalExecutor> shared = PalExecutor::getInstance();
+    std::shared_ptr<PalExecutor> blocking = PalExecutor::getBlockingInstance();
+    int rounds = argc > 1 ? atoi(argv[1]) : DEFAULT_ROUNDS;
+    uint64_t separateUs = 0;
+    uint64_t sameUs = 0;
+    std::vector<int> order;
+    std::mutex orderLock;
+    std::condition_variable orderCv;
+    int key = 0;
+    bool inOrder = true;
+    int status = 0;
+
+    status |= check(shared != blocking && PalExecutor::getBlockingInstance() == blocking,
+                    "blocking instance is separate and shared");
+
+    for (int n = 0; n < rounds; n++) {
+        separateUs = std::max(separateUs, runRound(blocking, shared));
+        sameUs = std::max(sameUs, runRound(shared, shared));
+    }
+    status |= check(separateUs < MAX_TIMER_LATENESS_MS * 1000,
+                    "shared timers on time while the blocking instance is busy");
+
+    for (int n = 0; n < 100; n++) {
+        blocking->post(&key, [&, n]() {
+            std::lock_guard<std::mutex> lck(orderLock);
+            order.push_back(n);
+            orderCv.notify_all();
+        });
+    }
+    {
+        std::unique_lock<std::mutex> lck(orderLock);
+        orderCv.wait(lck, [&] { return order.size() == 100; });
+    }
+    for (size_t n = 0; n < order.size(); n++)
+        inOrder = inOrder && order[n] == (int)n;
+    status |= check(inOrder, "blocking instance keeps the order of a key");
+
+    fprintf(stdout, "%d rounds, %d blocking tasks of %d ms: timers late by up to "
+            "%llu us on their own instance, %llu us sharing one\n", rounds,
+            NUM_BLOCKING_STREAMS, BLOCKING_TASK_MS,
+            (unsigned long long)separateUs, (unsigned long long)sameUs);
+    fprintf(stdout, "%s\n", status ? "FAIL" : "PASS");
+    return status;
+}
@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+/*
+ * Runs PalInitGraph bring-ups of timed fake steps. Checks that a step
+ * starts only once its dependencies are done while independent steps
+ * overlap, that the dependents of a failed or throwing step are skipped
+ * and run() returns the failure, and that unknown dependencies are
+ * refused. Then times a cold pal_init against a fake backend, the steps
+ * of the ResourceManager constructor and init() with their dependencies,
+ * the sound card showing up after a while, both serially as pal_init did
+ * before and through the graph.
+ *
+ * Usage: PalInitGraphTest [cold init runs]
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "PalInitGraph.h"
+
+#define DEFAULT_COLD_RUNS 3
+/* scheduling slack allowed on top of the critical path */
+#define MAX_SLACK_US 30000
+/* the fake mixer is polled like init_audio does, only faster */
+#define FAKE_CARD_POLL_US 50000
+
+/* begin and end of each fake step, by name */
+class Timeline {
+public:
+    std::function<int()> step(const char *name, uint32_t durationUs, int ret = 0)
+    {
+        return [this, name, durationUs, ret] {
+            uint64_t beginUs = nowUs();
+
+            usleep(durationUs);
+            std::lock_guard<std::mutex> lck(lock);
+            spans[name] = {beginUs, nowUs()};
+            return ret;
+        };
+    }
+
+    bool ran(const char *name)
+    {
+        return spans.count(name) != 0;
+    }
+
+    /* true if after began once before had ended */
+    bool ordered(const char *before, const char *after)
+    {
+        return ran(before) && ran(after) && spans[after].first >= spans[before].second;
+    }
+
+    bool overlapped(const char *a, const char *b)
+    {
+        return ran(a) && ran(b) && spans[a].first < spans[b].second &&
+               spans[b].first < spans[a].second;
+    }
+
+    static uint64_t nowUs()
+    {
+        struct timespec ts;
+
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+    }
+
+private:
+    std::map<std::string, std::pair<uint64_t, uint64_t>> spans;
+    std::mutex lock;
+};
+
+static int check(bool cond, const char *what)
+{
+    fprintf(stdout, "%s: %s\n", cond ? "PASS" : "FAIL", what);
+    return cond ? 0 : -1;
+}
+
+/* a -> {b, c} -> d, e on its own */
+static int orderTest()
+{
+    PalInitGraph graph("order");
+    Timeline t;
+    int a = 0, b = 0, c = 0, status = 0;
+
+    a = graph.addStep("a", {}, t.step("a", 20000));
+    b = graph.addStep("b", {a}, t.step("b", 30000));
+    c = graph.addStep("c", {a}, t.step("c", 30000));
+    graph.addStep("d", {b, c}, t.step("d", 10000));
+    graph.addStep("e", {}, t.step("e", 40000));
+
+    status |= check(graph.run() == 0, "run returns 0 when all steps succeed");
+    status |= check(t.ordered("a", "b") && t.ordered("a", "c"),
+                    "steps start after their dependency is done");
+    status |= check(t.ordered("b", "d") && t.ordered("c", "d"),
+                    "a step waits for all its dependencies");
+    status |= check(t.overlapped("b", "c") && t.overlapped("a", "e"),
+                    "independent steps overlap");
+
+    return status;
+}
+
+/* a fails, b depends on a, c on b; f throws, g depends on f; e is independent */
+static int failureTest()
+{
+    PalInitGraph graph("failure");
+    Timeline t;
+    int a = 0, b = 0, f = 0, ret = 0, status = 0;
+
+    a = graph.addStep("a", {}, t.step("a", 10000, -EIO));
+    b = graph.addStep("b", {a}, t.step("b", 10000));
+    graph.addStep("c", {b}, t.step("c", 10000));
+    f = graph.addStep("f", {}, []() -> int { throw std::runtime_error("fake"); });
+    graph.addStep("g", {f}, t.step("g", 10000));
+    graph.addStep("e", {}, t.step("e", 10000));
+
+    ret = graph.run();
+    status |= check(ret == -EIO, "run returns the status of the first failed step");
+    status |= check(!t.ran("b") && !t.ran("c"),
+                    "dependents of a failed step are skipped, transitively");
+    status |= check(!t.ran("g"), "dependents of a throwing step are skipped");
+    status |= check(t.ran("e"), "independent steps still run");
+
+    status |= check(graph.addStep("h", {42}, t.step("h", 0)) == -EINVAL,
+                    "unknown dependency is refused");
+    return status;
+}
+
+/*
+ * Fake backend: durations of the bring-up steps on a cold boot, the card
+ * registers cardDelayUs after pal_init started.
+ */
+struct fake_backend {
+    uint64_t startUs;
+    uint32_t cardDelayUs;
+};
+
+static int waitCard(struct fake_backend *be)
+{
+    while (Timeline::nowUs() - be->startUs < be->cardDelayUs)
+        usleep(FAKE_CARD_POLL_US);
+    return 0;
+}
+
+/* serial chains every step to the one before, the way pal_init ran them */
+static void addColdInit(PalInitGraph &graph, Timeline &t, struct fake_backend *be,
+                        bool serial)
+{
+    auto audio = t.step("init_audio", 20000);
+    int last = -1, sndXml = 0, card = 0, speaker = 0;
+    auto add = [&](const char *name, std::vector<int> deps, PalInitGraph::step_t fn) {
+        if (serial && last >= 0)
+            deps = {last};
+        last = graph.addStep(name, deps, fn);
+        return last;
+    };
+
+    /* ResourceManager constructor */
+    sndXml = add("snd_xml", {}, t.step("snd_xml", 30000));
+    card = add("init_audio", {sndXml}, [be, audio] {
+        waitCard(be);
+        return audio();
+    });
+    add("rm_xml", {card}, t.step("rm_xml", 60000));
+    add("usecase_xml", {}, t.step("usecase_xml", 120000));
+    add("agm_crash_cb", {}, t.step("agm_crash_cb", 40000));
+    add("wake_locks", {}, t.step("wake_locks", 5000));
+    /* ResourceManager::init() */
+    speaker = add("speaker", {}, t.step("speaker", 50000));
+    add("charger_listener", {speaker}, t.step("charger_listener", 30000));
+    add("vui_dmgr", {}, t.step("vui_dmgr", 80000));
+}
+
+/* worst time of runs cold inits, from the start of pal_init */
+static uint64_t timeColdInit(int runs, uint32_t cardDelayUs, bool serial, int *status)
+{
+    uint64_t elapsedUs = 0, worstUs = 0;
+
+    for (int r = 0; r < runs; r++) {
+        PalInitGraph graph(serial ? "serial init" : "cold init");
+        Timeline t;
+        struct fake_backend be = {Timeline::nowUs(), cardDelayUs};
+
+        addColdInit(graph, t, &be, serial);
+        *status |= graph.run();
+        elapsedUs = Timeline::nowUs() - be.startUs;
+        if (elapsedUs > worstUs)
+            worstUs = elapsedUs;
+        if (!t.ordered("init_audio", "rm_xml") || !t.ordered("speaker", "charger_listener"))
+            *status = -1;
+    }
+    return worstUs;
+}
+
+static int coldInitTest(int runs)
+{
+    /* the card chain: card wait, init_audio, rm_xml */
+    const uint32_t cardDelayUs = 250000;
+    const uint64_t criticalUs = cardDelayUs + 20000 + 60000;
+    uint64_t serialUs = 0, graphUs = 0;
+    int status = 0;
+
+    serialUs = timeColdInit(runs, cardDelayUs, true, &status);
+    graphUs = timeColdInit(runs, cardDelayUs, false, &status);
+
+    fprintf(stdout, "cold init, worst of %d runs: serial %llu us, graph %llu us, "
+            "critical path %llu us\n", runs, (unsigned long long)serialUs,
+            (unsigned long long)graphUs, (unsigned long long)criticalUs);
+    status = check(!status, "cold init steps succeed in dependency order");
+    status |= check(graphUs < criticalUs + FAKE_CARD_POLL_US + MAX_SLACK_US &&
+                    graphUs < serialUs, "cold init takes the critical path, not the serial sum");
+    return status;
+}
+
+int main(int argc, char *argv[])
+{
+    int runs = argc > 1 ? atoi(argv[1]) : DEFAULT_COLD_RUNS;
+    int status = 0;
+
+    status |= orderTest();
+    status |= failureTest();
+    status |= coldInitTest(runs);
+
+    fprintf(stdout, "%s\n", status ? "FAIL" : "PASS");
+    return status;
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+/*
+ * Measures the per call cost of the PAL log macros on the calling thread:
+ * a PAL_DBG recorded for the PalTraceLog thread, a PAL_DBG printing a
+ * string, which logs synchronously, a PAL_ERR with no record of the thread
+ * pending and a PAL_ERR that first writes out the pending records of the
+ * thread. Calls are made in batches smaller than a trace ring, so that no
+ * record is dropped, and the rings are flushed between batches, outside
+ * the measurement.
+ *
+ * Usage: PalTraceLogBench [batches]
+ */
+
+#define LOG_TAG "PAL: PalTraceLogBench"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "PalCommon.h"
+
+#define DEFAULT_BATCHES 100
+#define BATCH_SIZE 128
+
+static uint64_t nowNs()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* runs log(n) in batches and returns the average cost of a call in ns */
+template <typename Log>
+static uint64_t measure(int batches, Log log)
+{
+    uint64_t total = 0;
+    uint64_t begin = 0;
+
+    for (int b = 0; b < batches; b++) {
+        pal_trace_flush();
+        begin = nowNs();
+        for (int n = 0; n < BATCH_SIZE; n++)
+            log(n);
+        total += nowNs() - begin;
+    }
+    pal_trace_flush();
+
+    return total / ((uint64_t)batches * BATCH_SIZE);
+}
+
+int main(int argc, char *argv[])
+{
+    int batches = argc > 1 ? atoi(argv[1]) : DEFAULT_BATCHES;
+    const char *name = "speaker";
+    uint64_t dbgAsync = 0, dbgSync = 0, err = 0, errFlush = 0;
+
+    pal_log_lvl = PAL_LOG_ERR | PAL_LOG_INFO | PAL_LOG_DBG;
+
+    dbgAsync = measure(batches, [](int n) {
+        PAL_DBG(LOG_TAG, "bench record %d rate %u ch %d", n, 48000U, 2);
+    });
+    dbgSync = measure(batches, [&](int n) {
+        PAL_DBG(LOG_TAG, "bench device %s %d", name, n);
+    });
+    err = measure(batches, [](int n) {
+        PAL_ERR(LOG_TAG, "bench error %d", n);
+    });
+    /* every error writes out the record logged before it */
+    errFlush = measure(batches, [](int n) {
+        PAL_DBG(LOG_TAG, "bench before error %d", n);
+        PAL_ERR(LOG_TAG, "bench error %d", n);
+    });
+    pal_trace_deinit();
+
+    fprintf(stdout, "%d calls per case, ns per call: PAL_DBG recorded %llu, "
+            "PAL_DBG synchronous %llu, PAL_ERR %llu, PAL_DBG + PAL_ERR "
+            "flushing it %llu\n", batches * BATCH_SIZE,
+            (unsigned long long)dbgAsync, (unsigned long long)dbgSync,
+            (unsigned long long)err, (unsigned long long)errFlush);
+    return 0;
+}
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+/*
+ * Churns a PalVoteAggregator from several threads, the way streams vote
+ * for the sleep monitor on start and stop, against a fake driver that
+ * fails some pushes. Checks that the driver is on whenever a vote was
+ * pushed successfully and is still held, that no push repeats the driver
+ * state, and that once the deferred releases and retries settled the
+ * driver is on exactly while any vote is held.
+ *
+ * Usage: PalVoteAggregatorTest [rounds] [seed]
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+#include "PalVoteAggregator.h"
+
+#define DEFAULT_ROUNDS 4
+#define NUM_VOTERS 3
+#define VOTES_PER_ROUND 120
+#define MAX_PAUSE_US 2000
+/* one step in this many a voter drops its votes and idles */
+#define IDLE_ONE_IN 25
+#define MAX_IDLE_US (3 * PAL_VOTE_RELEASE_DELAY_MS * 1000)
+/* one push in this many fails, never more than the retries in a row */
+#define FAIL_ONE_IN 3
+/* deferred release, hold time and the retries of a failing push */
+#define SETTLE_MS (PAL_VOTE_MIN_HOLD_MS + \
+                   (PAL_VOTE_PUSH_RETRIES + 2) * PAL_VOTE_RELEASE_DELAY_MS)
+
+class FakeDriver {
+public:
+    FakeDriver(unsigned int seed) : on(false), pushes(0), failures(0),
+        redundant(0), failStreak(0), rng(seed) {}
+
+    int apply(bool enable)
+    {
+        std::lock_guard<std::mutex> lck(lock);
+
+        if (failStreak < PAL_VOTE_PUSH_RETRIES && rng() % FAIL_ONE_IN == 0) {
+            failStreak++;
+            failures++;
+            return -EIO;
+        }
+        failStreak = 0;
+        if (on == enable)
+            redundant++;
+        on = enable;
+        pushes++;
+        return 0;
+    }
+
+    bool isOn()
+    {
+        std::lock_guard<std::mutex> lck(lock);
+
+        return on;
+    }
+
+    bool on;
+    uint32_t pushes;
+    uint32_t failures;
+    uint32_t redundant;
+
+private:
+    uint32_t failStreak;
+    std::minstd_rand rng;
+    std::mutex lock;
+};
+
+static int check(bool cond, const char *what)
+{
+    fprintf(stdout, "%s: %s\n", cond ? "PASS" : "FAIL", what);
+    return cond ? 0 : -1;
+}
+
+int main(int argc, char *argv[])
+{
+    int rounds = argc > 1 ? atoi(argv[1]) : DEFAULT_ROUNDS;
+    unsigned int seed = argc > 2 ? (unsigned int)atoi(argv[2]) : 1;
+    FakeDriver driver(seed);
+    PalVoteAggregator aggregator("test", [&](bool enable) { return driver.apply(enable); });
+    std::vector<int> held(NUM_VOTERS, 0);
+    std::atomic<uint32_t> offWhileHeld(0);
+    struct pal_power_vote_counters stats;
+    int numHeld = 0;
+    bool settled = true;
+    int status = 0;
+
+    for (int r = 0; r < rounds; r++) {
+        std::vector<std::thread> voters;
+
+        for (int v = 0; v < NUM_VOTERS; v++) {
+            voters.emplace_back([&, v]() {
+                std::minstd_rand rng(seed * 131 + r * NUM_VOTERS + v);
+
+                for (int n = 0; n < VOTES_PER_ROUND; n++) {
+                    /* voters hold up to two votes, as a stream and its session may */
+                    if (held[v] < 2 && (held[v] == 0 || rng() % 2)) {
+                        held[v]++;
+                        if (!aggregator.vote(true) && !driver.isOn())
+                            offWhileHeld++;
+                    } else {
+                        held[v]--;
+                        aggregator.vote(false);
+                    }
+                    if (rng() % IDLE_ONE_IN) {
+                        usleep(rng() % MAX_PAUSE_US);
+                        continue;
+                    }
+                    for (; held[v] > 0; held[v]--)
+                        aggregator.vote(false);
+                    usleep(rng() % MAX_IDLE_US);
+                }
+                /* every other round, some voters keep a vote held */
+                while (held[v] > (r % 2 ? (int)(rng() % 2) : 0)) {
+                    held[v]--;
+                    aggregator.vote(false);
+                }
+            });
+        }
+        for (auto &t : voters)
+            t.join();
+
+        usleep(SETTLE_MS * 1000);
+        numHeld = 0;
+        for (auto h : held)
+            numHeld += h;
+        aggregator.getStats(&stats);
+        if (driver.isOn() != (numHeld > 0) || stats.active != (uint32_t)numHeld) {
+            fprintf(stdout, "round %d: %d votes held, driver %s\n", r, numHeld,
+                    driver.isOn() ? "on" : "off");
+            settled = false;
+        }
+    }
+
+    status |= check(offWhileHeld == 0, "driver on while a pushed vote is held");
+    status |= check(driver.redundant == 0, "no push repeats the driver state");
+    status |= check(settled, "settled driver state matches the votes held");
+    status |= check(driver.failures > 0, "pushes failed and were retried");
+
+    aggregator.getStats(&stats);
+    fprintf(stdout, "%d rounds: %u votes, %u unvotes, %u driver pushes, %u failed, "
+            "%u suppressed\n", rounds, stats.votes, stats.unvotes, driver.pushes,
+            driver.failures, stats.suppressed);
+    fprintf(stdout, "%s\n", status ? "FAIL" : "PASS");
+    return status;
+}
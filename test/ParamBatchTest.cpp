@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+/*
+ * Builds the params a playback start sends (device MFC, MSPP gain, soft
+ * pause delay and EC MFC) into a ParamBatch over many starts and checks
+ * that the batch lays each one out behind its module header, 8 byte
+ * aligned, and that it stops allocating once it has grown to its working
+ * size. Reports the allocations against the one per param the per-module
+ * builders made before.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ParamBatch.h"
+
+#define NUM_STARTS 1000
+#define NUM_PARAMS 4
+
+/* stand-ins with the sizes of the start time params */
+struct mfcConfig {
+    uint32_t sampleRate;
+    uint16_t bitWidth;
+    uint16_t numChannels;
+};
+
+struct msppGain {
+    uint32_t gain;
+};
+
+struct softPauseDelay {
+    uint32_t delayMs;
+};
+
+static const struct {
+    uint32_t miid;
+    uint32_t paramId;
+    size_t size;
+    size_t extra;
+} startParams[NUM_PARAMS] = {
+    {0x4001, 0x8001, sizeof(struct mfcConfig), 2 * sizeof(uint16_t)},
+    {0x4002, 0x8002, sizeof(struct msppGain), 0},
+    {0x4003, 0x8003, sizeof(struct softPauseDelay), 0},
+    {0x4004, 0x8001, sizeof(struct mfcConfig), 8 * sizeof(uint16_t)},
+};
+
+static int check(bool cond, const char *what)
+{
+    fprintf(stdout, "%s: %s\n", cond ? "PASS" : "FAIL", what);
+    return cond ? 0 : -1;
+}
+
+static int buildStart(ParamBatch &batch, uint32_t sampleRate)
+{
+    struct mfcConfig *mfc = NULL;
+    uint8_t *param = NULL;
+
+    for (int i = 0; i < NUM_PARAMS; i++) {
+        param = batch.appendParam(startParams[i].miid, startParams[i].paramId,
+                                  startParams[i].size + startParams[i].extra);
+        if (!param)
+            return -1;
+        if (startParams[i].paramId == 0x8001) {
+            mfc = (struct mfcConfig *)param;
+            mfc->sampleRate = sampleRate;
+            mfc->bitWidth = 16;
+            mfc->numChannels = (uint16_t)(startParams[i].extra / sizeof(uint16_t));
+        }
+    }
+    return 0;
+}
+
+/* walks the batch the way the DSP does and checks every header */
+static bool layoutValid(const ParamBatch &batch, uint32_t sampleRate)
+{
+    const struct apm_module_param_data_t *header = NULL;
+    const struct mfcConfig *mfc = NULL;
+    size_t offset = 0;
+    size_t paramSize = 0;
+
+    for (int i = 0; i < NUM_PARAMS; i++) {
+        if (offset % 8 || offset + sizeof(*header) > batch.size())
+            return false;
+        header = (const struct apm_module_param_data_t *)(batch.data() + offset);
+        paramSize = startParams[i].size + startParams[i].extra;
+        if (header->module_instance_id != startParams[i].miid ||
+            header->param_id != startParams[i].paramId ||
+            header->param_size != paramSize || header->error_code)
+            return false;
+        if (header->param_id == 0x8001) {
+            mfc = (const struct mfcConfig *)(header + 1);
+            if (mfc->sampleRate != sampleRate)
+                return false;
+        }
+        offset += (sizeof(*header) + paramSize + 7) & ~(size_t)7;
+    }
+    return offset == batch.size();
+}
+
+int main(int argc __unused, char *argv[] __unused)
+{
+    ParamBatch batch;
+    uint8_t *released = NULL;
+    size_t releasedSize = 0;
+    uint32_t allocs = 0;
+    bool layoutOk = true;
+    int status = 0;
+
+    status |= check(batch.empty() && batch.getAllocCount() == 0,
+                    "new batch holds no storage");
+
+    /* every start resets the batch and builds the same params again */
+    for (int n = 0; n < NUM_STARTS; n++) {
+        batch.reset();
+        if (buildStart(batch, 48000 + n)) {
+            status |= check(false, "append failed");
+            break;
+        }
+        layoutOk = layoutOk && layoutValid(batch, 48000 + n);
+        if (n == 0)
+            allocs = batch.getAllocCount();
+    }
+    status |= check(layoutOk, "params laid out behind their headers, 8 byte aligned");
+    status |= check(allocs == 1, "first start allocates once");
+    status |= check(batch.getAllocCount() == allocs,
+                    "later starts reuse the storage");
+
+    /* a param bigger than the storage grows it, once */
+    allocs = batch.getAllocCount();
+    batch.reset();
+    status |= check(batch.appendParam(0x5001, 0x9001, 4 * PARAM_BATCH_MIN_CAPACITY) != NULL &&
+                    batch.getAllocCount() == allocs + 1,
+                    "large param grows the storage in one step");
+    allocs = batch.getAllocCount();
+    batch.reset();
+    buildStart(batch, 48000);
+    status |= check(batch.getAllocCount() == allocs, "grown storage is kept on reset");
+
+    /* release hands the payload over, to be freed with free() */
+    released = batch.release(&releasedSize);
+    status |= check(released && releasedSize && batch.empty() && batch.capacity() == 0,
+                    "release hands over the payload");
+    free(released);
+    released = batch.release(&releasedSize);
+    status |= check(!released && releasedSize == 0, "release of an empty batch");
+
+    fprintf(stdout, "%d starts x %d params: %u allocations, %d with one per param\n",
+            NUM_STARTS, NUM_PARAMS, batch.getAllocCount(), NUM_STARTS * NUM_PARAMS);
+    fprintf(stdout, "%s\n", status ? "FAIL" : "PASS");
+    return status;
+}
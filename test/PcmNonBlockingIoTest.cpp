@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+/*
+ * Drives the io of PAL_STREAM_FLAG_NON_BLOCKING PCM streams against a fake
+ * pcm whose capture level or playback queue the test moves by hand. Checks
+ * that io never calls into a pcm that is not ready, which on a real pcm
+ * would wait for a period, that it returns -EAGAIN or a short count
+ * instead, that the ready eventfd stays quiet until the pcm is ready again
+ * and is then signalled, that pcm errors are returned and wake up pollers,
+ * and that stop wakes up a client still polling.
+ *
+ * Usage: PalPcmNonBlockingIoTest
+ */
+
+#include <errno.h>
+#include <poll.h>
+#include <stdio.h>
+#include <sys/eventfd.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "PcmNonBlockingIo.h"
+
+#define PERIOD_BYTES 192
+#define NUM_PERIODS 4
+#define BUFFER_BYTES (PERIOD_BYTES * NUM_PERIODS)
+/* how long a poller may take to see the pcm ready */
+#define MAX_WAKEUP_MS 100
+
+/* capture: bytes captured and not read yet; playback: bytes queued */
+class FakePcm {
+public:
+    FakePcm(bool capture) : capture(capture), level(0), error(0), blockingCalls(0),
+        ioCalls(0), timedWaits(0) {}
+
+    bool ready_l() { return capture ? level >= PERIOD_BYTES : BUFFER_BYTES - level >= PERIOD_BYTES; }
+
+    int wait(int timeoutMs)
+    {
+        std::unique_lock<std::mutex> lck(lock);
+
+        if (timeoutMs)
+            timedWaits++;
+        cv.wait_for(lck, std::chrono::milliseconds(timeoutMs),
+                    [&] { return error || ready_l(); });
+        if (error)
+            return error;
+        return ready_l() ? 1 : 0;
+    }
+
+    int io(size_t count)
+    {
+        std::lock_guard<std::mutex> lck(lock);
+
+        ioCalls++;
+        if (error)
+            return error;
+        if (capture ? level < count : BUFFER_BYTES - level < count) {
+            blockingCalls++;
+            return -EIO;
+        }
+        level = capture ? level - count : level + count;
+        return 0;
+    }
+
+    /* capture runs or playback drains by bytes */
+    void advance(size_t bytes)
+    {
+        std::lock_guard<std::mutex> lck(lock);
+
+        level = capture ? std::min(level + bytes, (size_t)BUFFER_BYTES) :
+                          (level > bytes ? level - bytes : 0);
+        cv.notify_all();
+    }
+
+    void setError(int err)
+    {
+        std::lock_guard<std::mutex> lck(lock);
+
+        error = err;
+        cv.notify_all();
+    }
+
+    bool capture;
+    size_t level;
+    int error;
+    uint32_t blockingCalls;
+    uint32_t ioCalls;
+    uint32_t timedWaits;
+    std::mutex lock;
+    std::condition_variable cv;
+};
+
+static FakePcm *fake(struct pcm *pcm)
+{
+    return reinterpret_cast<FakePcm *>(pcm);
+}
+
+static const struct pcm_io_ops fakeIoOps = {
+    [](struct pcm *pcm, int timeoutMs) { return fake(pcm)->wait(timeoutMs); },
+    [](struct pcm *pcm, void *data, unsigned int count) { return fake(pcm)->io(count); },
+    [](struct pcm *pcm, const void *data, unsigned int count) {
+        return fake(pcm)->io(count);
+    },
+};
+
+static int check(bool cond, const char *what)
+{
+    fprintf(stdout, "%s: %s\n", cond ? "PASS" : "FAIL", what);
+    return cond ? 0 : -1;
+}
+
+/* ms until fd is readable, -1 if not within timeoutMs; consumes the event */
+static int pollReady(int fd, int timeoutMs)
+{
+    struct pollfd pfd = {fd, POLLIN, 0};
+    struct timespec begin, end;
+    eventfd_t value;
+
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    if (poll(&pfd, 1, timeoutMs) != 1)
+        return -1;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    eventfd_read(fd, &value);
+    return (end.tv_sec - begin.tv_sec) * 1000 + (end.tv_nsec - begin.tv_nsec) / 1000000;
+}
+
+/* advances the fake pcm from another thread after delayMs */
+static std::thread advanceLater(FakePcm &pcm, size_t bytes, int delayMs)
+{
+    return std::thread([&pcm, bytes, delayMs]() {
+        usleep(delayMs * 1000);
+        pcm.advance(bytes);
+    });
+}
+
+static int captureTest()
+{
+    FakePcm fakePcm(true);
+    struct pcm *pcm = reinterpret_cast<struct pcm *>(&fakePcm);
+    PcmNonBlockingIo io(&fakeIoOps);
+    std::vector<uint8_t> data(BUFFER_BYTES);
+    int size = 0, ret = 0, status = 0;
+
+    status |= check(io.init() == 0 && io.getReadyFd() >= 0, "capture ready fd created");
+    io.start(pcm);
+
+    ret = io.read(pcm, data.data(), PERIOD_BYTES, PERIOD_BYTES, &size);
+    status |= check(ret == -EAGAIN && fakePcm.ioCalls == 0,
+                    "read of an empty capture returns -EAGAIN without reading");
+    status |= check(pollReady(io.getReadyFd(), 0) < 0, "ready fd quiet while nothing captured");
+
+    std::thread t = advanceLater(fakePcm, PERIOD_BYTES, 20);
+    ret = pollReady(io.getReadyFd(), MAX_WAKEUP_MS + 20);
+    t.join();
+    status |= check(ret >= 0, "ready fd signalled once a period is captured");
+    ret = io.read(pcm, data.data(), PERIOD_BYTES, PERIOD_BYTES, &size);
+    status |= check(ret == 0 && size == PERIOD_BYTES, "read returns the captured period");
+
+    fakePcm.advance(PERIOD_BYTES);
+    ret = io.read(pcm, data.data(), 3 * PERIOD_BYTES, PERIOD_BYTES, &size);
+    status |= check(ret == 0 && size == PERIOD_BYTES,
+                    "read returns a short count with less than asked captured");
+    t = advanceLater(fakePcm, 2 * PERIOD_BYTES, 20);
+    ret = pollReady(io.getReadyFd(), MAX_WAKEUP_MS + 20);
+    t.join();
+    status |= check(ret >= 0, "ready fd signalled after a short read");
+    ret = io.read(pcm, data.data(), 2 * PERIOD_BYTES, PERIOD_BYTES, &size);
+    status |= check(ret == 0 && size == 2 * PERIOD_BYTES, "read returns the rest");
+
+    /* armed and idle, the notifier only wakes up every PCM_READY_WAIT_MS */
+    fakePcm.timedWaits = 0;
+    io.read(pcm, data.data(), PERIOD_BYTES, PERIOD_BYTES, &size);
+    usleep(100 * 1000);
+    status |= check(fakePcm.timedWaits <= 100 / PCM_READY_WAIT_MS + 2,
+                    "notifier does not spin while the pcm is not ready");
+
+    fakePcm.setError(-EPIPE);
+    ret = pollReady(io.getReadyFd(), MAX_WAKEUP_MS);
+    status |= check(ret >= 0, "ready fd signalled on a pcm error");
+    ret = io.read(pcm, data.data(), PERIOD_BYTES, PERIOD_BYTES, &size);
+    status |= check(ret == -EPIPE, "read returns the pcm error, not -EAGAIN");
+
+    fakePcm.setError(0);
+    io.read(pcm, data.data(), PERIOD_BYTES, PERIOD_BYTES, &size);
+    t = std::thread([&]() {
+        usleep(20 * 1000);
+        io.stop();
+    });
+    ret = pollReady(io.getReadyFd(), MAX_WAKEUP_MS + 20);
+    t.join();
+    status |= check(ret >= 0, "stop wakes up a polling client");
+    status |= check(fakePcm.blockingCalls == 0, "capture never read from a pcm not ready");
+
+    return status;
+}
+
+static int playbackTest()
+{
+    FakePcm fakePcm(false);
+    struct pcm *pcm = reinterpret_cast<struct pcm *>(&fakePcm);
+    PcmNonBlockingIo io(&fakeIoOps);
+    std::vector<uint8_t> data(2 * BUFFER_BYTES);
+    int size = 0, ret = 0, status = 0;
+
+    io.init();
+    io.start(pcm);
+
+    ret = io.write(pcm, data.data(), 2 * BUFFER_BYTES, PERIOD_BYTES, &size);
+    status |= check(ret == 0 && size == BUFFER_BYTES,
+                    "write fills the playback buffer and returns a short count");
+    fakePcm.ioCalls = 0;
+    ret = io.write(pcm, data.data(), PERIOD_BYTES, PERIOD_BYTES, &size);
+    status |= check(ret == -EAGAIN && fakePcm.ioCalls == 0,
+                    "write to a full buffer returns -EAGAIN without writing");
+    status |= check(pollReady(io.getReadyFd(), 0) < 0, "ready fd quiet while the buffer is full");
+
+    std::thread t = advanceLater(fakePcm, PERIOD_BYTES, 20);
+    ret = pollReady(io.getReadyFd(), MAX_WAKEUP_MS + 20);
+    t.join();
+    status |= check(ret >= 0, "ready fd signalled once a period is played");
+    ret = io.write(pcm, data.data(), 2 * PERIOD_BYTES, PERIOD_BYTES, &size);
+    status |= check(ret == 0 && size == PERIOD_BYTES, "write takes the free period");
+
+    fakePcm.setError(-EPIPE);
+    ret = io.write(pcm, data.data(), PERIOD_BYTES, PERIOD_BYTES, &size);
+    status |= check(ret == -EPIPE, "write returns the pcm error, not -EAGAIN");
+
+    io.stop();
+    status |= check(pollReady(io.getReadyFd(), 0) >= 0, "stop signals the ready fd");
+    status |= check(fakePcm.blockingCalls == 0, "playback never wrote to a pcm not ready");
+
+    return status;
+}
+
+int main()
+{
+    int status = 0;
+
+    status |= captureTest();
+    status |= playbackTest();
+
+    fprintf(stdout, "%s\n", status ? "FAIL" : "PASS");
+    return status;
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+/*
+ * Parses the given resource manager xml files as a whole, the way boot did
+ * before, and section by section the way ResourceManager does now, and
+ * reports per file the time to the first stream open (read, index and
+ * eager sections) against the full parse, along with the time spent later
+ * on the deferred sections when they are first used.
+ *
+ * Usage: PalRmXmlBench <iterations> <resource manager xml>...
+ * e.g. PalRmXmlBench 20 configs/kalama/resourcemanager_kalama_mtp.xml
+ * The parsed tables accumulate over the runs, run it on an idle device.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <time.h>
+#include <vector>
+#include "ResourceManager.h"
+
+/* the sections ResourceManager defers to first use */
+static const char *deferredSections[] = {
+    "sound_trigger_platform_info",
+    "bt_codecs",
+    "gain_db_to_level_mapping",
+    "group_device_cfg",
+};
+
+static uint64_t nowUs()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int readFile(const char *path, std::string &xml)
+{
+    FILE *file = fopen(path, "r");
+    long size = 0;
+
+    if (!file)
+        return -1;
+    if (fseek(file, 0, SEEK_END) == 0)
+        size = ftell(file);
+    rewind(file);
+    if (size > 0) {
+        xml.resize(size);
+        xml.resize(fread(&xml[0], 1, size, file));
+    }
+    fclose(file);
+    return xml.empty() ? -1 : 0;
+}
+
+static int benchFile(const char *path, int iterations)
+{
+    std::map<std::string, std::vector<std::pair<size_t, size_t>>> sections;
+    std::string xml;
+    uint64_t fullUs = 0;
+    uint64_t indexUs = 0;
+    uint64_t eagerUs = 0;
+    uint64_t deferredUs = 0;
+    uint64_t begin = 0;
+    size_t numDeferred = 0;
+
+    if (readFile(path, xml)) {
+        fprintf(stderr, "%s: cannot read\n", path);
+        return -1;
+    }
+    begin = nowUs();
+    if (ResourceManager::indexXmlSections(xml, sections)) {
+        fprintf(stderr, "%s: cannot be indexed, parsed as a whole at boot\n", path);
+        return -1;
+    }
+    indexUs = nowUs() - begin;
+    for (auto name : deferredSections)
+        numDeferred += sections.count(name);
+
+    for (int n = 0; n < iterations; n++) {
+        begin = nowUs();
+        if (ResourceManager::XmlParser(path)) {
+            fprintf(stderr, "%s: full parse failed\n", path);
+            return -1;
+        }
+        fullUs += nowUs() - begin;
+
+        begin = nowUs();
+        if (ResourceManager::XmlSectionParser(path)) {
+            fprintf(stderr, "%s: section parse failed\n", path);
+            return -1;
+        }
+        eagerUs += nowUs() - begin;
+
+        begin = nowUs();
+        for (auto name : deferredSections)
+            ResourceManager::loadXmlSection(name);
+        deferredUs += nowUs() - begin;
+    }
+
+    fprintf(stdout, "%s: %zu bytes, %zu sections, %zu deferred\n", path, xml.size(),
+            sections.size(), numDeferred);
+    fprintf(stdout, "  full parse %llu us, to first open %llu us (index %llu us), "
+            "deferred %llu us\n",
+            (unsigned long long)(fullUs / iterations),
+            (unsigned long long)(eagerUs / iterations),
+            (unsigned long long)indexUs,
+            (unsigned long long)(deferredUs / iterations));
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    int iterations = 0;
+    int status = 0;
+
+    if (argc < 3) {
+        fprintf(stderr, "usage: %s <iterations> <resource manager xml>...\n", argv[0]);
+        return -1;
+    }
+    iterations = atoi(argv[1]);
+    if (iterations <= 0) {
+        fprintf(stderr, "invalid iterations %s\n", argv[1]);
+        return -1;
+    }
+
+    for (int i = 2; i < argc; i++)
+        status |= benchFile(argv[i], iterations);
+
+    fprintf(stdout, "%s\n", status ? "FAIL" : "PASS");
+    return status;
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+/*
+ * Runs SpkrTempSampler against a fake mixer whose temperature controls
+ * are plain integers. Checks that the channels are read in one pass and
+ * served from the cache, that small moves stay below the hysteresis, that
+ * a waiter on an idle speaker re-samples on timeout instead of blocking,
+ * and that wakeWaiters() ends a wait early.
+ */
+
+#include <atomic>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+#include <time.h>
+#include <unistd.h>
+#include <tinyalsa/asoundlib.h>
+#include "SpkrTempSampler.h"
+
+#define NUM_CTLS 2
+#define WAIT_MS 200
+
+struct mixer {
+    int unused;
+};
+
+struct mixer_ctl {
+    const char *name;
+    std::atomic<int> value;
+};
+
+static struct mixer fakeMixer;
+static struct mixer_ctl fakeCtls[NUM_CTLS] = {
+    {"SpkrLeft WSA Temp", {0}},
+    {"SpkrRight WSA Temp", {0}},
+};
+static std::atomic<uint32_t> numReads(0);
+
+/* the fake mixer, in place of the tinyalsa one */
+struct mixer_ctl *mixer_get_ctl_by_name(struct mixer *mixer, const char *name)
+{
+    if (mixer != &fakeMixer)
+        return NULL;
+    for (int i = 0; i < NUM_CTLS; i++) {
+        if (!strcmp(fakeCtls[i].name, name))
+            return &fakeCtls[i];
+    }
+    return NULL;
+}
+
+int mixer_ctl_get_value(struct mixer_ctl *ctl, unsigned int id __unused)
+{
+    numReads++;
+    return ctl->value.load();
+}
+
+static uint64_t nowMs()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static int check(bool cond, const char *what)
+{
+    fprintf(stdout, "%s: %s\n", cond ? "PASS" : "FAIL", what);
+    return cond ? 0 : -1;
+}
+
+int main(int argc __unused, char *argv[] __unused)
+{
+    SpkrTempSampler sampler;
+    std::vector<std::string> ctlNames = {
+        "SpkrLeft WSA Temp", "SpkrRight WSA Temp", "SpkrMissing WSA Temp"};
+    int temps[3] = {0};
+    uint32_t reads = 0;
+    uint64_t begin = 0;
+    bool changed = false;
+    int status = 0;
+
+    fakeCtls[0].value = 30;
+    fakeCtls[1].value = 32;
+    status |= check(sampler.init(&fakeMixer, ctlNames) == 0,
+                    "init with one unresolved control");
+
+    sampler.getTemperatures(temps, 3);
+    status |= check(temps[0] == 30 && temps[1] == 32 && temps[2] == -EINVAL,
+                    "temperatures of all channels, -EINVAL without control");
+    status |= check(numReads.load() == NUM_CTLS,
+                    "resolved channels read in a single pass");
+
+    /* within SPKR_TEMP_CACHE_MS the cached sample is returned */
+    reads = numReads.load();
+    fakeCtls[0].value = 60;
+    status |= check(sampler.getTemperature(0) == 30 && numReads.load() == reads,
+                    "reads within the cache window served from the cache");
+    sampler.getTemperatures(temps, 1, true);
+    status |= check(temps[0] == 60, "forced read bypasses the cache");
+
+    status |= check(!sampler.isInRange(0, 55), "out of range above the limit");
+    fakeCtls[0].value = 54;
+    sampler.getTemperatures(temps, 1, true);
+    status |= check(!sampler.isInRange(0, 55),
+                    "stays out of range inside the hysteresis band");
+    fakeCtls[0].value = 40;
+    sampler.getTemperatures(temps, 1, true);
+    status |= check(sampler.isInRange(0, 55), "back in range well inside");
+
+    /* a move below the hysteresis does not count as a change */
+    fakeCtls[0].value = 40 + SPKR_TEMP_HYSTERESIS - 1;
+    status |= check(!sampler.waitForChange(WAIT_MS),
+                    "move below hysteresis is not a change");
+
+    /* idle speaker: nobody else samples, the waiter must not hang */
+    fakeCtls[1].value = 32 + SPKR_TEMP_HYSTERESIS;
+    begin = nowMs();
+    changed = sampler.waitForChange(WAIT_MS);
+    fprintf(stdout, "idle wait returned after %llu ms\n",
+            (unsigned long long)(nowMs() - begin));
+    status |= check(changed, "idle wait re-samples on timeout and sees the change");
+
+    /* another caller sampling wakes the waiter before the timeout */
+    std::thread reader([&sampler] {
+        int temp = 0;
+
+        usleep(WAIT_MS * 1000 / 2);
+        fakeCtls[0].value = 70;
+        sampler.getTemperatures(&temp, 1, true);
+    });
+    begin = nowMs();
+    changed = sampler.waitForChange(10 * WAIT_MS);
+    status |= check(changed && nowMs() - begin < 10 * WAIT_MS,
+                    "sample taken by another caller wakes the waiter");
+    reader.join();
+
+    /* wakeWaiters ends the wait early without a change */
+    std::thread waker([&sampler] {
+        usleep(WAIT_MS * 1000 / 2);
+        sampler.wakeWaiters();
+    });
+    begin = nowMs();
+    changed = sampler.waitForChange(10 * WAIT_MS);
+    status |= check(!changed && nowMs() - begin < 10 * WAIT_MS,
+                    "wakeWaiters ends the wait early");
+    waker.join();
+
+    fprintf(stdout, "%s, %u control reads\n", status ? "FAIL" : "PASS",
+            numReads.load());
+    return status;
+}
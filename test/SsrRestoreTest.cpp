@@ -0,0 +1,234 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+/*
+ * Restores streams on a fake sound card after SSR through the
+ * SsrOrchestrator groups and checks that the card never sees two streams
+ * restarted on one device at once, that a TX stream restarts only once
+ * the RX streams it takes its echo reference from run again, whichever
+ * was registered first, and that a group otherwise restarts in
+ * registration order. Runs a fixed usecase set, where the independent
+ * groups have to restore concurrently, and random ones.
+ *
+ * Usage: PalSsrRestoreTest [random scenarios] [seed]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <algorithm>
+#include <mutex>
+#include <vector>
+#include "SsrOrchestrator.h"
+
+#define DEFAULT_SCENARIOS 500
+#define MAX_RANDOM_STREAMS 16
+#define NUM_RANDOM_DEVICES 5
+#define RESTART_US 2000
+
+/* stand-ins for the restore classes, any non zero value groups streams */
+#define CLASS_VOICE 1
+#define CLASS_DETECTION 2
+
+class FakeCard {
+public:
+    FakeCard(const std::vector<SsrOrchestrator::streamInfo> &info)
+        : maxConcurrent(0), streams(info), running(info.size(), false),
+          restarts(info.size(), 0), busy(info.size(), false), concurrent(0),
+          failure(NULL) {}
+
+    void restart(size_t i)
+    {
+        {
+            std::lock_guard<std::mutex> lck(lock);
+            for (size_t j = 0; j < streams.size(); j++) {
+                if (busy[j] && sharesDevice(i, j))
+                    fail("two streams restarted on one device at once");
+            }
+            for (auto ref : streams[i].ecRefs) {
+                if (!running[ref])
+                    fail("TX restarted before its echo reference");
+            }
+            busy[i] = true;
+            maxConcurrent = std::max(maxConcurrent, ++concurrent);
+        }
+        usleep(RESTART_US);
+        {
+            std::lock_guard<std::mutex> lck(lock);
+            busy[i] = false;
+            concurrent--;
+            running[i] = true;
+            restarts[i]++;
+            order.push_back(i);
+        }
+    }
+
+    /* checks the outcome once all groups are restored */
+    const char *verify(const std::vector<std::vector<size_t>> &groups)
+    {
+        std::vector<size_t> pos(streams.size(), 0);
+
+        for (size_t i = 0; i < streams.size(); i++) {
+            if (restarts[i] != 1)
+                return "stream not restarted exactly once";
+        }
+        for (size_t n = 0; n < order.size(); n++)
+            pos[order[n]] = n;
+        for (auto &group : groups) {
+            for (size_t a = 0; a < group.size(); a++) {
+                for (size_t b = a + 1; b < group.size(); b++) {
+                    size_t i = std::min(group[a], group[b]);
+                    size_t j = std::max(group[a], group[b]);
+                    if (pos[i] > pos[j] && !pulledAhead(j, i))
+                        return "group restarted out of registration order";
+                }
+            }
+        }
+        return failure;
+    }
+
+    std::vector<size_t> order;
+    int maxConcurrent;
+
+private:
+    void fail(const char *what)
+    {
+        if (!failure)
+            failure = what;
+    }
+
+    bool sharesDevice(size_t i, size_t j)
+    {
+        for (auto id : streams[i].deviceIds) {
+            if (std::find(streams[j].deviceIds.begin(), streams[j].deviceIds.end(), id) !=
+                streams[j].deviceIds.end())
+                return true;
+        }
+        return false;
+    }
+
+    /* an EC ref restarts ahead of the TX streams registered up to i */
+    bool pulledAhead(size_t rx, size_t i)
+    {
+        for (size_t tx = 0; tx <= i; tx++) {
+            if (std::find(streams[tx].ecRefs.begin(), streams[tx].ecRefs.end(), rx) !=
+                streams[tx].ecRefs.end())
+                return true;
+        }
+        return false;
+    }
+
+    const std::vector<SsrOrchestrator::streamInfo> &streams;
+    std::vector<bool> running;
+    std::vector<int> restarts;
+    std::vector<bool> busy;
+    int concurrent;
+    const char *failure;
+    std::mutex lock;
+};
+
+static int check(bool cond, const char *what)
+{
+    fprintf(stdout, "%s: %s\n", cond ? "PASS" : "FAIL", what);
+    return cond ? 0 : -1;
+}
+
+static const char *restore(const std::vector<SsrOrchestrator::streamInfo> &streams,
+                           FakeCard &card, size_t *numGroups)
+{
+    std::vector<std::vector<size_t>> groups;
+    size_t numStreams = 0;
+
+    SsrOrchestrator::planGroups(streams, groups);
+    for (auto &group : groups)
+        numStreams += group.size();
+    if (numStreams != streams.size())
+        return "groups do not hold every stream once";
+    SsrOrchestrator::runGroups(groups, [&](size_t i) { card.restart(i); });
+    if (numGroups)
+        *numGroups = groups.size();
+    return card.verify(groups);
+}
+
+static void randomScenario(std::vector<SsrOrchestrator::streamInfo> &streams)
+{
+    size_t num = 1 + rand() % MAX_RANDOM_STREAMS;
+    std::vector<bool> isTx(num);
+
+    streams.clear();
+    streams.resize(num);
+    for (size_t i = 0; i < num; i++) {
+        isTx[i] = rand() % 2;
+        streams[i].restoreClass = rand() % 4 == 0 ? 1 + rand() % 2 : 0;
+        for (int d = 0; d < NUM_RANDOM_DEVICES; d++) {
+            if (rand() % 4 == 0)
+                streams[i].deviceIds.push_back((isTx[i] ? 100 : 1) + d);
+        }
+    }
+    for (size_t i = 0; i < num; i++) {
+        if (!isTx[i])
+            continue;
+        for (size_t j = 0; j < num; j++) {
+            if (!isTx[j] && rand() % 3 == 0)
+                streams[i].ecRefs.push_back(j);
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    /*
+     * 0: handset mic voip TX, registered before its speaker EC ref
+     * 1: speaker playback
+     * 2: headset playback
+     * 3: bt sco playback
+     * 4: voice call, 5: voice call record
+     * 6: voice ui on the handset mic, 7: acd
+     */
+    std::vector<SsrOrchestrator::streamInfo> usecases = {
+        {0, {101}, {1}},
+        {0, {2}, {}},
+        {0, {3}, {}},
+        {0, {7}, {}},
+        {CLASS_VOICE, {8, 108}, {}},
+        {CLASS_VOICE, {}, {}},
+        {CLASS_DETECTION, {110}, {}},
+        {CLASS_DETECTION, {110}, {}},
+    };
+    std::vector<SsrOrchestrator::streamInfo> streams;
+    int scenarios = argc > 1 ? atoi(argv[1]) : DEFAULT_SCENARIOS;
+    unsigned int seed = argc > 2 ? (unsigned int)atoi(argv[2]) : 1;
+    const char *failure = NULL;
+    size_t numGroups = 0;
+    int n = 0;
+    int status = 0;
+
+    {
+        FakeCard card(usecases);
+
+        failure = restore(usecases, card, &numGroups);
+        if (failure)
+            fprintf(stdout, "usecases: %s\n", failure);
+        status |= check(!failure, "usecases restored in order");
+        status |= check(std::find(card.order.begin(), card.order.end(), (size_t)1) <
+                        std::find(card.order.begin(), card.order.end(), (size_t)0),
+                        "voip TX restarted after its speaker EC ref");
+        status |= check(numGroups == 5 && card.maxConcurrent > 1,
+                        "independent groups restored concurrently");
+    }
+
+    srand(seed);
+    for (n = 0, failure = NULL; n < scenarios && !failure; n++) {
+        randomScenario(streams);
+        FakeCard card(streams);
+        failure = restore(streams, card, NULL);
+    }
+    if (failure)
+        fprintf(stdout, "scenario %d seed %u: %s\n", n - 1, seed, failure);
+    status |= check(!failure, "random scenarios restored in order");
+
+    fprintf(stdout, "%s\n", status ? "FAIL" : "PASS");
+    return status;
+}
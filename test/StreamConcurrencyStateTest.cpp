@@ -0,0 +1,301 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+/*
+ * Registers and deregisters random streams and device users, in step with
+ * a model of the stream lists ResourceManager keeps, and after every step
+ * checks the answers of StreamConcurrencyState against walks of those
+ * lists, done the way ResourceManager did before it kept the state: the
+ * session counts of isStreamSupported, the TX/RX/WFD counts, the streams
+ * of each type and the TX streams in registration order, and the device
+ * users. Streams and devices are fake pointers, they are only used as keys.
+ *
+ * Usage: PalStreamConcurrencyStateTest [steps] [seed]
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <list>
+#include <map>
+#include <vector>
+#include "StreamConcurrencyState.h"
+
+#define NUM_STREAMS 48
+#define NUM_DEVICES 6
+#define DEFAULT_STEPS 200000
+
+struct legacyStream {
+    Stream *s;
+    struct pal_stream_attributes attr;
+};
+
+/* mActiveStreams with the attributes each stream reports */
+static std::vector<struct legacyStream> activeStreams;
+/* the per type lists of registerStream, keyed by the list they go to */
+static std::map<int, std::list<Stream*>> sessionLists;
+/* active_devices */
+static std::vector<std::pair<int, Stream*>> activeDevices;
+
+static Stream *fakeStream(int n)
+{
+    return reinterpret_cast<Stream*>((uintptr_t)0x1000 + 0x10 * n);
+}
+
+static Device *fakeDevice(int n)
+{
+    return reinterpret_cast<Device*>((uintptr_t)0x100000 + 0x10 * n);
+}
+
+static int fakeDeviceId(int n)
+{
+    return PAL_DEVICE_OUT_SPEAKER + n;
+}
+
+static int check(bool cond, const char *what)
+{
+    fprintf(stdout, "%s: %s\n", cond ? "PASS" : "FAIL", what);
+    return cond ? 0 : -1;
+}
+
+/* the list registerStream puts a stream type on, -1 for none */
+static int registerList(pal_stream_type_t type)
+{
+    switch (type) {
+        case PAL_STREAM_LOW_LATENCY:
+        case PAL_STREAM_VOIP_RX:
+        case PAL_STREAM_VOIP_TX:
+        case PAL_STREAM_VOICE_CALL:
+            return PAL_STREAM_LOW_LATENCY;
+        case PAL_STREAM_PCM_OFFLOAD:
+        case PAL_STREAM_LOOPBACK:
+            return PAL_STREAM_PCM_OFFLOAD;
+        case PAL_STREAM_DEEP_BUFFER:
+        case PAL_STREAM_SPATIAL_AUDIO:
+        case PAL_STREAM_COMPRESSED:
+        case PAL_STREAM_GENERIC:
+        case PAL_STREAM_VOICE_UI:
+        case PAL_STREAM_ULTRA_LOW_LATENCY:
+        case PAL_STREAM_PROXY:
+        case PAL_STREAM_VOICE_CALL_MUSIC:
+        case PAL_STREAM_VOICE_CALL_RECORD:
+        case PAL_STREAM_NON_TUNNEL:
+        case PAL_STREAM_HAPTICS:
+        case PAL_STREAM_ACD:
+        case PAL_STREAM_ULTRASOUND:
+        case PAL_STREAM_RAW:
+        case PAL_STREAM_SENSOR_PCM_DATA:
+        case PAL_STREAM_CONTEXT_PROXY:
+        case PAL_STREAM_VOICE_RECOGNITION:
+            return type;
+        default:
+            return -1;
+    }
+}
+
+static size_t listSize(int list)
+{
+    return sessionLists.count(list) ? sessionLists[list].size() : 0;
+}
+
+/* the session count isStreamSupported took from the lists */
+static size_t legacySessions(pal_stream_type_t type)
+{
+    switch (type) {
+        case PAL_STREAM_LOW_LATENCY:
+        case PAL_STREAM_VOIP:
+        case PAL_STREAM_VOIP_RX:
+        case PAL_STREAM_VOIP_TX:
+            return listSize(PAL_STREAM_LOW_LATENCY);
+        case PAL_STREAM_LOOPBACK:
+        case PAL_STREAM_TRANSCODE:
+        case PAL_STREAM_VOICE_UI:
+            return listSize(PAL_STREAM_VOICE_UI);
+        case PAL_STREAM_VOICE_CALL:
+            return 0;
+        default:
+            return registerList(type) < 0 ? 0 : listSize(registerList(type));
+    }
+}
+
+static bool isRegistered(Stream *s)
+{
+    for (auto &str : activeStreams)
+        if (str.s == s)
+            return true;
+    return false;
+}
+
+static void legacyRegister(Stream *s, const struct pal_stream_attributes &attr)
+{
+    int list = registerList(attr.type);
+
+    if (list >= 0)
+        sessionLists[list].push_back(s);
+    activeStreams.push_back({s, attr});
+}
+
+static void legacyDeregister(Stream *s)
+{
+    for (auto iter = activeStreams.begin(); iter != activeStreams.end(); iter++) {
+        if (iter->s != s)
+            continue;
+        int list = registerList(iter->attr.type);
+        if (list >= 0)
+            sessionLists[list].remove(s);
+        activeStreams.erase(iter);
+        break;
+    }
+}
+
+static void randomAttributes(struct pal_stream_attributes *attr)
+{
+    static const pal_stream_direction_t dirs[] = {
+        PAL_AUDIO_OUTPUT, PAL_AUDIO_INPUT, PAL_AUDIO_INPUT_OUTPUT,
+    };
+
+    *attr = {};
+    attr->type = (pal_stream_type_t)(PAL_STREAM_LOW_LATENCY +
+                                     rand() % (PAL_STREAM_MAX - PAL_STREAM_LOW_LATENCY));
+    attr->direction = dirs[rand() % 3];
+    attr->info.opt_stream_info.tx_proxy_type =
+        (pal_stream_proxy_tx_type_t)(rand() % (PAL_STREAM_PROXY_TX_TELEPHONY_RX + 1));
+}
+
+/* compares every answer of the state with the walks, returns a failure or NULL */
+static const char *compare(const StreamConcurrencyState &state)
+{
+    uint32_t numTx = 0, numRx = 0, numWfdTx = 0;
+    std::list<Stream*> walk;
+
+    for (int t = PAL_STREAM_LOW_LATENCY; t < PAL_STREAM_MAX; t++)
+        if (state.numSessions((pal_stream_type_t)t) != legacySessions((pal_stream_type_t)t))
+            return "session count of a type";
+
+    for (auto &str : activeStreams) {
+        if (str.attr.direction == PAL_AUDIO_INPUT) {
+            numTx++;
+            if (str.attr.info.opt_stream_info.tx_proxy_type == PAL_STREAM_PROXY_TX_WFD)
+                numWfdTx++;
+        } else {
+            numRx++;
+        }
+    }
+    if (state.numTx != numTx || state.numRx != numRx || state.numWfdTx != numWfdTx)
+        return "TX/RX/WFD counts";
+    if (state.streams.size() != activeStreams.size())
+        return "registered streams";
+
+    for (int t = PAL_STREAM_LOW_LATENCY; t < PAL_STREAM_MAX; t++) {
+        walk.clear();
+        for (auto &str : activeStreams)
+            if (str.attr.type == t)
+                walk.push_back(str.s);
+        if (state.byType[t] != walk || state.numByType[t] != walk.size())
+            return "streams of a type in registration order";
+    }
+
+    walk.clear();
+    for (auto &str : activeStreams)
+        if (str.attr.direction == PAL_AUDIO_INPUT)
+            walk.push_back(str.s);
+    if (state.txStreams != walk)
+        return "TX streams in registration order";
+
+    for (int d = 0; d < NUM_DEVICES; d++) {
+        uint32_t users = 0;
+
+        for (auto &dev : activeDevices)
+            users += dev.first == d;
+        if ((users ? state.numByDevice.at(fakeDeviceId(d)) : 0) != users ||
+            (!users && state.numByDevice.count(fakeDeviceId(d))))
+            return "users of a device";
+        for (int n = 0; n < NUM_STREAMS; n++) {
+            bool active = std::find(activeDevices.begin(), activeDevices.end(),
+                    std::make_pair(d, fakeStream(n))) != activeDevices.end();
+            if (active != (state.deviceUsers.count(
+                    std::make_pair(fakeDevice(d), fakeStream(n))) != 0))
+                return "device active for a stream";
+        }
+    }
+    return NULL;
+}
+
+int main(int argc, char *argv[])
+{
+    StreamConcurrencyState state;
+    struct pal_stream_attributes attr;
+    long steps = argc > 1 ? atol(argv[1]) : DEFAULT_STEPS;
+    unsigned int seed = argc > 2 ? (unsigned int)atoi(argv[2]) : 1;
+    const char *failure = NULL;
+    long step = 0;
+    uint32_t maxStreams = 0;
+    int status = 0;
+
+    srand(seed);
+    for (step = 0; step < steps && !failure; step++) {
+        Stream *s = fakeStream(rand() % NUM_STREAMS);
+        int d = rand() % NUM_DEVICES;
+        auto dev = std::make_pair(d, s);
+        auto devIter = std::find(activeDevices.begin(), activeDevices.end(), dev);
+
+        switch (rand() % 4) {
+            case 0:
+                if (isRegistered(s)) {
+                    if (state.addStream(s, &attr))
+                        failure = "stream registered twice";
+                    break;
+                }
+                randomAttributes(&attr);
+                legacyRegister(s, attr);
+                if (!state.addStream(s, &attr))
+                    failure = "stream registration";
+                break;
+            case 1:
+                if (state.removeStream(s) != isRegistered(s))
+                    failure = "stream deregistration";
+                legacyDeregister(s);
+                break;
+            case 2:
+                /* registerDevice_l skips a pair registered already */
+                if (devIter != activeDevices.end())
+                    break;
+                activeDevices.push_back(dev);
+                state.addDeviceUser(fakeDevice(d), fakeDeviceId(d), s);
+                break;
+            default:
+                if (devIter == activeDevices.end())
+                    break;
+                activeDevices.erase(devIter);
+                state.removeDeviceUser(fakeDevice(d), fakeDeviceId(d), s);
+                break;
+        }
+        if (!failure)
+            failure = compare(state);
+        maxStreams = std::max(maxStreams, (uint32_t)activeStreams.size());
+    }
+
+    if (failure)
+        fprintf(stdout, "step %ld seed %u: %s differs\n", step, seed, failure);
+    status |= check(!failure, "state answers match the list walks");
+
+    /* drain, everything goes back to zero */
+    for (int n = 0; n < NUM_STREAMS; n++) {
+        state.removeStream(fakeStream(n));
+        legacyDeregister(fakeStream(n));
+    }
+    for (auto &dev : activeDevices)
+        state.removeDeviceUser(fakeDevice(dev.first), fakeDeviceId(dev.first), dev.second);
+    activeDevices.clear();
+    status |= check(!compare(state) && state.streams.empty() && state.txStreams.empty() &&
+                    !state.numTx && !state.numRx && !state.numWfdTx &&
+                    state.deviceUsers.empty() && state.numByDevice.empty(),
+                    "state empty once everything is deregistered");
+
+    fprintf(stdout, "%ld steps, up to %u streams registered\n", step, maxStreams);
+    fprintf(stdout, "%s\n", status ? "FAIL" : "PASS");
+    return status;
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef PAL_INIT_GRAPH_H
+#define PAL_INIT_GRAPH_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <stdint.h>
+#include <vector>
+
+/*
+ * Bring-up steps with their dependencies. run() starts every step on its
+ * own thread, a step waits until the steps it depends on are done, so
+ * independent steps such as XML parsing and library loading overlap with
+ * the sound card wait. A step whose dependency failed is skipped. The
+ * begin and end of each step are logged as the startup timeline and
+ * recorded as spans while span tracing is on.
+ */
+class PalInitGraph
+{
+public:
+    typedef std::function<int()> step_t;
+
+    explicit PalInitGraph(const char *name);
+    /* deps are ids returned for steps added before, returns the step id */
+    int addStep(const char *name, std::vector<int> deps, step_t fn);
+    /* waits for all steps, returns the status of the first failed one */
+    int run();
+
+private:
+    struct step {
+        const char *name;
+        std::vector<int> deps;
+        step_t fn;
+        int status;
+        bool done;
+        uint64_t beginUs;
+        uint64_t endUs;
+    };
+
+    void runStep(int id);
+
+    const char *name;
+    std::vector<struct step> steps;
+    std::mutex lock;
+    std::condition_variable cv;
+};
+
+#endif //PAL_INIT_GRAPH_H
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef PAL_OFFLINE_CLOCK_H
+#define PAL_OFFLINE_CLOCK_H
+
+#include <atomic>
+#include <mutex>
+#include <stdint.h>
+
+/* a client stalled longer than this restarts pacing instead of bursting */
+#define PAL_OFFLINE_CLOCK_MAX_LAG_NS 200000000ULL
+
+/*
+ * Virtual clock of a stream whose sound card is offline. Dropped buffers
+ * are paced against absolute CLOCK_MONOTONIC deadlines derived from the
+ * total frames consumed, so sleep overshoot and processing time do not
+ * accumulate. The position reached offline is carried over as an offset
+ * to the session time once the card is back.
+ */
+class PalOfflineClock
+{
+public:
+    PalOfflineClock();
+    /* accounts frames at rate, returns the deadline to sleep until in ns */
+    uint64_t advance(uint32_t frames, uint32_t rate);
+    static void sleepUntil(uint64_t deadlineNs);
+    /* card is back, the offline position becomes the session time offset */
+    void online()
+    {
+        if (running.load(std::memory_order_relaxed))
+            stopRunning();
+    }
+    /* position while offline, false if the clock is not running */
+    bool getPosition(uint64_t *us);
+    /* session time read from the DSP plus the carried position */
+    uint64_t adjust(uint64_t sessionUs);
+    /* position carried over to the session time, once the card is back */
+    uint64_t getOffset();
+    /* stream stopped by the client, the position restarts from 0 */
+    void reset();
+
+private:
+    void stopRunning();
+    uint64_t position_l(uint64_t nowNs);
+
+    std::mutex lock;
+    std::atomic<bool> running;
+    uint64_t startNs;
+    uint64_t frames;
+    uint32_t rate;
+    uint64_t baseUs;    // position when the card went offline
+    uint64_t offsetUs;  // added to the session time after recovery
+    uint64_t lastUs;    // last position reported
+};
+
+#endif //PAL_OFFLINE_CLOCK_H
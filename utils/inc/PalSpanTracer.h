@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef PAL_SPAN_TRACER_H
+#define PAL_SPAN_TRACER_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#define PAL_SPAN_TRACE_MAX_EVENTS 200000
+/* traces are only written to this directory, ends with '/' */
+#ifndef PAL_SPAN_TRACE_DIR
+#if defined(FEATURE_IPQ_OPENWRT) || defined(LINUX_ENABLED)
+#define PAL_SPAN_TRACE_DIR "/tmp/"
+#else
+#define PAL_SPAN_TRACE_DIR "/data/vendor/audio/"
+#endif
+#endif
+#define PAL_SPAN_TRACE_DEFAULT_FILE "pal_trace.json"
+/* set to a file name to trace from pal_init to pal_deinit */
+#define PAL_SPAN_TRACE_ENV "PAL_TRACE_FILE"
+
+/*
+ * Records the begin and duration of scoped spans of PAL control operations
+ * and writes them as Chrome trace event JSON, which chrome://tracing and
+ * Perfetto show nested per thread. Tracing is started and stopped with
+ * PAL_PARAM_ID_SPAN_TRACE or PAL_SPAN_TRACE_ENV; while stopped a span
+ * costs one relaxed load. Each thread records into its own buffer, which
+ * stop() collects.
+ */
+class PalSpanTracer
+{
+public:
+    static bool isEnabled()
+    {
+        return enabled.load(std::memory_order_relaxed);
+    }
+    static uint64_t nowUs();
+    /*
+     * file is a plain name created in PAL_SPAN_TRACE_DIR, NULL or empty for
+     * PAL_SPAN_TRACE_DEFAULT_FILE; -EINVAL if it contains '/' or ".."
+     */
+    static int start(const char *file);
+    /* writes the spans recorded since start */
+    static int stop();
+    static void startFromEnv();
+    static void record(const char *name, uint64_t beginUs, uint64_t endUs);
+
+private:
+    struct span {
+        const char *name;
+        uint64_t beginUs;
+        uint64_t durUs;
+    };
+    /* only contended by stop(), spans of an older trace are dropped on use */
+    struct spanBuffer {
+        std::mutex lock;
+        std::vector<struct span> spans;
+        uint32_t generation;
+        int tid;
+    };
+
+    static struct spanBuffer *getBuffer();
+
+    static std::atomic<bool> enabled;
+    static std::atomic<uint32_t> generation;
+    static std::atomic<uint32_t> numSpans;
+    static std::atomic<uint32_t> dropped;
+    /* guards start/stop, path and the buffer list */
+    static std::mutex lock;
+    static std::string path;
+    static std::vector<std::shared_ptr<struct spanBuffer>> buffers;
+};
+
+class PalSpan
+{
+public:
+    /* name must be a string literal or otherwise outlive the trace */
+    explicit PalSpan(const char *spanName)
+        : name(spanName),
+          beginUs(PalSpanTracer::isEnabled() ? PalSpanTracer::nowUs() : 0) {}
+    ~PalSpan()
+    {
+        if (beginUs)
+            PalSpanTracer::record(name, beginUs, PalSpanTracer::nowUs());
+    }
+    PalSpan(const PalSpan &) = delete;
+    PalSpan & operator=(const PalSpan &) = delete;
+
+private:
+    const char *name;
+    uint64_t beginUs;
+};
+
+#define PAL_SPAN_CONCAT_(a, b) a##b
+#define PAL_SPAN_CONCAT(a, b) PAL_SPAN_CONCAT_(a, b)
+/* traces the enclosing scope */
+#define PAL_TRACE_SPAN(name) PalSpan PAL_SPAN_CONCAT(pal_span_, __LINE__)(name)
+
+#endif //PAL_SPAN_TRACER_H
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef SOUND_MODEL_STORE_H
+#define SOUND_MODEL_STORE_H
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <sys/types.h>
+#include <time.h>
+#include <stdint.h>
+
+/*
+ * Room kept in front of every model for the module param and register
+ * headers, so that a register payload can be laid out around the model
+ * without copying it. 8 bytes of zeroed slack follow the model for the
+ * payload padding.
+ */
+#define SOUND_MODEL_HEADROOM 64
+#define SOUND_MODEL_TAILROOM 8
+
+/*
+ * Read-only sound model, either a file mapped with mmap or a heap copy of
+ * a client model. The storage is released when the last reference goes
+ * away. The content hash is computed on first use only.
+ */
+class SoundModelBlob {
+public:
+    SoundModelBlob(void *base, size_t base_size, uint8_t *data, size_t size,
+                   const std::string &path);
+    SoundModelBlob(SoundModelBlob &rhs) = delete;
+    SoundModelBlob & operator=(SoundModelBlob &rhs) = delete;
+    ~SoundModelBlob();
+    const uint8_t *GetData() { return data_; }
+    uint32_t GetSize() { return (uint32_t)size_; }
+    uint64_t GetHash();
+    std::string &GetPath() { return path_; }
+    /*
+     * Returns header_size writable bytes right in front of the model, or
+     * nullptr if they do not fit in the headroom. Callers building payloads
+     * in place hold GetPayloadLock() until the payload has been sent.
+     */
+    uint8_t *GetHeadroom(size_t header_size);
+    std::mutex &GetPayloadLock() { return payload_mutex_; }
+
+private:
+    friend class SoundModelStore;
+
+    void *base_;
+    size_t base_size_;
+    bool mapped_;
+    uint8_t *data_;
+    size_t size_;
+    std::once_flag hash_once_;
+    uint64_t hash_;
+    std::string path_;
+    ino_t ino_;
+    time_t mtime_;
+    std::mutex payload_mutex_;
+};
+
+/*
+ * Process wide store of the sound models used by the detection engines.
+ * Files are mapped once and shared by path for as long as someone holds a
+ * reference; models registered with the DSP are additionally pinned by
+ * UUID through SoundModelPin, so that loading the same model again after
+ * a context switch neither re-reads nor re-copies it.
+ */
+class SoundModelStore {
+public:
+    static std::shared_ptr<SoundModelStore> GetInstance();
+    SoundModelStore();
+    SoundModelStore(SoundModelStore &rhs) = delete;
+    SoundModelStore & operator=(SoundModelStore &rhs) = delete;
+    ~SoundModelStore();
+
+    /* maps the file, reusing the mapping while path, size and mtime match */
+    std::shared_ptr<SoundModelBlob> MapFile(const std::string &path);
+    /* copies a client model */
+    std::shared_ptr<SoundModelBlob> CopyModel(const uint8_t *data, uint32_t size);
+    /* returns the model pinned under uuid if its content matches, else a copy */
+    std::shared_ptr<SoundModelBlob> ShareModel(uint32_t uuid, const uint8_t *data,
+                                               uint32_t size);
+
+private:
+    friend class SoundModelPin;
+
+    struct PinnedModel {
+        std::shared_ptr<SoundModelBlob> blob;
+        uint32_t refs;
+    };
+
+    /* pin a model registered under uuid, returns the new reference count */
+    uint32_t Acquire(uint32_t uuid, std::shared_ptr<SoundModelBlob> blob);
+    uint32_t Release(uint32_t uuid);
+
+    static std::shared_ptr<SoundModelStore> store_;
+    static std::mutex store_mutex_;
+    std::mutex mutex_;
+    std::map<std::string, std::weak_ptr<SoundModelBlob>> files_;
+    std::map<uint32_t, PinnedModel> models_;
+};
+
+/*
+ * Keeps a model registered with the DSP pinned in the store for as long as
+ * it lives. Engines hold one per loaded model, so the pin goes away with
+ * the unload, the engine teardown or an error path alike.
+ */
+class SoundModelPin {
+public:
+    SoundModelPin(uint32_t uuid, std::shared_ptr<SoundModelBlob> blob);
+    SoundModelPin(SoundModelPin &rhs) = delete;
+    SoundModelPin & operator=(SoundModelPin &rhs) = delete;
+    ~SoundModelPin();
+    std::shared_ptr<SoundModelBlob> GetModel() { return blob_; }
+
+private:
+    std::shared_ptr<SoundModelStore> store_;
+    std::shared_ptr<SoundModelBlob> blob_;
+    uint32_t uuid_;
+};
+
+#endif // SOUND_MODEL_STORE_H
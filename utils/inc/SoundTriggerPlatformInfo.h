@@ -121,6 +121,9 @@ public:
     void HandleEndTag(struct xml_userdata *data, const char *tag) override;
 
     static std::shared_ptr<SoundTriggerPlatformInfo> GetInstance();
+    /* the platform info is parsed by the loader on first GetInstance() */
+    static void SetSectionLoader(void (*loader)(const char *section)) { section_loader_ = loader; }
+    static void LoadSection();
     static bool GetLpiEnable() { return lpi_enable_; }
     static bool GetSupportNLPISwitch() { return support_nlpi_switch_; }
     static bool GetSupportDevSwitch() { return support_device_switch_; }
@@ -143,6 +146,7 @@ private:
     static bool concurrent_voip_call_;
     static bool low_latency_bargein_enable_;
     static std::shared_ptr<SoundTriggerPlatformInfo> me_;
+    static void (*section_loader_)(const char *section);
     st_cap_profile_map_t capture_profile_map_;
     std::shared_ptr<SoundTriggerXml> curr_child_;
 };
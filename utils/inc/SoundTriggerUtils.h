@@ -64,8 +64,12 @@
 #ifndef SOUND_TRIGGER_UTILS_H
 #define SOUND_TRIGGER_UTILS_H
 
+#include <list>
+#include <mutex>
+#include <vector>
 #include "PalDefs.h"
 #include "ListenSoundModelLib.h"
+#include "SoundModelStore.h"
 
 #define MAX_KW_USERS_NAME_LEN (2 * MAX_STRING_LEN)
 #define MAX_CONF_LEVEL_VALUE 100
@@ -475,19 +479,9 @@ public:
     int32_t SetUsers(listen_model_type *model, uint32_t num_users);
     int32_t SetConfLevels(uint16_t num_user_kw_pairs, uint16_t *num_users_per_kw,
                           uint16_t **user_kw_pair_flags);
-    void SetModelData(uint8_t *data, uint32_t size) {
-        if (sm_data_) {
-            free(sm_data_);
-            sm_data_ = nullptr;
-        }
-        sm_size_ = size;
-        if (!sm_size_)
-            return;
-        sm_data_ = (uint8_t*) calloc(1, sm_size_);
-        if (!sm_data_)
-            return;
-        memcpy(sm_data_, data, sm_size_);
-    }
+    /* copies the model into the SoundModelStore, copies of this info share it */
+    void SetModelData(uint8_t *data, uint32_t size);
+    void SetModelBlob(std::shared_ptr<SoundModelBlob> blob) { sm_blob_ = blob; }
     void UpdateConfLevel(uint32_t index, uint8_t conf_level) {
         if (index < cf_levels_size_)
             cf_levels_[index] = conf_level;
@@ -500,8 +494,11 @@ public:
         if (index < cf_levels_size_)
             det_cf_levels_[index] = conf_level;
     }
-    uint8_t* GetModelData() { return sm_data_; };
-    uint32_t GetModelSize() { return sm_size_; };
+    uint8_t* GetModelData() {
+        return sm_blob_ ? (uint8_t *)sm_blob_->GetData() : nullptr;
+    };
+    uint32_t GetModelSize() { return sm_blob_ ? sm_blob_->GetSize() : 0; };
+    std::shared_ptr<SoundModelBlob> GetModelBlob() { return sm_blob_; };
     char** GetKeyPhrases() { return keyphrases_; };
     char** GetConfLevelsKwUsers() { return cf_levels_kw_users_; };
     uint8_t* GetConfLevels() { return cf_levels_; };
@@ -512,8 +509,7 @@ public:
     static void FreeArrayPtrs(char **arr, uint32_t arr_len);
 
 private:
-    uint8_t *sm_data_;
-    uint32_t sm_size_;
+    std::shared_ptr<SoundModelBlob> sm_blob_;
     uint32_t num_keyphrases_;
     uint32_t num_users_;
     char **keyphrases_;
@@ -523,4 +519,43 @@ private:
     uint8_t *det_cf_levels_;
     uint32_t cf_levels_size_;
 };
+
+#define ST_MERGED_MODEL_CACHE_SIZE 4
+
+/*
+ * LRU cache of merged sound models keyed by the sorted content hashes of
+ * the constituent models, so that a model set seen recently (e.g. clients
+ * coming back after an app switch) does not go through SML merge/delete
+ * again. Entries hold a copy of the merged SoundModelInfo.
+ */
+class MergedModelCache {
+public:
+    MergedModelCache(uint32_t capacity = ST_MERGED_MODEL_CACHE_SIZE);
+    MergedModelCache(MergedModelCache &rhs) = delete;
+    MergedModelCache & operator=(MergedModelCache &rhs) = delete;
+    ~MergedModelCache();
+    static uint64_t HashModel(const uint8_t *data, uint32_t size);
+    /* copies the cached model for the set of hashes into out_info */
+    bool Lookup(std::vector<uint64_t> key, SoundModelInfo *out_info);
+    void Insert(std::vector<uint64_t> key, SoundModelInfo *info);
+    void RecordMerge(uint64_t duration_us);
+    void GetStats(struct pal_param_st_merge_cache_stats *stats);
+    void Clear();
+
+private:
+    struct Entry {
+        std::vector<uint64_t> key;
+        SoundModelInfo *info;
+    };
+
+    std::mutex mutex_;
+    std::list<Entry> entries_; /* most recently used first */
+    uint32_t capacity_;
+    uint32_t hits_;
+    uint32_t misses_;
+    uint32_t evictions_;
+    uint32_t num_merges_;
+    uint64_t total_merge_us_;
+    uint64_t max_merge_us_;
+};
 #endif // SOUND_TRIGGER_UTILS_H
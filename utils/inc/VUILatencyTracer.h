@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef VUI_LATENCY_TRACER_H
+#define VUI_LATENCY_TRACER_H
+
+#include <atomic>
+#include <stdint.h>
+
+#include "PalDefs.h"
+
+#define VUI_LATENCY_TRACE_RECORDS 64
+
+/*
+ * Per-stream record of detection latencies. Stages are marked with
+ * CLOCK_MONOTONIC timestamps by the engine and stream threads while a
+ * detection is handled, then the record is committed to a fixed ring
+ * that GetStats() reads without blocking the writers.
+ */
+class VUILatencyTracer
+{
+public:
+    VUILatencyTracer();
+    ~VUILatencyTracer() {}
+    VUILatencyTracer(const VUILatencyTracer &) = delete;
+    VUILatencyTracer & operator=(const VUILatencyTracer &) = delete;
+
+    /* starts a new record, committing the previous one if still open */
+    void Begin(uint64_t dsp_event_ns);
+    void Mark(pal_st_trace_stage_t stage);
+    void End();
+    bool IsOpen() const { return open_.load(std::memory_order_acquire); }
+    void GetStats(struct pal_param_st_latency_stats *stats) const;
+
+    static uint64_t GetTimeNs();
+
+private:
+    struct TraceRecord {
+        std::atomic<uint32_t> seq;
+        std::atomic<uint64_t> ts[PAL_ST_TRACE_STAGE_MAX];
+    };
+
+    std::atomic<bool> open_;
+    std::atomic<uint64_t> cur_[PAL_ST_TRACE_STAGE_MAX];
+    std::atomic<uint32_t> head_;
+    TraceRecord records_[VUI_LATENCY_TRACE_RECORDS];
+};
+
+#endif // VUI_LATENCY_TRACER_H
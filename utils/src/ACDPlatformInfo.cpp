@@ -249,6 +249,7 @@ std::shared_ptr<ACDPlatformInfo> ACDPlatformInfo::GetInstance()
 {
     if (!me_)
         me_ = std::shared_ptr<ACDPlatformInfo> (new ACDPlatformInfo);
+    SoundTriggerPlatformInfo::LoadSection();
 
     return me_;
 }
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#define LOG_TAG "PAL: PalInitGraph"
+
+#include "PalInitGraph.h"
+#include "PalSpanTracer.h"
+#include "PalCommon.h"
+#include <errno.h>
+#include <exception>
+#include <thread>
+
+PalInitGraph::PalInitGraph(const char *graphName)
+{
+    name = graphName;
+}
+
+int PalInitGraph::addStep(const char *stepName, std::vector<int> deps, step_t fn)
+{
+    int id = (int)steps.size();
+
+    for (int dep : deps) {
+        if (dep < 0 || dep >= id) {
+            PAL_ERR(LOG_TAG, "%s: step %s depends on unknown step %d", name,
+                    stepName, dep);
+            return -EINVAL;
+        }
+    }
+    steps.push_back({stepName, deps, fn, 0, false, 0, 0});
+
+    return id;
+}
+
+void PalInitGraph::runStep(int id)
+{
+    struct step &s = steps[id];
+    int status = 0;
+    uint64_t beginUs = 0;
+
+    {
+        std::unique_lock<std::mutex> lck(lock);
+        cv.wait(lck, [&] {
+            for (int dep : s.deps)
+                if (!steps[dep].done)
+                    return false;
+            return true;
+        });
+        for (int dep : s.deps) {
+            if (steps[dep].status) {
+                PAL_ERR(LOG_TAG, "%s: skip %s, %s failed", name, s.name,
+                        steps[dep].name);
+                status = -ECANCELED;
+                break;
+            }
+        }
+    }
+
+    beginUs = PalSpanTracer::nowUs();
+    if (!status) {
+        try {
+            status = s.fn();
+        } catch (const std::exception& e) {
+            PAL_ERR(LOG_TAG, "%s: %s failed: %s", name, s.name, e.what());
+            status = -EINVAL;
+        }
+    }
+
+    std::lock_guard<std::mutex> lck(lock);
+    s.status = status;
+    s.beginUs = beginUs;
+    s.endUs = PalSpanTracer::nowUs();
+    s.done = true;
+    cv.notify_all();
+}
+
+int PalInitGraph::run()
+{
+    std::vector<std::thread> workers;
+    uint64_t startUs = PalSpanTracer::nowUs();
+    uint64_t endUs = 0;
+    int status = 0;
+
+    workers.reserve(steps.size());
+    for (int id = 0; id < (int)steps.size(); id++)
+        workers.emplace_back(&PalInitGraph::runStep, this, id);
+    for (auto &worker : workers)
+        worker.join();
+    endUs = PalSpanTracer::nowUs();
+
+    for (auto &s : steps) {
+        PAL_INFO(LOG_TAG, "%s: %s at +%llu us took %llu us, status %d", name,
+                 s.name, (unsigned long long)(s.beginUs - startUs),
+                 (unsigned long long)(s.endUs - s.beginUs), s.status);
+        if (PalSpanTracer::isEnabled())
+            PalSpanTracer::record(s.name, s.beginUs, s.endUs);
+        if (s.status && !status)
+            status = s.status;
+    }
+    PAL_INFO(LOG_TAG, "%s: %zu steps done in %llu us, status %d", name,
+             steps.size(), (unsigned long long)(endUs - startUs), status);
+
+    return status;
+}
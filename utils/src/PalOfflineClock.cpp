@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#define LOG_TAG "PAL: PalOfflineClock"
+
+#include "PalOfflineClock.h"
+#include "PalCommon.h"
+#include <errno.h>
+#include <time.h>
+
+#define NS_PER_SEC 1000000000ULL
+
+static uint64_t nowNs()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * NS_PER_SEC + ts.tv_nsec;
+}
+
+PalOfflineClock::PalOfflineClock()
+{
+    running = false;
+    startNs = 0;
+    frames = 0;
+    rate = 0;
+    baseUs = 0;
+    offsetUs = 0;
+    lastUs = 0;
+}
+
+uint64_t PalOfflineClock::position_l(uint64_t now)
+{
+    uint64_t consumedNs = frames * NS_PER_SEC / rate;
+    uint64_t elapsedNs = now > startNs ? now - startNs : 0;
+
+    /* what was consumed so far, not what is queued up to the deadline */
+    return baseUs + (elapsedNs < consumedNs ? elapsedNs : consumedNs) / 1000;
+}
+
+uint64_t PalOfflineClock::advance(uint32_t numFrames, uint32_t sampleRate)
+{
+    std::lock_guard<std::mutex> lck(lock);
+    uint64_t now = nowNs();
+    uint64_t deadline = 0;
+
+    if (!running.load(std::memory_order_relaxed) || rate != sampleRate) {
+        baseUs = running.load(std::memory_order_relaxed) ? position_l(now) : lastUs;
+        PAL_DBG(LOG_TAG, "pacing at %u Hz from %llu us", sampleRate,
+                (unsigned long long)baseUs);
+        startNs = now;
+        frames = 0;
+        rate = sampleRate;
+        running.store(true, std::memory_order_relaxed);
+    }
+
+    deadline = startNs + frames * NS_PER_SEC / rate;
+    if (deadline + PAL_OFFLINE_CLOCK_MAX_LAG_NS < now) {
+        PAL_DBG(LOG_TAG, "client late by %llu ns, restart pacing",
+                (unsigned long long)(now - deadline));
+        baseUs = position_l(now);
+        startNs = now;
+        frames = 0;
+    }
+
+    frames += numFrames;
+    return startNs + frames * NS_PER_SEC / rate;
+}
+
+void PalOfflineClock::sleepUntil(uint64_t deadlineNs)
+{
+    struct timespec ts;
+
+    ts.tv_sec = deadlineNs / NS_PER_SEC;
+    ts.tv_nsec = deadlineNs % NS_PER_SEC;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+        ;
+}
+
+void PalOfflineClock::stopRunning()
+{
+    std::lock_guard<std::mutex> lck(lock);
+
+    if (!running.load(std::memory_order_relaxed))
+        return;
+
+    offsetUs = position_l(nowNs());
+    lastUs = offsetUs;
+    running.store(false, std::memory_order_relaxed);
+    PAL_DBG(LOG_TAG, "card online, session time offset %llu us",
+            (unsigned long long)offsetUs);
+}
+
+bool PalOfflineClock::getPosition(uint64_t *us)
+{
+    std::lock_guard<std::mutex> lck(lock);
+
+    if (!running.load(std::memory_order_relaxed))
+        return false;
+
+    lastUs = position_l(nowNs());
+    *us = lastUs;
+    return true;
+}
+
+uint64_t PalOfflineClock::adjust(uint64_t sessionUs)
+{
+    online();
+
+    std::lock_guard<std::mutex> lck(lock);
+    lastUs = offsetUs + sessionUs;
+    return lastUs;
+}
+
+uint64_t PalOfflineClock::getOffset()
+{
+    std::lock_guard<std::mutex> lck(lock);
+
+    /* while still running, the offset online() would carry over now */
+    if (running.load(std::memory_order_relaxed))
+        return position_l(nowNs());
+
+    return offsetUs;
+}
+
+void PalOfflineClock::reset()
+{
+    std::lock_guard<std::mutex> lck(lock);
+
+    running.store(false, std::memory_order_relaxed);
+    frames = 0;
+    baseUs = 0;
+    offsetUs = 0;
+    lastUs = 0;
+}
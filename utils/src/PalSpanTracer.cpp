@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#define LOG_TAG "PAL: PalSpanTracer"
+
+#include "PalSpanTracer.h"
+#include "PalCommon.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+std::atomic<bool> PalSpanTracer::enabled(false);
+std::atomic<uint32_t> PalSpanTracer::generation(0);
+std::atomic<uint32_t> PalSpanTracer::numSpans(0);
+std::atomic<uint32_t> PalSpanTracer::dropped(0);
+std::mutex PalSpanTracer::lock;
+std::string PalSpanTracer::path;
+std::vector<std::shared_ptr<struct PalSpanTracer::spanBuffer>> PalSpanTracer::buffers;
+
+uint64_t PalSpanTracer::nowUs()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+int PalSpanTracer::start(const char *file)
+{
+    std::lock_guard<std::mutex> lck(lock);
+
+    if (enabled.load(std::memory_order_relaxed)) {
+        PAL_ERR(LOG_TAG, "span trace already started");
+        return -EALREADY;
+    }
+
+    if (!file || !file[0]) {
+        file = PAL_SPAN_TRACE_DEFAULT_FILE;
+    } else if (strchr(file, '/') || strstr(file, "..")) {
+        PAL_ERR(LOG_TAG, "invalid trace file name %s", file);
+        return -EINVAL;
+    }
+
+    path = std::string(PAL_SPAN_TRACE_DIR) + file;
+    numSpans.store(0, std::memory_order_relaxed);
+    dropped.store(0, std::memory_order_relaxed);
+    /* buffers still holding spans of the last trace drop them on next use */
+    generation.fetch_add(1, std::memory_order_relaxed);
+    enabled.store(true, std::memory_order_release);
+    PAL_INFO(LOG_TAG, "span trace started");
+
+    return 0;
+}
+
+void PalSpanTracer::startFromEnv()
+{
+    const char *file = getenv(PAL_SPAN_TRACE_ENV);
+
+    if (file && file[0] && !isEnabled())
+        start(file);
+}
+
+struct PalSpanTracer::spanBuffer *PalSpanTracer::getBuffer()
+{
+    static thread_local std::shared_ptr<struct spanBuffer> buf;
+
+    if (!buf) {
+        buf = std::make_shared<struct spanBuffer>();
+        buf->generation = generation.load(std::memory_order_relaxed);
+        buf->tid = (int)syscall(SYS_gettid);
+        buf->spans.reserve(256);
+        std::lock_guard<std::mutex> lck(lock);
+        buffers.push_back(buf);
+    }
+
+    return buf.get();
+}
+
+void PalSpanTracer::record(const char *name, uint64_t beginUs, uint64_t endUs)
+{
+    struct spanBuffer *buf = NULL;
+    uint32_t gen = 0;
+
+    /* spans ending after stop are dropped with the rest of the trace */
+    if (!enabled.load(std::memory_order_acquire))
+        return;
+
+    if (numSpans.fetch_add(1, std::memory_order_relaxed) >= PAL_SPAN_TRACE_MAX_EVENTS) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    buf = getBuffer();
+    gen = generation.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lck(buf->lock);
+    if (buf->generation != gen) {
+        buf->spans.clear();
+        buf->generation = gen;
+    }
+    buf->spans.push_back({name, beginUs, endUs - beginUs});
+}
+
+static void writeJsonString(FILE *fp, const char *s)
+{
+    fputc('"', fp);
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\')
+            fputc('\\', fp);
+        if ((unsigned char)*s >= 0x20)
+            fputc(*s, fp);
+    }
+    fputc('"', fp);
+}
+
+int PalSpanTracer::stop()
+{
+    std::vector<std::pair<int, std::vector<struct span>>> recorded;
+    std::string file;
+    uint32_t gen = 0;
+    size_t numWritten = 0;
+    FILE *fp = NULL;
+    int pid = (int)getpid();
+    int status = 0;
+    int fd = -1;
+
+    lock.lock();
+    if (!enabled.load(std::memory_order_relaxed)) {
+        lock.unlock();
+        return -EINVAL;
+    }
+    enabled.store(false, std::memory_order_relaxed);
+    gen = generation.load(std::memory_order_relaxed);
+    file = path;
+    for (auto it = buffers.begin(); it != buffers.end();) {
+        std::shared_ptr<struct spanBuffer> buf = *it;
+        std::lock_guard<std::mutex> bufLck(buf->lock);
+
+        if (buf->generation == gen && !buf->spans.empty()) {
+            recorded.push_back(std::make_pair(buf->tid, std::vector<struct span>()));
+            recorded.back().second.swap(buf->spans);
+        }
+        /* only the list still holds buffers of exited threads */
+        if (it->use_count() == 2)
+            it = buffers.erase(it);
+        else
+            ++it;
+    }
+    lock.unlock();
+
+    /* never follow a link planted in place of the trace file */
+    fd = open(file.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_NOFOLLOW | O_CLOEXEC, 0640);
+    if (fd >= 0)
+        fp = fdopen(fd, "w");
+    if (!fp) {
+        status = -errno;
+        if (fd >= 0)
+            close(fd);
+        PAL_ERR(LOG_TAG, "failed to open trace file, status %d", status);
+        return status;
+    }
+
+    fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for (auto &thread : recorded) {
+        for (auto &sp : thread.second) {
+            fprintf(fp, "%s{\"ph\":\"X\",\"cat\":\"pal\",\"name\":",
+                    numWritten ? ",\n" : "");
+            writeJsonString(fp, sp.name);
+            fprintf(fp, ",\"pid\":%d,\"tid\":%d,\"ts\":%llu,\"dur\":%llu}", pid,
+                    thread.first, (unsigned long long)sp.beginUs,
+                    (unsigned long long)sp.durUs);
+            numWritten++;
+        }
+    }
+    fprintf(fp, "\n]}\n");
+    if (fclose(fp))
+        status = -errno;
+
+    PAL_INFO(LOG_TAG, "span trace stopped, %zu spans written, %u dropped, status %d",
+             numWritten, dropped.load(std::memory_order_relaxed), status);
+
+    return status;
+}
@@ -0,0 +1,475 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#define LOG_TAG "PAL: PalTraceLog"
+
+#include "PalCommon.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdint.h>
+#include <sys/syscall.h>
+#include <thread>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+#if !defined(FEATURE_IPQ_OPENWRT) && !defined(LINUX_ENABLED)
+#include <cutils/properties.h>
+#endif
+
+#define PAL_TRACE_RING_SIZE 256
+#define PAL_TRACE_DRAIN_MS 10
+#define PAL_TRACE_MSG_SIZE 1024
+
+struct pal_trace_entry {
+    const struct pal_trace_site *site;
+    struct timespec ts;
+    uint32_t nargs;
+    uint64_t args[PAL_TRACE_MAX_ARGS];
+};
+
+/* single producer ring of one logging thread, drained by the formatter */
+struct pal_trace_ring {
+    std::atomic<uint32_t> head;
+    std::atomic<uint32_t> tail;
+    std::atomic<uint32_t> dropped;
+    std::atomic<bool> orphaned;
+    pid_t tid;
+    struct pal_trace_entry entries[PAL_TRACE_RING_SIZE];
+};
+
+struct pal_trace_formatted {
+    struct timespec ts;
+    pid_t tid;
+    const struct pal_trace_site *site;
+    uint32_t nargs;
+    const uint64_t *args;
+};
+
+/* marks the ring of an exiting thread, the formatter frees it once drained */
+struct pal_trace_ring_owner {
+    struct pal_trace_ring *ring = NULL;
+
+    ~pal_trace_ring_owner()
+    {
+        if (ring)
+            ring->orphaned.store(true, std::memory_order_release);
+        ring = NULL;
+    }
+};
+
+struct pal_trace_state {
+    std::mutex lock;
+    std::mutex drainLock;
+    std::condition_variable cv;
+    std::vector<struct pal_trace_ring *> rings;
+    std::thread formatter;
+    /* written under lock, read without it on the record path */
+    std::atomic<bool> started;
+    bool exit;
+};
+
+/*
+ * Never freed, logging threads may still record while static objects are
+ * destroyed at exit.
+ */
+static struct pal_trace_state *trace = new pal_trace_state();
+static std::once_flag trace_init_once;
+static bool trace_enabled;
+static thread_local struct pal_trace_ring_owner trace_ring;
+
+static void pal_trace_thread();
+
+/*
+ * Pending records are written out by PAL_FATAL before aborting; a crash
+ * elsewhere loses at most the last PAL_TRACE_DRAIN_MS of debug logs.
+ */
+static void pal_trace_init()
+{
+#if defined(FEATURE_IPQ_OPENWRT)
+    trace_enabled = false;
+#elif defined(LINUX_ENABLED)
+    trace_enabled = true;
+#else
+    trace_enabled = property_get_bool("vendor.audio.pal.async_log", true);
+#endif
+    ALOGI("%s: %d: asynchronous logging %s", __func__, __LINE__,
+          trace_enabled ? "enabled" : "disabled");
+}
+
+/*
+ * A site is formatted asynchronously if each of its arguments is consumed
+ * by an integer, floating point or pointer conversion.
+ */
+static bool pal_trace_parse_spec(const char *&p, char *spec, size_t size,
+                                 char *conv, int *stars)
+{
+    const char *start = p;
+    size_t len = 0;
+
+    *stars = 0;
+    p++;
+    while (*p && strchr("-+ #0'", *p))
+        p++;
+    if (*p == '*') {
+        (*stars)++;
+        p++;
+    } else {
+        while (*p >= '0' && *p <= '9')
+            p++;
+    }
+    if (*p == '.') {
+        p++;
+        if (*p == '*') {
+            (*stars)++;
+            p++;
+        } else {
+            while (*p >= '0' && *p <= '9')
+                p++;
+        }
+    }
+    while (*p && strchr("hljztqL", *p))
+        p++;
+    if (!*p)
+        return false;
+
+    *conv = *p++;
+    len = p - start;
+    if (!spec)
+        return true;
+    if (len >= size)
+        return false;
+    memcpy(spec, start, len);
+    spec[len] = '\0';
+
+    return true;
+}
+
+static int pal_trace_classify(const struct pal_trace_site *site, uint32_t nargs)
+{
+    const char *p = site->fmt;
+    uint32_t consumed = 0;
+    char conv = 0;
+    int stars = 0;
+
+    while ((p = strchr(p, '%'))) {
+        if (p[1] == '%') {
+            p += 2;
+            continue;
+        }
+        if (!pal_trace_parse_spec(p, NULL, 0, &conv, &stars) ||
+            !strchr("diouxXcfFeEgGaAp", conv))
+            return PAL_TRACE_SITE_SYNC;
+        consumed += stars + 1;
+    }
+
+    return consumed == nargs ? PAL_TRACE_SITE_ASYNC : PAL_TRACE_SITE_SYNC;
+}
+
+bool pal_trace_async(struct pal_trace_site *site, uint32_t nargs)
+{
+    int mode = site->mode.load(std::memory_order_relaxed);
+
+    if (mode == PAL_TRACE_SITE_NEW) {
+        std::call_once(trace_init_once, pal_trace_init);
+        mode = trace_enabled ? pal_trace_classify(site, nargs) : PAL_TRACE_SITE_SYNC;
+        site->mode.store(mode, std::memory_order_relaxed);
+    }
+
+    return mode == PAL_TRACE_SITE_ASYNC;
+}
+
+bool pal_trace_record(struct pal_trace_site *site, uint32_t nargs,
+                      const uint64_t *args)
+{
+    struct pal_trace_ring *ring = trace_ring.ring;
+    struct pal_trace_entry *entry = NULL;
+    uint32_t head = 0;
+
+    if (site->mode.load(std::memory_order_relaxed) != PAL_TRACE_SITE_ASYNC)
+        return false;
+
+    if (!ring || !trace->started.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lck(trace->lock);
+
+        if (!ring) {
+            ring = new pal_trace_ring();
+            ring->tid = (pid_t)syscall(SYS_gettid);
+            trace->rings.push_back(ring);
+            trace_ring.ring = ring;
+        }
+        /* also restarts the formatter after pal_trace_deinit() */
+        if (!trace->started.load(std::memory_order_relaxed)) {
+            trace->formatter = std::thread(pal_trace_thread);
+            trace->started.store(true, std::memory_order_release);
+        }
+    }
+
+    head = ring->head.load(std::memory_order_relaxed);
+    if (head - ring->tail.load(std::memory_order_acquire) >= PAL_TRACE_RING_SIZE) {
+        ring->dropped.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    entry = &ring->entries[head % PAL_TRACE_RING_SIZE];
+    entry->site = site;
+    clock_gettime(CLOCK_REALTIME, &entry->ts);
+    entry->nargs = nargs;
+    memcpy(entry->args, args, nargs * sizeof(uint64_t));
+    ring->head.store(head + 1, std::memory_order_release);
+
+    return true;
+}
+
+static int pal_trace_format_arg(char *buf, size_t size, const char *spec,
+                                char conv, const uint64_t *args)
+{
+    size_t n = strlen(spec);
+    char mod = n > 2 ? spec[n - 2] : 0;
+    bool ll = n > 3 && mod == 'l' && spec[n - 3] == 'l';
+    double d;
+
+    if (mod == 'q')
+        ll = true;
+
+    switch (conv) {
+        case 'd':
+        case 'i':
+            if (ll)
+                return snprintf(buf, size, spec, (long long)args[0]);
+            if (mod == 'l')
+                return snprintf(buf, size, spec, (long)args[0]);
+            if (mod == 'j')
+                return snprintf(buf, size, spec, (intmax_t)args[0]);
+            if (mod == 'z')
+                return snprintf(buf, size, spec, (ssize_t)args[0]);
+            if (mod == 't')
+                return snprintf(buf, size, spec, (ptrdiff_t)args[0]);
+            return snprintf(buf, size, spec, (int)args[0]);
+        case 'o':
+        case 'u':
+        case 'x':
+        case 'X':
+            if (ll)
+                return snprintf(buf, size, spec, (unsigned long long)args[0]);
+            if (mod == 'l')
+                return snprintf(buf, size, spec, (unsigned long)args[0]);
+            if (mod == 'j')
+                return snprintf(buf, size, spec, (uintmax_t)args[0]);
+            if (mod == 'z')
+                return snprintf(buf, size, spec, (size_t)args[0]);
+            if (mod == 't')
+                return snprintf(buf, size, spec, (ptrdiff_t)args[0]);
+            return snprintf(buf, size, spec, (unsigned int)args[0]);
+        case 'c':
+            return snprintf(buf, size, spec, (int)args[0]);
+        case 'p':
+            return snprintf(buf, size, spec, (void *)(uintptr_t)args[0]);
+        default:
+            memcpy(&d, &args[0], sizeof(d));
+            if (mod == 'L')
+                return snprintf(buf, size, spec, (long double)d);
+            return snprintf(buf, size, spec, d);
+    }
+}
+
+static void pal_trace_format(const struct pal_trace_formatted &rec, char *msg,
+                             size_t size)
+{
+    const char *p = rec.site->fmt;
+    const char *pct = NULL;
+    char spec[32], sized[64];
+    char conv = 0;
+    int stars = 0, n = 0;
+    uint32_t arg = 0;
+    size_t off = 0;
+
+    n = snprintf(msg, size, "[%d %ld.%06ld] %s: %d: ", rec.tid,
+                 (long)rec.ts.tv_sec, rec.ts.tv_nsec / 1000, rec.site->func,
+                 rec.site->line);
+    off = std::min((size_t)std::max(n, 0), size - 1);
+
+    while (*p && off < size - 1) {
+        pct = strchr(p, '%');
+        if (!pct) {
+            off += snprintf(msg + off, size - off, "%s", p);
+            break;
+        }
+        n = std::min((size_t)(pct - p), size - 1 - off);
+        memcpy(msg + off, p, n);
+        off += n;
+        p = pct;
+        if (p[1] == '%') {
+            msg[off++] = '%';
+            p += 2;
+            continue;
+        }
+        if (!pal_trace_parse_spec(p, spec, sizeof(spec), &conv, &stars))
+            break;
+
+        /* replace * by the width and precision arguments */
+        if (stars) {
+            const char *s = spec;
+            size_t w = 0;
+
+            while (*s && w < sizeof(sized) - 12) {
+                if (*s == '*') {
+                    w += snprintf(sized + w, sizeof(sized) - w, "%d",
+                                  (int)rec.args[arg++]);
+                } else {
+                    sized[w++] = *s;
+                }
+                s++;
+            }
+            sized[w] = '\0';
+            n = pal_trace_format_arg(msg + off, size - off, sized, conv,
+                                     &rec.args[arg++]);
+        } else {
+            n = pal_trace_format_arg(msg + off, size - off, spec, conv,
+                                     &rec.args[arg++]);
+        }
+        if (n > 0)
+            off = std::min(off + n, size - 1);
+    }
+    msg[std::min(off, size - 1)] = '\0';
+}
+
+static void pal_trace_write(const struct pal_trace_site *site, const char *msg)
+{
+    const char *tag = site->tag ? site->tag : LOG_TAG;
+
+#if defined(FEATURE_IPQ_OPENWRT) || defined(LINUX_ENABLED)
+    switch (site->level) {
+        case PAL_LOG_INFO:
+            ALOGI("%s: %s", tag, msg);
+            break;
+        case PAL_LOG_VERBOSE:
+            ALOGV("%s: %s", tag, msg);
+            break;
+        default:
+            ALOGD("%s: %s", tag, msg);
+            break;
+    }
+#else
+    switch (site->level) {
+        case PAL_LOG_INFO:
+            __android_log_write(ANDROID_LOG_INFO, tag, msg);
+            break;
+        case PAL_LOG_VERBOSE:
+            __android_log_write(ANDROID_LOG_VERBOSE, tag, msg);
+            break;
+        default:
+            __android_log_write(ANDROID_LOG_DEBUG, tag, msg);
+            break;
+    }
+#endif
+}
+
+static void pal_trace_drain()
+{
+    std::vector<struct pal_trace_formatted> pending;
+    std::vector<std::pair<struct pal_trace_ring *, uint32_t>> drained;
+    std::vector<struct pal_trace_ring *> rings;
+    char msg[PAL_TRACE_MSG_SIZE];
+    uint32_t head = 0, tail = 0, dropped = 0;
+    std::lock_guard<std::mutex> drainLck(trace->drainLock);
+
+    {
+        std::lock_guard<std::mutex> lck(trace->lock);
+        rings = trace->rings;
+    }
+
+    for (auto ring : rings) {
+        head = ring->head.load(std::memory_order_acquire);
+        tail = ring->tail.load(std::memory_order_relaxed);
+        for (; tail != head; tail++) {
+            struct pal_trace_entry &e = ring->entries[tail % PAL_TRACE_RING_SIZE];
+            pending.push_back({e.ts, ring->tid, e.site, e.nargs, e.args});
+        }
+        drained.push_back(std::make_pair(ring, head));
+    }
+
+    /* records of different threads are written out in time order */
+    std::stable_sort(pending.begin(), pending.end(),
+        [](const struct pal_trace_formatted &a, const struct pal_trace_formatted &b) {
+            return a.ts.tv_sec < b.ts.tv_sec ||
+                   (a.ts.tv_sec == b.ts.tv_sec && a.ts.tv_nsec < b.ts.tv_nsec);
+        });
+    for (auto &rec : pending) {
+        pal_trace_format(rec, msg, sizeof(msg));
+        pal_trace_write(rec.site, msg);
+    }
+
+    for (auto &d : drained) {
+        d.first->tail.store(d.second, std::memory_order_release);
+        dropped = d.first->dropped.exchange(0, std::memory_order_relaxed);
+        if (dropped)
+            ALOGW("%s: %d: dropped %u log records of thread %d", __func__,
+                  __LINE__, dropped, d.first->tid);
+    }
+
+    std::lock_guard<std::mutex> lck(trace->lock);
+    for (auto it = trace->rings.begin(); it != trace->rings.end();) {
+        struct pal_trace_ring *ring = *it;
+
+        if (ring->orphaned.load(std::memory_order_acquire) &&
+            ring->tail.load(std::memory_order_relaxed) ==
+            ring->head.load(std::memory_order_acquire)) {
+            it = trace->rings.erase(it);
+            delete ring;
+        } else {
+            ++it;
+        }
+    }
+}
+
+static void pal_trace_thread()
+{
+    std::unique_lock<std::mutex> lck(trace->lock);
+
+    while (!trace->exit) {
+        trace->cv.wait_for(lck, std::chrono::milliseconds(PAL_TRACE_DRAIN_MS));
+        lck.unlock();
+        pal_trace_drain();
+        lck.lock();
+    }
+}
+
+void pal_trace_flush()
+{
+    pal_trace_drain();
+}
+
+void pal_trace_flush_pending()
+{
+    struct pal_trace_ring *ring = trace_ring.ring;
+
+    if (ring && ring->head.load(std::memory_order_relaxed) !=
+                ring->tail.load(std::memory_order_acquire))
+        pal_trace_drain();
+}
+
+void pal_trace_deinit()
+{
+    std::unique_lock<std::mutex> lck(trace->lock);
+    std::thread formatter;
+
+    if (!trace->started.load(std::memory_order_relaxed) || trace->exit)
+        return;
+
+    trace->exit = true;
+    formatter.swap(trace->formatter);
+    lck.unlock();
+    trace->cv.notify_all();
+    formatter.join();
+    pal_trace_drain();
+
+    /* the next asynchronous record starts a new formatter */
+    lck.lock();
+    trace->exit = false;
+    trace->started.store(false, std::memory_order_release);
+}
+
@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#define LOG_TAG "PAL: SoundModelStore"
+
+#include "SoundModelStore.h"
+#include "PalCommon.h"
+#include "SoundTriggerUtils.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+std::shared_ptr<SoundModelStore> SoundModelStore::store_ = nullptr;
+std::mutex SoundModelStore::store_mutex_;
+
+SoundModelBlob::SoundModelBlob(void *base, size_t base_size, uint8_t *data,
+                               size_t size, const std::string &path) :
+    base_(base),
+    base_size_(base_size),
+    mapped_(!path.empty()),
+    data_(data),
+    size_(size),
+    hash_(0),
+    path_(path),
+    ino_(0),
+    mtime_(0)
+{
+}
+
+SoundModelBlob::~SoundModelBlob() {
+    if (!base_)
+        return;
+
+    if (!mapped_)
+        free(base_);
+    else if (munmap(base_, base_size_))
+        PAL_ERR(LOG_TAG, "munmap of %s failed, errno %d", path_.c_str(), errno);
+}
+
+uint64_t SoundModelBlob::GetHash() {
+    std::call_once(hash_once_, [this] {
+        hash_ = MergedModelCache::HashModel(data_, (uint32_t)size_);
+    });
+    return hash_;
+}
+
+uint8_t *SoundModelBlob::GetHeadroom(size_t header_size) {
+    if (header_size > SOUND_MODEL_HEADROOM)
+        return nullptr;
+
+    return data_ - header_size;
+}
+
+std::shared_ptr<SoundModelStore> SoundModelStore::GetInstance() {
+    std::lock_guard<std::mutex> lck(store_mutex_);
+
+    if (!store_)
+        store_ = std::make_shared<SoundModelStore>();
+
+    return store_;
+}
+
+SoundModelStore::SoundModelStore() {
+}
+
+SoundModelStore::~SoundModelStore() {
+    models_.clear();
+    files_.clear();
+}
+
+std::shared_ptr<SoundModelBlob> SoundModelStore::MapFile(const std::string &path) {
+    std::lock_guard<std::mutex> lck(mutex_);
+    std::shared_ptr<SoundModelBlob> blob = nullptr;
+    std::map<std::string, std::weak_ptr<SoundModelBlob>>::iterator iter;
+    struct stat st;
+    void *base = nullptr;
+    void *addr = nullptr;
+    size_t page = 0;
+    size_t fileLen = 0;
+    size_t baseLen = 0;
+    int fd = -1;
+
+    fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        PAL_ERR(LOG_TAG, "Unable to open sound model file %s, errno %d",
+                path.c_str(), errno);
+        return nullptr;
+    }
+
+    if (fstat(fd, &st) || st.st_size <= 0) {
+        PAL_ERR(LOG_TAG, "Invalid sound model file %s", path.c_str());
+        goto exit;
+    }
+
+    /* reuse the existing mapping unless the file was replaced meanwhile */
+    iter = files_.find(path);
+    if (iter != files_.end()) {
+        blob = iter->second.lock();
+        if (blob && blob->ino_ == st.st_ino && blob->mtime_ == st.st_mtime &&
+            blob->size_ == (size_t)st.st_size) {
+            PAL_DBG(LOG_TAG, "reuse mapping of %s, size %u", path.c_str(),
+                    blob->GetSize());
+            goto exit;
+        }
+        blob = nullptr;
+        files_.erase(iter);
+    }
+
+    /*
+     * Reserve a writable page for the headers in front and the rounded up
+     * file plus a page behind, then map the file read-only over the middle,
+     * so a register payload is contiguous with the mapped model.
+     */
+    page = sysconf(_SC_PAGESIZE);
+    fileLen = ((size_t)st.st_size + page - 1) & ~(page - 1);
+    baseLen = page + fileLen + page;
+    base = mmap(nullptr, baseLen, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        PAL_ERR(LOG_TAG, "reserve for %s failed, errno %d", path.c_str(), errno);
+        goto exit;
+    }
+    addr = mmap((uint8_t *)base + page, fileLen, PROT_READ, MAP_PRIVATE | MAP_FIXED,
+                fd, 0);
+    if (addr == MAP_FAILED) {
+        PAL_ERR(LOG_TAG, "mmap of %s failed, errno %d", path.c_str(), errno);
+        munmap(base, baseLen);
+        goto exit;
+    }
+
+    blob = std::make_shared<SoundModelBlob>(base, baseLen, (uint8_t *)addr,
+                                            st.st_size, path);
+    blob->ino_ = st.st_ino;
+    blob->mtime_ = st.st_mtime;
+    files_[path] = blob;
+    PAL_INFO(LOG_TAG, "mapped %s, size %u", path.c_str(), blob->GetSize());
+
+exit:
+    close(fd);
+    return blob;
+}
+
+std::shared_ptr<SoundModelBlob> SoundModelStore::CopyModel(const uint8_t *data,
+                                                          uint32_t size) {
+    std::shared_ptr<SoundModelBlob> blob = nullptr;
+    uint8_t *base = nullptr;
+    size_t baseLen = SOUND_MODEL_HEADROOM + (size_t)size + SOUND_MODEL_TAILROOM;
+
+    if (!data || !size) {
+        PAL_ERR(LOG_TAG, "Invalid sound model");
+        return nullptr;
+    }
+
+    base = (uint8_t *)calloc(1, baseLen);
+    if (!base) {
+        PAL_ERR(LOG_TAG, "Failed to allocate %zu bytes for sound model", baseLen);
+        return nullptr;
+    }
+    memcpy(base + SOUND_MODEL_HEADROOM, data, size);
+
+    blob = std::make_shared<SoundModelBlob>(base, baseLen,
+                                            base + SOUND_MODEL_HEADROOM, size, "");
+    return blob;
+}
+
+std::shared_ptr<SoundModelBlob> SoundModelStore::ShareModel(uint32_t uuid,
+                                                           const uint8_t *data,
+                                                           uint32_t size) {
+    std::shared_ptr<SoundModelBlob> blob = nullptr;
+
+    {
+        std::lock_guard<std::mutex> lck(mutex_);
+
+        auto iter = models_.find(uuid);
+        if (iter != models_.end())
+            blob = iter->second.blob;
+    }
+
+    /* models differ in size far more often than in content */
+    if (blob && data && blob->GetSize() == size &&
+        !memcmp(blob->GetData(), data, size)) {
+        PAL_DBG(LOG_TAG, "reuse pinned model 0x%x, size %u", uuid, size);
+        return blob;
+    }
+
+    return CopyModel(data, size);
+}
+
+uint32_t SoundModelStore::Acquire(uint32_t uuid,
+                                  std::shared_ptr<SoundModelBlob> blob) {
+    std::lock_guard<std::mutex> lck(mutex_);
+
+    if (!blob)
+        return 0;
+
+    auto iter = models_.find(uuid);
+    if (iter == models_.end()) {
+        models_[uuid] = {blob, 1};
+        return 1;
+    }
+
+    if (iter->second.blob != blob) {
+        PAL_INFO(LOG_TAG, "model 0x%x replaced, size %u -> %u", uuid,
+                 iter->second.blob->GetSize(), blob->GetSize());
+        iter->second.blob = blob;
+    }
+
+    return ++iter->second.refs;
+}
+
+uint32_t SoundModelStore::Release(uint32_t uuid) {
+    std::lock_guard<std::mutex> lck(mutex_);
+    uint32_t refs = 0;
+
+    auto iter = models_.find(uuid);
+    if (iter == models_.end())
+        return 0;
+
+    refs = --iter->second.refs;
+    if (!refs)
+        models_.erase(iter);
+
+    return refs;
+}
+
+SoundModelPin::SoundModelPin(uint32_t uuid, std::shared_ptr<SoundModelBlob> blob) :
+    store_(SoundModelStore::GetInstance()),
+    blob_(blob),
+    uuid_(uuid)
+{
+    store_->Acquire(uuid_, blob_);
+}
+
+SoundModelPin::~SoundModelPin() {
+    if (blob_)
+        store_->Release(uuid_);
+}
@@ -151,6 +151,7 @@ bool SoundTriggerPlatformInfo::concurrent_capture_ = false;
 bool SoundTriggerPlatformInfo::concurrent_voice_call_ = false;
 bool SoundTriggerPlatformInfo::concurrent_voip_call_ = false;
 bool SoundTriggerPlatformInfo::low_latency_bargein_enable_ = false;
+void (*SoundTriggerPlatformInfo::section_loader_)(const char *section) = nullptr;
 
 SoundTriggerPlatformInfo::SoundTriggerPlatformInfo() : curr_child_(nullptr)
 {
@@ -160,9 +161,16 @@ std::shared_ptr<SoundTriggerPlatformInfo> SoundTriggerPlatformInfo::GetInstance(
 {
     if (!me_)
         me_ = std::shared_ptr<SoundTriggerPlatformInfo>(new SoundTriggerPlatformInfo);
+    LoadSection();
     return me_;
 }
 
+void SoundTriggerPlatformInfo::LoadSection()
+{
+    if (section_loader_)
+        section_loader_("sound_trigger_platform_info");
+}
+
 void SoundTriggerPlatformInfo::ReadCapProfileNames(StOperatingModes mode,
                                                    const char** attribs,
                                                    st_op_modes_t& op_modes)
@@ -241,8 +241,7 @@ SoundModelLib::~SoundModelLib()
 }
 
 SoundModelInfo::SoundModelInfo() :
-    sm_data_(nullptr),
-    sm_size_(0),
+    sm_blob_(nullptr),
     num_keyphrases_(0),
     num_users_(0),
     keyphrases_(nullptr),
@@ -255,10 +254,7 @@ SoundModelInfo::SoundModelInfo() :
 }
 
 SoundModelInfo::~SoundModelInfo() {
-    if (sm_data_) {
-        free(sm_data_);
-        sm_data_ = nullptr;
-    }
+    sm_blob_ = nullptr;
     if (cf_levels_) {
         free(cf_levels_);
         cf_levels_ = nullptr;
@@ -275,16 +271,8 @@ SoundModelInfo & SoundModelInfo::operator =(SoundModelInfo &smi) {
         return *this;
 
     PAL_VERBOSE(LOG_TAG, "Entry");
-    /* Free sm_data if it exists, then create and copy it */
-    sm_size_ = smi.sm_size_;
-    if (sm_data_)
-        free(sm_data_);
-    sm_data_ = (uint8_t *)calloc(1, sm_size_);
-    if (!sm_data_) {
-        PAL_ERR(LOG_TAG, "sm_data calloc allocation failed");
-        goto exit;
-    }
-    memcpy(sm_data_, smi.sm_data_, sm_size_);
+    /* the model content never changes, share it instead of copying */
+    sm_blob_ = smi.sm_blob_;
 
     /* Free cf_levels and det_cf_levels if they exists, then create and copy them */
     if (cf_levels_)
@@ -292,8 +280,7 @@ SoundModelInfo & SoundModelInfo::operator =(SoundModelInfo &smi) {
     cf_levels_ = (uint8_t *)calloc(1, 2 * smi.cf_levels_size_);
     if (!cf_levels_) {
         PAL_ERR(LOG_TAG, "cf_levels calloc allocation failed");
-        free(sm_data_);
-        sm_data_ = nullptr;
+        sm_blob_ = nullptr;
         goto exit;
     }
     memcpy(cf_levels_, smi.cf_levels_, smi.cf_levels_size_);
@@ -343,6 +330,14 @@ exit:
     return *this;
 }
 
+void SoundModelInfo::SetModelData(uint8_t *data, uint32_t size) {
+    sm_blob_ = nullptr;
+    if (!size)
+        return;
+
+    sm_blob_ = SoundModelStore::GetInstance()->CopyModel(data, size);
+}
+
 void SoundModelInfo::FreeArrayPtrs(char **arr, uint32_t arr_len)
 {
     if (!arr)
@@ -539,3 +534,113 @@ int32_t SoundModelInfo::UpdateConfLevelArray(uint8_t *conf_levels, uint32_t cfl_
     }
     return 0;
 }
+
+MergedModelCache::MergedModelCache(uint32_t capacity) :
+    capacity_(capacity ? capacity : 1),
+    hits_(0),
+    misses_(0),
+    evictions_(0),
+    num_merges_(0),
+    total_merge_us_(0),
+    max_merge_us_(0)
+{
+}
+
+MergedModelCache::~MergedModelCache() {
+    Clear();
+}
+
+/* 64 bit FNV-1a, only used to tell sound models apart */
+uint64_t MergedModelCache::HashModel(const uint8_t *data, uint32_t size) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+
+    for (uint32_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash ^ size;
+}
+
+bool MergedModelCache::Lookup(std::vector<uint64_t> key,
+                              SoundModelInfo *out_info) {
+    std::lock_guard<std::mutex> lck(mutex_);
+
+    std::sort(key.begin(), key.end());
+    for (auto it = entries_.begin(); it != entries_.end(); it++) {
+        if (it->key != key)
+            continue;
+
+        *out_info = *(it->info);
+        if (!out_info->GetModelData()) {
+            PAL_ERR(LOG_TAG, "Failed to copy cached merged model");
+            break;
+        }
+        entries_.splice(entries_.begin(), entries_, it);
+        hits_++;
+        PAL_DBG(LOG_TAG, "merged model hit for %zu models, size %d",
+                key.size(), out_info->GetModelSize());
+        return true;
+    }
+    misses_++;
+    return false;
+}
+
+void MergedModelCache::Insert(std::vector<uint64_t> key, SoundModelInfo *info) {
+    std::lock_guard<std::mutex> lck(mutex_);
+    SoundModelInfo *copy = nullptr;
+
+    std::sort(key.begin(), key.end());
+    for (auto it = entries_.begin(); it != entries_.end(); it++) {
+        if (it->key == key) {
+            delete it->info;
+            entries_.erase(it);
+            break;
+        }
+    }
+
+    copy = new SoundModelInfo();
+    *copy = *info;
+    if (!copy->GetModelData()) {
+        PAL_ERR(LOG_TAG, "Failed to copy merged model to cache");
+        delete copy;
+        return;
+    }
+
+    if (entries_.size() >= capacity_) {
+        delete entries_.back().info;
+        entries_.pop_back();
+        evictions_++;
+    }
+    entries_.push_front({key, copy});
+}
+
+void MergedModelCache::RecordMerge(uint64_t duration_us) {
+    std::lock_guard<std::mutex> lck(mutex_);
+
+    num_merges_++;
+    total_merge_us_ += duration_us;
+    if (duration_us > max_merge_us_)
+        max_merge_us_ = duration_us;
+    PAL_INFO(LOG_TAG, "sound model merge took %llu us",
+             (unsigned long long)duration_us);
+}
+
+void MergedModelCache::GetStats(struct pal_param_st_merge_cache_stats *stats) {
+    std::lock_guard<std::mutex> lck(mutex_);
+
+    stats->hits = hits_;
+    stats->misses = misses_;
+    stats->evictions = evictions_;
+    stats->num_entries = entries_.size();
+    stats->num_merges = num_merges_;
+    stats->total_merge_us = total_merge_us_;
+    stats->max_merge_us = max_merge_us_;
+}
+
+void MergedModelCache::Clear() {
+    std::lock_guard<std::mutex> lck(mutex_);
+
+    for (auto &entry : entries_)
+        delete entry.info;
+    entries_.clear();
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#define LOG_TAG "PAL: VUILatencyTracer"
+
+#include "VUILatencyTracer.h"
+
+#include <algorithm>
+#include <time.h>
+#include <vector>
+
+#include "PalCommon.h"
+
+#define NS_PER_US 1000
+
+static uint64_t GetPercentile(std::vector<uint64_t> &values, uint32_t pct)
+{
+    size_t idx = 0;
+
+    if (values.empty())
+        return 0;
+
+    idx = (values.size() * pct) / 100;
+    if (idx >= values.size())
+        idx = values.size() - 1;
+    std::nth_element(values.begin(), values.begin() + idx, values.end());
+
+    return values[idx];
+}
+
+VUILatencyTracer::VUILatencyTracer()
+{
+    open_.store(false);
+    head_.store(0);
+    for (int i = 0; i < PAL_ST_TRACE_STAGE_MAX; i++)
+        cur_[i].store(0);
+    for (int i = 0; i < VUI_LATENCY_TRACE_RECORDS; i++) {
+        records_[i].seq.store(0);
+        for (int j = 0; j < PAL_ST_TRACE_STAGE_MAX; j++)
+            records_[i].ts[j].store(0);
+    }
+}
+
+uint64_t VUILatencyTracer::GetTimeNs()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void VUILatencyTracer::Begin(uint64_t dsp_event_ns)
+{
+    if (IsOpen())
+        End();
+
+    for (int i = 0; i < PAL_ST_TRACE_STAGE_MAX; i++)
+        cur_[i].store(0, std::memory_order_relaxed);
+    cur_[PAL_ST_TRACE_DSP_EVENT].store(dsp_event_ns ? dsp_event_ns : GetTimeNs(),
+        std::memory_order_relaxed);
+    open_.store(true, std::memory_order_release);
+}
+
+void VUILatencyTracer::Mark(pal_st_trace_stage_t stage)
+{
+    if (stage >= PAL_ST_TRACE_STAGE_MAX || !IsOpen())
+        return;
+
+    cur_[stage].store(GetTimeNs(), std::memory_order_relaxed);
+}
+
+void VUILatencyTracer::End()
+{
+    bool expected = true;
+    uint32_t head = 0;
+    TraceRecord *rec = nullptr;
+
+    if (!open_.compare_exchange_strong(expected, false,
+            std::memory_order_acq_rel))
+        return;
+
+    head = head_.load(std::memory_order_relaxed);
+    rec = &records_[head % VUI_LATENCY_TRACE_RECORDS];
+
+    /* odd sequence marks the slot as being written */
+    rec->seq.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (int i = 0; i < PAL_ST_TRACE_STAGE_MAX; i++)
+        rec->ts[i].store(cur_[i].load(std::memory_order_relaxed),
+            std::memory_order_relaxed);
+    rec->seq.fetch_add(1, std::memory_order_release);
+    head_.store(head + 1, std::memory_order_release);
+}
+
+void VUILatencyTracer::GetStats(struct pal_param_st_latency_stats *stats) const
+{
+    uint32_t head = 0;
+    uint32_t count = 0;
+    uint32_t seq = 0;
+    uint64_t ts[PAL_ST_TRACE_STAGE_MAX];
+    uint64_t start = 0;
+    std::vector<uint64_t> notify;
+    std::vector<uint64_t> lab;
+    bool last_found = false;
+
+    if (!stats)
+        return;
+
+    memset(stats, 0, sizeof(struct pal_param_st_latency_stats));
+    head = head_.load(std::memory_order_acquire);
+    count = std::min(head, (uint32_t)VUI_LATENCY_TRACE_RECORDS);
+
+    /* walk from newest to oldest so the first valid record is the last one */
+    for (uint32_t i = 0; i < count; i++) {
+        const TraceRecord *rec =
+            &records_[(head - 1 - i) % VUI_LATENCY_TRACE_RECORDS];
+
+        seq = rec->seq.load(std::memory_order_acquire);
+        if (seq & 1)
+            continue;
+        for (int j = 0; j < PAL_ST_TRACE_STAGE_MAX; j++)
+            ts[j] = rec->ts[j].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (rec->seq.load(std::memory_order_relaxed) != seq)
+            continue;
+
+        start = ts[PAL_ST_TRACE_DSP_EVENT];
+        if (ts[PAL_ST_TRACE_CLIENT_NOTIFIED] > start)
+            notify.push_back((ts[PAL_ST_TRACE_CLIENT_NOTIFIED] - start) / NS_PER_US);
+        if (ts[PAL_ST_TRACE_LAB_FIRST_READ] > start)
+            lab.push_back((ts[PAL_ST_TRACE_LAB_FIRST_READ] - start) / NS_PER_US);
+
+        if (!last_found) {
+            for (int j = 0; j < PAL_ST_TRACE_STAGE_MAX; j++)
+                stats->last_stage_us[j] =
+                    ts[j] > start ? (ts[j] - start) / NS_PER_US : 0;
+            last_found = true;
+        }
+    }
+
+    stats->num_notified = notify.size();
+    stats->num_lab_read = lab.size();
+    stats->notify_p50_us = GetPercentile(notify, 50);
+    stats->notify_p99_us = GetPercentile(notify, 99);
+    stats->lab_p50_us = GetPercentile(lab, 50);
+    stats->lab_p99_us = GetPercentile(lab, 99);
+
+    PAL_DBG(LOG_TAG, "notify p50 %llu us p99 %llu us, lab p50 %llu us p99 %llu us",
+        (unsigned long long)stats->notify_p50_us,
+        (unsigned long long)stats->notify_p99_us,
+        (unsigned long long)stats->lab_p50_us,
+        (unsigned long long)stats->lab_p99_us);
+}
@@ -408,6 +408,7 @@ std::shared_ptr<VoiceUIPlatformInfo> VoiceUIPlatformInfo::GetInstance()
 {
     if (!me_)
         me_ = std::shared_ptr<VoiceUIPlatformInfo> (new VoiceUIPlatformInfo);
+    SoundTriggerPlatformInfo::LoadSection();
 
     return me_;
 }